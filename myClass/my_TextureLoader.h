@@ -6,60 +6,234 @@
 #include <iostream>
 #include <stb/stb_image.h>
 
+#include "my_glState.h"
+#include "my_glExtensions.h"
+#include "my_imageUtils.h"
+#include "my_ktx2.h"
+#include "my_mipCache.h"
+
+// 加载参数：翻转、强制通道数和采样方式（TextureCache 也用它区分同一文件的不同纹理）
+struct TextureParams {
+    bool flip = true;
+    int channels = 0;   // 0 = 保持图片原有通道数
+    bool srgb = false;  // 颜色贴图用 sRGB 内部格式，mip 在线性空间平均
+    GLint wrapS = GL_REPEAT;
+    GLint wrapT = GL_REPEAT;
+    GLint minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    GLint magFilter = GL_LINEAR;
+};
+
 class Texture{
 public:
-    GLuint ID;
-    int width, height, nrChannels;
+    GLuint ID = 0;
+    int width = 0, height = 0, nrChannels = 0;
+    size_t compressedBytes = 0; // KTX2 压缩纹理整条 mip 链的字节数，非压缩纹理为 0
+
+    // 接管一个已经创建好的纹理对象（异步流式加载完成后使用）
+    Texture(GLuint id, int width, int height, int nrChannels)
+        : ID(id), width(width), height(height), nrChannels(nrChannels) {}
 
     // 这里考虑的opnegl的坐标系与图片坐标系的不同（opengl坐标原点位于左下角 大多数图片第一个像素在左上角）
-    Texture(const std::string& path, bool flip = true) {
-        stbi_set_flip_vertically_on_load(flip);
-        unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-        if(!data){
+    Texture(const std::string& path, bool flip = true) : Texture(path, TextureParams{ flip }) {}
+
+    Texture(const std::string& path, const TextureParams& params) {
+        if (isKtx2Path(path)) {
+            loadKtx2(path, params);
+            return;
+        }
+        if (usesMipmaps(params.minFilter)) {
+            loadMipChain(path, params);
+            return;
+        }
+        // 解码不碰 stb 的全局翻转标志，翻转在这里原地完成，多个线程同时加载也互不影响
+        Image image = decodeImage(path, params.channels);
+        if(!image){
             std::cerr << "Failed to load texture:" << path << std::endl;
             return;
         }
-        // 根据图片通道数选择纹理存储格式 4通道->RGBA 3通道->RGB 1通道->RED(灰度图)
-        GLenum format = (nrChannels == 4) ? GL_RGBA : (nrChannels == 3 ? GL_RGB : GL_RED);
+        if (params.flip)
+            flipRowsInPlace(image.pixels, image.width, image.height, image.channels);
+        width = image.width;
+        height = image.height;
+        nrChannels = image.channels;
+        unsigned char* data = image.pixels;
 
-        // 生成纹理
+        // 根据图片通道数选择纹理存储格式 4通道->RGBA 3通道->RGB 2通道->RG(灰度+透明) 1通道->RED(灰度图)
+        GLenum format = pixelFormat(nrChannels);
+
+        // 生成纹理（过滤方式不采样 mip，只上传 level 0）
         glGenTextures(1, &ID);
-        glBindTexture(GL_TEXTURE_2D, ID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        glState().bindTexture(GL_TEXTURE_2D, ID);
+        // RGB/RED 的行宽不一定是 4 字节对齐
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat(nrChannels, params.srgb), width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
 
         // 为当前绑定的纹理对象设置环绕、过滤方式
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrapS);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrapT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.magFilter);
+    }
 
-        stbi_image_free(data);
+    static bool usesMipmaps(GLint minFilter) {
+        return minFilter != GL_LINEAR && minFilter != GL_NEAREST;
+    }
+
+    // 通道数 -> 上传用的像素格式 / 内部格式；TextureStreamer 上传 mip 链时用同一套对应关系
+    static GLenum pixelFormat(int channels) {
+        switch (channels) {
+        case 4: return GL_RGBA;
+        case 3: return GL_RGB;
+        case 2: return GL_RG;
+        default: return GL_RED;
+        }
+    }
+
+    // sRGB 只有三、四通道的格式，一、二通道忽略 srgb
+    static GLint internalFormat(int channels, bool srgb) {
+        if (channels == 4)
+            return srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+        if (channels == 3)
+            return srgb ? GL_SRGB8 : GL_RGB8;
+        if (channels == 2)
+            return GL_RG8;
+        return GL_R8;
+    }
+
+    static bool isKtx2Path(const std::string& path) {
+        return path.size() > 5 && path.compare(path.size() - 5, 5, ".ktx2") == 0;
+    }
+
+    // 驱动支持时返回对应的压缩内部格式，否则返回 0
+    static GLenum compressedInternalFormat(BlockFormat format, bool srgb) {
+        const GLExtensions& ext = glExt();
+        switch (format) {
+        case BlockFormat::BC1:
+            if (srgb ? ext.textureCompressionS3TCsRGB : ext.textureCompressionS3TC)
+                return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            break;
+        case BlockFormat::BC3:
+            if (srgb ? ext.textureCompressionS3TCsRGB : ext.textureCompressionS3TC)
+                return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            break;
+        case BlockFormat::BC7:
+            if (ext.textureCompressionBPTC)
+                return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+            break;
+        case BlockFormat::ETC2_RGB:
+            if (ext.textureCompressionETC2)
+                return srgb ? GL_COMPRESSED_SRGB8_ETC2 : GL_COMPRESSED_RGB8_ETC2;
+            break;
+        case BlockFormat::ETC2_RGBA:
+            if (ext.textureCompressionETC2)
+                return srgb ? GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC : GL_COMPRESSED_RGBA8_ETC2_EAC;
+            break;
+        }
+        return 0;
     }
 
     void use(GLuint textureUnit = 0) const {
-        glActiveTexture(GL_TEXTURE0 + textureUnit);
-        glBindTexture(GL_TEXTURE_2D, ID);
+        glState().bindTextureUnit(textureUnit, GL_TEXTURE_2D, ID);
+    }
+
+private:
+    // mip 链由 CPU 生成（或直接从 mip 缓存读出），逐级上传，不依赖驱动的 glGenerateMipmap
+    void loadMipChain(const std::string& path, const TextureParams& params) {
+        MipChain chain = mipCache().loadOrBuild(path, params.flip, params.srgb, params.channels);
+        if (!chain) {
+            std::cerr << "Failed to load texture:" << path << std::endl;
+            return;
+        }
+        width = chain.width;
+        height = chain.height;
+        nrChannels = chain.channels;
+        // 链里只有 1、2、4 通道（3 通道在生成时已扩成 4 通道）
+        GLenum format = pixelFormat(nrChannels);
+
+        glGenTextures(1, &ID);
+        glState().bindTexture(GL_TEXTURE_2D, ID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (size_t level = 0; level < chain.levels.size(); ++level) {
+            const MipLevelInfo& l = chain.levels[level];
+            glTexImage2D(GL_TEXTURE_2D, (GLint)level, internalFormat(nrChannels, params.srgb), l.width, l.height, 0,
+                         format, GL_UNSIGNED_BYTE, chain.level(level));
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)chain.levels.size() - 1);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrapS);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrapT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.magFilter);
+    }
+
+    // texture_baker 生成的 .ktx2：每一级 mip 都已离线压缩好，直接上传，不解码也不 glGenerateMipmap
+    // 文件在烘焙时已经按 OpenGL 的方向翻转过，这里忽略 params.flip
+    void loadKtx2(const std::string& path, const TextureParams& params) {
+        std::string error;
+        ktx2::Texture2D file = ktx2::read(path, &error);
+        if (!file) {
+            std::cerr << "Failed to load texture:" << path << " (" << error << ")" << std::endl;
+            return;
+        }
+        BlockFormat format;
+        bool srgb;
+        GLenum internalFormat = ktx2::blockFormatFor(file.vkFormat, format, srgb) ? compressedInternalFormat(format, srgb) : 0;
+        if (internalFormat == 0) {
+            std::cerr << "ERROR::TEXTURE::COMPRESSED_FORMAT_NOT_SUPPORTED vkFormat " << file.vkFormat
+                      << ": " << path << std::endl;
+            return;
+        }
+
+        width = file.width;
+        height = file.height;
+        nrChannels = (format == BlockFormat::BC1 || format == BlockFormat::ETC2_RGB) ? 3 : 4;
+
+        glGenTextures(1, &ID);
+        glState().bindTexture(GL_TEXTURE_2D, ID);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)file.levels.size() - 1);
+        for (size_t level = 0; level < file.levels.size(); ++level) {
+            const ktx2::Level& l = file.levels[level];
+            glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)level, internalFormat, l.width, l.height, 0,
+                                   (GLsizei)l.length, file.levelData(level));
+            compressedBytes += l.length;
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrapS);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrapT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.magFilter);
     }
 
+public:
      ~Texture() {
-        if (ID != 0)
+        if (ID != 0) {
+            glState().forgetTexture(ID);
             glDeleteTextures(1, &ID);
+        }
     }
 
     // 禁止拷贝，支持移动
     Texture(const Texture&) = delete;
     Texture& operator=(const Texture&) = delete;
-    Texture(Texture&& other) noexcept : ID(other.ID), width(other.width), height(other.height), nrChannels(other.nrChannels) {
+    Texture(Texture&& other) noexcept
+        : ID(other.ID), width(other.width), height(other.height), nrChannels(other.nrChannels), compressedBytes(other.compressedBytes) {
         other.ID = 0;
     }
     Texture& operator=(Texture&& other) noexcept {
         if (this != &other) {
-            glDeleteTextures(1, &ID);
+            if (ID != 0) {
+                glState().forgetTexture(ID);
+                glDeleteTextures(1, &ID);
+            }
             ID = other.ID;
             width = other.width;
             height = other.height;
             nrChannels = other.nrChannels;
+            compressedBytes = other.compressedBytes;
             other.ID = 0;
         }
         return *this;
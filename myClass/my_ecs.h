@@ -0,0 +1,370 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+
+#include "my_frustum.h"
+#include "my_jobSystem.h"
+#include "my_matrixKernels.h"
+
+// 面向数据的实体 / 组件存储（sparse set）
+//   - Entity 是 下标 + 代数：销毁后下标回收、代数加一，旧句柄自动失效
+//   - 每种组件一个池：sparse[实体下标] -> 稠密槽位，稠密部分紧凑连续，删除时把最后一个搬过来填洞
+//   - 池里的数据按 SoA 存：位置 / 旋转 / 缩放每个分量一列，世界矩阵、包围盒、绘制句柄也各自一列，
+//     变换更新和视锥剔除都是对几列数组的线性扫描，不经过指针
+//   - 同时有变换和渲染组件的实体在两个池里都排在最前面、顺序相同（owning group），
+//     [0, renderableCount()) 这一段用同一个槽位就能同时访问两个池的列，不需要查 sparse
+// 不调用 GL：绘制句柄只是记下程序、VAO 和索引范围，由调用方录制成 DrawPacket
+
+struct Entity {
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+    uint32_t index = NONE;
+    uint32_t generation = 0;
+
+    explicit operator bool() const { return index != NONE; }
+    bool operator==(const Entity& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const Entity& o) const { return !(*this == o); }
+};
+
+// 绘制需要的句柄：VAO 上绑好索引缓冲，画 [indexByteOffset, + indexCount) 这段三角形
+struct RenderHandle {
+    GLuint program = 0;
+    GLuint vao = 0;
+    GLsizei indexCount = 0;
+    GLintptr indexByteOffset = 0;
+};
+
+namespace ecs_detail {
+
+// 只管 实体下标 <-> 稠密槽位 的映射；列数据在派生的池里，槽位交换 / 弹出时由 Derived 同步
+template <typename Derived>
+class SparseSet {
+public:
+    size_t size() const { return dense.size(); }
+    bool contains(uint32_t entity) const { return entity < sparse.size() && sparse[entity] != Entity::NONE; }
+    uint32_t slotOf(uint32_t entity) const { return sparse[entity]; }
+    // 槽位 -> 实体下标
+    const std::vector<uint32_t>& entities() const { return dense; }
+
+protected:
+    std::vector<uint32_t> sparse;
+    std::vector<uint32_t> dense;
+
+    uint32_t insertSlot(uint32_t entity) {
+        if (entity >= sparse.size())
+            sparse.resize((size_t)entity + 1, Entity::NONE);
+        sparse[entity] = (uint32_t)dense.size();
+        dense.push_back(entity);
+        return sparse[entity];
+    }
+
+    void swapSlots(uint32_t a, uint32_t b) {
+        if (a == b)
+            return;
+        std::swap(dense[a], dense[b]);
+        sparse[dense[a]] = a;
+        sparse[dense[b]] = b;
+        static_cast<Derived*>(this)->swapColumns(a, b);
+    }
+
+    // 先换到末尾再弹出，其余实体的槽位不变（除了被搬过来的那个）
+    void eraseSlot(uint32_t entity) {
+        uint32_t slot = sparse[entity];
+        swapSlots(slot, (uint32_t)dense.size() - 1);
+        dense.pop_back();
+        sparse[entity] = Entity::NONE;
+        static_cast<Derived*>(this)->popColumns();
+    }
+
+    void reserveSlots(size_t n) { dense.reserve(n); }
+};
+
+template <typename T>
+void swapColumn(std::vector<T>& column, uint32_t a, uint32_t b) {
+    std::swap(column[a], column[b]);
+}
+
+} // namespace ecs_detail
+
+// 变换 + 包围盒：局部 TRS（旋转是单位四元数）和局部 AABB 是输入，世界矩阵和世界 AABB 由 updateTransforms() 算出
+class TransformPool : public ecs_detail::SparseSet<TransformPool> {
+public:
+    std::vector<float> px, py, pz;
+    std::vector<float> rx, ry, rz, rw;
+    std::vector<float> sx, sy, sz;
+    AABBSoA localBounds;
+    AABBSoA worldBounds;          // 可以直接交给 cullAABBs / OcclusionBuffer::cullAABBs
+    std::vector<glm::mat4> world;
+
+    glm::vec3 position(uint32_t slot) const { return glm::vec3(px[slot], py[slot], pz[slot]); }
+    glm::quat rotation(uint32_t slot) const { return glm::quat(rw[slot], rx[slot], ry[slot], rz[slot]); }
+    glm::vec3 scale(uint32_t slot) const { return glm::vec3(sx[slot], sy[slot], sz[slot]); }
+
+private:
+    friend class Registry;
+    friend class ecs_detail::SparseSet<TransformPool>;
+
+    void reserve(size_t n) {
+        reserveSlots(n);
+        for (std::vector<float>* column : floatColumns())
+            column->reserve(n);
+        localBounds.reserve(n);
+        worldBounds.reserve(n);
+        world.reserve(n);
+    }
+
+    void push(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+        px.push_back(position.x); py.push_back(position.y); pz.push_back(position.z);
+        rx.push_back(rotation.x); ry.push_back(rotation.y); rz.push_back(rotation.z); rw.push_back(rotation.w);
+        sx.push_back(scale.x); sy.push_back(scale.y); sz.push_back(scale.z);
+        // 没有设置包围盒时是原点处的一个点
+        localBounds.push(glm::vec3(0.0f), glm::vec3(0.0f));
+        worldBounds.push(position, glm::vec3(0.0f));
+        world.push_back(glm::mat4(1.0f));
+    }
+
+    void swapColumns(uint32_t a, uint32_t b) {
+        for (std::vector<float>* column : floatColumns())
+            ecs_detail::swapColumn(*column, a, b);
+        for (AABBSoA* bounds : { &localBounds, &worldBounds }) {
+            for (std::vector<float>* column : { &bounds->cx, &bounds->cy, &bounds->cz, &bounds->ex, &bounds->ey, &bounds->ez })
+                ecs_detail::swapColumn(*column, a, b);
+        }
+        ecs_detail::swapColumn(world, a, b);
+    }
+
+    void popColumns() {
+        for (std::vector<float>* column : floatColumns())
+            column->pop_back();
+        for (AABBSoA* bounds : { &localBounds, &worldBounds }) {
+            for (std::vector<float>* column : { &bounds->cx, &bounds->cy, &bounds->cz, &bounds->ex, &bounds->ey, &bounds->ez })
+                column->pop_back();
+        }
+        world.pop_back();
+    }
+
+    std::array<std::vector<float>*, 10> floatColumns() {
+        return { &px, &py, &pz, &rx, &ry, &rz, &rw, &sx, &sy, &sz };
+    }
+};
+
+// 绘制句柄和颜色
+class RenderPool : public ecs_detail::SparseSet<RenderPool> {
+public:
+    std::vector<GLuint> program;
+    std::vector<GLuint> vao;
+    std::vector<GLsizei> indexCount;
+    std::vector<GLintptr> indexByteOffset;
+    std::vector<glm::vec4> color;
+
+private:
+    friend class Registry;
+    friend class ecs_detail::SparseSet<RenderPool>;
+
+    void reserve(size_t n) {
+        reserveSlots(n);
+        program.reserve(n); vao.reserve(n); indexCount.reserve(n); indexByteOffset.reserve(n); color.reserve(n);
+    }
+
+    void push(const RenderHandle& handle, const glm::vec4& c) {
+        program.push_back(handle.program);
+        vao.push_back(handle.vao);
+        indexCount.push_back(handle.indexCount);
+        indexByteOffset.push_back(handle.indexByteOffset);
+        color.push_back(c);
+    }
+
+    void swapColumns(uint32_t a, uint32_t b) {
+        ecs_detail::swapColumn(program, a, b);
+        ecs_detail::swapColumn(vao, a, b);
+        ecs_detail::swapColumn(indexCount, a, b);
+        ecs_detail::swapColumn(indexByteOffset, a, b);
+        ecs_detail::swapColumn(color, a, b);
+    }
+
+    void popColumns() {
+        program.pop_back(); vao.pop_back(); indexCount.pop_back(); indexByteOffset.pop_back(); color.pop_back();
+    }
+};
+
+namespace ecs_detail {
+
+// 槽位 [first, last) 的 TRS -> 世界矩阵，再把局部 AABB 变换成世界 AABB（中心变换，半长取 |M| * e）
+// 合成和包围盒在同一趟 SIMD 内核里做，矩阵元素不用写出去再读回来
+inline void composeTransforms(TransformPool& t, size_t first, size_t last) {
+    TRSColumns trs{ t.px.data(), t.py.data(), t.pz.data(), t.rx.data(), t.ry.data(), t.rz.data(), t.rw.data(),
+                    t.sx.data(), t.sy.data(), t.sz.data() };
+    ConstAABBColumns local = readColumns(t.localBounds);
+    AABBColumns world = writeColumns(t.worldBounds);
+    matrixKernels().composeTransforms(trs, first, last, t.world.data(), &local, &world);
+}
+
+} // namespace ecs_detail
+
+class Registry {
+public:
+    TransformPool transforms;
+    RenderPool renderables;
+
+    // 预留 n 个实体的空间，避免场景搭建时反复扩容
+    void reserve(size_t n) {
+        generations.reserve(n);
+        transforms.reserve(n);
+        renderables.reserve(n);
+    }
+
+    Entity create() {
+        Entity e;
+        if (!freeList.empty()) {
+            e.index = freeList.back();
+            freeList.pop_back();
+        } else {
+            e.index = (uint32_t)generations.size();
+            generations.push_back(0);
+        }
+        e.generation = generations[e.index];
+        ++alive;
+        return e;
+    }
+
+    void destroy(Entity e) {
+        if (!valid(e))
+            return;
+        removeTransform(e);
+        removeRenderable(e);
+        ++generations[e.index];
+        freeList.push_back(e.index);
+        --alive;
+    }
+
+    bool valid(Entity e) const { return e.index < generations.size() && generations[e.index] == e.generation; }
+    size_t size() const { return alive; }
+
+    // ---- 变换 ----
+
+    void addTransform(Entity e, const glm::vec3& position, const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                      const glm::vec3& scale = glm::vec3(1.0f)) {
+        if (!valid(e) || transforms.contains(e.index))
+            return;
+        transforms.insertSlot(e.index);
+        transforms.push(position, rotation, scale);
+        if (renderables.contains(e.index))
+            joinGroup(e.index);
+    }
+
+    void removeTransform(Entity e) {
+        if (!valid(e) || !transforms.contains(e.index))
+            return;
+        leaveGroup(e.index);
+        transforms.eraseSlot(e.index);
+    }
+
+    bool hasTransform(Entity e) const { return valid(e) && transforms.contains(e.index); }
+
+    // 下面的读写都要求实体已经有变换组件；批量处理时直接按槽位访问 transforms 的列更快
+    void setPosition(Entity e, const glm::vec3& p) {
+        uint32_t s = transforms.slotOf(e.index);
+        transforms.px[s] = p.x; transforms.py[s] = p.y; transforms.pz[s] = p.z;
+    }
+    void setRotation(Entity e, const glm::quat& q) {
+        uint32_t s = transforms.slotOf(e.index);
+        transforms.rx[s] = q.x; transforms.ry[s] = q.y; transforms.rz[s] = q.z; transforms.rw[s] = q.w;
+    }
+    void setScale(Entity e, const glm::vec3& v) {
+        uint32_t s = transforms.slotOf(e.index);
+        transforms.sx[s] = v.x; transforms.sy[s] = v.y; transforms.sz[s] = v.z;
+    }
+    // 局部空间（模型空间）的包围盒
+    void setBounds(Entity e, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+        uint32_t s = transforms.slotOf(e.index);
+        AABBSoA& b = transforms.localBounds;
+        glm::vec3 center = (boundsMin + boundsMax) * 0.5f, extent = (boundsMax - boundsMin) * 0.5f;
+        b.cx[s] = center.x; b.cy[s] = center.y; b.cz[s] = center.z;
+        b.ex[s] = extent.x; b.ey[s] = extent.y; b.ez[s] = extent.z;
+    }
+
+    glm::vec3 position(Entity e) const { return transforms.position(transforms.slotOf(e.index)); }
+    const glm::mat4& worldMatrix(Entity e) const { return transforms.world[transforms.slotOf(e.index)]; }
+
+    // ---- 渲染 ----
+
+    void addRenderable(Entity e, const RenderHandle& handle, const glm::vec4& color = glm::vec4(1.0f)) {
+        if (!valid(e) || renderables.contains(e.index))
+            return;
+        renderables.insertSlot(e.index);
+        renderables.push(handle, color);
+        if (transforms.contains(e.index))
+            joinGroup(e.index);
+    }
+
+    void removeRenderable(Entity e) {
+        if (!valid(e) || !renderables.contains(e.index))
+            return;
+        leaveGroup(e.index);
+        renderables.eraseSlot(e.index);
+    }
+
+    bool hasRenderable(Entity e) const { return valid(e) && renderables.contains(e.index); }
+
+    // 同时有变换和渲染组件的实体数；两个池的槽位 [0, renderableCount()) 一一对应
+    size_t renderableCount() const { return grouped; }
+
+    // ---- 系统 ----
+
+    // 所有变换重新算世界矩阵和世界包围盒；传入 jobs 时分段并行（每个实体只写自己的槽位）
+    void updateTransforms(JobSystem* jobs = nullptr) {
+        size_t n = transforms.size();
+        if (jobs) {
+            jobs->parallelFor(0, n, [this](size_t first, size_t last) {
+                ecs_detail::composeTransforms(transforms, first, last);
+            }, MIN_ENTITIES_PER_TASK);
+        } else {
+            ecs_detail::composeTransforms(transforms, 0, n);
+        }
+    }
+
+    // 视锥内可渲染实体的槽位（升序）写进 visible，返回数量；槽位同时用于 transforms 和 renderables 的列
+    size_t cullRenderables(const Frustum& frustum, std::vector<uint32_t>& visible, CullPath path = CullPath::SIMD) const {
+        cullAABBs(frustum, transforms.worldBounds, visible, path);
+        // 结果是升序的，组外（没有渲染组件）的槽位都在末尾
+        visible.erase(std::lower_bound(visible.begin(), visible.end(), (uint32_t)grouped), visible.end());
+        return visible.size();
+    }
+
+private:
+    // 每个实体几十纳秒，分得太细调度开销就比计算大了
+    static constexpr size_t MIN_ENTITIES_PER_TASK = 1024;
+
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeList;
+    size_t alive = 0;
+    size_t grouped = 0;
+
+    // 两个池里都把这个实体换到组的末尾，组长度加一
+    void joinGroup(uint32_t entity) {
+        transforms.swapSlots(transforms.slotOf(entity), (uint32_t)grouped);
+        renderables.swapSlots(renderables.slotOf(entity), (uint32_t)grouped);
+        ++grouped;
+    }
+
+    // 在组里的话先和组的最后一个交换，组长度减一，之后再从池里删掉就不会打乱组
+    void leaveGroup(uint32_t entity) {
+        if (!transforms.contains(entity) || !renderables.contains(entity))
+            return;
+        uint32_t slot = transforms.slotOf(entity);
+        if (slot >= grouped)
+            return;
+        --grouped;
+        transforms.swapSlots(slot, (uint32_t)grouped);
+        renderables.swapSlots(renderables.slotOf(entity), (uint32_t)grouped);
+    }
+};
+
+#endif
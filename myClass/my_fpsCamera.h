@@ -2,9 +2,15 @@
 #define FPSCAMERA_H
 
 #include <glad/glad.h>
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "my_uniformBlocks.h"
+#include "my_glState.h"
+#include "my_frustum.h"
+#include "my_matrixKernels.h"
+
 enum FpsCamera_Movement{
     FORWARD,
     BACKWARD,
@@ -18,6 +24,8 @@ const float PITCH       =  0.0f;
 const float SPEED       =  2.5f;
 const float SENSITIVITY =  0.1f;
 const float ZOOM        =  45.0f;
+const float NEAR_PLANE  =  0.1f;
+const float FAR_PLANE   =  100.0f;
 
 class FpsCamera{
 public:
@@ -34,6 +42,10 @@ public:
     float MovementSpeed;
     float MouseSensitivity;
     float Zoom;
+    // 投影设置
+    float AspectRatio = 800.0f / 600.0f;
+    float NearPlane = NEAR_PLANE;
+    float FarPlane  = FAR_PLANE;
 
     // 向量构造函数
     FpsCamera(glm::vec3 position = glm::vec3(0.0f,0.0f,0.0f),glm::vec3 up = glm::vec3(0.0f,1.0f,0.0f),float yaw = YAW, float pitch = PITCH) 
@@ -57,9 +69,102 @@ public:
         updateCameraVectors();
     }
 
-    glm::mat4 GetViewMatrix(){
-        return glm::lookAt(Position, Position + Front, Up);
+    // 只有相机真的变化时才重新计算（直接修改公有成员也能检测到）
+    const glm::mat4& GetViewMatrix(){
+        if (!viewValid || Position != cachedPosition || Front != cachedFront || Up != cachedUp) {
+            view = glm::lookAt(Position, Position + Front, Up);
+            cachedPosition = Position;
+            cachedFront = Front;
+            cachedUp = Up;
+            viewValid = true;
+            viewProjValid = false;
+        }
+        return view;
+    }
+
+    const glm::mat4& GetProjectionMatrix(){
+        if (!projectionValid || Zoom != cachedZoom || AspectRatio != cachedAspect
+            || NearPlane != cachedNear || FarPlane != cachedFar) {
+            projection = glm::perspective(glm::radians(Zoom), AspectRatio, NearPlane, FarPlane);
+            cachedZoom = Zoom;
+            cachedAspect = AspectRatio;
+            cachedNear = NearPlane;
+            cachedFar = FarPlane;
+            projectionValid = true;
+            viewProjValid = false;
+        }
+        return projection;
+    }
+
+    const glm::mat4& GetViewProjectionMatrix(){
+        GetViewMatrix();
+        GetProjectionMatrix();
+        if (!viewProjValid) {
+            viewProj = projection * view;
+            viewProjValid = true;
+            matricesUploaded = false;
+            frustumValid = false;
+        }
+        return viewProj;
+    }
+
+    // 世界空间的视锥平面，和 viewProj 一起缓存
+    const Frustum& GetFrustum(){
+        GetViewProjectionMatrix();
+        if (!frustumValid) {
+            frustum = Frustum::fromMatrix(viewProj);
+            frustumValid = true;
+        }
+        return frustum;
+    }
+
+    // 批量算 mvps[i] = viewProj * models[i]，CPU 端要用 MVP 时（比如直接写进每物体的 uniform）一次算完整个数组
+    void ComputeMVPs(const glm::mat4* models, glm::mat4* mvps, size_t count){
+        matrixKernels().multiply(GetViewProjectionMatrix(), models, mvps, count);
     }
+
+    // 批量剔除：visible 里是和视锥相交的包围体下标（升序），返回可见数量
+    size_t CullAABBs(const AABBSoA& bounds, std::vector<uint32_t>& visible, CullPath path = CullPath::SIMD){
+        return cullAABBs(GetFrustum(), bounds, visible, path);
+    }
+
+    size_t CullSpheres(const SphereSoA& spheres, std::vector<uint32_t>& visible, CullPath path = CullPath::SIMD){
+        return cullSpheres(GetFrustum(), spheres, visible, path);
+    }
+
+    void SetAspectRatio(float width, float height){
+        if (width > 0.0f && height > 0.0f)
+            AspectRatio = width / height;
+    }
+
+    // 每帧调用一次：填充共享的相机 uniform block，所有程序通过绑定点读取
+    // 矩阵没变时只更新时间
+    void UpdateUniformBuffer(float time, float deltaTime){
+        if (ubo == 0) {
+            glGenBuffers(1, &ubo);
+            glState().bindBuffer(GL_UNIFORM_BUFFER, ubo);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlockData), nullptr, GL_DYNAMIC_DRAW);
+            glState().bindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, ubo);
+            matricesUploaded = false;
+        } else {
+            glState().bindBuffer(GL_UNIFORM_BUFFER, ubo);
+        }
+
+        GetViewProjectionMatrix();
+        CameraBlockData block;
+        block.time = glm::vec4(time, deltaTime, 0.0f, 0.0f);
+        if (matricesUploaded) {
+            glBufferSubData(GL_UNIFORM_BUFFER, offsetof(CameraBlockData, time), sizeof(block.time), &block.time);
+        } else {
+            block.view = view;
+            block.projection = projection;
+            block.viewProj = viewProj;
+            block.cameraPos = glm::vec4(Position, 1.0f);
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(block), &block);
+            matricesUploaded = true;
+        }
+    }
+
     // 输入
     void ProcessKeyboard(FpsCamera_Movement direction, float deltaTime){
         float velocity = MovementSpeed * deltaTime;
@@ -90,6 +195,20 @@ public:
     }
 
 private:
+    // 缓存的矩阵和计算它们时的参数
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::mat4 viewProj{1.0f};
+    Frustum frustum;
+    glm::vec3 cachedPosition{0.0f}, cachedFront{0.0f}, cachedUp{0.0f};
+    float cachedZoom = 0.0f, cachedAspect = 0.0f, cachedNear = 0.0f, cachedFar = 0.0f;
+    bool viewValid = false;
+    bool projectionValid = false;
+    bool viewProjValid = false;
+    bool frustumValid = false;
+    bool matricesUploaded = false;
+    GLuint ubo = 0;
+
     // 从相机的（更新的）欧拉角计算Front vector
     void updateCameraVectors(){
         // 计算新的Front vector
@@ -0,0 +1,64 @@
+#ifndef FRAME_ALLOCATOR_H
+#define FRAME_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// 每帧的线性分配器：构造时一次性申请一块内存，分配只是移动指针，帧末 reset() 整块作废
+// 用于渲染队列里的绘制包、uniform 数据这类只活一帧的小对象，录制期间不再碰堆
+// 不调用析构函数，只能放平凡可析构的类型；用完返回 nullptr，由调用方决定怎么报错
+class FrameAllocator {
+public:
+    explicit FrameAllocator(size_t capacity = 1 << 20)
+        : storage(new uint8_t[capacity + CACHE_LINE]), size(capacity) {
+        // 起点按缓存行对齐
+        base = storage.get() + (CACHE_LINE - reinterpret_cast<uintptr_t>(storage.get()) % CACHE_LINE) % CACHE_LINE;
+    }
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        size_t start = (offset + alignment - 1) & ~(alignment - 1);
+        if (start + bytes > size)
+            return nullptr;
+        offset = start + bytes;
+        if (offset > peak)
+            peak = offset;
+        return base + start;
+    }
+
+    // 未初始化的 T 数组（值初始化交给调用方）
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameAllocator never runs destructors");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameAllocator never runs destructors");
+        void* p = allocate(sizeof(T), alignof(T));
+        return p ? new (p) T{ std::forward<Args>(args)... } : nullptr;
+    }
+
+    void reset() { offset = 0; }
+
+    size_t used() const { return offset; }
+    size_t capacity() const { return size; }
+    size_t highWater() const { return peak; }  // 历史最高用量，用来调整容量
+
+private:
+    static const size_t CACHE_LINE = 64;
+
+    std::unique_ptr<uint8_t[]> storage;
+    uint8_t* base = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    size_t peak = 0;
+};
+
+#endif
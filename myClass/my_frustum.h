@@ -0,0 +1,267 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <glm/glm.hpp>
+
+#include "my_simd.h"
+
+// 视锥剔除（纯 CPU，不依赖 GL）
+//   - 平面从 projection * view 直接提取（Gribb/Hartmann），法线朝内并归一化
+//   - 包围体按 SoA 存放，SSE2 一次测 4 个、AVX2 一次测 8 个，结果写成紧凑的可见下标列表
+//   - CullPath::Scalar 是逐个测试的参考实现，运算顺序和 SIMD 完全相同，结果逐个一致
+//   - 只做保守测试：和某个平面完全在外侧才剔除，视锥角附近的少数包围体会被误判为可见
+struct Frustum {
+    // windows.h 把 NEAR / FAR 定义成了宏，这里加前缀
+    enum Plane { PLANE_LEFT, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR, PLANE_COUNT };
+    glm::vec4 planes[PLANE_COUNT]; // xyz = 法线，w = 距离，点 p 在内侧时 dot(xyz, p) + w >= 0
+
+    // m 是 projection * view（世界空间平面）或 projection * view * model（模型空间平面）
+    static Frustum fromMatrix(const glm::mat4& m) {
+        // glm 列主序：m[c][r]，第 r 行 = (m[0][r], m[1][r], m[2][r], m[3][r])
+        auto row = [&](int r) { return glm::vec4(m[0][r], m[1][r], m[2][r], m[3][r]); };
+        Frustum f;
+        f.planes[PLANE_LEFT]   = row(3) + row(0);
+        f.planes[PLANE_RIGHT]  = row(3) - row(0);
+        f.planes[PLANE_BOTTOM] = row(3) + row(1);
+        f.planes[PLANE_TOP]    = row(3) - row(1);
+        f.planes[PLANE_NEAR]   = row(3) + row(2);
+        f.planes[PLANE_FAR]    = row(3) - row(2);
+        for (glm::vec4& p : f.planes)
+            p /= glm::length(glm::vec3(p));
+        return f;
+    }
+
+    bool containsSphere(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& p : planes)
+            if (p.x * center.x + p.y * center.y + p.z * center.z + p.w + radius < 0.0f)
+                return false;
+        return true;
+    }
+
+    // 中心 + 半长表示的 AABB：离平面最近的角在外侧才算完全在外
+    bool intersectsAABB(const glm::vec3& center, const glm::vec3& extent) const {
+        for (const glm::vec4& p : planes) {
+            float d = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+            float r = std::fabs(p.x) * extent.x + std::fabs(p.y) * extent.y + std::fabs(p.z) * extent.z;
+            if (d + r < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
+
+// 一组 AABB 的 SoA 存储（中心 + 半长），每个分量一个连续数组，SIMD 一次读 4/8 个
+struct AABBSoA {
+    std::vector<float> cx, cy, cz, ex, ey, ez;
+
+    size_t size() const { return cx.size(); }
+    void clear() { cx.clear(); cy.clear(); cz.clear(); ex.clear(); ey.clear(); ez.clear(); }
+    void reserve(size_t n) { cx.reserve(n); cy.reserve(n); cz.reserve(n); ex.reserve(n); ey.reserve(n); ez.reserve(n); }
+
+    void push(const glm::vec3& center, const glm::vec3& extent) {
+        cx.push_back(center.x); cy.push_back(center.y); cz.push_back(center.z);
+        ex.push_back(extent.x); ey.push_back(extent.y); ez.push_back(extent.z);
+    }
+    void pushMinMax(const glm::vec3& min, const glm::vec3& max) {
+        push((min + max) * 0.5f, (max - min) * 0.5f);
+    }
+};
+
+// 一组包围球的 SoA 存储
+struct SphereSoA {
+    std::vector<float> x, y, z, r;
+
+    size_t size() const { return x.size(); }
+    void clear() { x.clear(); y.clear(); z.clear(); r.clear(); }
+    void reserve(size_t n) { x.reserve(n); y.reserve(n); z.reserve(n); r.reserve(n); }
+
+    void push(const glm::vec3& center, float radius) {
+        x.push_back(center.x); y.push_back(center.y); z.push_back(center.z); r.push_back(radius);
+    }
+};
+
+enum class CullPath { Scalar, SIMD };
+
+namespace cull_detail {
+
+// 按位掩码把可见的下标无分支地追加到 out：每个槽位都写，只在可见时前进
+inline size_t appendVisible(uint32_t* out, size_t count, uint32_t base, int mask, int lanes) {
+    for (int k = 0; k < lanes; ++k) {
+        out[count] = base + (uint32_t)k;
+        count += (size_t)((mask >> k) & 1);
+    }
+    return count;
+}
+
+inline size_t cullAABBsScalar(const Frustum& f, const AABBSoA& b, size_t first, size_t last, uint32_t* out, size_t count) {
+    for (size_t i = first; i < last; ++i) {
+        bool visible = true;
+        for (const glm::vec4& p : f.planes) {
+            float d = p.x * b.cx[i] + p.y * b.cy[i] + p.z * b.cz[i] + p.w;
+            float r = std::fabs(p.x) * b.ex[i] + std::fabs(p.y) * b.ey[i] + std::fabs(p.z) * b.ez[i];
+            visible = visible && (d + r >= 0.0f);
+        }
+        out[count] = (uint32_t)i;
+        count += visible ? 1 : 0;
+    }
+    return count;
+}
+
+inline size_t cullSpheresScalar(const Frustum& f, const SphereSoA& s, size_t first, size_t last, uint32_t* out, size_t count) {
+    for (size_t i = first; i < last; ++i) {
+        bool visible = true;
+        for (const glm::vec4& p : f.planes)
+            visible = visible && (p.x * s.x[i] + p.y * s.y[i] + p.z * s.z[i] + p.w + s.r[i] >= 0.0f);
+        out[count] = (uint32_t)i;
+        count += visible ? 1 : 0;
+    }
+    return count;
+}
+
+#if defined(MY_SIMD_AVX2)
+inline size_t cullAABBsSIMD(const Frustum& f, const AABBSoA& b, size_t n, uint32_t* out, size_t& done) {
+    __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 zero = _mm256_setzero_ps();
+    __m256 px[Frustum::PLANE_COUNT], py[Frustum::PLANE_COUNT], pz[Frustum::PLANE_COUNT], pw[Frustum::PLANE_COUNT];
+    __m256 ax[Frustum::PLANE_COUNT], ay[Frustum::PLANE_COUNT], az[Frustum::PLANE_COUNT];
+    for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+        px[k] = _mm256_set1_ps(f.planes[k].x);
+        py[k] = _mm256_set1_ps(f.planes[k].y);
+        pz[k] = _mm256_set1_ps(f.planes[k].z);
+        pw[k] = _mm256_set1_ps(f.planes[k].w);
+        ax[k] = _mm256_and_ps(px[k], absMask);
+        ay[k] = _mm256_and_ps(py[k], absMask);
+        az[k] = _mm256_and_ps(pz[k], absMask);
+    }
+    size_t count = 0, i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 cx = _mm256_loadu_ps(&b.cx[i]), cy = _mm256_loadu_ps(&b.cy[i]), cz = _mm256_loadu_ps(&b.cz[i]);
+        __m256 ex = _mm256_loadu_ps(&b.ex[i]), ey = _mm256_loadu_ps(&b.ey[i]), ez = _mm256_loadu_ps(&b.ez[i]);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[k], cx), _mm256_mul_ps(py[k], cy)),
+                                                   _mm256_mul_ps(pz[k], cz)), pw[k]);
+            __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax[k], ex), _mm256_mul_ps(ay[k], ey)), _mm256_mul_ps(az[k], ez));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(d, r), zero, _CMP_GE_OQ));
+        }
+        count = appendVisible(out, count, (uint32_t)i, _mm256_movemask_ps(inside), 8);
+    }
+    done = i;
+    return count;
+}
+
+inline size_t cullSpheresSIMD(const Frustum& f, const SphereSoA& s, size_t n, uint32_t* out, size_t& done) {
+    __m256 zero = _mm256_setzero_ps();
+    __m256 px[Frustum::PLANE_COUNT], py[Frustum::PLANE_COUNT], pz[Frustum::PLANE_COUNT], pw[Frustum::PLANE_COUNT];
+    for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+        px[k] = _mm256_set1_ps(f.planes[k].x);
+        py[k] = _mm256_set1_ps(f.planes[k].y);
+        pz[k] = _mm256_set1_ps(f.planes[k].z);
+        pw[k] = _mm256_set1_ps(f.planes[k].w);
+    }
+    size_t count = 0, i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 x = _mm256_loadu_ps(&s.x[i]), y = _mm256_loadu_ps(&s.y[i]), z = _mm256_loadu_ps(&s.z[i]);
+        __m256 r = _mm256_loadu_ps(&s.r[i]);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(px[k], x), _mm256_mul_ps(py[k], y)),
+                                                                 _mm256_mul_ps(pz[k], z)), pw[k]), r);
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, zero, _CMP_GE_OQ));
+        }
+        count = appendVisible(out, count, (uint32_t)i, _mm256_movemask_ps(inside), 8);
+    }
+    done = i;
+    return count;
+}
+#elif defined(MY_SIMD_SSE2)
+inline size_t cullAABBsSIMD(const Frustum& f, const AABBSoA& b, size_t n, uint32_t* out, size_t& done) {
+    __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 zero = _mm_setzero_ps();
+    __m128 px[Frustum::PLANE_COUNT], py[Frustum::PLANE_COUNT], pz[Frustum::PLANE_COUNT], pw[Frustum::PLANE_COUNT];
+    __m128 ax[Frustum::PLANE_COUNT], ay[Frustum::PLANE_COUNT], az[Frustum::PLANE_COUNT];
+    for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+        px[k] = _mm_set1_ps(f.planes[k].x);
+        py[k] = _mm_set1_ps(f.planes[k].y);
+        pz[k] = _mm_set1_ps(f.planes[k].z);
+        pw[k] = _mm_set1_ps(f.planes[k].w);
+        ax[k] = _mm_and_ps(px[k], absMask);
+        ay[k] = _mm_and_ps(py[k], absMask);
+        az[k] = _mm_and_ps(pz[k], absMask);
+    }
+    size_t count = 0, i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 cx = _mm_loadu_ps(&b.cx[i]), cy = _mm_loadu_ps(&b.cy[i]), cz = _mm_loadu_ps(&b.cz[i]);
+        __m128 ex = _mm_loadu_ps(&b.ex[i]), ey = _mm_loadu_ps(&b.ey[i]), ez = _mm_loadu_ps(&b.ez[i]);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px[k], cx), _mm_mul_ps(py[k], cy)), _mm_mul_ps(pz[k], cz)), pw[k]);
+            __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[k], ex), _mm_mul_ps(ay[k], ey)), _mm_mul_ps(az[k], ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, r), zero));
+        }
+        count = appendVisible(out, count, (uint32_t)i, _mm_movemask_ps(inside), 4);
+    }
+    done = i;
+    return count;
+}
+
+inline size_t cullSpheresSIMD(const Frustum& f, const SphereSoA& s, size_t n, uint32_t* out, size_t& done) {
+    __m128 zero = _mm_setzero_ps();
+    __m128 px[Frustum::PLANE_COUNT], py[Frustum::PLANE_COUNT], pz[Frustum::PLANE_COUNT], pw[Frustum::PLANE_COUNT];
+    for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+        px[k] = _mm_set1_ps(f.planes[k].x);
+        py[k] = _mm_set1_ps(f.planes[k].y);
+        pz[k] = _mm_set1_ps(f.planes[k].z);
+        pw[k] = _mm_set1_ps(f.planes[k].w);
+    }
+    size_t count = 0, i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 x = _mm_loadu_ps(&s.x[i]), y = _mm_loadu_ps(&s.y[i]), z = _mm_loadu_ps(&s.z[i]), r = _mm_loadu_ps(&s.r[i]);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int k = 0; k < Frustum::PLANE_COUNT; ++k) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px[k], x), _mm_mul_ps(py[k], y)),
+                                                        _mm_mul_ps(pz[k], z)), pw[k]), r);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+        }
+        count = appendVisible(out, count, (uint32_t)i, _mm_movemask_ps(inside), 4);
+    }
+    done = i;
+    return count;
+}
+#else
+inline size_t cullAABBsSIMD(const Frustum&, const AABBSoA&, size_t, uint32_t*, size_t& done) { done = 0; return 0; }
+inline size_t cullSpheresSIMD(const Frustum&, const SphereSoA&, size_t, uint32_t*, size_t& done) { done = 0; return 0; }
+#endif
+
+} // namespace cull_detail
+
+// 把和视锥相交的 AABB 下标按升序写进 visible（会被清空），返回可见数量
+inline size_t cullAABBs(const Frustum& frustum, const AABBSoA& bounds, std::vector<uint32_t>& visible,
+                        CullPath path = CullPath::SIMD) {
+    size_t n = bounds.size();
+    // 无分支追加总是先写再决定是否前进，写入位置不超过当前下标，n 个槽位足够
+    visible.resize(n);
+    size_t done = 0, count = 0;
+    if (path == CullPath::SIMD)
+        count = cull_detail::cullAABBsSIMD(frustum, bounds, n, visible.data(), done);
+    count = cull_detail::cullAABBsScalar(frustum, bounds, done, n, visible.data(), count);
+    visible.resize(count);
+    return count;
+}
+
+inline size_t cullSpheres(const Frustum& frustum, const SphereSoA& spheres, std::vector<uint32_t>& visible,
+                          CullPath path = CullPath::SIMD) {
+    size_t n = spheres.size();
+    visible.resize(n);
+    size_t done = 0, count = 0;
+    if (path == CullPath::SIMD)
+        count = cull_detail::cullSpheresSIMD(frustum, spheres, n, visible.data(), done);
+    count = cull_detail::cullSpheresScalar(frustum, spheres, done, n, visible.data(), count);
+    visible.resize(count);
+    return count;
+}
+
+#endif
@@ -0,0 +1,204 @@
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// glad 只生成了 gl=3.3 core 且没有任何扩展，
+// 这里手动补充用到的高版本/扩展枚举和函数指针，运行时按驱动能力加载
+
+// GL 4.1 / GL_ARB_get_program_binary
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+// GL_KHR_parallel_shader_compile / GL_ARB_parallel_shader_compile（枚举值相同）
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// 压缩纹理格式：S3TC(BC1/BC3) 只有扩展，BPTC(BC7) 是 GL 4.2，ETC2 是 GL 4.3 / GL_ARB_ES3_compatibility
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_SRGB8_ETC2
+#define GL_COMPRESSED_SRGB8_ETC2 0x9275
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC
+#define GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC 0x9279
+#endif
+
+// GL 4.4 / GL_ARB_buffer_storage：不可变存储 + 持久映射
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+#ifndef GL_CLIENT_STORAGE_BIT
+#define GL_CLIENT_STORAGE_BIT 0x0200
+#endif
+
+// GL 4.3：计算着色器、SSBO、间接绘制；GL 4.6 / GL_ARB_indirect_parameters：绘制数量也从缓冲里读
+#ifndef GL_COMPUTE_SHADER
+#define GL_COMPUTE_SHADER 0x91B9
+#endif
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_PARAMETER_BUFFER_ARB
+#define GL_PARAMETER_BUFFER_ARB 0x80EE
+#endif
+#ifndef GL_COMMAND_BARRIER_BIT
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#endif
+#ifndef GL_SHADER_STORAGE_BARRIER_BIT
+#define GL_SHADER_STORAGE_BARRIER_BIT 0x00002000
+#endif
+
+struct GLExtensions {
+    int major = 0;
+    int minor = 0;
+    std::vector<std::string> extensions; // 排好序，用于二分查找
+
+    // 程序二进制
+    bool programBinary = false;
+    void (APIENTRYP GetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary) = nullptr;
+    void (APIENTRYP ProgramBinary)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) = nullptr;
+    void (APIENTRYP ProgramParameteri)(GLuint program, GLenum pname, GLint value) = nullptr;
+
+    // 并行编译：查询 GL_COMPLETION_STATUS_KHR 不会阻塞
+    bool parallelShaderCompile = false;
+    void (APIENTRYP MaxShaderCompilerThreads)(GLuint count) = nullptr;
+
+    // 不可变缓冲存储，持久映射需要它
+    bool bufferStorage = false;
+    void (APIENTRYP BufferStorage)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) = nullptr;
+
+    // GPU 驱动渲染：计算着色器 + SSBO + 多重间接绘制（GL 4.3），可选的间接绘制数量（GL 4.6）
+    bool computeShader = false;
+    bool multiDrawIndirect = false;
+    bool indirectParameters = false;
+    void (APIENTRYP DispatchCompute)(GLuint x, GLuint y, GLuint z) = nullptr;
+    void (APIENTRYP Barrier)(GLbitfield barriers) = nullptr; // glMemoryBarrier（windows.h 把 MemoryBarrier 定义成了宏）
+    void (APIENTRYP MultiDrawElementsIndirect)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride) = nullptr;
+    void (APIENTRYP MultiDrawElementsIndirectCount)(GLenum mode, GLenum type, const void* indirect, GLintptr drawcount,
+                                                    GLsizei maxdrawcount, GLsizei stride) = nullptr;
+
+    // 压缩纹理（只是能力标志，上传用 3.3 core 自带的 glCompressedTexImage2D）
+    bool textureCompressionS3TC = false;
+    bool textureCompressionS3TCsRGB = false;
+    bool textureCompressionBPTC = false;
+    bool textureCompressionETC2 = false;
+
+    bool versionAtLeast(int maj, int min) const {
+        return major > maj || (major == maj && minor >= min);
+    }
+
+    bool hasExtension(const char* name) const {
+        return std::binary_search(extensions.begin(), extensions.end(), std::string(name));
+    }
+
+    // 必须在 gladLoadGLLoader 成功之后、上下文为当前时调用
+    void load(GLADloadproc loader) {
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        extensions.clear();
+        for (GLint i = 0; i < count; ++i)
+            extensions.emplace_back(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, (GLuint)i)));
+        std::sort(extensions.begin(), extensions.end());
+
+        if (versionAtLeast(4, 1) || hasExtension("GL_ARB_get_program_binary")) {
+            GetProgramBinary  = reinterpret_cast<decltype(GetProgramBinary)>(loader("glGetProgramBinary"));
+            ProgramBinary     = reinterpret_cast<decltype(ProgramBinary)>(loader("glProgramBinary"));
+            ProgramParameteri = reinterpret_cast<decltype(ProgramParameteri)>(loader("glProgramParameteri"));
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            programBinary = GetProgramBinary && ProgramBinary && ProgramParameteri && formats > 0;
+        }
+
+        if (hasExtension("GL_KHR_parallel_shader_compile"))
+            MaxShaderCompilerThreads = reinterpret_cast<decltype(MaxShaderCompilerThreads)>(loader("glMaxShaderCompilerThreadsKHR"));
+        else if (hasExtension("GL_ARB_parallel_shader_compile"))
+            MaxShaderCompilerThreads = reinterpret_cast<decltype(MaxShaderCompilerThreads)>(loader("glMaxShaderCompilerThreadsARB"));
+        parallelShaderCompile = MaxShaderCompilerThreads != nullptr;
+
+        if (versionAtLeast(4, 4) || hasExtension("GL_ARB_buffer_storage"))
+            BufferStorage = reinterpret_cast<decltype(BufferStorage)>(loader("glBufferStorage"));
+        bufferStorage = BufferStorage != nullptr;
+
+        // SSBO 没有单独的函数，只需要版本 / 扩展
+        if (versionAtLeast(4, 3) || (hasExtension("GL_ARB_compute_shader") && hasExtension("GL_ARB_shader_storage_buffer_object"))) {
+            DispatchCompute = reinterpret_cast<decltype(DispatchCompute)>(loader("glDispatchCompute"));
+            Barrier = reinterpret_cast<decltype(Barrier)>(loader("glMemoryBarrier"));
+            computeShader = DispatchCompute && Barrier;
+        }
+        if (versionAtLeast(4, 3) || hasExtension("GL_ARB_multi_draw_indirect")) {
+            MultiDrawElementsIndirect = reinterpret_cast<decltype(MultiDrawElementsIndirect)>(loader("glMultiDrawElementsIndirect"));
+            multiDrawIndirect = MultiDrawElementsIndirect != nullptr;
+        }
+        if (versionAtLeast(4, 6))
+            MultiDrawElementsIndirectCount = reinterpret_cast<decltype(MultiDrawElementsIndirectCount)>(loader("glMultiDrawElementsIndirectCount"));
+        else if (hasExtension("GL_ARB_indirect_parameters"))
+            MultiDrawElementsIndirectCount = reinterpret_cast<decltype(MultiDrawElementsIndirectCount)>(loader("glMultiDrawElementsIndirectCountARB"));
+        indirectParameters = MultiDrawElementsIndirectCount != nullptr;
+
+        textureCompressionS3TC = hasExtension("GL_EXT_texture_compression_s3tc");
+        textureCompressionS3TCsRGB = textureCompressionS3TC
+            && (hasExtension("GL_EXT_texture_sRGB") || hasExtension("GL_EXT_texture_compression_s3tc_srgb"));
+        textureCompressionBPTC = versionAtLeast(4, 2) || hasExtension("GL_ARB_texture_compression_bptc");
+        textureCompressionETC2 = versionAtLeast(4, 3) || hasExtension("GL_ARB_ES3_compatibility");
+    }
+};
+
+inline GLExtensions& glExt() {
+    static GLExtensions ext;
+    return ext;
+}
+
+inline void loadGLExtensions(GLADloadproc loader) {
+    glExt().load(loader);
+}
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+// GL 状态影子缓存：myClass 里所有的绑定/开关都走这里，和当前状态相同的调用直接跳过
+// 只能在拥有上下文的那个线程使用；外部代码直接调用 gl* 改了状态后要 invalidate()
+class GLStateCache {
+public:
+    struct Stats {
+        unsigned issued = 0;  // 真正发给驱动的调用
+        unsigned skipped = 0; // 冗余而被跳过的调用
+    };
+
+    static const unsigned MAX_TEXTURE_UNITS = 32;
+    static const unsigned MAX_BUFFER_BINDINGS = 16;
+
+    GLStateCache() { invalidate(); }
+
+    // 每帧开始时调用：保存上一帧的统计并清零
+    void beginFrame() {
+        lastFrame = current;
+        current = Stats{};
+    }
+    const Stats& frameStats() const { return current; }
+    const Stats& lastFrameStats() const { return lastFrame; }
+
+    // 把所有影子状态置为“未知”，下一次调用一定会发出
+    void invalidate() {
+        program = UNKNOWN;
+        vertexArray = UNKNOWN;
+        activeUnit = UNKNOWN;
+        for (GLuint& b : buffers) b = UNKNOWN;
+        for (IndexedBinding& b : uniformBindings) b = IndexedBinding{ UNKNOWN, 0, 0 };
+        for (auto& unit : textures)
+            for (GLuint& t : unit) t = UNKNOWN;
+        for (int& c : capabilities) c = -1;
+        depthFuncValue = UNKNOWN;
+        depthMaskValue = -1;
+        blendSrc = blendDst = UNKNOWN;
+        cullFaceValue = UNKNOWN;
+    }
+
+    // ---- 程序 / 顶点数组 ----
+    void useProgram(GLuint id) {
+        if (skip(program == id)) return;
+        glUseProgram(id);
+        program = id;
+    }
+
+    void bindVertexArray(GLuint id) {
+        if (skip(vertexArray == id)) return;
+        glBindVertexArray(id);
+        vertexArray = id;
+        // ELEMENT_ARRAY_BUFFER 是 VAO 状态的一部分，切换 VAO 后不再可知
+        buffers[ELEMENT_SLOT] = UNKNOWN;
+    }
+
+    // ---- 缓冲 ----
+    void bindBuffer(GLenum target, GLuint id) {
+        int slot = bufferSlot(target);
+        if (slot < 0) {
+            ++current.issued;
+            glBindBuffer(target, id);
+            return;
+        }
+        if (skip(buffers[slot] == id)) return;
+        glBindBuffer(target, id);
+        buffers[slot] = id;
+    }
+
+    void bindBufferBase(GLenum target, GLuint index, GLuint id) {
+        bindBufferRange(target, index, id, 0, 0);
+    }
+
+    // size == 0 表示整个缓冲（glBindBufferBase）
+    void bindBufferRange(GLenum target, GLuint index, GLuint id, GLintptr offset, GLsizeiptr size) {
+        IndexedBinding* binding = indexedBinding(target, index);
+        if (binding && skip(binding->buffer == id && binding->offset == offset && binding->size == size))
+            return;
+        if (!binding)
+            ++current.issued;
+        if (size == 0)
+            glBindBufferBase(target, index, id);
+        else
+            glBindBufferRange(target, index, id, offset, size);
+        if (binding)
+            *binding = IndexedBinding{ id, offset, size };
+        // 索引绑定同时会修改通用绑定点
+        int slot = bufferSlot(target);
+        if (slot >= 0)
+            buffers[slot] = id;
+    }
+
+    // ---- 纹理 ----
+    void activeTexture(GLuint unit) {
+        if (skip(activeUnit == unit)) return;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        activeUnit = unit;
+    }
+
+    // 绑定到当前激活的纹理单元
+    void bindTexture(GLenum target, GLuint id) {
+        int slot = textureSlot(target);
+        if (slot < 0 || activeUnit == UNKNOWN || activeUnit >= MAX_TEXTURE_UNITS) {
+            ++current.issued;
+            glBindTexture(target, id);
+            return;
+        }
+        if (skip(textures[activeUnit][slot] == id)) return;
+        glBindTexture(target, id);
+        textures[activeUnit][slot] = id;
+    }
+
+    // 把纹理绑定到指定单元；已经绑定时连 glActiveTexture 也省掉
+    void bindTextureUnit(GLuint unit, GLenum target, GLuint id) {
+        int slot = textureSlot(target);
+        if (slot >= 0 && unit < MAX_TEXTURE_UNITS && textures[unit][slot] == id) {
+            ++current.skipped;
+            return;
+        }
+        activeTexture(unit);
+        bindTexture(target, id);
+    }
+
+    // ---- 开关和固定功能状态 ----
+    void enable(GLenum cap) { setCapability(cap, true); }
+    void disable(GLenum cap) { setCapability(cap, false); }
+
+    void setCapability(GLenum cap, bool on) {
+        int slot = capabilitySlot(cap);
+        if (slot >= 0 && skip(capabilities[slot] == (on ? 1 : 0))) return;
+        if (slot < 0) ++current.issued;
+        if (on) glEnable(cap); else glDisable(cap);
+        if (slot >= 0) capabilities[slot] = on ? 1 : 0;
+    }
+
+    void depthFunc(GLenum func) {
+        if (skip(depthFuncValue == func)) return;
+        glDepthFunc(func);
+        depthFuncValue = func;
+    }
+
+    void depthMask(GLboolean flag) {
+        if (skip(depthMaskValue == (flag ? 1 : 0))) return;
+        glDepthMask(flag);
+        depthMaskValue = flag ? 1 : 0;
+    }
+
+    void blendFunc(GLenum src, GLenum dst) {
+        if (skip(blendSrc == src && blendDst == dst)) return;
+        glBlendFunc(src, dst);
+        blendSrc = src;
+        blendDst = dst;
+    }
+
+    void cullFace(GLenum mode) {
+        if (skip(cullFaceValue == mode)) return;
+        glCullFace(mode);
+        cullFaceValue = mode;
+    }
+
+    // ---- 对象删除前调用：GL 会把已删除对象从当前上下文的绑定点解绑 ----
+    void forgetProgram(GLuint id) {
+        if (program == id) program = UNKNOWN;
+    }
+    void forgetVertexArray(GLuint id) {
+        if (vertexArray == id) vertexArray = 0;
+    }
+    void forgetBuffer(GLuint id) {
+        for (GLuint& b : buffers)
+            if (b == id) b = 0;
+        for (IndexedBinding& b : uniformBindings)
+            if (b.buffer == id) b = IndexedBinding{ 0, 0, 0 };
+        // 可能挂在 VAO 上作为索引缓冲
+        buffers[ELEMENT_SLOT] = UNKNOWN;
+    }
+    void forgetTexture(GLuint id) {
+        for (auto& unit : textures)
+            for (GLuint& t : unit)
+                if (t == id) t = 0;
+    }
+
+private:
+    static const GLuint UNKNOWN = 0xFFFFFFFFu;
+    static const int BUFFER_SLOTS = 6;
+    static const int ELEMENT_SLOT = 1;
+    static const int TEXTURE_SLOTS = 3;
+    static const int CAPABILITY_SLOTS = 4;
+
+    struct IndexedBinding {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+
+    GLuint program;
+    GLuint vertexArray;
+    GLuint activeUnit;
+    GLuint buffers[BUFFER_SLOTS];
+    IndexedBinding uniformBindings[MAX_BUFFER_BINDINGS];
+    GLuint textures[MAX_TEXTURE_UNITS][TEXTURE_SLOTS];
+    int capabilities[CAPABILITY_SLOTS];
+    GLenum depthFuncValue;
+    int depthMaskValue;
+    GLenum blendSrc, blendDst;
+    GLenum cullFaceValue;
+
+    Stats current;
+    Stats lastFrame;
+
+    // 统计并返回是否可以跳过
+    bool skip(bool redundant) {
+        if (redundant) ++current.skipped;
+        else ++current.issued;
+        return redundant;
+    }
+
+    static int bufferSlot(GLenum target) {
+        switch (target) {
+        case GL_ARRAY_BUFFER:         return 0;
+        case GL_ELEMENT_ARRAY_BUFFER: return ELEMENT_SLOT;
+        case GL_UNIFORM_BUFFER:       return 2;
+        case GL_PIXEL_UNPACK_BUFFER:  return 3;
+        case GL_COPY_READ_BUFFER:     return 4;
+        case GL_COPY_WRITE_BUFFER:    return 5;
+        default:                      return -1;
+        }
+    }
+
+    IndexedBinding* indexedBinding(GLenum target, GLuint index) {
+        if (target == GL_UNIFORM_BUFFER && index < MAX_BUFFER_BINDINGS)
+            return &uniformBindings[index];
+        return nullptr;
+    }
+
+    static int textureSlot(GLenum target) {
+        switch (target) {
+        case GL_TEXTURE_2D:       return 0;
+        case GL_TEXTURE_2D_ARRAY: return 1;
+        case GL_TEXTURE_CUBE_MAP: return 2;
+        default:                  return -1;
+        }
+    }
+
+    static int capabilitySlot(GLenum cap) {
+        switch (cap) {
+        case GL_DEPTH_TEST:   return 0;
+        case GL_BLEND:        return 1;
+        case GL_CULL_FACE:    return 2;
+        case GL_SCISSOR_TEST: return 3;
+        default:              return -1;
+        }
+    }
+};
+
+inline GLStateCache& glState() {
+    static GLStateCache state;
+    return state;
+}
+
+#endif
@@ -0,0 +1,353 @@
+#ifndef GPU_DRIVEN_H
+#define GPU_DRIVEN_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "my_glExtensions.h"
+#include "my_glState.h"
+#include "my_shader.h"
+#include "my_frustum.h"
+
+// GPU 驱动渲染的物体，与 shader/gpuObjects.glsl 一一对应（std430）
+struct GpuObject {
+    glm::mat4 model;
+    glm::vec4 color;
+    glm::vec4 center;  // xyz = 世界空间 AABB 中心
+    glm::vec4 extent;  // xyz = 世界空间 AABB 半长
+    uint32_t mesh = 0; // 在网格表里的下标
+    uint32_t pad[3] = {};
+};
+static_assert(sizeof(GpuObject) == 128, "GpuObject must match std430 layout");
+
+// 共享顶点 / 索引缓冲里的一段网格
+struct GpuMesh {
+    GLuint indexCount = 0;
+    GLuint firstIndex = 0;
+    GLint baseVertex = 0;
+    GLuint pad = 0;
+};
+
+// 和 GL 规定的间接绘制命令布局一致
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// 编译只有计算阶段的程序，失败时返回 0（错误已打印）
+inline GLuint compileComputeProgram(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "ERROR::SHADER::COMPUTE_FILE_NOT_READ: " << path << std::endl;
+        return 0;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    std::string code = Shader::resolveIncludes(stream.str(), std::filesystem::path(path).parent_path());
+    const char* source = code.c_str();
+
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    bool compiled = Shader::checkCompileErrors(shader, "COMPUTE");
+    GLuint program = glCreateProgram();
+    glAttachShader(program, shader);
+    glLinkProgram(program);
+    glDeleteShader(shader);
+    if (!compiled || !Shader::checkCompileErrors(program, "PROGRAM")) {
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// GPU 驱动渲染：物体的变换和包围盒放在 SSBO 里，计算着色器做视锥剔除并直接写间接绘制命令，
+// 整帧只有一次 dispatch 和一次 glMultiDrawElementsIndirect(Count)，CPU 开销和物体数量无关
+// 需要 GL 4.3（计算着色器 + SSBO + 多重间接绘制），用之前先检查 supported()，不支持时走 CPU 路径
+// 顶点着色器用 shader/gpuDriven.vert：每实例属性 OBJECT_INDEX_LOCATION 存 0..N-1，
+// 命令的 baseInstance = 物体下标，于是这个属性正好取到物体下标，不需要 gl_BaseInstance（GL 4.6）
+// CPU 侧另有剔除结果（例如遮挡剔除）时用 setVisibility 传一张按物体下标的位图，没置位的物体 GPU 上也不画
+class GpuDrivenRenderer {
+public:
+    static const GLuint OBJECT_INDEX_LOCATION = 1;
+
+    // SSBO 绑定点，和 shader/cull.comp、gpuObjects.glsl 里的 binding 对应
+    static const GLuint OBJECT_BINDING = 0;
+    static const GLuint MESH_BINDING = 1;
+    static const GLuint COMMAND_BINDING = 2;
+    static const GLuint COUNT_BINDING = 3;
+    static const GLuint VISIBILITY_BINDING = 4;
+
+    struct Stats {
+        double cullUs = 0.0;  // 上一次 draw 里 CPU 花在剔除 + 绘制调用上的时间（不含 GPU）
+        bool compacted = false;
+    };
+
+    static bool supported() {
+        return glExt().computeShader && glExt().multiDrawIndirect;
+    }
+
+    // 检查每个物体的网格下标，越界时报出第一个出错的物体
+    static bool validateObjects(const GpuObject* objects, size_t count, size_t meshCount) {
+        for (size_t i = 0; i < count; ++i)
+            if (objects[i].mesh >= meshCount) {
+                std::cerr << "ERROR::GPU_DRIVEN::MESH_OUT_OF_RANGE: object " << i << std::endl;
+                return false;
+            }
+        return true;
+    }
+
+    // 物体下标列表 -> 每个物体一位的位图（setVisibility 的格式），列表里超出 count 的下标忽略
+    static void buildVisibilityMask(const std::vector<uint32_t>& visibleIndices, size_t count, std::vector<uint32_t>& mask) {
+        mask.assign((count + 31) / 32, 0u);
+        for (uint32_t index : visibleIndices)
+            if (index < count)
+                mask[index / 32] |= 1u << (index % 32);
+    }
+
+    // shader/cull.comp 的 CPU 参考实现：同样的可见性测试、同样的命令布局，返回 drawCount
+    // commands 至少要有 count 条；compact 时可见的命令按物体下标顺序排在前面，
+    // GPU 上是原子加的先后顺序，只有集合相同，比较时用 sameCommands
+    // visibilityMask 非空时和 setVisibility 一样，还要求物体在位图里置位
+    static GLuint buildCommands(const Frustum& frustum, const GpuObject* objects, size_t count, const GpuMesh* meshes,
+                                bool compact, DrawElementsIndirectCommand* commands, const uint32_t* visibilityMask = nullptr) {
+        GLuint drawCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            bool visible = frustum.intersectsAABB(glm::vec3(objects[i].center), glm::vec3(objects[i].extent));
+            if (visibilityMask && ((visibilityMask[i / 32] >> (i % 32)) & 1u) == 0)
+                visible = false;
+            const GpuMesh& mesh = meshes[objects[i].mesh];
+            DrawElementsIndirectCommand command = { mesh.indexCount, visible ? 1u : 0u, mesh.firstIndex, mesh.baseVertex, (GLuint)i };
+            if (compact) {
+                if (visible)
+                    commands[drawCount++] = command;
+            } else {
+                commands[i] = command;
+                drawCount += visible ? 1 : 0;
+            }
+        }
+        return drawCount;
+    }
+
+    // 比较两份命令缓冲的前 drawCount 条（compact）或全部 count 条；compact 时先按 baseInstance 排序
+    static bool sameCommands(std::vector<DrawElementsIndirectCommand> a, std::vector<DrawElementsIndirectCommand> b,
+                             size_t count, GLuint drawCount, bool compact) {
+        size_t n = compact ? drawCount : count;
+        if (a.size() < n || b.size() < n)
+            return false;
+        auto byInstance = [](const DrawElementsIndirectCommand& x, const DrawElementsIndirectCommand& y) {
+            return x.baseInstance < y.baseInstance;
+        };
+        if (compact) {
+            std::sort(a.begin(), a.begin() + n, byInstance);
+            std::sort(b.begin(), b.begin() + n, byInstance);
+        }
+        return std::memcmp(a.data(), b.data(), n * sizeof(DrawElementsIndirectCommand)) == 0;
+    }
+
+    // vertexBuffer：紧密排列的 vec3 位置；indexBuffer：GL_UNSIGNED_INT 索引；meshes：其中的各段
+    GpuDrivenRenderer(GLuint vertexBuffer, GLuint indexBuffer, const std::vector<GpuMesh>& meshes,
+                      const char* cullShaderPath = "shader\\cull.comp")
+        : meshCount((GLuint)meshes.size()), compact(glExt().indirectParameters) {
+        GLuint program = compileComputeProgram(cullShaderPath);
+        if (program != 0) {
+            cullShader.reset(new Shader(program));
+            planesUniform = cullShader->uniform("planes"_uniform);
+            objectCountUniform = cullShader->uniform("objectCount"_uniform);
+            compactUniform = cullShader->uniform("compact"_uniform);
+            useVisibilityUniform = cullShader->uniform("useVisibility"_uniform);
+        }
+
+        glGenVertexArrays(1, &vao);
+        glState().bindVertexArray(vao);
+        glState().bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+        glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+        GLuint buffers[6];
+        glGenBuffers(6, buffers);
+        objectBuffer = buffers[0];
+        meshBuffer = buffers[1];
+        commandBuffer = buffers[2];
+        countBuffer = buffers[3];
+        objectIndexBuffer = buffers[4];
+        visibilityBuffer = buffers[5];
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, meshBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, meshes.size() * sizeof(GpuMesh), meshes.data(), GL_STATIC_DRAW);
+        GLuint zero = 0;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GLuint), &zero, GL_DYNAMIC_DRAW);
+        // 没有调用 setVisibility 时着色器不读它，但 SSBO 绑定点上不能是空缓冲
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibilityBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GLuint), &zero, GL_DYNAMIC_DRAW);
+    }
+
+    GpuDrivenRenderer(const GpuDrivenRenderer&) = delete;
+    GpuDrivenRenderer& operator=(const GpuDrivenRenderer&) = delete;
+
+    bool valid() const { return cullShader != nullptr; }
+
+    // 上传全部物体（数量变化时重新分配缓冲）；只改变换时用 updateObjects
+    void setObjects(const GpuObject* objects, size_t count) {
+        if (!validateObjects(objects, count, meshCount))
+            return;
+        bool resized = count != objectCount;
+        objectCount = (GLuint)count;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, objectBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, count * sizeof(GpuObject), objects, GL_DYNAMIC_DRAW);
+        if (!resized)
+            return;
+        // 物体数量变了，旧位图的下标已经对不上
+        useVisibility = false;
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, count * sizeof(DrawElementsIndirectCommand), nullptr, GL_DYNAMIC_DRAW);
+
+        std::vector<GLuint> indices(count);
+        for (size_t i = 0; i < count; ++i)
+            indices[i] = (GLuint)i;
+        glState().bindVertexArray(vao);
+        glState().bindBuffer(GL_ARRAY_BUFFER, objectIndexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, count * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        glVertexAttribIPointer(OBJECT_INDEX_LOCATION, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+        glEnableVertexAttribArray(OBJECT_INDEX_LOCATION);
+        glVertexAttribDivisor(OBJECT_INDEX_LOCATION, 1);
+    }
+
+    void setObjects(const std::vector<GpuObject>& objects) { setObjects(objects.data(), objects.size()); }
+
+    void updateObjects(size_t first, const GpuObject* objects, size_t count) {
+        if (first + count > objectCount)
+            return;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, objectBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, first * sizeof(GpuObject), count * sizeof(GpuObject), objects);
+    }
+
+    // 每帧可以换一张位图（buildVisibilityMask 生成，至少覆盖全部物体）；之后的 draw 只画置位的物体
+    void setVisibility(const std::vector<uint32_t>& mask) {
+        if (mask.size() * 32 < objectCount) {
+            std::cerr << "ERROR::GPU_DRIVEN::VISIBILITY_MASK_TOO_SHORT: " << mask.size() * 32 << " < " << objectCount << std::endl;
+            return;
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, visibilityBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, mask.size() * sizeof(uint32_t), mask.data(), GL_STREAM_DRAW);
+        useVisibility = true;
+    }
+
+    void clearVisibility() { useVisibility = false; }
+
+    // 剔除 + 绘制：drawShader 用 gpuDriven.vert，调用前设置好它的其它 uniform
+    void draw(const Frustum& frustum, const Shader& drawShader) {
+        if (!valid() || objectCount == 0)
+            return;
+        auto start = std::chrono::steady_clock::now();
+
+        GLuint zero = 0;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), &zero);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OBJECT_BINDING, objectBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MESH_BINDING, meshBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BINDING, commandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COUNT_BINDING, countBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBILITY_BINDING, visibilityBuffer);
+
+        cullShader->use();
+        glUniform4fv(planesUniform.location, Frustum::PLANE_COUNT, &frustum.planes[0].x);
+        glUniform1ui(objectCountUniform.location, objectCount);
+        glUniform1i(compactUniform.location, compact ? 1 : 0);
+        glUniform1i(useVisibilityUniform.location, useVisibility ? 1 : 0);
+        glExt().DispatchCompute((objectCount + 63) / 64, 1, 1);
+        // 命令和数量要作为间接参数读取，顶点着色器还要读物体 SSBO
+        glExt().Barrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+        drawShader.use();
+        glState().bindVertexArray(vao);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+        if (compact) {
+            glBindBuffer(GL_PARAMETER_BUFFER_ARB, countBuffer);
+            glExt().MultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0, (GLsizei)objectCount, 0);
+            // 用完就解绑：Mesa 会把还绑着的参数缓冲带进之后普通的间接绘制，只画出一部分
+            glBindBuffer(GL_PARAMETER_BUFFER_ARB, 0);
+        } else {
+            glExt().MultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei)objectCount, 0);
+        }
+
+        last.compacted = compact;
+        last.cullUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 读回上一帧的可见数量：会等 GPU 做完，只用于调试和基准
+    GLuint readVisibleCount() const {
+        GLuint visible = 0;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, countBuffer);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(GLuint), &visible);
+        return visible;
+    }
+
+    // 读回上一帧 cull.comp 写出的命令（每个物体一条的容量），同样只用于调试和核对
+    void readCommands(std::vector<DrawElementsIndirectCommand>& commands) const {
+        commands.resize(objectCount);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, commandBuffer);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, objectCount * sizeof(DrawElementsIndirectCommand), commands.data());
+    }
+
+    // 关闭 / 打开命令压缩（只有支持 GL_ARB_indirect_parameters 时才能打开）
+    void setCompaction(bool enabled) { compact = enabled && glExt().indirectParameters; }
+
+    size_t size() const { return objectCount; }
+    const Stats& stats() const { return last; }
+
+    // 和 main 里的其它 GL 对象一样在上下文销毁前显式释放
+    void release() {
+        if (vao != 0) {
+            glState().forgetVertexArray(vao);
+            glDeleteVertexArrays(1, &vao);
+            vao = 0;
+        }
+        GLuint buffers[6] = { objectBuffer, meshBuffer, commandBuffer, countBuffer, objectIndexBuffer, visibilityBuffer };
+        for (GLuint b : buffers)
+            glState().forgetBuffer(b);
+        glDeleteBuffers(6, buffers);
+        objectBuffer = meshBuffer = commandBuffer = countBuffer = objectIndexBuffer = visibilityBuffer = 0;
+        if (cullShader) {
+            glState().forgetProgram(cullShader->ID);
+            glDeleteProgram(cullShader->ID);
+            cullShader.reset();
+        }
+    }
+
+private:
+    std::unique_ptr<Shader> cullShader;
+    Uniform planesUniform, objectCountUniform, compactUniform, useVisibilityUniform;
+
+    GLuint vao = 0;
+    GLuint objectBuffer = 0;
+    GLuint meshBuffer = 0;
+    GLuint commandBuffer = 0;
+    GLuint countBuffer = 0;
+    GLuint objectIndexBuffer = 0;
+    GLuint visibilityBuffer = 0;
+    GLuint objectCount = 0;
+    GLuint meshCount = 0;
+    bool compact = false;
+    bool useVisibility = false;
+    Stats last;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef IMAGE_UTILS_H
+#define IMAGE_UTILS_H
+
+#include <stb/stb_image.h>
+#include <string>
+#include <cstring>
+#include <cstddef>
+
+#include "my_simd.h"
+
+// 解码后的图片，拥有 stbi_load 分配的像素（只能移动）
+// 解码从不使用 stbi_set_flip_vertically_on_load 这个进程全局标志，
+// 翻转在解码后按调用单独处理，所以可以在多个线程里同时解码
+struct Image {
+    unsigned char* pixels = nullptr;
+    int width = 0, height = 0, channels = 0;
+
+    Image() = default;
+    ~Image() { stbi_image_free(pixels); }
+
+    Image(const Image&) = delete;
+    Image& operator=(const Image&) = delete;
+    Image(Image&& other) noexcept
+        : pixels(other.pixels), width(other.width), height(other.height), channels(other.channels) {
+        other.pixels = nullptr;
+    }
+    Image& operator=(Image&& other) noexcept {
+        if (this != &other) {
+            stbi_image_free(pixels);
+            pixels = other.pixels;
+            width = other.width;
+            height = other.height;
+            channels = other.channels;
+            other.pixels = nullptr;
+        }
+        return *this;
+    }
+
+    explicit operator bool() const { return pixels != nullptr; }
+    size_t bytes() const { return (size_t)width * height * channels; }
+};
+
+// 解码但不翻转；desiredChannels 为 0 时保持原有通道数
+inline Image decodeImage(const std::string& path, int desiredChannels = 0) {
+    Image image;
+    image.pixels = stbi_load(path.c_str(), &image.width, &image.height, &image.channels, desiredChannels);
+    if (desiredChannels != 0)
+        image.channels = desiredChannels;
+    return image;
+}
+
+// 从内存（例如源文件的映射）解码，同样不翻转
+inline Image decodeImage(const unsigned char* data, size_t size, int desiredChannels = 0) {
+    Image image;
+    image.pixels = stbi_load_from_memory(data, (int)size, &image.width, &image.height, &image.channels, desiredChannels);
+    if (desiredChannels != 0)
+        image.channels = desiredChannels;
+    return image;
+}
+
+namespace image_detail {
+
+// 交换两行，不需要临时行缓冲
+inline void swapRows(unsigned char* a, unsigned char* b, size_t bytes) {
+    size_t i = 0;
+#if defined(MY_SIMD_AVX2)
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(a + i), vb);
+        _mm256_storeu_si256((__m256i*)(b + i), va);
+    }
+#endif
+#if defined(MY_SIMD_SSE2)
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(a + i), vb);
+        _mm_storeu_si128((__m128i*)(b + i), va);
+    }
+#endif
+    for (; i < bytes; ++i) {
+        unsigned char t = a[i];
+        a[i] = b[i];
+        b[i] = t;
+    }
+}
+
+#if defined(MY_SIMD_X86)
+// SSSE3 的 pshufb 一次扩 4 个像素（编译时开了 AVX2 再加一条 8 像素的路径），返回处理到的像素数
+// 每次读 16 字节、用 12 字节（4 个像素），保证不读越界：x*3 + 16 <= width*3
+MY_SIMD_TARGET_SSSE3 inline int expandRowRGBtoRGBASSSE3(const unsigned char* src, unsigned char* dst, int width) {
+    int x = 0;
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+#if defined(MY_SIMD_AVX2)
+    const __m256i shuffle256 = _mm256_broadcastsi128_si256(shuffle);
+    const __m256i alpha256 = _mm256_set1_epi32((int)0xFF000000);
+    for (; x + 10 <= width; x += 8) {
+        __m128i lo = _mm_loadu_si128((const __m128i*)(src + x * 3));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(src + x * 3 + 12));
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        v = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle256), alpha256);
+        _mm256_storeu_si256((__m256i*)(dst + x * 4), v);
+    }
+#endif
+    for (; x + 6 <= width; x += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + x * 3));
+        v = _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha);
+        _mm_storeu_si128((__m128i*)(dst + x * 4), v);
+    }
+    return x;
+}
+#endif
+
+// 一行 RGB -> RGBA，alpha 填 255；CPU 支持 SSSE3 时先走向量路径，剩下的像素逐个处理
+inline void expandRowRGBtoRGBA(const unsigned char* src, unsigned char* dst, int width) {
+    int x = 0;
+#if defined(MY_SIMD_X86)
+    if (simdHasSSSE3())
+        x = expandRowRGBtoRGBASSSE3(src, dst, width);
+#endif
+    for (; x < width; ++x) {
+        dst[x * 4 + 0] = src[x * 3 + 0];
+        dst[x * 4 + 1] = src[x * 3 + 1];
+        dst[x * 4 + 2] = src[x * 3 + 2];
+        dst[x * 4 + 3] = 255;
+    }
+}
+
+} // namespace image_detail
+
+// 原地上下翻转（OpenGL 纹理原点在左下角）
+inline void flipRowsInPlace(unsigned char* pixels, int width, int height, int channels) {
+    size_t stride = (size_t)width * channels;
+    for (int y = 0; y < height / 2; ++y)
+        image_detail::swapRows(pixels + y * stride, pixels + (size_t)(height - 1 - y) * stride, stride);
+}
+
+// 目标通道数：3 通道扩成 4 通道（上传时不用管 GL_UNPACK_ALIGNMENT，驱动也不用再转换），其余不变
+inline int uploadChannels(int channels) {
+    return channels == 3 ? 4 : channels;
+}
+
+// 把解码结果写进调用者提供的缓冲（例如映射好的 PBO），同时完成翻转和 RGB->RGBA 扩展，不额外分配内存
+// dst 至少要 width * height * uploadChannels(channels) 字节
+inline void convertForUpload(const Image& image, unsigned char* dst, bool flip) {
+    int dstChannels = uploadChannels(image.channels);
+    size_t srcStride = (size_t)image.width * image.channels;
+    size_t dstStride = (size_t)image.width * dstChannels;
+    for (int y = 0; y < image.height; ++y) {
+        const unsigned char* srcRow = image.pixels + y * srcStride;
+        unsigned char* dstRow = dst + (size_t)(flip ? image.height - 1 - y : y) * dstStride;
+        if (dstChannels == image.channels)
+            std::memcpy(dstRow, srcRow, srcStride);
+        else
+            image_detail::expandRowRGBtoRGBA(srcRow, dstRow, image.width);
+    }
+}
+
+#endif
@@ -0,0 +1,243 @@
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+
+#include "my_glState.h"
+#include "my_streamBuffer.h"
+
+// 每个实例的数据，和 shader/cube.vert 里的 aModel / aColor 对应
+struct InstanceData {
+    glm::mat4 model;
+    glm::vec4 color;
+};
+
+// 实例属性占用的顶点属性位置（mat4 占 4 个连续位置）
+const GLuint INSTANCE_MODEL_LOCATION = 1;
+const GLuint INSTANCE_COLOR_LOCATION = 5;
+
+// 一段连续的槽位
+struct SlotRange {
+    uint32_t first;
+    uint32_t count;
+};
+
+// 把升序、不重复的槽位列表合并成连续区间；两段之间只空出不超过 maxGap 个槽位时并成一段
+// （顺带多传几个没变的实例，换更少的上传调用）
+inline void coalesceSlots(const std::vector<uint32_t>& slots, uint32_t maxGap, std::vector<SlotRange>& ranges) {
+    ranges.clear();
+    for (uint32_t slot : slots) {
+        if (!ranges.empty() && slot - (ranges.back().first + ranges.back().count) <= maxGap)
+            ranges.back().count = slot - ranges.back().first + 1;
+        else
+            ranges.push_back({ slot, 1 });
+    }
+}
+
+// 常驻显存的实例缓冲：槽位 i 放第 i 个实例，每帧只把变化的槽位按区间 glBufferSubData 上去
+// 配合 TransformGraph::changed() 使用，静止的场景一帧什么都不用传
+class ResidentInstanceBuffer {
+public:
+    struct Stats {
+        unsigned ranges = 0; // 这一帧的上传调用次数
+        size_t bytes = 0;
+    };
+
+    // 80 字节一个实例，空出 16 个以内就合并
+    static constexpr uint32_t MERGE_GAP = 16;
+
+    GLuint buffer = 0;
+
+    // 一共 count 个实例；full 为真（比如层级重排过）或容量不够时整块重传，否则只传 changedSlots
+    // instanceAt(slot) 返回槽位 slot 的 InstanceData
+    template <typename F>
+    void update(size_t count, const std::vector<uint32_t>& changedSlots, bool full, F&& instanceAt) {
+        frameStats = Stats();
+        if (buffer == 0) {
+            glGenBuffers(1, &buffer);
+            full = true;
+        }
+        glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+        if (full || count > capacity) {
+            // 整块重传前先孤立旧存储，不等上一帧还在用的缓冲
+            capacity = std::max(count, capacity);
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(capacity * sizeof(InstanceData)), nullptr, GL_DYNAMIC_DRAW);
+            staging.resize(count);
+            for (size_t s = 0; s < count; ++s)
+                staging[s] = instanceAt((uint32_t)s);
+            if (count > 0) {
+                glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(count * sizeof(InstanceData)), staging.data());
+                frameStats.ranges = 1;
+                frameStats.bytes = count * sizeof(InstanceData);
+            }
+        } else {
+            coalesceSlots(changedSlots, MERGE_GAP, ranges);
+            for (const SlotRange& range : ranges) {
+                staging.resize(range.count);
+                for (uint32_t k = 0; k < range.count; ++k)
+                    staging[k] = instanceAt(range.first + k);
+                glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(range.first * sizeof(InstanceData)),
+                                (GLsizeiptr)(range.count * sizeof(InstanceData)), staging.data());
+                frameStats.bytes += range.count * sizeof(InstanceData);
+            }
+            frameStats.ranges = (unsigned)ranges.size();
+        }
+        instances = count;
+    }
+
+    size_t size() const { return instances; }
+    const Stats& stats() const { return frameStats; }
+
+    // 和 main 里的 VAO/VBO 一样在上下文销毁前显式释放
+    void release() {
+        if (buffer != 0) {
+            glState().forgetBuffer(buffer);
+            glDeleteBuffers(1, &buffer);
+            buffer = 0;
+        }
+        capacity = 0;
+        instances = 0;
+    }
+
+private:
+    size_t capacity = 0;
+    size_t instances = 0;
+    std::vector<InstanceData> staging;
+    std::vector<SlotRange> ranges;
+    Stats frameStats;
+};
+
+// 把一个已有的 VAO 变成实例化绘制：在上面挂一个每实例缓冲，
+// 一次 glDrawArraysInstanced 画一批，代替每个物体一次 setMat4 + glDrawArrays
+// VAO 上绑了索引缓冲时传入 indexType（GL_UNSIGNED_INT 等），vertexCount 就是索引数，改用 glDrawElementsInstanced
+class InstancedMesh {
+public:
+    GLuint instanceVBO = 0;
+
+    InstancedMesh(GLuint vao, GLsizei vertexCount, GLsizei maxBatch = 16384, GLenum mode = GL_TRIANGLES,
+                  GLenum indexType = 0)
+        : vao(vao), vertexCount(vertexCount), maxBatch(maxBatch), mode(mode), indexType(indexType)
+    {
+        glGenBuffers(1, &instanceVBO);
+        glState().bindVertexArray(vao);
+        glState().bindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)maxBatch * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+
+        for (GLuint i = 0; i < 4; ++i) {
+            glEnableVertexAttribArray(INSTANCE_MODEL_LOCATION + i);
+            glVertexAttribDivisor(INSTANCE_MODEL_LOCATION + i, 1);
+        }
+        glEnableVertexAttribArray(INSTANCE_COLOR_LOCATION);
+        glVertexAttribDivisor(INSTANCE_COLOR_LOCATION, 1);
+        pointInstanceAttributes(instanceVBO, 0);
+    }
+
+    // 和 main 里的 VAO/VBO 一样在上下文销毁前显式释放
+    void release() {
+        if (instanceVBO != 0) {
+            glState().forgetBuffer(instanceVBO);
+            glDeleteBuffers(1, &instanceVBO);
+            instanceVBO = 0;
+        }
+    }
+
+    InstancedMesh(const InstancedMesh&) = delete;
+    InstancedMesh& operator=(const InstancedMesh&) = delete;
+
+    // 调用前需要先 use() 对应的 shader；超过 maxBatch 的部分分批提交
+    void draw(const InstanceData* instances, size_t count) {
+        if (count == 0)
+            return;
+        glState().bindVertexArray(vao);
+        pointInstanceAttributes(instanceVBO, 0);
+        for (size_t first = 0; first < count; first += maxBatch) {
+            GLsizei batch = (GLsizei)std::min<size_t>(maxBatch, count - first);
+            // 先孤立旧存储再写入，避免等待上一批还在使用的缓冲
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)maxBatch * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)batch * sizeof(InstanceData), instances + first);
+            if (indexType == 0)
+                glDrawArraysInstanced(mode, 0, vertexCount, batch);
+            else
+                glDrawElementsInstanced(mode, vertexCount, indexType, nullptr, batch);
+        }
+    }
+
+    void draw(const std::vector<InstanceData>& instances) {
+        draw(instances.data(), instances.size());
+    }
+
+    // 只上传不绘制，配合 RenderQueue 先录制后提交：一帧只能上传一批，
+    // 返回实际写入的实例数（最多 maxBatch），作为绘制包的 instances
+    GLsizei upload(const InstanceData* instances, size_t count) {
+        GLsizei batch = (GLsizei)std::min<size_t>(maxBatch, count);
+        glState().bindVertexArray(vao);
+        pointInstanceAttributes(instanceVBO, 0);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)maxBatch * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)batch * sizeof(InstanceData), instances);
+        return batch;
+    }
+
+    GLsizei upload(const std::vector<InstanceData>& instances) {
+        return upload(instances.data(), instances.size());
+    }
+
+    // 从流式环形缓冲里分配实例数据并让实例属性指向它，不再孤立 / 重新上传自己的 instanceVBO
+    // 回退路径下绘制前要先 stream.flush()；返回写入的实例数，空间不够时返回 0
+    GLsizei upload(StreamBuffer& stream, const InstanceData* instances, size_t count) {
+        StreamAllocation allocation = stream.allocate(count * sizeof(InstanceData), sizeof(glm::vec4));
+        if (!allocation)
+            return 0;
+        std::memcpy(allocation.data, instances, count * sizeof(InstanceData));
+        glState().bindVertexArray(vao);
+        pointInstanceAttributes(stream.buffer(), allocation.offset);
+        return (GLsizei)count;
+    }
+
+    GLsizei upload(StreamBuffer& stream, const std::vector<InstanceData>& instances) {
+        return upload(stream, instances.data(), instances.size());
+    }
+
+    // 实例属性直接指向常驻实例缓冲，返回实例数，作为绘制包的 instances
+    GLsizei useInstances(const ResidentInstanceBuffer& instances) {
+        glState().bindVertexArray(vao);
+        pointInstanceAttributes(instances.buffer, 0);
+        return (GLsizei)instances.size();
+    }
+
+    GLuint vertexArray() const { return vao; }
+    GLsizei vertices() const { return vertexCount; }
+    GLenum primitive() const { return mode; }
+    GLenum elementType() const { return indexType; }
+
+private:
+    GLuint vao;
+    GLsizei vertexCount;
+    GLsizei maxBatch;
+    GLenum mode;
+    GLenum indexType;
+    GLuint sourceBuffer = 0;
+    GLintptr sourceOffset = -1;
+
+    // 实例属性指向 buffer 的 offset 处（VAO 需已绑定）；和当前来源相同时跳过
+    // mat4 按 4 个 vec4 属性传入
+    void pointInstanceAttributes(GLuint buffer, GLintptr offset) {
+        glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+        if (buffer == sourceBuffer && offset == sourceOffset)
+            return;
+        for (GLuint i = 0; i < 4; ++i)
+            glVertexAttribPointer(INSTANCE_MODEL_LOCATION + i, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                  (void*)(offset + offsetof(InstanceData, model) + i * sizeof(glm::vec4)));
+        glVertexAttribPointer(INSTANCE_COLOR_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(offset + offsetof(InstanceData, color)));
+        sourceBuffer = buffer;
+        sourceOffset = offset;
+    }
+};
+
+#endif
@@ -0,0 +1,418 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+
+// 工作窃取的任务系统：每个线程一个 Chase-Lev 双端队列，自己从底部压入 / 弹出（无锁、无竞争），
+// 空闲线程从别人的顶部偷；任务完成通过计数器通知，等待的线程不睡觉而是帮着执行别的任务
+// 和 ThreadPool 的区别：wait(counter) 只等自己关心的那批任务，可以嵌套（任务里再 parallelFor），
+// 不会像 ThreadPool::wait() 那样等到全部任务、在工作线程里调用还会死锁
+// 任务里不能调用 GL（上下文只在主线程），也不要做阻塞 IO（会占住一个工作线程），那种用 ThreadPool
+
+class JobCounter;
+
+namespace job_detail {
+
+struct Job {
+    std::function<void()> work;
+    JobCounter* counter = nullptr;
+};
+
+// Chase-Lev 双端队列（Lê et al. 2013 的弱内存序版本）：所有者 push / pop 底部，其他线程 steal 顶部
+// 满了按两倍扩容；旧数组要等析构时才释放，因为窃取者可能还拿着旧指针在读
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 256) {
+        rings.emplace_back(new Ring(capacity));
+        ring.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // 只能由所有者线程调用
+    void push(Job* job) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Ring* r = ring.load(std::memory_order_relaxed);
+        if (b - t > (int64_t)r->capacity() - 1)
+            r = grow(r, t, b);
+        r->put(b, job);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // 只能由所有者线程调用；空时返回 nullptr
+    Job* pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Ring* r = ring.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Job* job = r->get(b);
+        if (t == b) {
+            // 只剩最后一个，和窃取者抢
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // 任意线程调用；空或者没抢到时返回 nullptr
+    Job* steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return nullptr;
+        Job* job = ring.load(std::memory_order_acquire)->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+
+    // 近似值，只用来做调度上的判断
+    int64_t size() const {
+        return std::max<int64_t>(0, bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed));
+    }
+
+private:
+    struct Ring {
+        explicit Ring(size_t capacity) : mask(capacity - 1), slots(new std::atomic<Job*>[capacity]) {}
+        size_t capacity() const { return mask + 1; }
+        Job* get(int64_t i) const { return slots[(size_t)i & mask].load(std::memory_order_acquire); }
+        void put(int64_t i, Job* job) { slots[(size_t)i & mask].store(job, std::memory_order_release); }
+
+        size_t mask; // 容量是 2 的幂
+        std::unique_ptr<std::atomic<Job*>[]> slots;
+    };
+
+    Ring* grow(Ring* old, int64_t t, int64_t b) {
+        rings.emplace_back(new Ring(old->capacity() * 2));
+        Ring* bigger = rings.back().get();
+        for (int64_t i = t; i < b; ++i)
+            bigger->put(i, old->get(i));
+        ring.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    // top 和 bottom 分开放在不同缓存行，窃取者改 top 时不会让所有者的 bottom 失效
+    alignas(64) std::atomic<int64_t> top{ 0 };
+    alignas(64) std::atomic<int64_t> bottom{ 0 };
+    std::atomic<Ring*> ring{ nullptr };
+    std::vector<std::unique_ptr<Ring>> rings; // 只有所有者线程修改
+};
+
+} // namespace job_detail
+
+// 一批任务的完成计数：run() 时加一，任务执行完减一，到 0 表示这批全部完成
+// 计数器要活到 wait() 返回为止（通常放在调用 wait 的函数栈上）
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool done() const {
+        return pending.load(std::memory_order_acquire) == 0 && finishing.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> pending{ 0 };
+    // 正在做“减到 0 之后的收尾”（取出后继任务）的线程数；不为 0 时等待者不能返回，否则计数器可能已经销毁
+    std::atomic<int> finishing{ 0 };
+    std::mutex mutex;
+    std::vector<job_detail::Job*> continuations; // runAfter() 挂在这里，计数到 0 时放进队列
+};
+
+class JobSystem {
+public:
+    struct Stats {
+        uint64_t executed = 0; // 所有线程执行的任务数
+        uint64_t stolen = 0;   // 其中从别的线程队列里偷来的
+    };
+
+    // workerCount 个工作线程，加上构造它的线程（所有者，通常是主线程）一起执行任务
+    explicit JobSystem(unsigned workerCount = defaultWorkerCount()) : owner(std::this_thread::get_id()) {
+        participants.reserve(workerCount + 1);
+        for (unsigned i = 0; i <= workerCount; ++i)
+            participants.emplace_back(new Participant());
+        for (unsigned i = 1; i <= workerCount; ++i)
+            workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    // 析构前应该已经 wait 过所有计数器；还没执行的任务直接丢掉
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        sleepCondition.notify_all();
+        for (std::thread& t : workers)
+            t.join();
+        for (auto& participant : participants)
+            while (job_detail::Job* job = participant->queue.pop())
+                delete job;
+        for (job_detail::Job* job : injected)
+            delete job;
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // 参与执行任务的线程数（工作线程 + 所有者线程），用来决定切多少块
+    size_t size() const { return participants.size(); }
+
+    // 留一个核给渲染线程之外的系统；所有者线程等待时也会执行任务，所以工作线程数 = 核数 - 1
+    static unsigned defaultWorkerCount() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n > 1 ? n - 1 : 0;
+    }
+
+    // 提交一个任务；counter 不为空时任务完成后减一
+    void run(std::function<void()> work, JobCounter* counter = nullptr) {
+        if (counter)
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+        push(new job_detail::Job{ std::move(work), counter });
+    }
+
+    // 依赖：dependency 计数到 0 之后才开始执行 work（已经是 0 就立即提交）
+    // counter 在调用时就加一，所以等 counter 也会等到这个还没开始的任务
+    void runAfter(JobCounter& dependency, std::function<void()> work, JobCounter* counter = nullptr) {
+        if (counter)
+            counter->pending.fetch_add(1, std::memory_order_relaxed);
+        job_detail::Job* job = new job_detail::Job{ std::move(work), counter };
+        {
+            std::lock_guard<std::mutex> lock(dependency.mutex);
+            if (dependency.pending.load(std::memory_order_seq_cst) != 0) {
+                dependency.continuations.push_back(job);
+                return;
+            }
+        }
+        push(job);
+    }
+
+    // 等到 counter 归零；等的时候执行队列里的任务（自己的、外部提交的、偷别人的），而不是睡眠
+    void wait(JobCounter& counter) {
+        int self = participantIndex();
+        unsigned idle = 0;
+        while (!counter.done()) {
+            if (job_detail::Job* job = findJob(self)) {
+                execute(job, self);
+                idle = 0;
+            } else if (++idle > 64) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // 把 [begin, end) 分段并行执行 fn(first, last)，返回时全部完成；当前线程也参与执行
+    // 懒惰二分（lazy binary splitting）自适应分块：本线程队列空了（说明别的线程把上次切出去的一半偷走了、
+    // 还有空闲的人）才继续对半切，否则按 grain 一段段顺序执行；负载不均时自动切得更细，均匀时任务数很少
+    // minGrain 为 0 时按范围长度和线程数估一个下限，避免切得比调度开销还小
+    template <typename F>
+    void parallelFor(size_t begin, size_t end, F&& fn, size_t minGrain = 0) {
+        if (begin >= end)
+            return;
+        size_t count = end - begin;
+        size_t grain = minGrain ? minGrain : std::max<size_t>(1, count / (size() * 32));
+        if (size() == 1 || count <= grain) {
+            fn(begin, end);
+            return;
+        }
+        JobCounter counter;
+        splitRange(begin, end, grain, fn, counter);
+        wait(counter);
+    }
+
+    Stats stats() const {
+        Stats s;
+        for (const auto& participant : participants) {
+            s.executed += participant->executed.load(std::memory_order_relaxed);
+            s.stolen += participant->stolen.load(std::memory_order_relaxed);
+        }
+        s.executed += foreignExecuted.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    // 每个参与者独占一条缓存行，计数不在线程之间来回传
+    struct alignas(64) Participant {
+        job_detail::WorkStealingDeque queue;
+        std::atomic<uint64_t> executed{ 0 };
+        std::atomic<uint64_t> stolen{ 0 };
+        uint32_t seed = 0x9E3779B9u; // 挑选窃取目标的随机数状态，只有自己用
+    };
+
+    // 当前线程在这个任务系统里的下标：0 是所有者线程，1.. 是工作线程，-1 是外部线程
+    struct ThreadSlot {
+        const JobSystem* system = nullptr;
+        int index = -1;
+    };
+    static ThreadSlot& threadSlot() {
+        static thread_local ThreadSlot slot;
+        return slot;
+    }
+    int participantIndex() const {
+        const ThreadSlot& slot = threadSlot();
+        if (slot.system == this)
+            return slot.index;
+        return std::this_thread::get_id() == owner ? 0 : -1;
+    }
+
+    std::thread::id owner;
+    std::vector<std::unique_ptr<Participant>> participants;
+    std::vector<std::thread> workers;
+
+    // 外部线程（不是所有者也不是工作线程）提交的任务：没有自己的队列，放进一个加锁的共享队列
+    std::mutex injectedMutex;
+    std::deque<job_detail::Job*> injected;
+    std::atomic<size_t> injectedCount{ 0 };
+    std::atomic<uint64_t> foreignExecuted{ 0 };
+
+    // 空闲的工作线程睡在条件变量上；每次提交任务 epoch 加一，睡前和睡后比较 epoch，避免丢失唤醒
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<uint64_t> epoch{ 0 };
+    std::atomic<int> sleeping{ 0 };
+    bool stopping = false;
+
+    void push(job_detail::Job* job) {
+        int self = participantIndex();
+        if (self >= 0) {
+            participants[self]->queue.push(job);
+        } else {
+            std::lock_guard<std::mutex> lock(injectedMutex);
+            injected.push_back(job);
+            injectedCount.fetch_add(1, std::memory_order_release);
+        }
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            sleepCondition.notify_one();
+        }
+    }
+
+    job_detail::Job* findJob(int self) {
+        if (self >= 0)
+            if (job_detail::Job* job = participants[self]->queue.pop())
+                return job;
+        if (injectedCount.load(std::memory_order_acquire) > 0) {
+            std::lock_guard<std::mutex> lock(injectedMutex);
+            if (!injected.empty()) {
+                job_detail::Job* job = injected.front();
+                injected.pop_front();
+                injectedCount.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+        // 从随机位置开始轮一圈，避免所有空闲线程都去偷同一个人
+        size_t n = participants.size();
+        size_t start = 0;
+        if (self >= 0) {
+            uint32_t& seed = participants[self]->seed;
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            start = seed % n;
+        }
+        for (size_t k = 0; k < n; ++k) {
+            size_t victim = (start + k) % n;
+            if ((int)victim == self)
+                continue;
+            if (job_detail::Job* job = participants[victim]->queue.steal()) {
+                if (self >= 0)
+                    participants[self]->stolen.fetch_add(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void execute(job_detail::Job* job, int self) {
+        job->work();
+        if (self >= 0)
+            participants[self]->executed.fetch_add(1, std::memory_order_relaxed);
+        else
+            foreignExecuted.fetch_add(1, std::memory_order_relaxed);
+        JobCounter* counter = job->counter;
+        delete job;
+        if (counter)
+            finish(*counter);
+    }
+
+    void finish(JobCounter& counter) {
+        counter.finishing.fetch_add(1, std::memory_order_seq_cst);
+        if (counter.pending.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+            std::vector<job_detail::Job*> ready;
+            {
+                std::lock_guard<std::mutex> lock(counter.mutex);
+                ready.swap(counter.continuations);
+            }
+            for (job_detail::Job* job : ready)
+                push(job);
+        }
+        // 这之后不再碰 counter，等待者可以返回并销毁它
+        counter.finishing.fetch_sub(1, std::memory_order_release);
+    }
+
+    template <typename F>
+    void splitRange(size_t begin, size_t end, size_t grain, F& fn, JobCounter& counter) {
+        int self = participantIndex();
+        while (begin < end) {
+            bool hungry = self < 0 || participants[self]->queue.size() == 0;
+            if (end - begin > grain && hungry) {
+                size_t mid = begin + (end - begin) / 2;
+                run([this, mid, end, grain, &fn, &counter]() { splitRange(mid, end, grain, fn, counter); }, &counter);
+                end = mid;
+                continue;
+            }
+            size_t last = std::min(end, begin + grain);
+            fn(begin, last);
+            begin = last;
+        }
+    }
+
+    void workerLoop(int index) {
+        threadSlot() = ThreadSlot{ this, index };
+        for (;;) {
+            // 先自旋找活，找不到再睡；睡前记下 epoch，期间有人提交任务就不睡
+            job_detail::Job* job = nullptr;
+            uint64_t seen = 0;
+            for (int spin = 0; spin < 64 && !job; ++spin) {
+                seen = epoch.load(std::memory_order_seq_cst);
+                job = findJob(index);
+                if (!job)
+                    std::this_thread::yield();
+            }
+            if (job) {
+                execute(job, index);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleeping.fetch_add(1, std::memory_order_seq_cst);
+            sleepCondition.wait(lock, [&]() { return stopping || epoch.load(std::memory_order_seq_cst) != seen; });
+            sleeping.fetch_sub(1, std::memory_order_seq_cst);
+            if (stopping)
+                return;
+        }
+    }
+};
+
+#endif
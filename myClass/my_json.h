@@ -0,0 +1,310 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// 最小的 JSON DOM 解析器，给 glTF 的 .gltf / .glb 里的 JSON 块用
+// 只读：解析一次，之后按 key / 下标取值；缺失的 key 或越界下标返回一个 Null 值，调用方不用层层判断
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object; // 保持文件里的顺序，glTF 的对象都很小，线性查找即可
+
+    bool isNull() const { return type == Type::Null; }
+    bool isNumber() const { return type == Type::Number; }
+    bool isString() const { return type == Type::String; }
+    bool isArray() const { return type == Type::Array; }
+    bool isObject() const { return type == Type::Object; }
+
+    size_t size() const { return type == Type::Array ? array.size() : type == Type::Object ? object.size() : 0; }
+
+    const JsonValue& operator[](size_t index) const {
+        return type == Type::Array && index < array.size() ? array[index] : null();
+    }
+    // 字面量 0 既能转成 size_t 也能转成指针，单独给 int 一个重载消除歧义
+    const JsonValue& operator[](int index) const { return (*this)[(size_t)index]; }
+    const JsonValue& operator[](const char* key) const {
+        if (type == Type::Object)
+            for (const auto& member : object)
+                if (member.first == key)
+                    return member.second;
+        return null();
+    }
+    bool has(const char* key) const { return !(*this)[key].isNull(); }
+
+    double asNumber(double fallback = 0.0) const { return type == Type::Number ? number : fallback; }
+    int asInt(int fallback = 0) const { return type == Type::Number ? (int)number : fallback; }
+    size_t asSize(size_t fallback = 0) const { return type == Type::Number && number >= 0.0 ? (size_t)number : fallback; }
+    bool asBool(bool fallback = false) const { return type == Type::Bool ? boolean : fallback; }
+    const std::string& asString() const { return type == Type::String ? string : emptyString(); }
+
+    static const JsonValue& null() {
+        static const JsonValue value;
+        return value;
+    }
+
+private:
+    static const std::string& emptyString() {
+        static const std::string value;
+        return value;
+    }
+};
+
+namespace json_detail {
+
+class Parser {
+public:
+    Parser(const char* text, size_t length) : p(text), end(text + length) {}
+
+    bool parse(JsonValue& out, std::string* error) {
+        skipSpace();
+        bool ok = parseValue(out, 0);
+        if (ok) {
+            skipSpace();
+            if (p != end)
+                ok = fail("trailing characters");
+        }
+        if (!ok && error)
+            *error = message + " at byte " + std::to_string(offset());
+        return ok;
+    }
+
+    void setStart(const char* text) { start = text; }
+
+private:
+    // 嵌套过深的文件（恶意或损坏）直接拒绝，避免递归爆栈
+    static const int MAX_DEPTH = 256;
+
+    const char* p;
+    const char* end;
+    const char* start = nullptr;
+    std::string message;
+
+    size_t offset() const { return start ? (size_t)(p - start) : 0; }
+
+    bool fail(const char* what) {
+        if (message.empty())
+            message = what;
+        return false;
+    }
+
+    void skipSpace() {
+        while (p != end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+            ++p;
+    }
+
+    bool literal(const char* word) {
+        size_t n = std::strlen(word);
+        if ((size_t)(end - p) < n || std::memcmp(p, word, n) != 0)
+            return fail("invalid literal");
+        p += n;
+        return true;
+    }
+
+    bool parseValue(JsonValue& out, int depth) {
+        if (depth > MAX_DEPTH)
+            return fail("nesting too deep");
+        if (p == end)
+            return fail("unexpected end");
+        switch (*p) {
+        case '{': return parseObject(out, depth);
+        case '[': return parseArray(out, depth);
+        case '"': out.type = JsonValue::Type::String; return parseString(out.string);
+        case 't': out.type = JsonValue::Type::Bool; out.boolean = true; return literal("true");
+        case 'f': out.type = JsonValue::Type::Bool; out.boolean = false; return literal("false");
+        case 'n': out.type = JsonValue::Type::Null; return literal("null");
+        default:  return parseNumber(out);
+        }
+    }
+
+    bool parseObject(JsonValue& out, int depth) {
+        out.type = JsonValue::Type::Object;
+        ++p;
+        skipSpace();
+        if (p != end && *p == '}') {
+            ++p;
+            return true;
+        }
+        for (;;) {
+            skipSpace();
+            if (p == end || *p != '"')
+                return fail("expected object key");
+            out.object.emplace_back();
+            if (!parseString(out.object.back().first))
+                return false;
+            skipSpace();
+            if (p == end || *p != ':')
+                return fail("expected ':'");
+            ++p;
+            skipSpace();
+            if (!parseValue(out.object.back().second, depth + 1))
+                return false;
+            skipSpace();
+            if (p != end && *p == ',') {
+                ++p;
+                continue;
+            }
+            if (p != end && *p == '}') {
+                ++p;
+                return true;
+            }
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    bool parseArray(JsonValue& out, int depth) {
+        out.type = JsonValue::Type::Array;
+        ++p;
+        skipSpace();
+        if (p != end && *p == ']') {
+            ++p;
+            return true;
+        }
+        for (;;) {
+            skipSpace();
+            out.array.emplace_back();
+            if (!parseValue(out.array.back(), depth + 1))
+                return false;
+            skipSpace();
+            if (p != end && *p == ',') {
+                ++p;
+                continue;
+            }
+            if (p != end && *p == ']') {
+                ++p;
+                return true;
+            }
+            return fail("expected ',' or ']'");
+        }
+    }
+
+    bool parseNumber(JsonValue& out) {
+        const char* first = p;
+        if (p != end && *p == '-')
+            ++p;
+        while (p != end && ((*p >= '0' && *p <= '9') || *p == '.' || *p == 'e' || *p == 'E' || *p == '+' || *p == '-'))
+            ++p;
+        if (p == first)
+            return fail("unexpected character");
+        // strtod 需要以 0 结尾的字符串，数字都很短，拷贝到栈上
+        char buffer[64];
+        size_t n = (size_t)(p - first);
+        if (n >= sizeof(buffer))
+            return fail("number too long");
+        std::memcpy(buffer, first, n);
+        buffer[n] = 0;
+        char* parsedEnd = nullptr;
+        out.type = JsonValue::Type::Number;
+        out.number = std::strtod(buffer, &parsedEnd);
+        if (parsedEnd != buffer + n)
+            return fail("invalid number");
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out += (char)code;
+        } else if (code < 0x800) {
+            out += (char)(0xC0 | (code >> 6));
+            out += (char)(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += (char)(0xE0 | (code >> 12));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        } else {
+            out += (char)(0xF0 | (code >> 18));
+            out += (char)(0x80 | ((code >> 12) & 0x3F));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+    }
+
+    bool parseHex4(uint32_t& code) {
+        if (end - p < 4)
+            return fail("truncated \\u escape");
+        code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *p++;
+            code <<= 4;
+            if (c >= '0' && c <= '9') code |= (uint32_t)(c - '0');
+            else if (c >= 'a' && c <= 'f') code |= (uint32_t)(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') code |= (uint32_t)(c - 'A' + 10);
+            else return fail("invalid \\u escape");
+        }
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        ++p; // 开头的引号
+        for (;;) {
+            if (p == end)
+                return fail("unterminated string");
+            char c = *p++;
+            if (c == '"')
+                return true;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (p == end)
+                return fail("unterminated string");
+            char e = *p++;
+            switch (e) {
+            case '"':  out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/':  out += '/'; break;
+            case 'b':  out += '\b'; break;
+            case 'f':  out += '\f'; break;
+            case 'n':  out += '\n'; break;
+            case 'r':  out += '\r'; break;
+            case 't':  out += '\t'; break;
+            case 'u': {
+                uint32_t code;
+                if (!parseHex4(code))
+                    return false;
+                // 代理对拼成一个码点
+                if (code >= 0xD800 && code < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                    p += 2;
+                    uint32_t low;
+                    if (!parseHex4(low))
+                        return false;
+                    if (low < 0xDC00 || low >= 0xE000)
+                        return fail("invalid surrogate pair");
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                }
+                appendUtf8(out, code);
+                break;
+            }
+            default:
+                return fail("invalid escape");
+            }
+        }
+    }
+};
+
+} // namespace json_detail
+
+// 解析失败返回 false，error 里是原因和字节位置
+inline bool parseJson(const char* text, size_t length, JsonValue& out, std::string* error = nullptr) {
+    json_detail::Parser parser(text, length);
+    parser.setStart(text);
+    out = JsonValue{};
+    return parser.parse(out, error);
+}
+
+inline bool parseJson(const std::string& text, JsonValue& out, std::string* error = nullptr) {
+    return parseJson(text.data(), text.size(), out, error);
+}
+
+#endif
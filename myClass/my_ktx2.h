@@ -0,0 +1,252 @@
+#ifndef KTX2_H
+#define KTX2_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+
+#include "my_textureCompressor.h"
+#include "my_mappedFile.h"
+
+// KTX2 容器的最小读写实现：单层 2D 纹理 + 完整 mip 链，不做超压缩（supercompressionScheme = 0）
+// 规范见 https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+namespace ktx2 {
+
+const uint8_t IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+// VkFormat 取值
+enum VkFormat : uint32_t {
+    VK_FORMAT_UNDEFINED = 0,
+    VK_FORMAT_BC1_RGB_UNORM_BLOCK = 131,
+    VK_FORMAT_BC1_RGB_SRGB_BLOCK = 132,
+    VK_FORMAT_BC3_UNORM_BLOCK = 137,
+    VK_FORMAT_BC3_SRGB_BLOCK = 138,
+    VK_FORMAT_BC7_UNORM_BLOCK = 145,
+    VK_FORMAT_BC7_SRGB_BLOCK = 146,
+    VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK = 147,
+    VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK = 148,
+    VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK = 151,
+    VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK = 152
+};
+
+inline uint32_t vkFormatFor(BlockFormat format, bool srgb) {
+    switch (format) {
+    case BlockFormat::BC1:       return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+    case BlockFormat::BC3:       return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+    case BlockFormat::BC7:       return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+    case BlockFormat::ETC2_RGB:  return srgb ? VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+    case BlockFormat::ETC2_RGBA: return srgb ? VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK : VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+// 反查：返回 false 表示不是本工具链支持的格式
+inline bool blockFormatFor(uint32_t vkFormat, BlockFormat& format, bool& srgb) {
+    srgb = (vkFormat & 1) == 0; // 上面这些格式 UNORM 都是奇数，SRGB 紧随其后
+    switch (vkFormat) {
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK: case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        format = BlockFormat::BC1; return true;
+    case VK_FORMAT_BC3_UNORM_BLOCK: case VK_FORMAT_BC3_SRGB_BLOCK:
+        format = BlockFormat::BC3; return true;
+    case VK_FORMAT_BC7_UNORM_BLOCK: case VK_FORMAT_BC7_SRGB_BLOCK:
+        format = BlockFormat::BC7; return true;
+    case VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK: case VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK:
+        format = BlockFormat::ETC2_RGB; return true;
+    case VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK: case VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK:
+        format = BlockFormat::ETC2_RGBA; return true;
+    }
+    return false;
+}
+
+struct Level {
+    int width = 0, height = 0;
+    size_t offset = 0;  // 相对文件开头
+    size_t length = 0;
+};
+
+// 读进内存的 KTX2 文件；levels[0] 是最大的一级
+struct Texture2D {
+    uint32_t vkFormat = VK_FORMAT_UNDEFINED;
+    int width = 0, height = 0;
+    std::vector<Level> levels;
+    MappedFile file;    // 整个文件只读映射，levelData 直接指向映射，上传时不再拷贝
+
+    explicit operator bool() const { return !levels.empty(); }
+    const uint8_t* levelData(size_t level) const { return file.data() + levels[level].offset; }
+};
+
+namespace detail {
+
+inline void put32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        out.push_back((uint8_t)(v >> (8 * i)));
+}
+
+inline void put64(std::vector<uint8_t>& out, uint64_t v) {
+    put32(out, (uint32_t)v);
+    put32(out, (uint32_t)(v >> 32));
+}
+
+inline void set32(std::vector<uint8_t>& out, size_t at, uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        out[at + i] = (uint8_t)(v >> (8 * i));
+}
+
+inline void set64(std::vector<uint8_t>& out, size_t at, uint64_t v) {
+    set32(out, at, (uint32_t)v);
+    set32(out, at + 4, (uint32_t)(v >> 32));
+}
+
+inline uint32_t get32(const uint8_t* p) {
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+inline uint64_t get64(const uint8_t* p) {
+    return get32(p) | (uint64_t)get32(p + 4) << 32;
+}
+
+inline void padTo(std::vector<uint8_t>& out, size_t alignment) {
+    while (out.size() % alignment)
+        out.push_back(0);
+}
+
+// Khronos Data Format Descriptor：一个 basic descriptor block，描述压缩块里的通道
+inline void writeDFD(std::vector<uint8_t>& out, BlockFormat format, bool srgb) {
+    const uint32_t MODEL_BC1A = 128, MODEL_BC3 = 130, MODEL_BC7 = 134, MODEL_ETC2 = 161;
+    const uint32_t CHANNEL_COLOR = 0, CHANNEL_ETC2_COLOR = 2, CHANNEL_ALPHA = 15;
+    struct Sample { uint32_t offset, length, channel; };
+
+    uint32_t model = 0;
+    std::vector<Sample> samples;
+    switch (format) {
+    case BlockFormat::BC1:       model = MODEL_BC1A; samples = { { 0, 64, CHANNEL_COLOR } }; break;
+    case BlockFormat::BC3:       model = MODEL_BC3;  samples = { { 0, 64, CHANNEL_ALPHA }, { 64, 64, CHANNEL_COLOR } }; break;
+    case BlockFormat::BC7:       model = MODEL_BC7;  samples = { { 0, 128, CHANNEL_COLOR } }; break;
+    case BlockFormat::ETC2_RGB:  model = MODEL_ETC2; samples = { { 0, 64, CHANNEL_ETC2_COLOR } }; break;
+    case BlockFormat::ETC2_RGBA: model = MODEL_ETC2; samples = { { 0, 64, CHANNEL_ALPHA }, { 64, 64, CHANNEL_ETC2_COLOR } }; break;
+    }
+
+    uint32_t blockSize = 24 + 16 * (uint32_t)samples.size();
+    put32(out, 4 + blockSize);                        // dfdTotalSize
+    put32(out, 0);                                     // vendorId = Khronos, descriptorType = basic
+    put32(out, 2 | blockSize << 16);                   // versionNumber = 1.3, descriptorBlockSize
+    put32(out, model | 1 << 8 | (srgb ? 2u : 1u) << 16); // 色彩模型、BT.709 原色、传递函数
+    put32(out, 3 | 3 << 8);                            // 4x4 的块
+    put32(out, (uint32_t)blockBytes(format));          // bytesPlane0
+    put32(out, 0);
+    for (const Sample& s : samples) {
+        put32(out, s.offset | (s.length - 1) << 16 | s.channel << 24);
+        put32(out, 0);
+        put32(out, 0);
+        put32(out, 0xFFFFFFFFu);
+    }
+}
+
+} // namespace detail
+
+// 写出 KTX2；levels 按从大到小给出，文件里按规范从小到大排列
+// orientation 写进 KTXorientation 键值（"ru" 表示已经为 OpenGL 上下翻转过）
+inline bool write(const std::string& path, BlockFormat format, bool srgb,
+                  const std::vector<CompressedLevel>& levels, const std::string& orientation = "rd") {
+    if (levels.empty())
+        return false;
+    using namespace detail;
+    size_t levelCount = levels.size();
+
+    std::vector<uint8_t> out(IDENTIFIER, IDENTIFIER + 12);
+    put32(out, vkFormatFor(format, srgb));
+    put32(out, 1);                               // typeSize
+    put32(out, (uint32_t)levels[0].width);
+    put32(out, (uint32_t)levels[0].height);
+    put32(out, 0);                               // pixelDepth
+    put32(out, 0);                               // layerCount
+    put32(out, 1);                               // faceCount
+    put32(out, (uint32_t)levelCount);
+    put32(out, 0);                               // supercompressionScheme
+
+    size_t indexAt = out.size();
+    out.resize(out.size() + 32 + 24 * levelCount, 0); // 先占位，后面回填
+
+    size_t dfdAt = out.size();
+    writeDFD(out, format, srgb);
+    size_t dfdLength = out.size() - dfdAt;
+
+    size_t kvdAt = out.size();
+    std::string kv = std::string("KTXorientation") + '\0' + orientation + '\0';
+    put32(out, (uint32_t)kv.size());
+    out.insert(out.end(), kv.begin(), kv.end());
+    padTo(out, 4);
+    size_t kvdLength = out.size() - kvdAt;
+
+    set32(out, indexAt + 0, (uint32_t)dfdAt);
+    set32(out, indexAt + 4, (uint32_t)dfdLength);
+    set32(out, indexAt + 8, (uint32_t)kvdAt);
+    set32(out, indexAt + 12, (uint32_t)kvdLength);
+    set64(out, indexAt + 16, 0);                 // 没有超压缩全局数据
+    set64(out, indexAt + 24, 0);
+
+    // mip 数据按块大小对齐，最小的一级在最前面
+    for (size_t i = levelCount; i-- > 0;) {
+        padTo(out, blockBytes(format));
+        size_t at = indexAt + 32 + 24 * i;
+        set64(out, at + 0, out.size());
+        set64(out, at + 8, levels[i].data.size());
+        set64(out, at + 16, levels[i].data.size());
+        out.insert(out.end(), levels[i].data.begin(), levels[i].data.end());
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(out.data()), (std::streamsize)out.size());
+    return (bool)file;
+}
+
+// 读入整个文件并解析 level index；失败时返回空对象，error 给出原因
+inline Texture2D read(const std::string& path, std::string* error = nullptr) {
+    using namespace detail;
+    Texture2D texture;
+    auto fail = [&](const char* reason) {
+        if (error)
+            *error = reason;
+        return Texture2D{};
+    };
+
+    if (!texture.file.open(path))
+        return fail("cannot open file");
+    size_t size = texture.file.size();
+    if (size < 80)
+        return fail("file too small");
+
+    const uint8_t* p = texture.file.data();
+    if (std::memcmp(p, IDENTIFIER, 12) != 0)
+        return fail("not a KTX2 file");
+    texture.vkFormat = get32(p + 12);
+    texture.width = (int)get32(p + 20);
+    texture.height = (int)get32(p + 24);
+    uint32_t depth = get32(p + 28), layers = get32(p + 32), faces = get32(p + 36);
+    uint32_t levelCount = std::max(1u, get32(p + 40));
+    if (depth > 1 || layers > 1 || faces != 1)
+        return fail("only single 2D textures are supported");
+    if (get32(p + 44) != 0)
+        return fail("supercompressed files are not supported");
+    if (size < 80 + 24 * (size_t)levelCount)
+        return fail("truncated level index");
+
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        const uint8_t* entry = p + 80 + 24 * i;
+        Level level;
+        level.width = std::max(1, texture.width >> i);
+        level.height = std::max(1, texture.height >> i);
+        level.offset = (size_t)get64(entry);
+        level.length = (size_t)get64(entry + 8);
+        if (level.offset + level.length > size)
+            return fail("level data out of range");
+        texture.levels.push_back(level);
+    }
+    return texture;
+}
+
+} // namespace ktx2
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef LOCK_FREE_QUEUE_H
+#define LOCK_FREE_QUEUE_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <cstdint>
+
+// 有界多生产者多消费者无锁队列（Dmitry Vyukov 的环形队列）
+// 容量会向上取整到 2 的幂；队满时 push 返回 false，队空时 pop 返回 false
+template <typename T>
+class LockFreeQueue {
+public:
+    explicit LockFreeQueue(size_t capacity = 256) {
+        size_t size = 2;
+        while (size < capacity)
+            size <<= 1;
+        cells = std::vector<Cell>(size);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    // 只有成功入队才会移走 value，队满返回 false 时调用方手里的值还在，可以直接重试
+    template <typename U>
+    bool push(U&& value) {
+        Cell* cell;
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::forward<U>(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& value) {
+        Cell* cell;
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->value);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{ 0 };
+        T value{};
+
+        Cell() = default;
+        // vector 初始化需要，构造完成后不会再移动
+        Cell(Cell&& other) noexcept : sequence(other.sequence.load()), value(std::move(other.value)) {}
+        Cell& operator=(Cell&& other) noexcept {
+            sequence.store(other.sequence.load());
+            value = std::move(other.value);
+            return *this;
+        }
+    };
+
+    // 生产者和消费者的位置放在不同缓存行，避免伪共享
+    alignas(64) std::vector<Cell> cells;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+    alignas(64) std::atomic<size_t> dequeuePos{ 0 };
+};
+
+#endif
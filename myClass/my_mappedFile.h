@@ -0,0 +1,117 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// 只读内存映射一个文件：页面在第一次访问时才由系统读入，不需要先分配缓冲区再拷贝
+// 缓存文件（.mips / .ktx2）的像素可以直接把映射里的指针交给 glTexImage2D
+// 只能移动；缓存更新走临时文件 + 改名，不会改写已经映射的内容
+// （Windows 上目标文件被映射时改名会失败，这次就不更新，下次启动再写）
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { moveFrom(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    // 空文件也算失败（零长度无法映射）
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) {
+                bytes = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                // 视图会保持映射存活，两个句柄可以立刻关掉
+                CloseHandle(mapping);
+                if (bytes)
+                    length = (size_t)fileSize.QuadPart;
+            }
+        }
+        CloseHandle(file);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                bytes = p;
+                length = (size_t)st.st_size;
+            }
+        }
+        ::close(fd);
+#endif
+        return bytes != nullptr;
+    }
+
+    void close() {
+        if (!bytes)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(bytes);
+#else
+        munmap(bytes, length);
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+
+    explicit operator bool() const { return bytes != nullptr; }
+    const uint8_t* data() const { return static_cast<const uint8_t*>(bytes); }
+    size_t size() const { return length; }
+
+    // 每页读一个字节，把缺页（也就是磁盘读取）提前放到调用线程里，而不是等到渲染线程上传时
+    void prefault() const {
+        volatile uint8_t sink = 0;
+        for (size_t i = 0; i < length; i += 4096)
+            sink = sink + data()[i];
+        (void)sink;
+    }
+
+private:
+    void* bytes = nullptr;
+    size_t length = 0;
+
+    void moveFrom(MappedFile& other) {
+        bytes = other.bytes;
+        length = other.length;
+        other.bytes = nullptr;
+        other.length = 0;
+    }
+};
+
+#endif
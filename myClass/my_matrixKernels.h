@@ -0,0 +1,541 @@
+#ifndef MATRIX_KERNELS_H
+#define MATRIX_KERNELS_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+#include "my_frustum.h"
+
+// 批量矩阵内核：一次处理一整个数组，而不是每个物体各调一次 glm
+//   - multiply：out[i] = a * in[i]，用来算 viewProj * model、父矩阵 * 局部矩阵
+//   - composeTransforms：SoA 的 TRS 列合成 T * R * S 矩阵，可选顺带把局部包围盒变换到世界空间
+//   - transformAABBs：已有的矩阵数组变换包围盒（中心 + 半长）
+// 和 my_simd.h 的编译期选择不同，这里的 SSE2 / AVX2 / AVX-512 实现都编译进去，
+// 启动时按 CPUID（和操作系统是否保存 YMM/ZMM 状态）选当前机器支持的最宽路径，发行版不用开 -mavx2 也能用上
+// 每条路径的运算顺序都和标量实现一样，而且不用 FMA：结果和标量逐位相同，也和没有被编译成 FMA 的 glm a * b 逐位相同；
+// 合成矩阵没有走 glm 的 translate * mat4_cast * scale 三次矩阵乘，和它的结果在舍入误差内一致
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MY_MATRIX_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// GCC / Clang 要给每个函数标上目标指令集才能在同一个编译单元里用 AVX2 / AVX-512 的内建函数；MSVC 不需要
+#if defined(MY_MATRIX_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MY_MATRIX_TARGET_SSE2 __attribute__((target("sse2")))
+#define MY_MATRIX_TARGET_AVX2 __attribute__((target("avx2")))
+#define MY_MATRIX_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define MY_MATRIX_TARGET_SSE2
+#define MY_MATRIX_TARGET_AVX2
+#define MY_MATRIX_TARGET_AVX512
+#endif
+
+// 不允许把乘加合并成 FMA：AVX-512 隐含 FMA，GCC 默认会把 _mm512_add_ps(_mm512_mul_ps(...)) 合成一条，
+// Clang 会合并同一个表达式里的标量乘加，合并后少一次舍入，就和标量结果不再逐位一致
+#if defined(__clang__)
+#define MY_MATRIX_NO_CONTRACT _Pragma("clang fp contract(off)")
+#else
+#define MY_MATRIX_NO_CONTRACT
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+// GCC 12 的 avx512fintrin.h 里 _mm512_undefined_ps 会误报未初始化（12.3 修复）
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+enum class MathPath { Scalar, SSE2, AVX2, AVX512 };
+
+inline const char* mathPathName(MathPath path) {
+    switch (path) {
+    case MathPath::SSE2: return "SSE2";
+    case MathPath::AVX2: return "AVX2";
+    case MathPath::AVX512: return "AVX-512";
+    default: return "scalar";
+    }
+}
+
+// 局部 TRS 的列（和 TransformPool / TransformGraph 的列一一对应），旋转是单位四元数
+struct TRSColumns {
+    const float *px, *py, *pz;
+    const float *rx, *ry, *rz, *rw;
+    const float *sx, *sy, *sz;
+};
+
+// AABBSoA 的列指针，内核只按下标读写，不改变长度
+struct ConstAABBColumns {
+    const float *cx, *cy, *cz, *ex, *ey, *ez;
+};
+struct AABBColumns {
+    float *cx, *cy, *cz, *ex, *ey, *ez;
+};
+
+inline ConstAABBColumns readColumns(const AABBSoA& b) {
+    return ConstAABBColumns{ b.cx.data(), b.cy.data(), b.cz.data(), b.ex.data(), b.ey.data(), b.ez.data() };
+}
+inline AABBColumns writeColumns(AABBSoA& b) {
+    return AABBColumns{ b.cx.data(), b.cy.data(), b.cz.data(), b.ex.data(), b.ey.data(), b.ez.data() };
+}
+
+namespace matrix_detail {
+
+static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "glm::mat4 must be 16 tightly packed floats");
+
+inline const float* floats(const glm::mat4* m) { return &(*m)[0][0]; }
+inline float* floats(glm::mat4* m) { return &(*m)[0][0]; }
+
+// ---- 标量参考实现，也是各条 SIMD 路径的尾部 ----
+
+inline void multiplyScalar(const glm::mat4& a, const glm::mat4* in, glm::mat4* out, size_t n) {
+    MY_MATRIX_NO_CONTRACT
+    float m[16];
+    for (int k = 0; k < 16; ++k)
+        m[k] = floats(&a)[k];
+    for (size_t i = 0; i < n; ++i) {
+        float b[16];
+        for (int k = 0; k < 16; ++k)
+            b[k] = floats(in + i)[k];
+        float* r = floats(out + i);
+        for (int c = 0; c < 4; ++c)
+            for (int row = 0; row < 4; ++row)
+                r[c * 4 + row] = m[row] * b[c * 4] + m[4 + row] * b[c * 4 + 1] + m[8 + row] * b[c * 4 + 2] + m[12 + row] * b[c * 4 + 3];
+    }
+}
+
+// 矩阵元素 mRC 是第 R 列第 C 行
+inline void transformAABBScalar(float m00, float m01, float m02, float m10, float m11, float m12, float m20, float m21,
+                                float m22, float m30, float m31, float m32, const ConstAABBColumns& local,
+                                const AABBColumns& world, size_t i) {
+    MY_MATRIX_NO_CONTRACT
+    float cx = local.cx[i], cy = local.cy[i], cz = local.cz[i];
+    float ex = local.ex[i], ey = local.ey[i], ez = local.ez[i];
+    world.cx[i] = m00 * cx + m10 * cy + m20 * cz + m30;
+    world.cy[i] = m01 * cx + m11 * cy + m21 * cz + m31;
+    world.cz[i] = m02 * cx + m12 * cy + m22 * cz + m32;
+    world.ex[i] = std::fabs(m00) * ex + std::fabs(m10) * ey + std::fabs(m20) * ez;
+    world.ey[i] = std::fabs(m01) * ex + std::fabs(m11) * ey + std::fabs(m21) * ez;
+    world.ez[i] = std::fabs(m02) * ex + std::fabs(m12) * ey + std::fabs(m22) * ez;
+}
+
+inline void composeScalar(const TRSColumns& t, size_t first, size_t last, glm::mat4* out,
+                          const ConstAABBColumns* local, const AABBColumns* world) {
+    MY_MATRIX_NO_CONTRACT
+    for (size_t i = first; i < last; ++i) {
+        float x = t.rx[i], y = t.ry[i], z = t.rz[i], w = t.rw[i];
+        float xx = x * x, yy = y * y, zz = z * z;
+        float xy = x * y, xz = x * z, yz = y * z;
+        float wx = w * x, wy = w * y, wz = w * z;
+        float sx = t.sx[i], sy = t.sy[i], sz = t.sz[i];
+
+        float m00 = (1.0f - 2.0f * (yy + zz)) * sx, m01 = 2.0f * (xy + wz) * sx, m02 = 2.0f * (xz - wy) * sx;
+        float m10 = 2.0f * (xy - wz) * sy, m11 = (1.0f - 2.0f * (xx + zz)) * sy, m12 = 2.0f * (yz + wx) * sy;
+        float m20 = 2.0f * (xz + wy) * sz, m21 = 2.0f * (yz - wx) * sz, m22 = (1.0f - 2.0f * (xx + yy)) * sz;
+        float m30 = t.px[i], m31 = t.py[i], m32 = t.pz[i];
+        float* m = floats(out + i);
+        m[0] = m00; m[1] = m01; m[2] = m02; m[3] = 0.0f;
+        m[4] = m10; m[5] = m11; m[6] = m12; m[7] = 0.0f;
+        m[8] = m20; m[9] = m21; m[10] = m22; m[11] = 0.0f;
+        m[12] = m30; m[13] = m31; m[14] = m32; m[15] = 1.0f;
+        if (local)
+            transformAABBScalar(m00, m01, m02, m10, m11, m12, m20, m21, m22, m30, m31, m32, *local, *world, i);
+    }
+}
+
+inline void transformAABBsScalar(const glm::mat4* matrices, const ConstAABBColumns& local, const AABBColumns& world,
+                                 size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+        const float* m = floats(matrices + i);
+        transformAABBScalar(m[0], m[1], m[2], m[4], m[5], m[6], m[8], m[9], m[10], m[12], m[13], m[14], local, world, i);
+    }
+}
+
+#if defined(MY_MATRIX_X86)
+
+// ---- SSE2：4 个物体一组 ----
+
+MY_MATRIX_TARGET_SSE2
+inline __m128 abs128(__m128 v) { return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))); }
+
+// a 的 4 列按 b 的 4 个分量加权求和，顺序和 glm 一样：((a0 * b.x + a1 * b.y) + a2 * b.z) + a3 * b.w
+MY_MATRIX_TARGET_SSE2
+inline __m128 combine128(__m128 a0, __m128 a1, __m128 a2, __m128 a3, __m128 b) {
+    MY_MATRIX_NO_CONTRACT
+    __m128 sum = _mm_add_ps(_mm_mul_ps(a0, _mm_shuffle_ps(b, b, 0x00)), _mm_mul_ps(a1, _mm_shuffle_ps(b, b, 0x55)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_shuffle_ps(b, b, 0xAA)));
+    return _mm_add_ps(sum, _mm_mul_ps(a3, _mm_shuffle_ps(b, b, 0xFF)));
+}
+
+MY_MATRIX_TARGET_SSE2
+inline void multiplySSE2(const glm::mat4& a, const glm::mat4* in, glm::mat4* out, size_t n) {
+    const float* pa = floats(&a);
+    __m128 a0 = _mm_loadu_ps(pa), a1 = _mm_loadu_ps(pa + 4), a2 = _mm_loadu_ps(pa + 8), a3 = _mm_loadu_ps(pa + 12);
+    for (size_t i = 0; i < n; ++i) {
+        // 先把整个矩阵读进来再写，in 和 out 可以是同一个数组
+        const float* pb = floats(in + i);
+        __m128 b0 = _mm_loadu_ps(pb), b1 = _mm_loadu_ps(pb + 4), b2 = _mm_loadu_ps(pb + 8), b3 = _mm_loadu_ps(pb + 12);
+        float* r = floats(out + i);
+        _mm_storeu_ps(r, combine128(a0, a1, a2, a3, b0));
+        _mm_storeu_ps(r + 4, combine128(a0, a1, a2, a3, b1));
+        _mm_storeu_ps(r + 8, combine128(a0, a1, a2, a3, b2));
+        _mm_storeu_ps(r + 12, combine128(a0, a1, a2, a3, b3));
+    }
+}
+
+// 中心和半长按 SoA 一次算一组；矩阵元素 mRC 是第 R 列第 C 行，ABS 是这个宽度的取绝对值
+#define MY_MATRIX_AABB_LANES(P, V, local, world, i, m00, m01, m02, m10, m11, m12, m20, m21, m22, m30, m31, m32, ABS) \
+    {                                                                                                                      \
+        V cx = P##_loadu_ps(local->cx + i), cy = P##_loadu_ps(local->cy + i), cz = P##_loadu_ps(local->cz + i);          \
+        V ex = P##_loadu_ps(local->ex + i), ey = P##_loadu_ps(local->ey + i), ez = P##_loadu_ps(local->ez + i);          \
+        P##_storeu_ps(world->cx + i, P##_add_ps(P##_add_ps(P##_add_ps(P##_mul_ps(m00, cx), P##_mul_ps(m10, cy)), P##_mul_ps(m20, cz)), m30)); \
+        P##_storeu_ps(world->cy + i, P##_add_ps(P##_add_ps(P##_add_ps(P##_mul_ps(m01, cx), P##_mul_ps(m11, cy)), P##_mul_ps(m21, cz)), m31)); \
+        P##_storeu_ps(world->cz + i, P##_add_ps(P##_add_ps(P##_add_ps(P##_mul_ps(m02, cx), P##_mul_ps(m12, cy)), P##_mul_ps(m22, cz)), m32)); \
+        P##_storeu_ps(world->ex + i, P##_add_ps(P##_add_ps(P##_mul_ps(ABS(m00), ex), P##_mul_ps(ABS(m10), ey)), \
+                                               P##_mul_ps(ABS(m20), ez)));                                 \
+        P##_storeu_ps(world->ey + i, P##_add_ps(P##_add_ps(P##_mul_ps(ABS(m01), ex), P##_mul_ps(ABS(m11), ey)), \
+                                               P##_mul_ps(ABS(m21), ez)));                                 \
+        P##_storeu_ps(world->ez + i, P##_add_ps(P##_add_ps(P##_mul_ps(ABS(m02), ex), P##_mul_ps(ABS(m12), ey)), \
+                                               P##_mul_ps(ABS(m22), ez)));                                 \
+    }
+
+// 四元数 + 缩放合成旋转缩放部分的 9 个元素，每个变量是一组物体的同一个元素
+#define MY_MATRIX_COMPOSE_LANES(P, V, t, i)                                                                   \
+    V x = P##_loadu_ps(t.rx + i), y = P##_loadu_ps(t.ry + i), z = P##_loadu_ps(t.rz + i), w = P##_loadu_ps(t.rw + i); \
+    V xx = P##_mul_ps(x, x), yy = P##_mul_ps(y, y), zz = P##_mul_ps(z, z);                                    \
+    V xy = P##_mul_ps(x, y), xz = P##_mul_ps(x, z), yz = P##_mul_ps(y, z);                                    \
+    V wx = P##_mul_ps(w, x), wy = P##_mul_ps(w, y), wz = P##_mul_ps(w, z);                                    \
+    V sx = P##_loadu_ps(t.sx + i), sy = P##_loadu_ps(t.sy + i), sz = P##_loadu_ps(t.sz + i);                 \
+    V m00 = P##_mul_ps(P##_sub_ps(one, P##_mul_ps(two, P##_add_ps(yy, zz))), sx);                             \
+    V m01 = P##_mul_ps(P##_mul_ps(two, P##_add_ps(xy, wz)), sx);                                              \
+    V m02 = P##_mul_ps(P##_mul_ps(two, P##_sub_ps(xz, wy)), sx);                                              \
+    V m10 = P##_mul_ps(P##_mul_ps(two, P##_sub_ps(xy, wz)), sy);                                              \
+    V m11 = P##_mul_ps(P##_sub_ps(one, P##_mul_ps(two, P##_add_ps(xx, zz))), sy);                             \
+    V m12 = P##_mul_ps(P##_mul_ps(two, P##_add_ps(yz, wx)), sy);                                              \
+    V m20 = P##_mul_ps(P##_mul_ps(two, P##_add_ps(xz, wy)), sz);                                              \
+    V m21 = P##_mul_ps(P##_mul_ps(two, P##_sub_ps(yz, wx)), sz);                                              \
+    V m22 = P##_mul_ps(P##_sub_ps(one, P##_mul_ps(two, P##_add_ps(xx, yy))), sz);                             \
+    V m30 = P##_loadu_ps(t.px + i), m31 = P##_loadu_ps(t.py + i), m32 = P##_loadu_ps(t.pz + i);
+
+// 在每个 128 位通道内转置 4 个向量：(a, b, c, d) 的第 k 个元素 -> 第 k 个结果
+#define MY_MATRIX_TRANSPOSE_LANES(P, V, a, b, c, d)                                              \
+    {                                                                                            \
+        V t0 = P##_unpacklo_ps(a, b), t1 = P##_unpackhi_ps(a, b);                                \
+        V t2 = P##_unpacklo_ps(c, d), t3 = P##_unpackhi_ps(c, d);                                \
+        a = P##_shuffle_ps(t0, t2, 0x44);                                                        \
+        b = P##_shuffle_ps(t0, t2, 0xEE);                                                        \
+        c = P##_shuffle_ps(t1, t3, 0x44);                                                        \
+        d = P##_shuffle_ps(t1, t3, 0xEE);                                                        \
+    }
+
+MY_MATRIX_TARGET_SSE2
+inline void composeSSE2(const TRSColumns& t, size_t first, size_t last, glm::mat4* out,
+                        const ConstAABBColumns* local, const AABBColumns* world) {
+    MY_MATRIX_NO_CONTRACT
+    const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), zero = _mm_setzero_ps();
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        MY_MATRIX_COMPOSE_LANES(_mm, __m128, t, i)
+        if (local)
+            MY_MATRIX_AABB_LANES(_mm, __m128, local, world, i, m00, m01, m02, m10, m11, m12, m20, m21, m22, m30, m31, m32, abs128)
+
+        // 转置成每个物体一个矩阵：第 c 列 = (mc0, mc1, mc2, mc3) 的第 k 个元素
+        __m128 c0a = m00, c0b = m01, c0c = m02, c0d = zero;
+        __m128 c1a = m10, c1b = m11, c1c = m12, c1d = zero;
+        __m128 c2a = m20, c2b = m21, c2c = m22, c2d = zero;
+        __m128 c3a = m30, c3b = m31, c3c = m32, c3d = one;
+        MY_MATRIX_TRANSPOSE_LANES(_mm, __m128, c0a, c0b, c0c, c0d)
+        MY_MATRIX_TRANSPOSE_LANES(_mm, __m128, c1a, c1b, c1c, c1d)
+        MY_MATRIX_TRANSPOSE_LANES(_mm, __m128, c2a, c2b, c2c, c2d)
+        MY_MATRIX_TRANSPOSE_LANES(_mm, __m128, c3a, c3b, c3c, c3d)
+        float* r = floats(out + i);
+        _mm_storeu_ps(r + 0, c0a); _mm_storeu_ps(r + 4, c1a); _mm_storeu_ps(r + 8, c2a); _mm_storeu_ps(r + 12, c3a);
+        _mm_storeu_ps(r + 16, c0b); _mm_storeu_ps(r + 20, c1b); _mm_storeu_ps(r + 24, c2b); _mm_storeu_ps(r + 28, c3b);
+        _mm_storeu_ps(r + 32, c0c); _mm_storeu_ps(r + 36, c1c); _mm_storeu_ps(r + 40, c2c); _mm_storeu_ps(r + 44, c3c);
+        _mm_storeu_ps(r + 48, c0d); _mm_storeu_ps(r + 52, c1d); _mm_storeu_ps(r + 56, c2d); _mm_storeu_ps(r + 60, c3d);
+    }
+    composeScalar(t, i, last, out, local, world);
+}
+
+// 矩阵是 AoS 的，先把 4 个矩阵的同一列转置成 SoA 再算；更宽的路径也用这个，这一步是读矩阵的带宽在主导
+MY_MATRIX_TARGET_SSE2
+inline void transformAABBsSSE2(const glm::mat4* matrices, const ConstAABBColumns& local, const AABBColumns& world,
+                               size_t first, size_t last) {
+    MY_MATRIX_NO_CONTRACT
+    const ConstAABBColumns* in = &local;
+    const AABBColumns* out = &world;
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        const float* m = floats(matrices + i);
+        __m128 m00 = _mm_loadu_ps(m + 0), m01 = _mm_loadu_ps(m + 16), m02 = _mm_loadu_ps(m + 32), m03 = _mm_loadu_ps(m + 48);
+        __m128 m10 = _mm_loadu_ps(m + 4), m11 = _mm_loadu_ps(m + 20), m12 = _mm_loadu_ps(m + 36), m13 = _mm_loadu_ps(m + 52);
+        __m128 m20 = _mm_loadu_ps(m + 8), m21 = _mm_loadu_ps(m + 24), m22 = _mm_loadu_ps(m + 40), m23 = _mm_loadu_ps(m + 56);
+        __m128 m30 = _mm_loadu_ps(m + 12), m31 = _mm_loadu_ps(m + 28), m32 = _mm_loadu_ps(m + 44), m33 = _mm_loadu_ps(m + 60);
+        MY_MATRIX_TRANSPOSE_LANES(_mm, __m128, m00, m01, m02, m03)
+        MY_MATRIX_TRANSPOSE_LANES(_mm, __m128, m10, m11, m12, m13)
+        MY_MATRIX_TRANSPOSE_LANES(_mm, __m128, m20, m21, m22, m23)
+        MY_MATRIX_TRANSPOSE_LANES(_mm, __m128, m30, m31, m32, m33)
+        (void)m03; (void)m13; (void)m23; (void)m33;
+        MY_MATRIX_AABB_LANES(_mm, __m128, in, out, i, m00, m01, m02, m10, m11, m12, m20, m21, m22, m30, m31, m32, abs128)
+    }
+    transformAABBsScalar(matrices, local, world, i, last);
+}
+
+// ---- AVX2：8 个物体一组 ----
+
+MY_MATRIX_TARGET_AVX2
+inline __m256 abs256(__m256 v) { return _mm256_and_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF))); }
+
+// 两个 128 位通道各放一份 a 的列，一次算结果的两列
+MY_MATRIX_TARGET_AVX2
+inline __m256 combine256(__m256 a0, __m256 a1, __m256 a2, __m256 a3, __m256 b) {
+    MY_MATRIX_NO_CONTRACT
+    __m256 sum = _mm256_add_ps(_mm256_mul_ps(a0, _mm256_shuffle_ps(b, b, 0x00)), _mm256_mul_ps(a1, _mm256_shuffle_ps(b, b, 0x55)));
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(a2, _mm256_shuffle_ps(b, b, 0xAA)));
+    return _mm256_add_ps(sum, _mm256_mul_ps(a3, _mm256_shuffle_ps(b, b, 0xFF)));
+}
+
+MY_MATRIX_TARGET_AVX2
+inline void multiplyAVX2(const glm::mat4& a, const glm::mat4* in, glm::mat4* out, size_t n) {
+    const float* pa = floats(&a);
+    __m256 a0 = _mm256_broadcast_ps((const __m128*)pa), a1 = _mm256_broadcast_ps((const __m128*)(pa + 4));
+    __m256 a2 = _mm256_broadcast_ps((const __m128*)(pa + 8)), a3 = _mm256_broadcast_ps((const __m128*)(pa + 12));
+    for (size_t i = 0; i < n; ++i) {
+        const float* pb = floats(in + i);
+        __m256 b01 = _mm256_loadu_ps(pb), b23 = _mm256_loadu_ps(pb + 8);
+        float* r = floats(out + i);
+        _mm256_storeu_ps(r, combine256(a0, a1, a2, a3, b01));
+        _mm256_storeu_ps(r + 8, combine256(a0, a1, a2, a3, b23));
+    }
+}
+
+MY_MATRIX_TARGET_AVX2
+inline void composeAVX2(const TRSColumns& t, size_t first, size_t last, glm::mat4* out,
+                        const ConstAABBColumns* local, const AABBColumns* world) {
+    MY_MATRIX_NO_CONTRACT
+    const __m256 one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f), zero = _mm256_setzero_ps();
+    size_t i = first;
+    for (; i + 8 <= last; i += 8) {
+        MY_MATRIX_COMPOSE_LANES(_mm256, __m256, t, i)
+        if (local)
+            MY_MATRIX_AABB_LANES(_mm256, __m256, local, world, i, m00, m01, m02, m10, m11, m12, m20, m21, m22, m30, m31, m32, abs256)
+
+        // 通道内转置后 cXk 的低半是物体 k 的第 X 列，高半是物体 k + 4 的
+        __m256 c0[4] = { m00, m01, m02, zero }, c1[4] = { m10, m11, m12, zero };
+        __m256 c2[4] = { m20, m21, m22, zero }, c3[4] = { m30, m31, m32, one };
+        MY_MATRIX_TRANSPOSE_LANES(_mm256, __m256, c0[0], c0[1], c0[2], c0[3])
+        MY_MATRIX_TRANSPOSE_LANES(_mm256, __m256, c1[0], c1[1], c1[2], c1[3])
+        MY_MATRIX_TRANSPOSE_LANES(_mm256, __m256, c2[0], c2[1], c2[2], c2[3])
+        MY_MATRIX_TRANSPOSE_LANES(_mm256, __m256, c3[0], c3[1], c3[2], c3[3])
+        float* r = floats(out + i);
+        for (int k = 0; k < 4; ++k) {
+            _mm256_storeu_ps(r + k * 16, _mm256_permute2f128_ps(c0[k], c1[k], 0x20));
+            _mm256_storeu_ps(r + k * 16 + 8, _mm256_permute2f128_ps(c2[k], c3[k], 0x20));
+            _mm256_storeu_ps(r + (k + 4) * 16, _mm256_permute2f128_ps(c0[k], c1[k], 0x31));
+            _mm256_storeu_ps(r + (k + 4) * 16 + 8, _mm256_permute2f128_ps(c2[k], c3[k], 0x31));
+        }
+    }
+    composeScalar(t, i, last, out, local, world);
+}
+
+// ---- AVX-512：16 个物体一组，乘法一个寄存器放一整个矩阵 ----
+
+MY_MATRIX_TARGET_AVX512
+inline __m512 abs512(__m512 v) { return _mm512_abs_ps(v); }
+
+MY_MATRIX_TARGET_AVX512
+inline void multiplyAVX512(const glm::mat4& a, const glm::mat4* in, glm::mat4* out, size_t n) {
+    MY_MATRIX_NO_CONTRACT
+    const float* pa = floats(&a);
+    // 把 a 的每一列复制到 4 个 128 位通道
+    __m512 am = _mm512_loadu_ps(pa);
+    __m512 a0 = _mm512_shuffle_f32x4(am, am, 0x00), a1 = _mm512_shuffle_f32x4(am, am, 0x55);
+    __m512 a2 = _mm512_shuffle_f32x4(am, am, 0xAA), a3 = _mm512_shuffle_f32x4(am, am, 0xFF);
+    for (size_t i = 0; i < n; ++i) {
+        __m512 b = _mm512_loadu_ps(floats(in + i));
+        __m512 sum = _mm512_add_ps(_mm512_mul_ps(a0, _mm512_permute_ps(b, 0x00)), _mm512_mul_ps(a1, _mm512_permute_ps(b, 0x55)));
+        sum = _mm512_add_ps(sum, _mm512_mul_ps(a2, _mm512_permute_ps(b, 0xAA)));
+        sum = _mm512_add_ps(sum, _mm512_mul_ps(a3, _mm512_permute_ps(b, 0xFF)));
+        _mm512_storeu_ps(floats(out + i), sum);
+    }
+}
+
+MY_MATRIX_TARGET_AVX512
+inline void composeAVX512(const TRSColumns& t, size_t first, size_t last, glm::mat4* out,
+                          const ConstAABBColumns* local, const AABBColumns* world) {
+    MY_MATRIX_NO_CONTRACT
+    const __m512 one = _mm512_set1_ps(1.0f), two = _mm512_set1_ps(2.0f), zero = _mm512_setzero_ps();
+    size_t i = first;
+    for (; i + 16 <= last; i += 16) {
+        MY_MATRIX_COMPOSE_LANES(_mm512, __m512, t, i)
+        if (local)
+            MY_MATRIX_AABB_LANES(_mm512, __m512, local, world, i, m00, m01, m02, m10, m11, m12, m20, m21, m22, m30, m31, m32, abs512)
+
+        // 通道内转置后 cXk 的 4 个通道依次是物体 k、k + 4、k + 8、k + 12 的第 X 列，
+        // 再用两级 128 位重排把同一个物体的 4 列拼成一个寄存器
+        __m512 c0[4] = { m00, m01, m02, zero }, c1[4] = { m10, m11, m12, zero };
+        __m512 c2[4] = { m20, m21, m22, zero }, c3[4] = { m30, m31, m32, one };
+        MY_MATRIX_TRANSPOSE_LANES(_mm512, __m512, c0[0], c0[1], c0[2], c0[3])
+        MY_MATRIX_TRANSPOSE_LANES(_mm512, __m512, c1[0], c1[1], c1[2], c1[3])
+        MY_MATRIX_TRANSPOSE_LANES(_mm512, __m512, c2[0], c2[1], c2[2], c2[3])
+        MY_MATRIX_TRANSPOSE_LANES(_mm512, __m512, c3[0], c3[1], c3[2], c3[3])
+        float* r = floats(out + i);
+        for (int k = 0; k < 4; ++k) {
+            __m512 lo01 = _mm512_shuffle_f32x4(c0[k], c1[k], 0x44), lo23 = _mm512_shuffle_f32x4(c2[k], c3[k], 0x44);
+            __m512 hi01 = _mm512_shuffle_f32x4(c0[k], c1[k], 0xEE), hi23 = _mm512_shuffle_f32x4(c2[k], c3[k], 0xEE);
+            _mm512_storeu_ps(r + k * 16, _mm512_shuffle_f32x4(lo01, lo23, 0x88));
+            _mm512_storeu_ps(r + (k + 4) * 16, _mm512_shuffle_f32x4(lo01, lo23, 0xDD));
+            _mm512_storeu_ps(r + (k + 8) * 16, _mm512_shuffle_f32x4(hi01, hi23, 0x88));
+            _mm512_storeu_ps(r + (k + 12) * 16, _mm512_shuffle_f32x4(hi01, hi23, 0xDD));
+        }
+    }
+    composeScalar(t, i, last, out, local, world);
+}
+
+#undef MY_MATRIX_AABB_LANES
+#undef MY_MATRIX_COMPOSE_LANES
+#undef MY_MATRIX_TRANSPOSE_LANES
+
+inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)subleaf);
+    for (int k = 0; k < 4; ++k)
+        regs[k] = (uint32_t)r[k];
+#else
+    if (!__get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]))
+        regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#endif
+}
+
+// 操作系统在上下文切换时保存哪些寄存器状态（XCR0）
+inline uint64_t xcr0() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    uint32_t lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+#endif
+}
+
+#endif // MY_MATRIX_X86
+
+// 这台机器上能用的最宽路径：指令集要 CPU 支持，对应的寄存器状态还要操作系统保存
+inline MathPath detectPath() {
+#if defined(MY_MATRIX_X86)
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    uint32_t maxLeaf = regs[0];
+    cpuid(1, 0, regs);
+    bool sse2 = (regs[3] >> 26) & 1;
+    bool osxsave = (regs[2] >> 27) & 1;
+    bool avx = (regs[2] >> 28) & 1;
+    if (!sse2)
+        return MathPath::Scalar;
+    if (!osxsave || !avx || maxLeaf < 7)
+        return MathPath::SSE2;
+    uint64_t xcr = xcr0();
+    bool ymmState = (xcr & 0x6) == 0x6;        // XMM + YMM
+    bool zmmState = (xcr & 0xE6) == 0xE6;      // 再加 opmask 和 ZMM 的高低两半
+    cpuid(7, 0, regs);
+    bool avx2 = (regs[1] >> 5) & 1;
+    bool avx512f = (regs[1] >> 16) & 1;
+    if (avx512f && zmmState)
+        return MathPath::AVX512;
+    if (avx2 && ymmState)
+        return MathPath::AVX2;
+    return MathPath::SSE2;
+#else
+    return MathPath::Scalar;
+#endif
+}
+
+} // namespace matrix_detail
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+#endif
+
+// 按 CPU 选好的函数表；正常用 matrixKernels() 取全局那份
+// setPath 只用于基准对比和排查，不要在别的线程正在调用内核时切换
+class MatrixKernels {
+public:
+    MatrixKernels() : best(matrix_detail::detectPath()) { setPath(best); }
+
+    MathPath supportedPath() const { return best; }
+    MathPath path() const { return current; }
+
+    // 强制走某条路径，超出这台机器能力时退回支持的最宽路径；返回实际使用的路径
+    MathPath setPath(MathPath wanted) {
+        current = (int)wanted > (int)best ? best : wanted;
+        multiplyFn = matrix_detail::multiplyScalar;
+        composeFn = matrix_detail::composeScalar;
+        aabbFn = matrix_detail::transformAABBsScalar;
+#if defined(MY_MATRIX_X86)
+        switch (current) {
+        case MathPath::AVX512:
+            multiplyFn = matrix_detail::multiplyAVX512;
+            composeFn = matrix_detail::composeAVX512;
+            aabbFn = matrix_detail::transformAABBsSSE2;
+            break;
+        case MathPath::AVX2:
+            multiplyFn = matrix_detail::multiplyAVX2;
+            composeFn = matrix_detail::composeAVX2;
+            aabbFn = matrix_detail::transformAABBsSSE2;
+            break;
+        case MathPath::SSE2:
+            multiplyFn = matrix_detail::multiplySSE2;
+            composeFn = matrix_detail::composeSSE2;
+            aabbFn = matrix_detail::transformAABBsSSE2;
+            break;
+        default:
+            break;
+        }
+#endif
+        return current;
+    }
+
+    // out[i] = a * in[i]，i < n；in 和 out 可以是同一个数组，a 不能在 out 里
+    void multiply(const glm::mat4& a, const glm::mat4* in, glm::mat4* out, size_t n) const {
+        multiplyFn(a, in, out, n);
+    }
+
+    // 槽位 [first, last) 的 TRS 合成 T * R * S 写进 out[i]；local 非空时把 local 的包围盒用合成的矩阵变换到 world
+    void composeTransforms(const TRSColumns& trs, size_t first, size_t last, glm::mat4* out,
+                           const ConstAABBColumns* local = nullptr, const AABBColumns* world = nullptr) const {
+        composeFn(trs, first, last, out, local, world);
+    }
+
+    // world[i] = matrices[i] 变换后的 local[i]，i 属于 [first, last)
+    void transformAABBs(const glm::mat4* matrices, const ConstAABBColumns& local, const AABBColumns& world,
+                        size_t first, size_t last) const {
+        aabbFn(matrices, local, world, first, last);
+    }
+
+private:
+    typedef void (*MultiplyFn)(const glm::mat4&, const glm::mat4*, glm::mat4*, size_t);
+    typedef void (*ComposeFn)(const TRSColumns&, size_t, size_t, glm::mat4*, const ConstAABBColumns*, const AABBColumns*);
+    typedef void (*AABBFn)(const glm::mat4*, const ConstAABBColumns&, const AABBColumns&, size_t, size_t);
+
+    MathPath best;
+    MathPath current = MathPath::Scalar;
+    MultiplyFn multiplyFn = nullptr;
+    ComposeFn composeFn = nullptr;
+    AABBFn aabbFn = nullptr;
+};
+
+inline MatrixKernels& matrixKernels() {
+    static MatrixKernels kernels;
+    return kernels;
+}
+
+#endif
@@ -0,0 +1,1204 @@
+#ifndef MESH_IMPORT_H
+#define MESH_IMPORT_H
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include "my_mappedFile.h"
+#include "my_jobSystem.h"
+#include "my_json.h"
+#include "my_meshOptimizer.h"
+
+// 网格导入：OBJ 和 glTF 2.0（.gltf + .bin / data URI，或 .glb）解析成统一的交错顶点 + 32 位索引 + 子网格表
+// 文本解析是一次性的开销：结果写成二进制缓存（model.obj -> model.obj.mesh），之后内存映射直接用，
+// 顶点和索引在缓存里首尾相连，StaticMesh 一次 glBufferData 就能从映射上传，不再解析
+// 不调用 GL，解析可以放在工作线程里；带 JobSystem 时 OBJ 分块并行解析，子网格的去重 / 优化也并行
+
+// 交错顶点：位置、法线、uv，32 字节
+struct MeshVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 uv;
+};
+static_assert(sizeof(MeshVertex) == 32, "MeshVertex is written to the mesh cache as is");
+
+// 一个材质一个子网格；索引是整个顶点数组里的绝对下标，可以直接 glDrawElements
+struct SubMesh {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint32_t firstVertex = 0; // 子网格用到的顶点是连续的一段
+    uint32_t vertexCount = 0;
+    uint32_t material = 0;    // MeshData::materials 的下标
+    uint32_t reserved = 0;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+};
+static_assert(sizeof(SubMesh) == 48, "SubMesh is written to the mesh cache as is");
+
+// 导入结果：顶点 / 索引要么自己持有，要么指向缓存文件的映射（和 MipChain 一样）
+struct MeshData {
+    std::vector<MeshVertex> vertexStorage;
+    std::vector<uint32_t> indexStorage;
+    std::shared_ptr<const MappedFile> mapping;
+    size_t vertexOffset = 0; // 映射里顶点的字节偏移，索引紧跟在顶点后面
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+
+    std::vector<SubMesh> submeshes;
+    std::vector<std::string> materials;
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+
+    explicit operator bool() const { return vertexCount > 0 && indexCount > 0; }
+    size_t triangleCount() const { return indexCount / 3; }
+
+    const MeshVertex* vertices() const {
+        return mapping ? reinterpret_cast<const MeshVertex*>(mapping->data() + vertexOffset) : vertexStorage.data();
+    }
+    const uint32_t* indices() const {
+        return mapping ? reinterpret_cast<const uint32_t*>(mapping->data() + vertexOffset + vertexBytes())
+                       : indexStorage.data();
+    }
+    size_t vertexBytes() const { return vertexCount * sizeof(MeshVertex); }
+    size_t indexBytes() const { return indexCount * sizeof(uint32_t); }
+
+    // 映射的网格顶点和索引是连续的一块，可以一次上传；自己持有的网格返回 nullptr
+    const uint8_t* contiguousGeometry() const { return mapping ? mapping->data() + vertexOffset : nullptr; }
+};
+
+namespace mesh_import_detail {
+
+using Clock = std::chrono::steady_clock;
+
+inline uint64_t elapsedUs(Clock::time_point start) {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+}
+
+// 并行跑 count 个任务并等待（当前线程也参与）；没有任务系统时直接在当前线程跑
+template <typename F>
+void forEachTask(size_t count, JobSystem* jobs, F fn) {
+    if (!jobs) {
+        for (size_t i = 0; i < count; ++i)
+            fn(i);
+        return;
+    }
+    jobs->parallelFor(0, count, [&fn](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            fn(i);
+    }, 1);
+}
+
+// 一个子网格的中间结果：索引是子网格内的局部下标
+struct SubMeshBuild {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    uint32_t material = 0;
+    bool needsNormals = false; // 有的顶点法线是 0（源文件没给），组装时按面积加权生成
+};
+
+// 给法线为 0 的顶点生成面积加权的平滑法线
+inline void generateMissingNormals(SubMeshBuild& build) {
+    std::vector<char> missing(build.vertices.size());
+    for (size_t i = 0; i < build.vertices.size(); ++i)
+        missing[i] = build.vertices[i].normal == glm::vec3(0.0f);
+    for (size_t t = 0; t + 2 < build.indices.size(); t += 3) {
+        MeshVertex& a = build.vertices[build.indices[t]];
+        MeshVertex& b = build.vertices[build.indices[t + 1]];
+        MeshVertex& c = build.vertices[build.indices[t + 2]];
+        // 叉积不归一化，长度就是面积的两倍，大三角形权重大
+        glm::vec3 n = glm::cross(b.position - a.position, c.position - a.position);
+        if (missing[build.indices[t]]) a.normal += n;
+        if (missing[build.indices[t + 1]]) b.normal += n;
+        if (missing[build.indices[t + 2]]) c.normal += n;
+    }
+    for (size_t i = 0; i < build.vertices.size(); ++i) {
+        if (!missing[i])
+            continue;
+        glm::vec3& n = build.vertices[i].normal;
+        float length = glm::length(n);
+        n = length > 0.0f ? n / length : glm::vec3(0.0f, 1.0f, 0.0f);
+    }
+}
+
+// 生成法线、可选的顶点缓存 / 读取优化、包围盒，然后把所有子网格拼成一个网格（索引改成绝对下标）
+inline void assemble(std::vector<SubMeshBuild>& builds, std::vector<std::string> materials, bool optimize,
+                     JobSystem* jobs, MeshData& out) {
+    // 空的子网格（材质切换了但没有面）去掉
+    builds.erase(std::remove_if(builds.begin(), builds.end(), [](const SubMeshBuild& b) { return b.indices.empty(); }),
+                 builds.end());
+
+    std::vector<SubMesh> submeshes(builds.size());
+    forEachTask(builds.size(), jobs, [&](size_t i) {
+        SubMeshBuild& build = builds[i];
+        if (build.needsNormals)
+            generateMissingNormals(build);
+        if (optimize) {
+            optimizeVertexCache(build.indices, build.vertices.size());
+            std::vector<MeshVertex> reordered(build.vertices.size());
+            size_t kept = optimizeVertexFetch(reordered.data(), build.vertices.data(), build.vertices.size(),
+                                              sizeof(MeshVertex), build.indices.data(), build.indices.size());
+            reordered.resize(kept);
+            build.vertices.swap(reordered);
+        }
+        SubMesh& sub = submeshes[i];
+        sub.material = build.material;
+        sub.indexCount = (uint32_t)build.indices.size();
+        sub.vertexCount = (uint32_t)build.vertices.size();
+        sub.boundsMin = glm::vec3(INFINITY);
+        sub.boundsMax = glm::vec3(-INFINITY);
+        for (const MeshVertex& v : build.vertices) {
+            sub.boundsMin = glm::min(sub.boundsMin, v.position);
+            sub.boundsMax = glm::max(sub.boundsMax, v.position);
+        }
+    });
+
+    size_t vertexCount = 0, indexCount = 0;
+    for (SubMesh& sub : submeshes) {
+        sub.firstVertex = (uint32_t)vertexCount;
+        sub.firstIndex = (uint32_t)indexCount;
+        vertexCount += sub.vertexCount;
+        indexCount += sub.indexCount;
+    }
+    out.vertexStorage.resize(vertexCount);
+    out.indexStorage.resize(indexCount);
+    forEachTask(builds.size(), jobs, [&](size_t i) {
+        const SubMesh& sub = submeshes[i];
+        std::copy(builds[i].vertices.begin(), builds[i].vertices.end(), out.vertexStorage.begin() + sub.firstVertex);
+        uint32_t* indices = out.indexStorage.data() + sub.firstIndex;
+        for (size_t k = 0; k < builds[i].indices.size(); ++k)
+            indices[k] = builds[i].indices[k] + sub.firstVertex;
+        std::vector<MeshVertex>().swap(builds[i].vertices);
+        std::vector<uint32_t>().swap(builds[i].indices);
+    });
+
+    out.vertexCount = vertexCount;
+    out.indexCount = indexCount;
+    out.boundsMin = glm::vec3(submeshes.empty() ? 0.0f : INFINITY);
+    out.boundsMax = glm::vec3(submeshes.empty() ? 0.0f : -INFINITY);
+    for (const SubMesh& sub : submeshes) {
+        out.boundsMin = glm::min(out.boundsMin, sub.boundsMin);
+        out.boundsMax = glm::max(out.boundsMax, sub.boundsMax);
+    }
+    out.submeshes = std::move(submeshes);
+    out.materials = std::move(materials);
+}
+
+// ---- OBJ ----
+
+// 比 strtod 快得多的 float 解析（不依赖 locale），精度对网格数据足够；p 不会越过 end
+inline const char* parseFloat(const char* p, const char* end, float& out) {
+    static const double POW10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    while (p < end && (*p == ' ' || *p == '\t'))
+        ++p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    // 超过 17 位有效数字的部分丢掉，只记指数
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        if (mantissa < 100000000000000000ull)
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        else
+            ++exponent;
+    }
+    if (p < end && *p == '.') {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p)
+            if (mantissa < 100000000000000000ull) {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                --exponent;
+            }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            negativeExponent = *p++ == '-';
+        int e = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p)
+            if (e < 10000)
+                e = e * 10 + (*p - '0');
+        exponent += negativeExponent ? -e : e;
+    }
+    double value = (double)mantissa;
+    if (exponent < 0)
+        value = exponent >= -22 ? value / POW10[-exponent] : value * std::pow(10.0, exponent);
+    else if (exponent > 0)
+        value = exponent <= 22 ? value * POW10[exponent] : value * std::pow(10.0, exponent);
+    out = (float)(negative ? -value : value);
+    return p;
+}
+
+inline const char* parseInt(const char* p, const char* end, int64_t& out, bool& valid) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = *p++ == '-';
+    const char* digits = p;
+    int64_t value = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p)
+        if (value < ((int64_t)1 << 40))
+            value = value * 10 + (*p - '0');
+    valid = p != digits;
+    out = negative ? -value : value;
+    return p;
+}
+
+// 一个角的 v / vt / vn，已经换成 0 开始的全局下标，-1 表示没有
+struct ObjCorner {
+    int32_t v, vt, vn;
+};
+
+// 一块文本的解析结果
+struct ObjChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    // 第一遍统计的数量，前缀和以后就是这一块之前的总数，用来解析负数下标
+    size_t positionCount = 0, uvCount = 0, normalCount = 0;
+    size_t positionBase = 0, uvBase = 0, normalBase = 0;
+
+    std::vector<float> positions, uvs, normals;
+    std::vector<ObjCorner> corners; // 每 3 个一个三角形（多边形已经扇形三角化）
+    // 材质切换：从第 triangle 个三角形开始用 name
+    struct MaterialSwitch {
+        size_t triangle;
+        std::string name;
+    };
+    std::vector<MaterialSwitch> materialSwitches;
+    size_t badIndices = 0;
+};
+
+inline bool startsWith(const char* p, const char* end, const char* word) {
+    size_t n = std::strlen(word);
+    return (size_t)(end - p) >= n && std::memcmp(p, word, n) == 0;
+}
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+// 第一遍：只数 v / vt / vn 的行数
+inline void countObjChunk(ObjChunk& chunk) {
+    for (const char* p = chunk.begin; p < chunk.end;) {
+        const char* line = static_cast<const char*>(std::memchr(p, '\n', (size_t)(chunk.end - p)));
+        const char* lineEnd = line ? line : chunk.end;
+        while (p < lineEnd && isSpace(*p))
+            ++p;
+        if (lineEnd - p >= 2 && p[0] == 'v') {
+            if (isSpace(p[1])) ++chunk.positionCount;
+            else if (p[1] == 't' && lineEnd - p >= 3 && isSpace(p[2])) ++chunk.uvCount;
+            else if (p[1] == 'n' && lineEnd - p >= 3 && isSpace(p[2])) ++chunk.normalCount;
+        }
+        p = lineEnd + 1;
+    }
+}
+
+// OBJ 下标：正数从 1 开始，负数相对当前已读的数量；越界的记 -1 并计数
+inline int32_t resolveObjIndex(int64_t index, size_t countSoFar, size_t total, size_t& badIndices) {
+    int64_t resolved = index > 0 ? index - 1 : (int64_t)countSoFar + index;
+    if (index == 0 || resolved < 0 || resolved >= (int64_t)total) {
+        ++badIndices;
+        return -1;
+    }
+    return (int32_t)resolved;
+}
+
+// 第二遍：真正解析一块；totals 是全文件的数量（用来检查下标）
+inline void parseObjChunk(ObjChunk& chunk, size_t totalPositions, size_t totalUVs, size_t totalNormals) {
+    chunk.positions.reserve(chunk.positionCount * 3);
+    chunk.uvs.reserve(chunk.uvCount * 2);
+    chunk.normals.reserve(chunk.normalCount * 3);
+    std::vector<ObjCorner> polygon;
+
+    for (const char* p = chunk.begin; p < chunk.end;) {
+        const char* line = static_cast<const char*>(std::memchr(p, '\n', (size_t)(chunk.end - p)));
+        const char* lineEnd = line ? line : chunk.end;
+        const char* next = lineEnd + 1;
+        if (lineEnd > p && lineEnd[-1] == '\r')
+            --lineEnd;
+        while (p < lineEnd && isSpace(*p))
+            ++p;
+
+        if (lineEnd - p >= 2 && p[0] == 'v' && isSpace(p[1])) {
+            float x, y, z;
+            p = parseFloat(p + 2, lineEnd, x);
+            p = parseFloat(p, lineEnd, y);
+            parseFloat(p, lineEnd, z);
+            chunk.positions.insert(chunk.positions.end(), { x, y, z });
+        } else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && isSpace(p[2])) {
+            float u, v = 0.0f;
+            p = parseFloat(p + 3, lineEnd, u);
+            parseFloat(p, lineEnd, v);
+            chunk.uvs.insert(chunk.uvs.end(), { u, v });
+        } else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 'n' && isSpace(p[2])) {
+            float x, y, z;
+            p = parseFloat(p + 3, lineEnd, x);
+            p = parseFloat(p, lineEnd, y);
+            parseFloat(p, lineEnd, z);
+            chunk.normals.insert(chunk.normals.end(), { x, y, z });
+        } else if (lineEnd - p >= 2 && p[0] == 'f' && isSpace(p[1])) {
+            size_t positionsSoFar = chunk.positionBase + chunk.positions.size() / 3;
+            size_t uvsSoFar = chunk.uvBase + chunk.uvs.size() / 2;
+            size_t normalsSoFar = chunk.normalBase + chunk.normals.size() / 3;
+            polygon.clear();
+            p += 2;
+            for (;;) {
+                while (p < lineEnd && isSpace(*p))
+                    ++p;
+                if (p >= lineEnd)
+                    break;
+                int64_t index;
+                bool valid;
+                ObjCorner corner{ -1, -1, -1 };
+                p = parseInt(p, lineEnd, index, valid);
+                if (!valid) {
+                    ++chunk.badIndices;
+                    break;
+                }
+                corner.v = resolveObjIndex(index, positionsSoFar, totalPositions, chunk.badIndices);
+                if (p < lineEnd && *p == '/') {
+                    ++p;
+                    if (p < lineEnd && *p != '/') {
+                        p = parseInt(p, lineEnd, index, valid);
+                        if (valid)
+                            corner.vt = resolveObjIndex(index, uvsSoFar, totalUVs, chunk.badIndices);
+                    }
+                    if (p < lineEnd && *p == '/') {
+                        p = parseInt(p + 1, lineEnd, index, valid);
+                        if (valid)
+                            corner.vn = resolveObjIndex(index, normalsSoFar, totalNormals, chunk.badIndices);
+                    }
+                }
+                // 跳过这个角剩下的字符（格式不对的部分）
+                while (p < lineEnd && !isSpace(*p))
+                    ++p;
+                polygon.push_back(corner);
+            }
+            // 位置下标无效的面整个丢掉
+            bool usable = polygon.size() >= 3;
+            for (const ObjCorner& c : polygon)
+                usable = usable && c.v >= 0;
+            if (usable)
+                for (size_t i = 1; i + 1 < polygon.size(); ++i)
+                    chunk.corners.insert(chunk.corners.end(), { polygon[0], polygon[i], polygon[i + 1] });
+        } else if (startsWith(p, lineEnd, "usemtl") && lineEnd - p > 6 && isSpace(p[6])) {
+            p += 7;
+            while (p < lineEnd && isSpace(*p))
+                ++p;
+            const char* nameEnd = lineEnd;
+            while (nameEnd > p && isSpace(nameEnd[-1]))
+                --nameEnd;
+            chunk.materialSwitches.push_back({ chunk.corners.size() / 3, std::string(p, nameEnd) });
+        }
+        p = next;
+    }
+}
+
+// 一个材质的所有三角形：按 (v, vt, vn) 去重成顶点
+inline void buildObjSubMesh(const std::vector<ObjCorner>& corners, const std::vector<ObjChunk>& chunks,
+                            const std::vector<size_t>& positionChunk, SubMeshBuild& build) {
+    // 全局下标 -> (块, 块内下标)；下标按块递增，二分找块
+    auto fetch = [&](int32_t index, size_t ObjChunk::*base, const std::vector<float> ObjChunk::*data, int floats,
+                     float* out) {
+        size_t chunkIndex = std::upper_bound(positionChunk.begin(), positionChunk.end(), (size_t)index,
+                                             [&](size_t value, size_t c) { return value < chunks[c].*base; }) - positionChunk.begin() - 1;
+        const ObjChunk& chunk = chunks[chunkIndex];
+        std::memcpy(out, (chunk.*data).data() + ((size_t)index - chunk.*base) * floats, floats * sizeof(float));
+    };
+
+    size_t tableSize = 1;
+    while (tableSize < corners.size() * 2)
+        tableSize <<= 1;
+    const uint32_t EMPTY = ~0u;
+    std::vector<uint32_t> table(tableSize, EMPTY);
+    std::vector<ObjCorner> keys;
+    build.indices.resize(corners.size());
+
+    for (size_t i = 0; i < corners.size(); ++i) {
+        const ObjCorner& c = corners[i];
+        uint64_t hash = ((uint64_t)(uint32_t)c.v * 0x9E3779B97F4A7C15ull) ^ ((uint64_t)(uint32_t)c.vt * 0xC2B2AE3D27D4EB4Full)
+                        ^ ((uint64_t)(uint32_t)c.vn * 0x165667B19E3779F9ull);
+        hash ^= hash >> 32;
+        size_t slot = hash & (tableSize - 1);
+        while (table[slot] != EMPTY) {
+            const ObjCorner& k = keys[table[slot]];
+            if (k.v == c.v && k.vt == c.vt && k.vn == c.vn)
+                break;
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        if (table[slot] == EMPTY) {
+            table[slot] = (uint32_t)keys.size();
+            keys.push_back(c);
+            MeshVertex vertex{};
+            fetch(c.v, &ObjChunk::positionBase, &ObjChunk::positions, 3, &vertex.position.x);
+            if (c.vt >= 0)
+                fetch(c.vt, &ObjChunk::uvBase, &ObjChunk::uvs, 2, &vertex.uv.x);
+            if (c.vn >= 0)
+                fetch(c.vn, &ObjChunk::normalBase, &ObjChunk::normals, 3, &vertex.normal.x);
+            else
+                build.needsNormals = true;
+            build.vertices.push_back(vertex);
+        }
+        build.indices[i] = table[slot];
+    }
+}
+
+inline bool importOBJ(const uint8_t* data, size_t size, MeshData& out, JobSystem* jobs, bool optimize,
+                      std::string* error) {
+    const char* text = reinterpret_cast<const char*>(data);
+    const char* end = text + size;
+
+    // 按行边界切块：每块至少 1 MiB，线程多时切得更细一些方便负载均衡
+    size_t workers = jobs ? jobs->size() : 1;
+    size_t chunkBytes = std::max<size_t>(1 << 20, size / (workers * 4) + 1);
+    std::vector<ObjChunk> chunks;
+    for (const char* p = text; p < end;) {
+        const char* chunkEnd = p + std::min(chunkBytes, (size_t)(end - p));
+        if (chunkEnd < end) {
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', (size_t)(end - chunkEnd)));
+            chunkEnd = newline ? newline + 1 : end;
+        }
+        chunks.emplace_back();
+        chunks.back().begin = p;
+        chunks.back().end = chunkEnd;
+        p = chunkEnd;
+    }
+
+    forEachTask(chunks.size(), jobs, [&](size_t i) { countObjChunk(chunks[i]); });
+    size_t positions = 0, uvs = 0, normals = 0;
+    for (ObjChunk& chunk : chunks) {
+        chunk.positionBase = positions;
+        chunk.uvBase = uvs;
+        chunk.normalBase = normals;
+        positions += chunk.positionCount;
+        uvs += chunk.uvCount;
+        normals += chunk.normalCount;
+    }
+    forEachTask(chunks.size(), jobs, [&](size_t i) { parseObjChunk(chunks[i], positions, uvs, normals); });
+
+    // 按材质把三角形分桶；材质状态跨块延续，没有 usemtl 的面归到名字为空的材质
+    std::vector<std::string> materials;
+    std::vector<std::vector<ObjCorner>> buckets;
+    auto materialIndex = [&](const std::string& name) {
+        auto it = std::find(materials.begin(), materials.end(), name);
+        if (it != materials.end())
+            return (size_t)(it - materials.begin());
+        materials.push_back(name);
+        buckets.emplace_back();
+        return materials.size() - 1;
+    };
+    size_t current = SIZE_MAX;
+    size_t badIndices = 0;
+    for (ObjChunk& chunk : chunks) {
+        badIndices += chunk.badIndices;
+        size_t triangles = chunk.corners.size() / 3;
+        size_t first = 0;
+        for (size_t s = 0; s <= chunk.materialSwitches.size(); ++s) {
+            size_t last = s < chunk.materialSwitches.size() ? chunk.materialSwitches[s].triangle : triangles;
+            if (last > first) {
+                if (current == SIZE_MAX)
+                    current = materialIndex("");
+                std::vector<ObjCorner>& bucket = buckets[current];
+                bucket.insert(bucket.end(), chunk.corners.begin() + first * 3, chunk.corners.begin() + last * 3);
+            }
+            if (s < chunk.materialSwitches.size())
+                current = materialIndex(chunk.materialSwitches[s].name);
+            first = last;
+        }
+        std::vector<ObjCorner>().swap(chunk.corners);
+    }
+    if (badIndices > 0)
+        std::cerr << "ERROR::MESH_IMPORT::OBJ_BAD_INDICES: " << badIndices << " out-of-range or malformed indices skipped"
+                  << std::endl;
+
+    // 每块的起始下标，给去重时按全局下标找数据用（三种数据各自的前缀和单调递增，共用一个块序号表）
+    std::vector<size_t> chunkOrder(chunks.size());
+    for (size_t i = 0; i < chunks.size(); ++i)
+        chunkOrder[i] = i;
+
+    std::vector<SubMeshBuild> builds(buckets.size());
+    forEachTask(buckets.size(), jobs, [&](size_t i) {
+        builds[i].material = (uint32_t)i;
+        buildObjSubMesh(buckets[i], chunks, chunkOrder, builds[i]);
+        std::vector<ObjCorner>().swap(buckets[i]);
+    });
+
+    assemble(builds, std::move(materials), optimize, jobs, out);
+    if (!out) {
+        if (error)
+            *error = "no faces";
+        return false;
+    }
+    return true;
+}
+
+// ---- glTF ----
+
+inline int base64Value(char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+' || c == '-') return 62;
+    if (c == '/' || c == '_') return 63;
+    return -1;
+}
+
+inline std::vector<uint8_t> decodeBase64(const char* p, const char* end) {
+    std::vector<uint8_t> out;
+    out.reserve((size_t)(end - p) / 4 * 3);
+    uint32_t bits = 0;
+    int count = 0;
+    for (; p < end; ++p) {
+        int value = base64Value(*p);
+        if (value < 0)
+            continue; // '=' 填充和换行
+        bits = (bits << 6) | (uint32_t)value;
+        count += 6;
+        if (count >= 8) {
+            count -= 8;
+            out.push_back((uint8_t)(bits >> count));
+        }
+    }
+    return out;
+}
+
+// URI 里的 %20 之类
+inline std::string decodeURI(const std::string& uri) {
+    std::string out;
+    for (size_t i = 0; i < uri.size(); ++i) {
+        if (uri[i] == '%' && i + 2 < uri.size()) {
+            out += (char)std::strtol(uri.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        } else {
+            out += uri[i];
+        }
+    }
+    return out;
+}
+
+struct GltfBuffer {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+// 一个 accessor 的读取视图
+struct GltfAccessor {
+    const uint8_t* data = nullptr;
+    size_t count = 0;
+    size_t stride = 0;
+    int componentType = 0;
+    int components = 0;
+    bool normalized = false;
+
+    explicit operator bool() const { return data != nullptr; }
+
+    float readFloat(size_t i, int c) const {
+        const uint8_t* p = data + i * stride;
+        switch (componentType) {
+        case 5126: { float v; std::memcpy(&v, p + c * 4, 4); return v; }
+        case 5121: return normalized ? p[c] / 255.0f : (float)p[c];
+        case 5120: return normalized ? std::max((int8_t)p[c] / 127.0f, -1.0f) : (float)(int8_t)p[c];
+        case 5123: { uint16_t v; std::memcpy(&v, p + c * 2, 2); return normalized ? v / 65535.0f : (float)v; }
+        case 5122: { int16_t v; std::memcpy(&v, p + c * 2, 2); return normalized ? std::max(v / 32767.0f, -1.0f) : (float)v; }
+        default: return 0.0f;
+        }
+    }
+
+    uint32_t readIndex(size_t i) const {
+        const uint8_t* p = data + i * stride;
+        switch (componentType) {
+        case 5121: return p[0];
+        case 5123: { uint16_t v; std::memcpy(&v, p, 2); return v; }
+        case 5125: { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        default: return 0;
+        }
+    }
+};
+
+inline int gltfComponentSize(int componentType) {
+    switch (componentType) {
+    case 5120: case 5121: return 1;
+    case 5122: case 5123: return 2;
+    case 5125: case 5126: return 4;
+    default: return 0;
+    }
+}
+
+inline int gltfComponentCount(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    if (type == "MAT4") return 16;
+    return 0;
+}
+
+// 检查范围后返回视图；不支持或越界时返回空视图（sparse accessor 不支持）
+inline GltfAccessor gltfAccessor(const JsonValue& root, const std::vector<GltfBuffer>& buffers, const JsonValue& index) {
+    GltfAccessor view;
+    if (!index.isNumber())
+        return view;
+    const JsonValue& accessor = root["accessors"][index.asSize(SIZE_MAX)];
+    const JsonValue& bufferView = root["bufferViews"][accessor["bufferView"].asSize(SIZE_MAX)];
+    size_t bufferIndex = bufferView["buffer"].asSize(SIZE_MAX);
+    if (!accessor.isObject() || !bufferView.isObject() || bufferIndex >= buffers.size() || accessor.has("sparse"))
+        return view;
+    int componentSize = gltfComponentSize(accessor["componentType"].asInt());
+    int components = gltfComponentCount(accessor["type"].asString());
+    if (componentSize == 0 || components == 0)
+        return view;
+    size_t elementSize = (size_t)componentSize * components;
+    size_t count = accessor["count"].asSize();
+    size_t stride = bufferView["byteStride"].asSize(elementSize);
+    size_t offset = bufferView["byteOffset"].asSize() + accessor["byteOffset"].asSize();
+    size_t viewEnd = bufferView["byteOffset"].asSize() + bufferView["byteLength"].asSize();
+    const GltfBuffer& buffer = buffers[bufferIndex];
+    if (count == 0 || stride < elementSize || viewEnd > buffer.size || offset + (count - 1) * stride + elementSize > viewEnd)
+        return view;
+    view.data = buffer.data + offset;
+    view.count = count;
+    view.stride = stride;
+    view.componentType = accessor["componentType"].asInt();
+    view.components = components;
+    view.normalized = accessor["normalized"].asBool();
+    return view;
+}
+
+inline glm::mat4 gltfNodeTransform(const JsonValue& node) {
+    const JsonValue& matrix = node["matrix"];
+    if (matrix.size() == 16) {
+        glm::mat4 m;
+        for (int c = 0; c < 4; ++c)
+            for (int r = 0; r < 4; ++r)
+                m[c][r] = (float)matrix[(size_t)(c * 4 + r)].asNumber();
+        return m;
+    }
+    const JsonValue& t = node["translation"];
+    const JsonValue& r = node["rotation"];
+    const JsonValue& s = node["scale"];
+    glm::vec3 translation(t[0].asNumber(), t[1].asNumber(), t[2].asNumber());
+    glm::vec3 scale(s[0].asNumber(1.0), s[1].asNumber(1.0), s[2].asNumber(1.0));
+    float x = (float)r[0].asNumber(), y = (float)r[1].asNumber(), z = (float)r[2].asNumber(), w = (float)r[3].asNumber(1.0);
+    // 单位四元数转旋转矩阵（列主序）
+    glm::mat4 m(1.0f);
+    m[0] = glm::vec4(1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w), 0.0f) * scale.x;
+    m[1] = glm::vec4(2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w), 0.0f) * scale.y;
+    m[2] = glm::vec4(2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y), 0.0f) * scale.z;
+    m[3] = glm::vec4(translation, 1.0f);
+    return m;
+}
+
+// 场景里的一个图元实例：mesh 的第 primitive 个图元放在 transform 处
+struct GltfInstance {
+    const JsonValue* primitive;
+    glm::mat4 transform;
+    uint32_t material;
+    size_t vertexCount;
+    size_t indexCount;
+    size_t build;        // 所属子网格
+    size_t vertexOffset; // 在子网格里的位置
+    size_t indexOffset;
+};
+
+inline void collectGltfNode(const JsonValue& root, size_t nodeIndex, const glm::mat4& parent, int depth,
+                            std::vector<std::pair<size_t, glm::mat4>>& meshNodes) {
+    const JsonValue& node = root["nodes"][nodeIndex];
+    // 节点图应该是树，深度限制防止坏文件里的环
+    if (!node.isObject() || depth > 64)
+        return;
+    glm::mat4 world = parent * gltfNodeTransform(node);
+    if (node["mesh"].isNumber())
+        meshNodes.push_back({ node["mesh"].asSize(), world });
+    const JsonValue& children = node["children"];
+    for (size_t i = 0; i < children.size(); ++i)
+        collectGltfNode(root, children[i].asSize(SIZE_MAX), world, depth + 1, meshNodes);
+}
+
+// path 用于找外部 .bin；dependencies 返回读过的外部文件（缓存失效判断要用）
+inline bool importGLTF(const std::string& path, const uint8_t* data, size_t size, MeshData& out, JobSystem* jobs,
+                       bool optimize, std::string* error, std::vector<std::string>* dependencies) {
+    auto failWith = [&](const std::string& what) {
+        if (error)
+            *error = what;
+        return false;
+    };
+
+    // .glb：12 字节头 + JSON 块 + 可选的 BIN 块
+    const char* json = reinterpret_cast<const char*>(data);
+    size_t jsonLength = size;
+    GltfBuffer binChunk;
+    if (size >= 12 && std::memcmp(data, "glTF", 4) == 0) {
+        uint32_t header[3], chunkLength, chunkType;
+        std::memcpy(header, data, 12);
+        if (header[1] != 2 || size < 20)
+            return failWith("unsupported GLB version");
+        std::memcpy(&chunkLength, data + 12, 4);
+        std::memcpy(&chunkType, data + 16, 4);
+        if (chunkType != 0x4E4F534A || 20 + (size_t)chunkLength > size) // "JSON"
+            return failWith("bad GLB JSON chunk");
+        json = reinterpret_cast<const char*>(data + 20);
+        jsonLength = chunkLength;
+        size_t binStart = 20 + ((size_t)chunkLength + 3) / 4 * 4;
+        if (binStart + 8 <= size) {
+            std::memcpy(&chunkLength, data + binStart, 4);
+            std::memcpy(&chunkType, data + binStart + 4, 4);
+            if (chunkType == 0x004E4942 && binStart + 8 + chunkLength <= size) { // "BIN\0"
+                binChunk.data = data + binStart + 8;
+                binChunk.size = chunkLength;
+            }
+        }
+    }
+
+    JsonValue root;
+    std::string jsonError;
+    if (!parseJson(json, jsonLength, root, &jsonError))
+        return failWith("JSON: " + jsonError);
+
+    // 外部 .bin 用映射，data URI 解码到内存
+    std::vector<GltfBuffer> buffers;
+    std::vector<MappedFile> mappedBuffers;
+    std::vector<std::vector<uint8_t>> decodedBuffers;
+    mappedBuffers.reserve(root["buffers"].size());
+    decodedBuffers.reserve(root["buffers"].size());
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    for (size_t i = 0; i < root["buffers"].size(); ++i) {
+        const JsonValue& buffer = root["buffers"][i];
+        const std::string& uri = buffer["uri"].asString();
+        GltfBuffer view;
+        if (uri.empty()) {
+            view = binChunk;
+        } else if (uri.compare(0, 5, "data:") == 0) {
+            size_t comma = uri.find(',');
+            if (comma == std::string::npos || uri.find(";base64") > comma)
+                return failWith("unsupported data URI in buffer " + std::to_string(i));
+            decodedBuffers.push_back(decodeBase64(uri.data() + comma + 1, uri.data() + uri.size()));
+            view.data = decodedBuffers.back().data();
+            view.size = decodedBuffers.back().size();
+        } else {
+            std::string file = (directory / decodeURI(uri)).string();
+            mappedBuffers.emplace_back(file);
+            if (!mappedBuffers.back())
+                return failWith("cannot read buffer " + file);
+            view.data = mappedBuffers.back().data();
+            view.size = mappedBuffers.back().size();
+            if (dependencies)
+                dependencies->push_back(file);
+        }
+        if (view.size < buffer["byteLength"].asSize())
+            return failWith("buffer " + std::to_string(i) + " is shorter than its byteLength");
+        buffers.push_back(view);
+    }
+
+    // 默认场景里所有带 mesh 的节点；没有场景时每个 mesh 原样放一份
+    std::vector<std::pair<size_t, glm::mat4>> meshNodes;
+    const JsonValue& scenes = root["scenes"];
+    if (scenes.size() > 0) {
+        const JsonValue& nodes = scenes[root["scene"].asSize(0)]["nodes"];
+        for (size_t i = 0; i < nodes.size(); ++i)
+            collectGltfNode(root, nodes[i].asSize(SIZE_MAX), glm::mat4(1.0f), 0, meshNodes);
+    } else {
+        for (size_t i = 0; i < root["meshes"].size(); ++i)
+            meshNodes.push_back({ i, glm::mat4(1.0f) });
+    }
+
+    // 材质名：没名字的用下标，没有材质的图元归到空名字
+    std::vector<std::string> materials;
+    std::vector<size_t> materialOf(root["materials"].size() + 1, SIZE_MAX);
+    auto materialIndex = [&](const JsonValue& primitive) {
+        size_t gltfIndex = primitive["material"].asSize(root["materials"].size());
+        if (gltfIndex > root["materials"].size())
+            gltfIndex = root["materials"].size();
+        if (materialOf[gltfIndex] == SIZE_MAX) {
+            std::string name = gltfIndex < root["materials"].size()
+                ? root["materials"][gltfIndex]["name"].asString() : std::string();
+            if (name.empty() && gltfIndex < root["materials"].size())
+                name = "material_" + std::to_string(gltfIndex);
+            materialOf[gltfIndex] = materials.size();
+            materials.push_back(name);
+        }
+        return (uint32_t)materialOf[gltfIndex];
+    };
+
+    std::vector<GltfInstance> instances;
+    size_t skipped = 0;
+    for (const auto& meshNode : meshNodes) {
+        const JsonValue& primitives = root["meshes"][meshNode.first]["primitives"];
+        for (size_t p = 0; p < primitives.size(); ++p) {
+            const JsonValue& primitive = primitives[p];
+            GltfAccessor position = gltfAccessor(root, buffers, primitive["attributes"]["POSITION"]);
+            GltfAccessor indices = gltfAccessor(root, buffers, primitive["indices"]);
+            // 只导入三角形列表
+            if (primitive["mode"].asInt(4) != 4 || !position || position.components != 3
+                || (primitive.has("indices") && (!indices || indices.components != 1))) {
+                ++skipped;
+                continue;
+            }
+            size_t indexCount = indices ? indices.count : position.count;
+            instances.push_back({ &primitive, meshNode.second, materialIndex(primitive), position.count,
+                                  indexCount - indexCount % 3, 0, 0, 0 });
+        }
+    }
+    if (skipped > 0)
+        std::cerr << "ERROR::MESH_IMPORT::GLTF_PRIMITIVES_SKIPPED: " << skipped
+                  << " primitives (not triangles, sparse or out-of-range accessors)" << std::endl;
+
+    // 同一材质的实例拼成一个子网格，先算好每个实例在子网格里的位置，再并行填充
+    std::vector<SubMeshBuild> builds(materials.size());
+    for (GltfInstance& instance : instances) {
+        SubMeshBuild& build = builds[instance.material];
+        build.material = instance.material;
+        instance.build = instance.material;
+        instance.vertexOffset = build.vertices.size();
+        instance.indexOffset = build.indices.size();
+        build.vertices.resize(build.vertices.size() + instance.vertexCount);
+        build.indices.resize(build.indices.size() + instance.indexCount);
+    }
+    std::vector<char> needsNormals(instances.size(), 0);
+    forEachTask(instances.size(), jobs, [&](size_t i) {
+        const GltfInstance& instance = instances[i];
+        const JsonValue& attributes = (*instance.primitive)["attributes"];
+        GltfAccessor position = gltfAccessor(root, buffers, attributes["POSITION"]);
+        GltfAccessor normal = gltfAccessor(root, buffers, attributes["NORMAL"]);
+        GltfAccessor uv = gltfAccessor(root, buffers, attributes["TEXCOORD_0"]);
+        GltfAccessor indices = gltfAccessor(root, buffers, (*instance.primitive)["indices"]);
+        bool hasNormals = normal && normal.components == 3 && normal.count >= position.count;
+        bool hasUVs = uv && uv.components == 2 && uv.count >= position.count;
+        needsNormals[i] = !hasNormals;
+
+        // 法线用逆转置矩阵，非均匀缩放下才正确
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(instance.transform)));
+        MeshVertex* vertices = builds[instance.build].vertices.data() + instance.vertexOffset;
+        for (size_t v = 0; v < instance.vertexCount; ++v) {
+            glm::vec3 p(position.readFloat(v, 0), position.readFloat(v, 1), position.readFloat(v, 2));
+            vertices[v].position = glm::vec3(instance.transform * glm::vec4(p, 1.0f));
+            vertices[v].normal = glm::vec3(0.0f);
+            if (hasNormals) {
+                glm::vec3 n = normalMatrix * glm::vec3(normal.readFloat(v, 0), normal.readFloat(v, 1), normal.readFloat(v, 2));
+                float length = glm::length(n);
+                vertices[v].normal = length > 0.0f ? n / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+            vertices[v].uv = hasUVs ? glm::vec2(uv.readFloat(v, 0), uv.readFloat(v, 1)) : glm::vec2(0.0f);
+        }
+        // 镜像变换（行列式为负）会把绕序反过来，交换每个三角形的两个顶点恢复逆时针
+        bool mirrored = glm::determinant(glm::mat3(instance.transform)) < 0.0f;
+        uint32_t* out = builds[instance.build].indices.data() + instance.indexOffset;
+        uint32_t base = (uint32_t)instance.vertexOffset;
+        for (size_t k = 0; k < instance.indexCount; k += 3) {
+            uint32_t tri[3];
+            for (int c = 0; c < 3; ++c) {
+                uint32_t index = indices ? indices.readIndex(k + c) : (uint32_t)(k + c);
+                tri[c] = base + (index < instance.vertexCount ? index : 0);
+            }
+            if (mirrored)
+                std::swap(tri[1], tri[2]);
+            std::memcpy(out + k, tri, sizeof(tri));
+        }
+    });
+    for (size_t i = 0; i < instances.size(); ++i)
+        if (needsNormals[i])
+            builds[instances[i].build].needsNormals = true;
+
+    assemble(builds, std::move(materials), optimize, jobs, out);
+    if (!out)
+        return failWith("no triangle primitives");
+    return true;
+}
+
+} // namespace mesh_import_detail
+
+enum class MeshFormat { Unknown, OBJ, GLTF };
+
+inline MeshFormat meshFormatOf(const std::string& path) {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    if (extension == ".obj")
+        return MeshFormat::OBJ;
+    if (extension == ".gltf" || extension == ".glb")
+        return MeshFormat::GLTF;
+    return MeshFormat::Unknown;
+}
+
+// 直接解析源文件（不经过缓存）；失败打印错误并返回空网格
+// optimize：每个子网格做顶点缓存 + 顶点读取重排（一次性的开销，结果进缓存）
+inline MeshData importMesh(const std::string& path, JobSystem* jobs = nullptr, bool optimize = true,
+                           std::vector<std::string>* dependencies = nullptr) {
+    MeshData mesh;
+    MeshFormat format = meshFormatOf(path);
+    if (format == MeshFormat::Unknown) {
+        std::cerr << "ERROR::MESH_IMPORT::UNKNOWN_FORMAT: " << path << std::endl;
+        return mesh;
+    }
+    MappedFile file(path);
+    if (!file) {
+        std::cerr << "ERROR::MESH_IMPORT::FILE_NOT_READ: " << path << std::endl;
+        return mesh;
+    }
+    std::string error;
+    bool ok = format == MeshFormat::OBJ
+        ? mesh_import_detail::importOBJ(file.data(), file.size(), mesh, jobs, optimize, &error)
+        : mesh_import_detail::importGLTF(path, file.data(), file.size(), mesh, jobs, optimize, &error, dependencies);
+    if (!ok) {
+        std::cerr << "ERROR::MESH_IMPORT::PARSE_FAILED: " << path << ": " << error << std::endl;
+        return MeshData{};
+    }
+    return mesh;
+}
+
+// 导入结果的磁盘缓存，结构和 MipCache 一样：源文件旁边的 .mesh 文件，大小 + 修改时间一致直接命中，
+// 时间变了再比较内容哈希；glTF 引用的外部 .bin 也记在缓存里，一起参与校验
+// 文件 = 128 字节头 + 顶点 + 索引（连续，一次上传）+ 子网格表 + 名字表（材质名和依赖文件名，以 0 结尾）
+// 线程安全，可以在工作线程里调用 loadOrImport()，也可以在任务里调用并传入同一个 JobSystem（等待时会帮着执行）
+class MeshCache {
+public:
+    bool enabled = true;
+    bool optimize = true;
+
+    std::atomic<unsigned> hits{ 0 };
+    std::atomic<unsigned> rehashed{ 0 };
+    std::atomic<unsigned> misses{ 0 };
+    std::atomic<uint64_t> loadUs{ 0 };      // 命中：校验 + 映射 + 预读
+    std::atomic<uint64_t> loadBytes{ 0 };   // 命中时读的缓存字节数
+    std::atomic<uint64_t> importUs{ 0 };    // 未命中：解析 + 优化 + 写缓存
+    std::atomic<uint64_t> importBytes{ 0 }; // 未命中时解析的源文件字节数
+
+    static std::string pathFor(const std::string& source) { return source + ".mesh"; }
+
+    MeshData loadOrImport(const std::string& source, JobSystem* jobs = nullptr) {
+        auto start = mesh_import_detail::Clock::now();
+        std::string cachePath = pathFor(source);
+        MeshData mesh;
+        if (enabled && map(cachePath, source, mesh)) {
+            ++hits;
+            loadUs += mesh_import_detail::elapsedUs(start);
+            loadBytes += mesh.mapping->size();
+            return mesh;
+        }
+
+        std::vector<std::string> dependencies;
+        mesh = importMesh(source, jobs, optimize, &dependencies);
+        if (!mesh)
+            return mesh;
+        std::vector<std::string> files = dependencies;
+        files.insert(files.begin(), source);
+        SourceStamp stamp = stampOf(files, true);
+        if (enabled && stamp.valid)
+            write(cachePath, stamp, mesh, dependencies);
+        ++misses;
+        importUs += mesh_import_detail::elapsedUs(start);
+        importBytes += stamp.size;
+        return mesh;
+    }
+
+    void printStats() const {
+        auto rate = [](uint64_t bytes, uint64_t us) { return us ? bytes / (double)us : 0.0; }; // 字节/微秒 = MB/s
+        std::cout << "Mesh cache: " << hits << " hit (" << loadUs / 1000.0 << " ms, " << rate(loadBytes, loadUs)
+                  << " MB/s, " << rehashed << " revalidated by hash), " << misses << " miss (" << importUs / 1000.0
+                  << " ms parse + build, " << rate(importBytes, importUs) << " MB/s of source)" << std::endl;
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x4853454D; // "MESH"
+    static constexpr uint32_t VERSION = 1;
+
+    struct SourceStamp {
+        bool valid = false;
+        uint64_t size = 0;  // 源文件和依赖文件的总字节数
+        int64_t mtime = 0;  // 其中最新的修改时间
+        uint64_t hash = 0;  // 只在需要时计算
+    };
+
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint64_t sourceSize = 0;
+        int64_t  sourceMtime = 0;
+        uint64_t sourceHash = 0;
+        uint64_t vertexCount = 0;
+        uint64_t indexCount = 0;
+        uint32_t submeshCount = 0;
+        uint32_t materialCount = 0;
+        uint32_t dependencyCount = 0;
+        uint32_t nameBytes = 0;
+        float    boundsMin[3] = {};
+        float    boundsMax[3] = {};
+        uint32_t vertexSize = sizeof(MeshVertex);
+        uint32_t optimized = 0;
+        uint8_t  reserved[32] = {};
+    };
+    static_assert(sizeof(Header) == 128, "mesh cache header must stay 128 bytes");
+
+    // 按 8 字节一组的 FNV-1a 变体：网格源文件动辄几百 MB，逐字节太慢
+    static uint64_t hashBytes(uint64_t hash, const uint8_t* data, size_t size) {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            hash = (hash ^ word) * 1099511628211ull;
+            hash ^= hash >> 29;
+        }
+        for (; i < size; ++i)
+            hash = (hash ^ data[i]) * 1099511628211ull;
+        return hash;
+    }
+
+    static SourceStamp stampOf(const std::vector<std::string>& files, bool withHash) {
+        SourceStamp stamp;
+        stamp.hash = 14695981039346656037ull;
+        stamp.mtime = INT64_MIN; // libstdc++ 的 file_time_type 纪元在 2174 年，现在的时间是负数
+        for (const std::string& file : files) {
+            std::error_code ec;
+            uint64_t size = std::filesystem::file_size(file, ec);
+            if (ec)
+                return SourceStamp{};
+            int64_t mtime = (int64_t)std::filesystem::last_write_time(file, ec).time_since_epoch().count();
+            if (ec)
+                return SourceStamp{};
+            stamp.size += size;
+            stamp.mtime = std::max(stamp.mtime, mtime);
+            if (withHash) {
+                MappedFile mapped(file);
+                if (!mapped)
+                    return SourceStamp{};
+                stamp.hash = hashBytes(stamp.hash, mapped.data(), mapped.size());
+            }
+        }
+        stamp.valid = true;
+        return stamp;
+    }
+
+    static size_t align16(size_t value) { return (value + 15) / 16 * 16; }
+
+    bool map(const std::string& path, const std::string& source, MeshData& mesh) {
+        auto file = std::make_shared<MappedFile>(path);
+        Header header;
+        if (!*file || file->size() < sizeof(header))
+            return false;
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (header.magic != MAGIC || header.version != VERSION || header.vertexSize != sizeof(MeshVertex)
+            || header.optimized != (optimize ? 1u : 0u) || header.vertexCount == 0 || header.indexCount == 0)
+            return false;
+
+        size_t geometryBytes = header.vertexCount * sizeof(MeshVertex) + header.indexCount * sizeof(uint32_t);
+        size_t submeshOffset = align16(sizeof(header) + geometryBytes);
+        size_t nameOffset = submeshOffset + (size_t)header.submeshCount * sizeof(SubMesh);
+        if (nameOffset + header.nameBytes > file->size())
+            return false;
+
+        // 名字表：materialCount 个材质名，然后 dependencyCount 个依赖文件名
+        std::vector<std::string> names;
+        const char* p = reinterpret_cast<const char*>(file->data() + nameOffset);
+        const char* end = p + header.nameBytes;
+        while (p < end) {
+            const char* zero = static_cast<const char*>(std::memchr(p, 0, (size_t)(end - p)));
+            if (!zero)
+                return false;
+            names.emplace_back(p, zero);
+            p = zero + 1;
+        }
+        if (names.size() != (size_t)header.materialCount + header.dependencyCount)
+            return false;
+
+        std::vector<std::string> files(names.begin() + header.materialCount, names.end());
+        files.insert(files.begin(), source);
+        SourceStamp stamp = stampOf(files, false);
+        if (!stamp.valid || stamp.size != header.sourceSize)
+            return false;
+        bool touched = stamp.mtime != header.sourceMtime;
+        if (touched) {
+            stamp = stampOf(files, true);
+            if (!stamp.valid || stamp.hash != header.sourceHash)
+                return false;
+        }
+
+        mesh.submeshes.resize(header.submeshCount);
+        std::memcpy(mesh.submeshes.data(), file->data() + submeshOffset, mesh.submeshes.size() * sizeof(SubMesh));
+        // 子网格的范围也要落在顶点/索引数组里，否则缓存被截断或写坏时会越界读，返回 false 就从源文件重建
+        for (const SubMesh& sub : mesh.submeshes)
+            if ((uint64_t)sub.firstIndex + sub.indexCount > header.indexCount
+                || (uint64_t)sub.firstVertex + sub.vertexCount > header.vertexCount || sub.material >= header.materialCount)
+                return false;
+        mesh.materials.assign(names.begin(), names.begin() + header.materialCount);
+        mesh.vertexCount = (size_t)header.vertexCount;
+        mesh.indexCount = (size_t)header.indexCount;
+        mesh.boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+        mesh.boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+        mesh.vertexOffset = sizeof(header);
+        // 缺页放在调用线程里，上传时不再等磁盘
+        file->prefault();
+        mesh.mapping = std::move(file);
+
+        if (touched) {
+            ++rehashed;
+            header.sourceMtime = stamp.mtime;
+            std::fstream update(path, std::ios::binary | std::ios::in | std::ios::out);
+            if (update)
+                update.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+        return true;
+    }
+
+    void write(const std::string& path, const SourceStamp& stamp, const MeshData& mesh,
+               const std::vector<std::string>& dependencies) const {
+        Header header;
+        header.sourceSize = stamp.size;
+        header.sourceMtime = stamp.mtime;
+        header.sourceHash = stamp.hash;
+        header.vertexCount = mesh.vertexCount;
+        header.indexCount = mesh.indexCount;
+        header.submeshCount = (uint32_t)mesh.submeshes.size();
+        header.materialCount = (uint32_t)mesh.materials.size();
+        header.dependencyCount = (uint32_t)dependencies.size();
+        for (int i = 0; i < 3; ++i) {
+            header.boundsMin[i] = mesh.boundsMin[i];
+            header.boundsMax[i] = mesh.boundsMax[i];
+        }
+        header.optimized = optimize ? 1 : 0;
+        std::string names;
+        for (const std::string& name : mesh.materials)
+            names.append(name.c_str(), name.size() + 1);
+        for (const std::string& name : dependencies)
+            names.append(name.c_str(), name.size() + 1);
+        header.nameBytes = (uint32_t)names.size();
+
+        // 先写临时文件再改名，和 MipCache 一样
+        std::string tmp = path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                std::cerr << "ERROR::MESH_CACHE::WRITE_FAILED: " << tmp << std::endl;
+                return;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(mesh.vertices()), (std::streamsize)mesh.vertexBytes());
+            file.write(reinterpret_cast<const char*>(mesh.indices()), (std::streamsize)mesh.indexBytes());
+            size_t written = sizeof(header) + mesh.vertexBytes() + mesh.indexBytes();
+            static const char zeros[16] = {};
+            file.write(zeros, (std::streamsize)(align16(written) - written));
+            file.write(reinterpret_cast<const char*>(mesh.submeshes.data()),
+                       (std::streamsize)(mesh.submeshes.size() * sizeof(SubMesh)));
+            file.write(names.data(), (std::streamsize)names.size());
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        if (ec)
+            std::filesystem::remove(tmp, ec);
+    }
+};
+
+inline MeshCache& meshCache() {
+    static MeshCache cache;
+    return cache;
+}
+
+#endif
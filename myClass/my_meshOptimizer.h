@@ -0,0 +1,348 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+// CPU 网格处理：顶点去重生成索引、按顶点后变换缓存重排三角形（Forsyth）、按首次使用重排顶点，
+// 以及 ACMR / ATVR / 顶点读取量的统计。只处理内存里的数据，不调用 GL
+// 顶点是交错的 float 数组，floatsPerVertex 个 float 一个顶点（位置、法线、uv……都算在里面）
+
+// 去重后的网格：indices 每 3 个一个三角形
+struct IndexedMesh {
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    size_t floatsPerVertex = 3;
+
+    size_t vertexCount() const { return floatsPerVertex ? vertices.size() / floatsPerVertex : 0; }
+    size_t triangleCount() const { return indices.size() / 3; }
+    size_t vertexBytes() const { return floatsPerVertex * sizeof(float); }
+};
+
+// 顶点后变换缓存模拟的结果
+// ACMR = 变换次数 / 三角形数（越低越好，下限约 0.5）；ATVR = 变换次数 / 顶点数（下限 1.0）
+struct VertexCacheStats {
+    size_t triangles = 0;
+    size_t vertices = 0;
+    size_t transforms = 0;
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+// 顶点读取模拟：按缓存行统计实际从显存读了多少字节；overfetch = 读取量 / 顶点数据总量（下限 1.0）
+struct VertexFetchStats {
+    size_t bytesFetched = 0;
+    float overfetch = 0.0f;
+};
+
+namespace mesh_detail {
+
+// -0.0 和 0.0 视为同一个值，其它按位比较（NaN 只和同样位模式的 NaN 相等）
+inline uint32_t canonicalBits(float value) {
+    if (value == 0.0f)
+        return 0;
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline uint64_t hashVertex(const float* v, size_t floats) {
+    uint64_t hash = 14695981039346656037ull; // 按 32 位字做 FNV-1a
+    for (size_t i = 0; i < floats; ++i) {
+        hash ^= canonicalBits(v[i]);
+        hash *= 1099511628211ull;
+    }
+    // 乘法只把低位往高位扩散，取低位当槽号前再混合一次（murmur3 fmix64）
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+inline bool sameVertex(const float* a, const float* b, size_t floats) {
+    for (size_t i = 0; i < floats; ++i)
+        if (canonicalBits(a[i]) != canonicalBits(b[i]))
+            return false;
+    return true;
+}
+
+// Forsyth 评分用的缓存大小和参数（"Linear-Speed Vertex Cache Optimisation"）
+const int FORSYTH_CACHE_SIZE = 32;
+const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+// cachePosition < 0 表示不在缓存里；liveTriangles 是还没输出的相邻三角形数
+inline float forsythScore(int cachePosition, uint32_t liveTriangles) {
+    if (liveTriangles == 0)
+        return -1.0f;
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        // 刚用过的三个顶点分数固定，避免同一个三角形的顶点互相抢
+        if (cachePosition < 3) {
+            score = FORSYTH_LAST_TRIANGLE_SCORE;
+        } else {
+            float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scale, FORSYTH_CACHE_DECAY_POWER);
+        }
+    }
+    // 剩下的三角形越少越要尽快处理掉，免得以后孤零零地再变换一次
+    score += FORSYTH_VALENCE_BOOST_SCALE * std::pow((float)liveTriangles, -FORSYTH_VALENCE_BOOST_POWER);
+    return score;
+}
+
+} // namespace mesh_detail
+
+// 三角形列表去重：完全相同的顶点只保留一份，返回索引网格（顶点按首次出现的顺序）
+inline IndexedMesh buildIndexedMesh(const float* vertices, size_t vertexCount, size_t floatsPerVertex) {
+    IndexedMesh mesh;
+    mesh.floatsPerVertex = floatsPerVertex;
+    mesh.indices.resize(vertexCount);
+    if (vertexCount == 0 || floatsPerVertex == 0)
+        return mesh;
+
+    // 开放寻址哈希表，存放的是去重后顶点的编号
+    size_t tableSize = 1;
+    while (tableSize < vertexCount * 2)
+        tableSize <<= 1;
+    const uint32_t EMPTY = ~0u;
+    std::vector<uint32_t> table(tableSize, EMPTY);
+    mesh.vertices.reserve(vertexCount * floatsPerVertex);
+
+    uint32_t unique = 0;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        const float* v = vertices + i * floatsPerVertex;
+        size_t slot = mesh_detail::hashVertex(v, floatsPerVertex) & (tableSize - 1);
+        while (table[slot] != EMPTY
+               && !mesh_detail::sameVertex(mesh.vertices.data() + table[slot] * floatsPerVertex, v, floatsPerVertex))
+            slot = (slot + 1) & (tableSize - 1);
+        if (table[slot] == EMPTY) {
+            table[slot] = unique++;
+            mesh.vertices.insert(mesh.vertices.end(), v, v + floatsPerVertex);
+        }
+        mesh.indices[i] = table[slot];
+    }
+    mesh.vertices.shrink_to_fit();
+    return mesh;
+}
+
+inline IndexedMesh buildIndexedMesh(const std::vector<float>& vertices, size_t floatsPerVertex) {
+    return buildIndexedMesh(vertices.data(), vertices.size() / floatsPerVertex, floatsPerVertex);
+}
+
+// 按顶点后变换缓存重排三角形（Tom Forsyth 的线性时间贪心算法），只改 indices，不动顶点
+// 每一步从刚进入缓存的顶点相邻的三角形里挑分数最高的输出，缓存里没有候选时按原顺序找下一个
+inline void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    using namespace mesh_detail;
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+        return;
+
+    // 每个顶点相邻的三角形列表（CSR），输出过的三角形从列表里删掉
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+        ++liveTriangles[indices[i]];
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangles[v];
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t)
+            for (int k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = (uint32_t)t;
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = forsythScore(-1, liveTriangles[v]);
+    std::vector<float> triangleScore(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t)
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+    std::vector<uint32_t> source(indices, indices + triangleCount * 3);
+    std::vector<char> emitted(triangleCount, 0);
+    // 多留 3 个位置放刚输出的三角形的顶点，挤出去的顶点要重新评分
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t nextCache[FORSYTH_CACHE_SIZE + 3];
+    int cacheCount = 0;
+    size_t scan = 0;
+    size_t best = 0;
+
+    for (size_t output = 0; output < triangleCount; ++output) {
+        if (output > 0 && (best == SIZE_MAX || emitted[best])) {
+            // 缓存里的顶点已经没有剩余三角形：按原顺序取下一个没输出的
+            while (emitted[scan])
+                ++scan;
+            best = scan;
+        }
+        const uint32_t* tri = &source[best * 3];
+        std::memcpy(indices + output * 3, tri, 3 * sizeof(uint32_t));
+        emitted[best] = 1;
+
+        // 从三个顶点的相邻列表里删掉这个三角形
+        for (int k = 0; k < 3; ++k) {
+            uint32_t v = tri[k];
+            uint32_t* list = &adjacency[adjacencyOffset[v]];
+            uint32_t count = liveTriangles[v];
+            for (uint32_t j = 0; j < count; ++j)
+                if (list[j] == best) {
+                    list[j] = list[count - 1];
+                    break;
+                }
+            --liveTriangles[v];
+        }
+
+        // LRU：这个三角形的顶点放到最前面，其余顺延
+        int nextCount = 0;
+        for (int k = 0; k < 3; ++k)
+            if (std::find(nextCache, nextCache + nextCount, tri[k]) == nextCache + nextCount)
+                nextCache[nextCount++] = tri[k];
+        for (int i = 0; i < cacheCount; ++i)
+            if (std::find(nextCache, nextCache + nextCount, cache[i]) == nextCache + nextCount)
+                nextCache[nextCount++] = cache[i];
+
+        for (int i = 0; i < nextCount; ++i) {
+            uint32_t v = nextCache[i];
+            cachePosition[v] = i < FORSYTH_CACHE_SIZE ? i : -1;
+        }
+
+        // 重新评分缓存里（包括刚被挤出去的）顶点，再更新它们相邻的三角形，顺便挑出下一个最好的
+        float bestScore = -1.0f;
+        best = SIZE_MAX;
+        for (int i = 0; i < nextCount; ++i) {
+            uint32_t v = nextCache[i];
+            float score = forsythScore(cachePosition[v], liveTriangles[v]);
+            float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+            const uint32_t* list = &adjacency[adjacencyOffset[v]];
+            for (uint32_t j = 0; j < liveTriangles[v]; ++j) {
+                uint32_t t = list[j];
+                triangleScore[t] += delta;
+                if (triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(nextCount, FORSYTH_CACHE_SIZE);
+        std::memcpy(cache, nextCache, cacheCount * sizeof(uint32_t));
+    }
+}
+
+inline void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount) {
+    optimizeVertexCache(indices.data(), indices.size(), vertexCount);
+}
+
+// 按索引里第一次用到的顺序重排顶点，让顶点读取尽量顺序访问；没被用到的顶点会被丢掉
+// 应该在 optimizeVertexCache 之后调用（三角形顺序定下来以后）
+// 通用版本：顶点是任意 vertexBytes 字节的结构，重排结果写到 destination（不能和 vertices 重叠），返回保留的顶点数
+inline size_t optimizeVertexFetch(void* destination, const void* vertices, size_t vertexCount, size_t vertexBytes,
+                                  uint32_t* indices, size_t indexCount) {
+    const uint32_t UNUSED = ~0u;
+    std::vector<uint32_t> remap(vertexCount, UNUSED);
+    uint8_t* out = static_cast<uint8_t*>(destination);
+    const uint8_t* in = static_cast<const uint8_t*>(vertices);
+    uint32_t next = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t index = indices[i];
+        if (remap[index] == UNUSED) {
+            remap[index] = next;
+            std::memcpy(out + (size_t)next * vertexBytes, in + (size_t)index * vertexBytes, vertexBytes);
+            ++next;
+        }
+        indices[i] = remap[index];
+    }
+    return next;
+}
+
+inline void optimizeVertexFetch(IndexedMesh& mesh) {
+    std::vector<float> reordered(mesh.vertices.size());
+    size_t kept = optimizeVertexFetch(reordered.data(), mesh.vertices.data(), mesh.vertexCount(), mesh.vertexBytes(),
+                                      mesh.indices.data(), mesh.indices.size());
+    reordered.resize(kept * mesh.floatsPerVertex);
+    mesh.vertices.swap(reordered);
+}
+
+// 用 FIFO 缓存模拟顶点后变换缓存（大多数硬件更接近 FIFO），统计需要变换的顶点数
+inline VertexCacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                           unsigned cacheSize = 16) {
+    VertexCacheStats stats;
+    stats.triangles = indexCount / 3;
+    std::vector<size_t> insertedAt(vertexCount, 0); // 进入缓存时的时间戳 + 1，0 表示从没进过
+    std::vector<char> used(vertexCount, 0);
+    size_t time = 0;
+    for (size_t i = 0; i < stats.triangles * 3; ++i) {
+        uint32_t v = indices[i];
+        if (!used[v]) {
+            used[v] = 1;
+            ++stats.vertices;
+        }
+        // FIFO：命中不刷新位置，进入缓存后再有 cacheSize 个新顶点就被挤出
+        if (insertedAt[v] == 0 || time - (insertedAt[v] - 1) >= cacheSize) {
+            insertedAt[v] = ++time;
+            ++stats.transforms;
+        }
+    }
+    if (stats.triangles > 0)
+        stats.acmr = (float)stats.transforms / stats.triangles;
+    if (stats.vertices > 0)
+        stats.atvr = (float)stats.transforms / stats.vertices;
+    return stats;
+}
+
+inline VertexCacheStats analyzeVertexCache(const IndexedMesh& mesh, unsigned cacheSize = 16) {
+    return analyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertexCount(), cacheSize);
+}
+
+// 模拟按 64 字节缓存行读取顶点数据（一个小的全相联 LRU 缓存），统计实际读取的字节数
+inline VertexFetchStats analyzeVertexFetch(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                           size_t vertexBytes, size_t cacheLines = 64) {
+    const size_t LINE_BYTES = 64;
+    VertexFetchStats stats;
+    std::vector<size_t> lines;
+    lines.reserve(cacheLines);
+    std::vector<char> used(vertexCount, 0);
+    size_t usedVertices = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t v = indices[i];
+        if (!used[v]) {
+            used[v] = 1;
+            ++usedVertices;
+        }
+        size_t first = (size_t)v * vertexBytes / LINE_BYTES;
+        size_t last = ((size_t)v * vertexBytes + vertexBytes - 1) / LINE_BYTES;
+        for (size_t line = first; line <= last; ++line) {
+            auto it = std::find(lines.begin(), lines.end(), line);
+            if (it != lines.end()) {
+                lines.erase(it);
+            } else {
+                stats.bytesFetched += LINE_BYTES;
+                if (lines.size() == cacheLines)
+                    lines.erase(lines.begin());
+            }
+            lines.push_back(line);
+        }
+    }
+    if (usedVertices > 0)
+        stats.overfetch = (float)stats.bytesFetched / (usedVertices * vertexBytes);
+    return stats;
+}
+
+inline VertexFetchStats analyzeVertexFetch(const IndexedMesh& mesh) {
+    return analyzeVertexFetch(mesh.indices.data(), mesh.indices.size(), mesh.vertexCount(), mesh.vertexBytes());
+}
+
+// 常规流程：先重排三角形，再按新的三角形顺序重排顶点
+inline void optimizeMesh(IndexedMesh& mesh) {
+    optimizeVertexCache(mesh.indices, mesh.vertexCount());
+    optimizeVertexFetch(mesh);
+}
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef MIP_CACHE_H
+#define MIP_CACHE_H
+
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+
+#include "my_imageUtils.h"
+#include "my_mappedFile.h"
+#include "my_mipmap.h"
+
+// 解码后像素的磁盘缓存：放在源图片旁边（container.jpg -> container.jpg.mips）
+// 文件 = 64 字节头 + 已翻转、已扩成 RGBA 的整条 mip 链，命中时直接内存映射，
+// MipChain 指向映射里的像素，Texture 从映射上传，不解码也不经过中间缓冲区
+// 失效判断：源文件大小 + 修改时间一致直接命中；时间变了（git checkout、拷贝工程）再比较内容哈希，
+// 内容没变就沿用并更新头里的时间，内容变了才重新解码
+// 线程安全，TextureStreamer 的工作线程会并发调用 loadOrBuild()
+class MipCache {
+public:
+    bool enabled = true;
+
+    // 统计（微秒，原子累加）
+    std::atomic<unsigned> hits{ 0 };
+    std::atomic<unsigned> rehashed{ 0 }; // 命中中靠内容哈希确认的次数
+    std::atomic<unsigned> misses{ 0 };
+    std::atomic<uint64_t> buildUs{ 0 };  // 未命中：解码 + 生成 mip 链
+    std::atomic<uint64_t> loadUs{ 0 };   // 命中：校验 + 映射缓存文件
+
+    // 缓存文件名区分翻转、sRGB 和强制通道数，同一张图的不同用法互不覆盖
+    static std::string pathFor(const std::string& source, bool flip, bool srgb, int channels) {
+        std::string path = source;
+        if (!flip)
+            path += ".noflip";
+        if (srgb)
+            path += ".srgb";
+        if (channels)
+            path += ".c" + std::to_string(channels);
+        return path + ".mips";
+    }
+
+    // 先查缓存，未命中就解码、翻转、RGB 扩成 RGBA、生成整条链并写回缓存；失败返回空链
+    MipChain loadOrBuild(const std::string& source, bool flip, bool srgb, int channels = 0, JobSystem* jobs = nullptr) {
+        auto start = std::chrono::steady_clock::now();
+        SourceStamp stamp = stampOf(source);
+        std::string cachePath = pathFor(source, flip, srgb, channels);
+
+        MipChain chain;
+        if (enabled && stamp.valid && map(cachePath, source, stamp, chain)) {
+            ++hits;
+            loadUs += elapsedUs(start);
+            return chain;
+        }
+
+        // 源文件也走映射：哈希和解码共用同一份字节，不用先读进缓冲区
+        MappedFile file(source);
+        if (!file)
+            return chain;
+        Image image = decodeImage(file.data(), file.size(), channels);
+        if (!image)
+            return chain;
+        chain = allocateMipChain(image.width, image.height, uploadChannels(image.channels), srgb);
+        convertForUpload(image, chain.writableLevel(0), flip);
+        generateMips(chain, jobs);
+
+        if (enabled && stamp.valid)
+            write(cachePath, stamp, hashBytes(file.data(), file.size()), chain);
+        ++misses;
+        buildUs += elapsedUs(start);
+        return chain;
+    }
+
+    void printStats() const {
+        std::cout << "Mip cache: " << hits << " hit (" << loadUs / 1000.0 << " ms, " << rehashed
+                  << " revalidated by hash), " << misses << " miss (" << buildUs / 1000.0
+                  << " ms decode + build)" << std::endl;
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x5350494D; // "MIPS"
+    static constexpr uint32_t VERSION = 2;
+
+    struct SourceStamp {
+        bool valid = false;
+        uint64_t size = 0;
+        int64_t mtime = 0;
+    };
+
+    // 凑满 64 字节，映射后像素数据按缓存行对齐
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint64_t sourceSize = 0;
+        int64_t  sourceMtime = 0;
+        uint64_t sourceHash = 0;
+        int32_t  width = 0, height = 0, channels = 0, srgb = 0;
+        uint8_t  reserved[16] = {};
+    };
+    static_assert(sizeof(Header) == 64, "mip cache header must stay 64 bytes");
+
+    static uint64_t elapsedUs(std::chrono::steady_clock::time_point start) {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // FNV-1a 64 位，和着色器缓存的 key 用同一种哈希
+    static uint64_t hashBytes(const uint8_t* data, size_t size) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= data[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static SourceStamp stampOf(const std::string& source) {
+        SourceStamp stamp;
+        std::error_code ec;
+        stamp.size = std::filesystem::file_size(source, ec);
+        if (ec)
+            return stamp;
+        stamp.mtime = (int64_t)std::filesystem::last_write_time(source, ec).time_since_epoch().count();
+        stamp.valid = !ec;
+        return stamp;
+    }
+
+    // 校验通过后让 chain 直接引用映射里的像素
+    bool map(const std::string& path, const std::string& source, const SourceStamp& stamp, MipChain& chain) {
+        auto file = std::make_shared<MappedFile>(path);
+        Header header;
+        if (!*file || file->size() < sizeof(header))
+            return false;
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (header.magic != MAGIC || header.version != VERSION || header.sourceSize != stamp.size
+            || header.width <= 0 || header.height <= 0 || header.channels <= 0 || header.channels > 4)
+            return false;
+
+        bool touched = header.sourceMtime != stamp.mtime;
+        if (touched) {
+            MappedFile sourceFile(source);
+            if (!sourceFile || hashBytes(sourceFile.data(), sourceFile.size()) != header.sourceHash)
+                return false;
+        }
+
+        chain.width = header.width;
+        chain.height = header.height;
+        chain.channels = header.channels;
+        chain.srgb = header.srgb != 0;
+        chain.levels = mipLayout(chain.width, chain.height, chain.channels);
+        if (sizeof(header) + chain.bytes() > file->size()) {
+            chain = MipChain{};
+            return false;
+        }
+        chain.mapping = std::move(file);
+        chain.mappingOffset = sizeof(header);
+
+        if (touched) {
+            ++rehashed;
+            header.sourceMtime = stamp.mtime;
+            updateHeader(path, header);
+        }
+        return true;
+    }
+
+    // 只改写文件头，像素部分不动（已有的映射看到的像素不变）；失败无所谓，下次再按哈希确认
+    static void updateHeader(const std::string& path, const Header& header) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        if (file)
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    static void write(const std::string& path, const SourceStamp& stamp, uint64_t sourceHash, const MipChain& chain) {
+        Header header;
+        header.sourceSize = stamp.size;
+        header.sourceMtime = stamp.mtime;
+        header.sourceHash = sourceHash;
+        header.width = chain.width;
+        header.height = chain.height;
+        header.channels = chain.channels;
+        header.srgb = chain.srgb ? 1 : 0;
+
+        // 先写临时文件再改名，并发加载同一张图或中途退出都不会留下半个文件
+        std::string tmp = path + ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                std::cerr << "ERROR::MIP_CACHE::WRITE_FAILED: " << tmp << std::endl;
+                return;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(chain.data()), (std::streamsize)chain.bytes());
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp, path, ec);
+        if (ec)
+            std::filesystem::remove(tmp, ec);
+    }
+};
+
+inline MipCache& mipCache() {
+    static MipCache cache;
+    return cache;
+}
+
+#endif
@@ -0,0 +1,284 @@
+#ifndef MIPMAP_H
+#define MIPMAP_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <memory>
+
+#include "my_simd.h"
+#include "my_mappedFile.h"
+#include "my_jobSystem.h"
+
+// CPU 生成 mip 链，代替 glGenerateMipmap：
+//   - 2x2 盒式滤波（奇数尺寸时边缘重复），结果与驱动无关、可以缓存到磁盘
+//   - sRGB 的 RGBA 链整条在 12 位线性空间里缩小，每级只编码回 sRGB 一次；alpha 始终按线性处理
+//   - 4 通道的行内核走 SSE2/AVX2，MipFilterPath::Scalar 是逐像素的参考实现，两者结果逐字节一致
+struct MipLevelInfo {
+    int width = 0, height = 0;
+    size_t offset = 0, size = 0;
+};
+
+// 一条完整的 mip 链，所有级别放在一块连续内存里（level 0 在最前）
+// 像素要么在 pixels 里（刚生成的链），要么直接指向 mip 缓存文件的只读映射（mapping 非空时，pixels 为空）
+struct MipChain {
+    int width = 0, height = 0, channels = 0;
+    bool srgb = false;
+    std::vector<MipLevelInfo> levels;
+    std::vector<uint8_t> pixels;
+    std::shared_ptr<const MappedFile> mapping;
+    size_t mappingOffset = 0;
+
+    explicit operator bool() const { return !levels.empty(); }
+    size_t bytes() const { return levels.empty() ? 0 : levels.back().offset + levels.back().size; }
+    const uint8_t* data() const { return mapping ? mapping->data() + mappingOffset : pixels.data(); }
+    const uint8_t* level(size_t i) const { return data() + levels[i].offset; }
+    // 只对自己持有像素的链有效（生成 mip 时写入）
+    uint8_t* writableLevel(size_t i) { return pixels.data() + levels[i].offset; }
+};
+
+enum class MipFilterPath { Scalar, SIMD };
+
+inline int mipLevelCount(int width, int height) {
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        ++levels;
+    }
+    return levels;
+}
+
+// 按尺寸排好每一级的偏移
+inline std::vector<MipLevelInfo> mipLayout(int width, int height, int channels) {
+    std::vector<MipLevelInfo> levels(mipLevelCount(width, height));
+    size_t offset = 0;
+    for (MipLevelInfo& level : levels) {
+        level.width = width;
+        level.height = height;
+        level.offset = offset;
+        level.size = (size_t)width * height * channels;
+        offset += level.size;
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return levels;
+}
+
+namespace mip_detail {
+
+// sRGB <-> 12 位线性整数；四个 12 位值相加仍在 16 位以内，SIMD 可以直接用 epi16 累加
+struct SrgbTables {
+    uint16_t toLinear[256];
+    uint8_t toSrgb[4096];
+};
+
+inline const SrgbTables& srgbTables() {
+    static const SrgbTables tables = []() {
+        SrgbTables t;
+        for (int i = 0; i < 256; ++i) {
+            double c = i / 255.0;
+            double linear = c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+            t.toLinear[i] = (uint16_t)std::lround(linear * 4095.0);
+        }
+        for (int i = 0; i < 4096; ++i) {
+            double linear = i / 4095.0;
+            double c = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            t.toSrgb[i] = (uint8_t)std::lround(c * 255.0);
+        }
+        return t;
+    }();
+    return tables;
+}
+
+// 一行 RGBA8 的 2x2 平均：要求源行宽 >= 2 * dstWidth；返回已处理的像素数，剩下的交给标量尾部
+inline int boxRowRGBA8(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int dstWidth) {
+    int x = 0;
+#if defined(MY_SIMD_AVX2)
+    const __m256i zero256 = _mm256_setzero_si256();
+    const __m256i two256 = _mm256_set1_epi16(2);
+    for (; x + 4 <= dstWidth; x += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(row0 + x * 8));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(row1 + x * 8));
+        // 每个 128 位通道里：lo = 像素 0,1，hi = 像素 2,3
+        __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero256), _mm256_unpacklo_epi8(b, zero256));
+        __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero256), _mm256_unpackhi_epi8(b, zero256));
+        lo = _mm256_add_epi16(lo, _mm256_srli_si256(lo, 8));
+        hi = _mm256_add_epi16(hi, _mm256_srli_si256(hi, 8));
+        __m256i sum = _mm256_srli_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), two256), 2);
+        __m256i packed = _mm256_packus_epi16(sum, sum);
+        packed = _mm256_permute4x64_epi64(packed, 0x08); // 取两个通道各自的低 64 位
+        _mm_storeu_si128((__m128i*)(dst + x * 4), _mm256_castsi256_si128(packed));
+    }
+#endif
+#if defined(MY_SIMD_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    for (; x + 2 <= dstWidth; x += 2) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+        __m128i b = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+        lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+        hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+        __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+        _mm_storel_epi64((__m128i*)(dst + x * 4), _mm_packus_epi16(sum, sum));
+    }
+#endif
+    return x;
+}
+
+// 同上，输入输出都是 16 位 RGBA（线性值）
+inline int boxRowRGBA16(const uint16_t* row0, const uint16_t* row1, uint16_t* dst, int dstWidth) {
+    int x = 0;
+#if defined(MY_SIMD_AVX2)
+    const __m256i two256 = _mm256_set1_epi16(2);
+    for (; x + 4 <= dstWidth; x += 4) {
+        __m256i a = _mm256_add_epi16(_mm256_loadu_si256((const __m256i*)(row0 + x * 8)),
+                                     _mm256_loadu_si256((const __m256i*)(row1 + x * 8)));
+        __m256i b = _mm256_add_epi16(_mm256_loadu_si256((const __m256i*)(row0 + x * 8 + 16)),
+                                     _mm256_loadu_si256((const __m256i*)(row1 + x * 8 + 16)));
+        a = _mm256_add_epi16(a, _mm256_srli_si256(a, 8));
+        b = _mm256_add_epi16(b, _mm256_srli_si256(b, 8));
+        __m256i sum = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), 0xD8);
+        _mm256_storeu_si256((__m256i*)(dst + x * 4), _mm256_srli_epi16(_mm256_add_epi16(sum, two256), 2));
+    }
+#endif
+#if defined(MY_SIMD_SSE2)
+    const __m128i two = _mm_set1_epi16(2);
+    for (; x + 2 <= dstWidth; x += 2) {
+        __m128i a = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(row0 + x * 8)),
+                                  _mm_loadu_si128((const __m128i*)(row1 + x * 8)));
+        __m128i b = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(row0 + x * 8 + 8)),
+                                  _mm_loadu_si128((const __m128i*)(row1 + x * 8 + 8)));
+        a = _mm_add_epi16(a, _mm_srli_si128(a, 8));
+        b = _mm_add_epi16(b, _mm_srli_si128(b, 8));
+        _mm_storeu_si128((__m128i*)(dst + x * 4), _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(a, b), two), 2));
+    }
+#endif
+    return x;
+}
+
+// 缩小一级的 [firstRow, lastRow) 行；T 为 uint8_t（任意通道数）或 uint16_t（线性 RGBA）
+template <typename T>
+inline void downsampleRows(const T* src, int srcWidth, int srcHeight, int channels, T* dst,
+                           int firstRow, int lastRow, MipFilterPath path) {
+    int dstWidth = std::max(1, srcWidth / 2);
+    for (int y = firstRow; y < lastRow; ++y) {
+        const T* row0 = src + (size_t)std::min(y * 2, srcHeight - 1) * srcWidth * channels;
+        const T* row1 = src + (size_t)std::min(y * 2 + 1, srcHeight - 1) * srcWidth * channels;
+        T* out = dst + (size_t)y * dstWidth * channels;
+        int x = 0;
+        if (path == MipFilterPath::SIMD && channels == 4 && srcWidth >= 2) {
+            if constexpr (sizeof(T) == 1)
+                x = boxRowRGBA8(row0, row1, out, dstWidth);
+            else
+                x = boxRowRGBA16(row0, row1, out, dstWidth);
+        }
+        for (; x < dstWidth; ++x) {
+            int x0 = std::min(x * 2, srcWidth - 1) * channels;
+            int x1 = std::min(x * 2 + 1, srcWidth - 1) * channels;
+            for (int c = 0; c < channels; ++c)
+                out[x * channels + c] = (T)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) >> 2);
+        }
+    }
+}
+
+// 按行分块：有任务系统且行数够多时并行，fn(firstRow, lastRow)；每块至少 32 行，再细调度开销就比缩小本身大了
+template <typename F>
+inline void forEachRowRange(int rows, JobSystem* jobs, F fn) {
+    const size_t minRowsPerTask = 32;
+    if (!jobs || rows < (int)minRowsPerTask * 2) {
+        fn(0, rows);
+        return;
+    }
+    jobs->parallelFor(0, (size_t)rows, [&fn](size_t first, size_t last) { fn((int)first, (int)last); }, minRowsPerTask);
+}
+
+} // namespace mip_detail
+
+// level 0 已经写好，依次生成其余各级
+inline void generateMips(MipChain& chain, JobSystem* jobs = nullptr, MipFilterPath path = MipFilterPath::SIMD) {
+    using namespace mip_detail;
+    if (!chain.srgb || chain.channels != 4) {
+        for (size_t i = 1; i < chain.levels.size(); ++i) {
+            const MipLevelInfo& prev = chain.levels[i - 1];
+            const uint8_t* src = chain.level(i - 1);
+            uint8_t* dst = chain.writableLevel(i);
+            forEachRowRange(chain.levels[i].height, jobs, [&](int first, int last) {
+                downsampleRows(src, prev.width, prev.height, chain.channels, dst, first, last, path);
+            });
+        }
+        return;
+    }
+
+    // sRGB：每级在 12 位线性空间缩小，再查表编码回 sRGB，中间不反复量化到 8 位
+    // level 0 不整张转线性（太占内存带宽），而是逐行把两行源像素查表转换后直接缩小
+    const SrgbTables& t = srgbTables();
+    std::unique_ptr<uint16_t[]> current, next;
+    for (size_t i = 1; i < chain.levels.size(); ++i) {
+        const MipLevelInfo& prev = chain.levels[i - 1];
+        const MipLevelInfo& level = chain.levels[i];
+        next.reset(new uint16_t[level.size]);
+        const uint8_t* base = chain.level(0);
+        uint8_t* dst = chain.writableLevel(i);
+        forEachRowRange(level.height, jobs, [&](int first, int last) {
+            std::vector<uint16_t> rows;
+            if (i == 1)
+                rows.resize((size_t)prev.width * 8);
+            for (int y = first; y < last; ++y) {
+                uint16_t* out = next.get() + (size_t)y * level.width * 4;
+                if (i == 1) {
+                    for (int r = 0; r < 2; ++r) {
+                        const uint8_t* in = base + (size_t)std::min(y * 2 + r, prev.height - 1) * prev.width * 4;
+                        uint16_t* linear = rows.data() + (size_t)r * prev.width * 4;
+                        for (int p = 0; p < prev.width * 4; p += 4) {
+                            linear[p + 0] = t.toLinear[in[p + 0]];
+                            linear[p + 1] = t.toLinear[in[p + 1]];
+                            linear[p + 2] = t.toLinear[in[p + 2]];
+                            linear[p + 3] = in[p + 3];
+                        }
+                    }
+                    // 两行拼成一张高为 2 的小图
+                    downsampleRows(rows.data(), prev.width, 2, 4, out, 0, 1, path);
+                } else {
+                    downsampleRows(current.get(), prev.width, prev.height, 4, next.get(), y, y + 1, path);
+                }
+                uint8_t* encoded = dst + (size_t)y * level.width * 4;
+                for (int p = 0; p < level.width * 4; p += 4) {
+                    encoded[p + 0] = t.toSrgb[out[p + 0]];
+                    encoded[p + 1] = t.toSrgb[out[p + 1]];
+                    encoded[p + 2] = t.toSrgb[out[p + 2]];
+                    encoded[p + 3] = (uint8_t)out[p + 3];
+                }
+            }
+        });
+        current.swap(next);
+    }
+}
+
+// 按尺寸分配好整条链（内容未初始化）
+inline MipChain allocateMipChain(int width, int height, int channels, bool srgb) {
+    MipChain chain;
+    chain.width = width;
+    chain.height = height;
+    chain.channels = channels;
+    chain.srgb = srgb;
+    chain.levels = mipLayout(width, height, channels);
+    const MipLevelInfo& last = chain.levels.back();
+    chain.pixels.resize(last.offset + last.size);
+    return chain;
+}
+
+// 由 level 0 生成完整 mip 链（一直到 1x1）
+inline MipChain buildMipChain(const uint8_t* pixels, int width, int height, int channels, bool srgb,
+                              JobSystem* jobs = nullptr, MipFilterPath path = MipFilterPath::SIMD) {
+    MipChain chain = allocateMipChain(width, height, channels, srgb);
+    std::memcpy(chain.writableLevel(0), pixels, chain.levels[0].size);
+    generateMips(chain, jobs, path);
+    return chain;
+}
+
+#endif
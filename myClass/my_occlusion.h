@@ -0,0 +1,427 @@
+#ifndef OCCLUSION_H
+#define OCCLUSION_H
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <glm/glm.hpp>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "my_simd.h"
+#include "my_frustum.h"
+#include "my_jobSystem.h"
+
+// CPU 软件光栅化的遮挡剔除（纯 CPU，不依赖 GL）：
+//   1. begin(viewProj) 清空低分辨率深度缓冲
+//   2. addOccluder() 把遮挡体三角形变换到屏幕空间并做好边函数 / 深度平面的 setup
+//   3. rasterize() 按 tile 分桶，各 tile 并行光栅化（SSE2 4 像素 / AVX2 8 像素一组），再建 Hi-Z 金字塔
+//   4. isVisible() / cullAABBs() 用包围盒投影后的最近深度和 Hi-Z 里对应区域的最远深度比较
+// 深度取 NDC z 映射到 [0, 1]，越大越远；每个像素只取最小值，tile 之间互不重叠，
+// 所以结果与线程调度无关，CullPath::Scalar 和 SIMD 的深度缓冲逐字节一致
+// 保守性：跨过近平面的遮挡体三角形直接丢掉，跨过近平面或在屏幕外的包围盒一律当作可见
+class OcclusionBuffer {
+public:
+    static const int TILE_WIDTH = 32;
+    static const int TILE_HEIGHT = 16;
+
+    struct Stats {
+        size_t trianglesSubmitted = 0;  // addOccluder 收到的三角形
+        size_t trianglesSetup = 0;      // 通过近平面 / 视锥 / 面积检查，实际参与光栅化的
+        size_t tested = 0;              // cullAABBs 测试的包围盒
+        size_t occluded = 0;            // 其中被剔除的
+        double rasterUs = 0.0;          // 分桶 + 光栅化
+        double hizUs = 0.0;             // 建 Hi-Z 金字塔
+    };
+
+    // 宽高向上取到 2 的幂（且不小于一个 tile），Hi-Z 每级正好减半，2x2 取最远才是保守的
+    explicit OcclusionBuffer(int requestedWidth = 256, int requestedHeight = 128) {
+        width = TILE_WIDTH;
+        while (width < requestedWidth)
+            width *= 2;
+        height = TILE_HEIGHT;
+        while (height < requestedHeight)
+            height *= 2;
+        tilesX = width / TILE_WIDTH;
+        tilesY = height / TILE_HEIGHT;
+        int w = width, h = height;
+        for (;;) {
+            hiz.push_back({ w, h, std::vector<float>((size_t)w * h, 1.0f) });
+            if (w == 1 && h == 1)
+                break;
+            w = std::max(1, w / 2);
+            h = std::max(1, h / 2);
+        }
+        bins.resize((size_t)tilesX * tilesY);
+    }
+
+    int bufferWidth() const { return width; }
+    int bufferHeight() const { return height; }
+    int levels() const { return (int)hiz.size(); }
+    int levelWidth(int level) const { return hiz[level].width; }
+    int levelHeight(int level) const { return hiz[level].height; }
+    const float* depth(int level = 0) const { return hiz[level].depth.data(); }
+    const Stats& stats() const { return frameStats; }
+
+    void begin(const glm::mat4& viewProjection) {
+        viewProj = viewProjection;
+        triangles.clear();
+        frameStats = Stats{};
+    }
+
+    // positions 是 xyz 三角形列表（例如 CUBE_VERTICES），model 把它放进世界空间
+    void addOccluder(const float* positions, size_t vertexCount, const glm::mat4& model) {
+        glm::mat4 m = viewProj * model;
+        for (size_t i = 0; i + 2 < vertexCount; i += 3) {
+            glm::vec4 clip[3];
+            for (int k = 0; k < 3; ++k) {
+                const float* p = positions + (i + k) * 3;
+                clip[k] = m * glm::vec4(p[0], p[1], p[2], 1.0f);
+            }
+            ++frameStats.trianglesSubmitted;
+            setupTriangle(clip);
+        }
+    }
+
+    // 光栅化所有遮挡体并建 Hi-Z；jobs 为空时在当前线程完成
+    void rasterize(JobSystem* jobs = nullptr, CullPath path = CullPath::SIMD) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<float>& buffer = hiz[0].depth;
+        std::fill(buffer.begin(), buffer.end(), 1.0f);
+
+        for (std::vector<uint32_t>& bin : bins)
+            bin.clear();
+        for (size_t i = 0; i < triangles.size(); ++i) {
+            const Triangle& t = triangles[i];
+            for (int ty = t.minY / TILE_HEIGHT; ty <= t.maxY / TILE_HEIGHT; ++ty)
+                for (int tx = t.minX / TILE_WIDTH; tx <= t.maxX / TILE_WIDTH; ++tx)
+                    bins[(size_t)ty * tilesX + tx].push_back((uint32_t)i);
+        }
+
+        int tileCount = tilesX * tilesY;
+        if (jobs && jobs->size() > 1) {
+            // 每个分块的三角形数差别很大（空块直接跳过），一次一块，靠窃取平衡负载
+            jobs->parallelFor(0, (size_t)tileCount, [this, path](size_t first, size_t last) {
+                for (size_t tile = first; tile < last; ++tile)
+                    if (!bins[tile].empty())
+                        rasterizeTile((int)tile, path);
+            }, 1);
+        } else {
+            for (int tile = 0; tile < tileCount; ++tile)
+                rasterizeTile(tile, path);
+        }
+        auto rasterized = std::chrono::steady_clock::now();
+        buildHiZ(path);
+
+        frameStats.rasterUs = std::chrono::duration<double, std::micro>(rasterized - start).count();
+        frameStats.hizUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - rasterized).count();
+    }
+
+    // 中心 + 半长表示的世界空间 AABB 是否可能可见（没有被 rasterize() 过的遮挡体完全挡住）
+    bool isVisible(const glm::vec3& center, const glm::vec3& extent) const {
+        // 8 个角 = 中心 ± 三个轴向半长，变换是线性的，只需要算一次中心和三个轴
+        glm::vec4 base = viewProj * glm::vec4(center, 1.0f);
+        glm::vec4 axisX = viewProj[0] * extent.x, axisY = viewProj[1] * extent.y, axisZ = viewProj[2] * extent.z;
+        float minX, minY, maxX, maxY, minZ;
+        if (!projectBox(base, axisX, axisY, axisZ, minX, minY, maxX, maxY, minZ))
+            return true;
+        if (maxX < 0.0f || maxY < 0.0f || minX >= (float)width || minY >= (float)height || minZ <= 0.0f)
+            return true;
+
+        int x0 = std::max(0, (int)minX), x1 = std::min(width - 1, (int)maxX);
+        int y0 = std::max(0, (int)minY), y1 = std::min(height - 1, (int)maxY);
+        // 选 2^level >= 矩形边长的一级，矩形在这一级最多跨 2x2 个纹素，固定读 4 个值，不再有变长循环
+        int size = std::max(x1 - x0, y1 - y0);
+        int level = std::min(size > 0 ? bitWidth((uint32_t)size) : 0, (int)hiz.size() - 1);
+        const HiZLevel& l = hiz[level];
+        const float* row0 = l.depth.data() + (size_t)(y0 >> level) * l.width;
+        const float* row1 = l.depth.data() + (size_t)(y1 >> level) * l.width;
+        int c0 = x0 >> level, c1 = x1 >> level;
+        float farthest = std::max(std::max(row0[c0], row0[c1]), std::max(row1[c0], row1[c1]));
+        return minZ <= farthest;
+    }
+
+    // 就地过滤下标列表（通常是视锥剔除的结果），只留下可能可见的，返回剩余数量
+    size_t cullAABBs(const AABBSoA& bounds, std::vector<uint32_t>& indices) {
+        size_t kept = 0;
+        for (uint32_t index : indices) {
+            glm::vec3 center(bounds.cx[index], bounds.cy[index], bounds.cz[index]);
+            glm::vec3 extent(bounds.ex[index], bounds.ey[index], bounds.ez[index]);
+            if (isVisible(center, extent))
+                indices[kept++] = index;
+        }
+        frameStats.tested += indices.size();
+        frameStats.occluded += indices.size() - kept;
+        indices.resize(kept);
+        return kept;
+    }
+
+private:
+    static constexpr float MIN_W = 1e-5f;
+
+    // 屏幕空间三角形：三条边函数 e = a*x + b*y + c（三角形内部全部 >= 0）和深度平面 z = za*x + zb*y + zc
+    struct Triangle {
+        float a[3], b[3], c[3];
+        float za, zb, zc;
+        int minX, minY, maxX, maxY;
+    };
+
+    struct HiZLevel {
+        int width, height;
+        std::vector<float> depth;
+    };
+
+    int width, height, tilesX, tilesY;
+    glm::mat4 viewProj{ 1.0f };
+    std::vector<Triangle> triangles;
+    std::vector<std::vector<uint32_t>> bins;
+    std::vector<HiZLevel> hiz;  // hiz[0] 就是深度缓冲，之后每级取 2x2 里最远的深度
+    Stats frameStats;
+
+    // 投影 8 个角，求屏幕矩形和最近深度；有角在相机平面附近或后面时返回 false
+    // SSE2 把 8 个角分成两组 4 个一起算，运算顺序和标量版相同
+    bool projectBox(const glm::vec4& base, const glm::vec4& axisX, const glm::vec4& axisY, const glm::vec4& axisZ,
+                    float& minX, float& minY, float& maxX, float& maxY, float& minZ) const {
+#if defined(MY_SIMD_SSE2)
+        const __m128 signX = _mm_setr_ps(-1.0f, 1.0f, -1.0f, 1.0f), signY = _mm_setr_ps(-1.0f, -1.0f, 1.0f, 1.0f);
+        const __m128 signZ[2] = { _mm_set1_ps(-1.0f), _mm_set1_ps(1.0f) };
+        const __m128 half = _mm_set1_ps(0.5f), w = _mm_set1_ps((float)width), h = _mm_set1_ps((float)height);
+        auto corners = [&](int c, __m128 sz) {
+            return _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_set1_ps(base[c]), _mm_mul_ps(signX, _mm_set1_ps(axisX[c]))),
+                                         _mm_mul_ps(signY, _mm_set1_ps(axisY[c]))), _mm_mul_ps(sz, _mm_set1_ps(axisZ[c])));
+        };
+        __m128 wMin = _mm_set1_ps(1e30f);
+        __m128 xMin = wMin, yMin = wMin, zMin = wMin, xMax = _mm_set1_ps(-1e30f), yMax = xMax;
+        for (int g = 0; g < 2; ++g) {
+            __m128 cx = corners(0, signZ[g]), cy = corners(1, signZ[g]), cz = corners(2, signZ[g]), cw = corners(3, signZ[g]);
+            wMin = _mm_min_ps(wMin, cw);
+            __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), cw);
+            __m128 sx = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(cx, inv), half), half), w);
+            __m128 sy = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(cy, inv), half), half), h);
+            __m128 sz = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cz, inv), half), half);
+            xMin = _mm_min_ps(xMin, sx);
+            xMax = _mm_max_ps(xMax, sx);
+            yMin = _mm_min_ps(yMin, sy);
+            yMax = _mm_max_ps(yMax, sy);
+            zMin = _mm_min_ps(zMin, sz);
+        }
+        if (horizontalMin(wMin) <= MIN_W)
+            return false;
+        minX = horizontalMin(xMin);
+        maxX = horizontalMax(xMax);
+        minY = horizontalMin(yMin);
+        maxY = horizontalMax(yMax);
+        minZ = horizontalMin(zMin);
+        return true;
+#else
+        minX = minY = minZ = 1e30f;
+        maxX = maxY = -1e30f;
+        for (int k = 0; k < 8; ++k) {
+            glm::vec4 clip = base + ((k & 1) ? axisX : -axisX) + ((k & 2) ? axisY : -axisY) + ((k & 4) ? axisZ : -axisZ);
+            if (clip.w <= MIN_W)
+                return false;
+            float inv = 1.0f / clip.w;
+            minX = std::min(minX, (clip.x * inv * 0.5f + 0.5f) * width);
+            maxX = std::max(maxX, (clip.x * inv * 0.5f + 0.5f) * width);
+            minY = std::min(minY, (clip.y * inv * 0.5f + 0.5f) * height);
+            maxY = std::max(maxY, (clip.y * inv * 0.5f + 0.5f) * height);
+            minZ = std::min(minZ, clip.z * inv * 0.5f + 0.5f);
+        }
+        return true;
+#endif
+    }
+
+    // 表示 value 需要的位数（value > 0），即 2^n > value 的最小 n
+    static int bitWidth(uint32_t value) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse(&index, value);
+        return (int)index + 1;
+#else
+        return 32 - __builtin_clz(value);
+#endif
+    }
+
+#if defined(MY_SIMD_SSE2)
+    static float horizontalMin(__m128 v) {
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(v);
+    }
+    static float horizontalMax(__m128 v) {
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(v);
+    }
+#endif
+
+    void setupTriangle(const glm::vec4* clip) {
+        // 任何一个顶点在相机平面附近或后面就丢掉整个三角形（少挡一点，不会错挡）
+        for (int k = 0; k < 3; ++k)
+            if (clip[k].w <= MIN_W)
+                return;
+        // 三个顶点都在同一个裁剪面外侧，不可能覆盖屏幕
+        for (int axis = 0; axis < 3; ++axis) {
+            bool allBelow = true, allAbove = true;
+            for (int k = 0; k < 3; ++k) {
+                allBelow = allBelow && clip[k][axis] < -clip[k].w;
+                allAbove = allAbove && clip[k][axis] > clip[k].w;
+            }
+            if (allBelow || allAbove)
+                return;
+        }
+
+        float x[3], y[3], z[3];
+        for (int k = 0; k < 3; ++k) {
+            float inv = 1.0f / clip[k].w;
+            x[k] = (clip[k].x * inv * 0.5f + 0.5f) * width;
+            y[k] = (clip[k].y * inv * 0.5f + 0.5f) * height;
+            z[k] = clip[k].z * inv * 0.5f + 0.5f;
+        }
+        float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+        if (std::fabs(area) < 1e-8f)
+            return;
+        // 统一成逆时针，正反面都当遮挡体
+        if (area < 0.0f) {
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+            std::swap(z[1], z[2]);
+            area = -area;
+        }
+
+        Triangle t;
+        t.minX = std::max(0, (int)std::floor(std::min({ x[0], x[1], x[2] })));
+        t.maxX = std::min(width - 1, (int)std::ceil(std::max({ x[0], x[1], x[2] })));
+        t.minY = std::max(0, (int)std::floor(std::min({ y[0], y[1], y[2] })));
+        t.maxY = std::min(height - 1, (int)std::ceil(std::max({ y[0], y[1], y[2] })));
+        if (t.minX > t.maxX || t.minY > t.maxY)
+            return;
+
+        for (int k = 0; k < 3; ++k) {
+            int j = (k + 1) % 3;
+            t.a[k] = y[k] - y[j];
+            t.b[k] = x[j] - x[k];
+            t.c[k] = -(t.a[k] * x[k] + t.b[k] * y[k]);
+        }
+        t.za = ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) / area;
+        t.zb = ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) / area;
+        t.zc = z[0] - t.za * x[0] - t.zb * y[0];
+        triangles.push_back(t);
+        ++frameStats.trianglesSetup;
+    }
+
+    void rasterizeTile(int tile, CullPath path) {
+        int tx0 = (tile % tilesX) * TILE_WIDTH, ty0 = (tile / tilesX) * TILE_HEIGHT;
+        float* buffer = hiz[0].depth.data();
+        for (uint32_t index : bins[tile]) {
+            const Triangle& t = triangles[index];
+            int xLo = std::max(t.minX, tx0), xHi = std::min(t.maxX, tx0 + TILE_WIDTH - 1);
+            int yLo = std::max(t.minY, ty0), yHi = std::min(t.maxY, ty0 + TILE_HEIGHT - 1);
+            for (int y = yLo; y <= yHi; ++y) {
+                float* row = buffer + (size_t)y * width;
+                float py = (float)y + 0.5f;
+                // 每条边 / 深度平面对当前行是常数的部分
+                float r0 = t.b[0] * py + t.c[0], r1 = t.b[1] * py + t.c[1], r2 = t.b[2] * py + t.c[2];
+                float rz = t.zb * py + t.zc;
+                int x = xLo;
+                if (path == CullPath::SIMD)
+                    x = rasterizeSpanSIMD(t, row, xLo, xHi, r0, r1, r2, rz);
+                for (; x <= xHi; ++x) {
+                    float px = (float)x + 0.5f;
+                    float e0 = t.a[0] * px + r0, e1 = t.a[1] * px + r1, e2 = t.a[2] * px + r2;
+                    if (e0 >= 0.0f && e1 >= 0.0f && e2 >= 0.0f) {
+                        float z = t.za * px + rz;
+                        row[x] = row[x] < z ? row[x] : z;
+                    }
+                }
+            }
+        }
+    }
+
+    // 从 xLo 所在的对齐组开始一次处理 4/8 个像素，组内超出 [xLo, xHi] 的像素用掩码屏蔽，返回处理到的位置
+    static int rasterizeSpanSIMD(const Triangle& t, float* row, int xLo, int xHi, float r0, float r1, float r2, float rz) {
+#if defined(MY_SIMD_AVX2)
+        const int lanes = 8;
+        int x = xLo & ~(lanes - 1);
+        __m256 offsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+        __m256 lo = _mm256_set1_ps((float)xLo), hi = _mm256_set1_ps((float)xHi + 1.0f), zero = _mm256_setzero_ps();
+        __m256 a0 = _mm256_set1_ps(t.a[0]), a1 = _mm256_set1_ps(t.a[1]), a2 = _mm256_set1_ps(t.a[2]), za = _mm256_set1_ps(t.za);
+        __m256 v0 = _mm256_set1_ps(r0), v1 = _mm256_set1_ps(r1), v2 = _mm256_set1_ps(r2), vz = _mm256_set1_ps(rz);
+        for (; x <= xHi; x += lanes) {
+            __m256 px = _mm256_add_ps(_mm256_set1_ps((float)x), offsets);
+            __m256 mask = _mm256_and_ps(_mm256_cmp_ps(px, lo, _CMP_GE_OQ), _mm256_cmp_ps(px, hi, _CMP_LT_OQ));
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a0, px), v0), zero, _CMP_GE_OQ));
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a1, px), v1), zero, _CMP_GE_OQ));
+            mask = _mm256_and_ps(mask, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a2, px), v2), zero, _CMP_GE_OQ));
+            if (_mm256_movemask_ps(mask) == 0)
+                continue;
+            __m256 z = _mm256_add_ps(_mm256_mul_ps(za, px), vz);
+            __m256 old = _mm256_loadu_ps(row + x);
+            _mm256_storeu_ps(row + x, _mm256_blendv_ps(old, _mm256_min_ps(old, z), mask));
+        }
+        return x;
+#elif defined(MY_SIMD_SSE2)
+        const int lanes = 4;
+        int x = xLo & ~(lanes - 1);
+        __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        __m128 lo = _mm_set1_ps((float)xLo), hi = _mm_set1_ps((float)xHi + 1.0f), zero = _mm_setzero_ps();
+        __m128 a0 = _mm_set1_ps(t.a[0]), a1 = _mm_set1_ps(t.a[1]), a2 = _mm_set1_ps(t.a[2]), za = _mm_set1_ps(t.za);
+        __m128 v0 = _mm_set1_ps(r0), v1 = _mm_set1_ps(r1), v2 = _mm_set1_ps(r2), vz = _mm_set1_ps(rz);
+        for (; x <= xHi; x += lanes) {
+            __m128 px = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+            __m128 mask = _mm_and_ps(_mm_cmpge_ps(px, lo), _mm_cmplt_ps(px, hi));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), v0), zero));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), v1), zero));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), v2), zero));
+            if (_mm_movemask_ps(mask) == 0)
+                continue;
+            __m128 z = _mm_add_ps(_mm_mul_ps(za, px), vz);
+            __m128 old = _mm_loadu_ps(row + x);
+            __m128 nearer = _mm_min_ps(old, z);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, nearer), _mm_andnot_ps(mask, old)));
+        }
+        return x;
+#else
+        (void)t; (void)row; (void)xHi; (void)r0; (void)r1; (void)r2; (void)rz;
+        return xLo;
+#endif
+    }
+
+    // 每级取 2x2 里最远的深度；某一维已经缩到 1 之后那一维重复同一行（列）
+    void buildHiZ(CullPath path) {
+        for (size_t level = 1; level < hiz.size(); ++level) {
+            const HiZLevel& src = hiz[level - 1];
+            HiZLevel& dst = hiz[level];
+            for (int y = 0; y < dst.height; ++y) {
+                const float* row0 = src.depth.data() + (size_t)std::min(y * 2, src.height - 1) * src.width;
+                const float* row1 = src.depth.data() + (size_t)std::min(y * 2 + 1, src.height - 1) * src.width;
+                float* out = dst.depth.data() + (size_t)y * dst.width;
+                int x = 0;
+#if defined(MY_SIMD_SSE2)
+                if (path == CullPath::SIMD && src.width >= 2) {
+                    for (; x + 4 <= dst.width; x += 4) {
+                        __m128 m0 = _mm_max_ps(_mm_loadu_ps(row0 + x * 2), _mm_loadu_ps(row1 + x * 2));
+                        __m128 m1 = _mm_max_ps(_mm_loadu_ps(row0 + x * 2 + 4), _mm_loadu_ps(row1 + x * 2 + 4));
+                        __m128 even = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(2, 0, 2, 0));
+                        __m128 odd = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(3, 1, 3, 1));
+                        _mm_storeu_ps(out + x, _mm_max_ps(even, odd));
+                    }
+                }
+#else
+                (void)path;
+#endif
+                for (; x < dst.width; ++x) {
+                    int x0 = std::min(x * 2, src.width - 1), x1 = std::min(x * 2 + 1, src.width - 1);
+                    float a = row0[x0] > row1[x0] ? row0[x0] : row1[x0];
+                    float b = row0[x1] > row1[x1] ? row0[x1] : row1[x1];
+                    out[x] = a > b ? a : b;
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,560 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include "my_glState.h"
+#include "my_shader.h"
+#include "my_uniformBlocks.h"
+#include "my_frameAllocator.h"
+#include "my_jobSystem.h"
+
+// 渲染通道：决定混合 / 深度写入，同时是排序键的最高位
+enum class RenderPass : uint8_t {
+    Opaque = 0,      // 不混合，写深度，从前往后画
+    Transparent = 1, // alpha 混合，不写深度，从后往前画
+    Overlay = 2      // alpha 混合，关闭深度测试，最后画
+};
+
+enum class UniformKind : uint8_t { Int, Float, Vec3, Vec4, Mat4 };
+
+// 一次 uniform 写入：数据放在帧分配器里，同一个绘制包的写入串成链表
+struct UniformWrite {
+    UniformWrite* next;
+    const void* data;
+    GLint location;
+    UniformKind kind;
+};
+
+// 一个绘制包：执行一次 draw 需要的全部状态，按值比较，不引用任何 C++ 对象
+// 由 RenderQueue::record 从帧分配器里分配，只在当前帧有效
+struct DrawPacket {
+    static const unsigned MAX_TEXTURES = 4;
+
+    GLuint program = 0;
+    GLuint vao = 0;
+    GLuint textures[MAX_TEXTURES] = {};       // 0 表示该单元不使用
+    GLenum textureTargets[MAX_TEXTURES] = {};
+    UniformWrite* uniforms = nullptr;
+
+    // 每次 draw 的 uniform block（ObjectBlock），通常从 StreamBuffer 里分配；buffer 为 0 表示不用
+    GLuint blockBuffer = 0;
+    GLintptr blockOffset = 0;
+    GLsizeiptr blockSize = 0;
+
+    GLenum mode = GL_TRIANGLES;
+    GLenum indexType = 0;                      // 0 表示 glDrawArrays*
+    GLintptr first = 0;                        // 索引绘制时为索引缓冲里的字节偏移，超过 2GB 的缓冲也放得下
+    GLsizei count = 0;
+    GLsizei instances = 1;
+
+    float depth = 0.0f;                        // 到相机的距离，只用于排序
+    RenderPass pass = RenderPass::Opaque;
+
+    void setTexture(unsigned unit, GLenum target, GLuint id) {
+        if (unit >= MAX_TEXTURES) {
+            std::cerr << "ERROR::RENDER_QUEUE::TEXTURE_UNIT_OUT_OF_RANGE: " << unit << std::endl;
+            return;
+        }
+        textures[unit] = id;
+        textureTargets[unit] = target;
+    }
+
+    void setUniformBlock(GLuint buffer, GLintptr offset, GLsizeiptr size) {
+        blockBuffer = buffer;
+        blockOffset = offset;
+        blockSize = size;
+    }
+
+    void setArrays(GLenum primitive, GLint firstVertex, GLsizei vertexCount, GLsizei instanceCount = 1) {
+        mode = primitive;
+        indexType = 0;
+        first = firstVertex;
+        count = vertexCount;
+        instances = instanceCount;
+    }
+
+    void setElements(GLenum primitive, GLsizei indexCount, GLenum type, GLintptr byteOffset = 0, GLsizei instanceCount = 1) {
+        mode = primitive;
+        indexType = type;
+        first = byteOffset;
+        count = indexCount;
+        instances = instanceCount;
+    }
+};
+
+// 命令列表：一块帧分配器 + 绘制包指针数组，录制绘制包和它们的 uniform 数据
+// 不碰 GL，可以在工作线程里填写；每个线程用自己的列表，互不加锁，最后由 GL 线程合并进 RenderQueue
+// 列表里的绘制包在下一次 reset() 之前有效
+class CommandList {
+public:
+    explicit CommandList(size_t maxPackets = 16384, size_t frameBytes = 4 << 20)
+        : frame(frameBytes), capacity(maxPackets), list(new const DrawPacket*[maxPackets]) {}
+
+    CommandList(const CommandList&) = delete;
+    CommandList& operator=(const CommandList&) = delete;
+
+    void reset() {
+        frame.reset();
+        count = 0;
+        overflowReported = false;
+    }
+
+    // 分配一个绘制包；列表或帧内存用完时返回 nullptr，调用方跳过这次绘制即可
+    DrawPacket* record(RenderPass pass, GLuint program, GLuint vao, float depth = 0.0f) {
+        DrawPacket* packet = count < capacity ? frame.create<DrawPacket>() : nullptr;
+        if (!packet) {
+            reportOverflow();
+            return nullptr;
+        }
+        packet->pass = pass;
+        packet->program = program;
+        packet->vao = vao;
+        packet->depth = depth;
+        list[count++] = packet;
+        return packet;
+    }
+
+    void setUniform(DrawPacket* packet, Uniform u, int value) { addUniform(packet, u, UniformKind::Int, &value, sizeof(value)); }
+    void setUniform(DrawPacket* packet, Uniform u, float value) { addUniform(packet, u, UniformKind::Float, &value, sizeof(value)); }
+    void setUniform(DrawPacket* packet, Uniform u, const glm::vec3& value) { addUniform(packet, u, UniformKind::Vec3, glm::value_ptr(value), sizeof(value)); }
+    void setUniform(DrawPacket* packet, Uniform u, const glm::vec4& value) { addUniform(packet, u, UniformKind::Vec4, glm::value_ptr(value), sizeof(value)); }
+    void setUniform(DrawPacket* packet, Uniform u, const glm::mat4& value) { addUniform(packet, u, UniformKind::Mat4, glm::value_ptr(value), sizeof(value)); }
+
+    size_t size() const { return count; }
+    const DrawPacket* const* packets() const { return list.get(); }
+    const FrameAllocator& memory() const { return frame; }
+
+private:
+    FrameAllocator frame;
+    size_t capacity;
+    size_t count = 0;
+    std::atomic<bool> overflowReported{ false };
+    std::unique_ptr<const DrawPacket*[]> list;
+
+    void addUniform(DrawPacket* packet, Uniform u, UniformKind kind, const void* value, size_t bytes) {
+        if (!packet || !u.valid())
+            return;
+        void* data = frame.allocate(bytes, 16);
+        UniformWrite* write = data ? frame.create<UniformWrite>() : nullptr;
+        if (!write) {
+            reportOverflow();
+            return;
+        }
+        std::memcpy(data, value, bytes);
+        // 追加到链表尾，提交时按调用顺序写入（同一个 location 写多次时后写的生效）
+        write->next = nullptr;
+        write->data = data;
+        write->location = u.location;
+        write->kind = kind;
+        UniformWrite** tail = &packet->uniforms;
+        while (*tail)
+            tail = &(*tail)->next;
+        *tail = write;
+    }
+
+    // 工作线程里也可能调用，每次 reset() 之后（即每帧）只报一次
+    void reportOverflow() {
+        if (overflowReported.exchange(true))
+            return;
+        std::cerr << "ERROR::RENDER_QUEUE::OUT_OF_FRAME_MEMORY: " << count << "/" << capacity << " packets, "
+                  << frame.used() << "/" << frame.capacity() << " bytes" << std::endl;
+    }
+};
+
+// 渲染命令队列：一帧里先录制所有绘制包，再按 64 位键基数排序后一次提交
+// 键的布局（高位在前，最低 4 位保留为 0）：
+//   不透明 / 覆盖层：通道 4 | 程序 12 | 纹理组合 12 | VAO 8 | 深度 24（近的在前）
+//   透明：           通道 4 | 深度 24（远的在前）| 程序 12 | 纹理组合 12 | VAO 8
+// 程序和 VAO 取 GL 名字的低位，纹理组合取哈希：冲突只影响分组效果，提交时按真实值比较状态
+// 录制期间不分配堆内存：绘制包和 uniform 数据都在帧分配器里，排序用的数组构造时一次分配好
+// 单线程时直接用 record / setUniform 写队列自带的列表；多线程时用 recordParallel，
+// 或者自己在工作线程里填 CommandList，再在 GL 线程上 merge。合并按调用顺序进行，排序是稳定的，
+// 所以结果和单线程按同样顺序录制完全一致：merge / recordParallel 之后再 record 的绘制包
+// 写进一个新的列表，接在已经合并的列表后面，不会插到它们前面
+class RenderQueue {
+public:
+    struct Stats {
+        unsigned packets = 0;
+        unsigned passChanges = 0;
+        unsigned programChanges = 0;
+        unsigned vaoChanges = 0;
+        unsigned textureChanges = 0;  // 按纹理单元计
+        unsigned uniformWrites = 0;
+        unsigned blockBinds = 0;      // ObjectBlock 的 glBindBufferRange
+        double sortUs = 0.0;
+
+        unsigned stateChanges() const { return passChanges + programChanges + vaoChanges + textureChanges; }
+    };
+
+    static const size_t MAX_LISTS = 64;
+
+    explicit RenderQueue(size_t maxPackets = 16384, size_t frameBytes = 4 << 20)
+        : local(maxPackets, frameBytes), capacity(maxPackets), frameBytes(frameBytes),
+          recorded(new const DrawPacket*[maxPackets]), ordered(new const DrawPacket*[maxPackets]),
+          items(new SortItem[maxPackets]), scratch(new SortItem[maxPackets]) {
+        begin();
+    }
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // 每帧录制前调用：作废上一帧的绘制包和合并进来的列表
+    void begin() {
+        local.reset();
+        lists[0] = &local;
+        listCount = 1;
+        current = &local;
+        workerListsUsed = 0;
+        serialListsUsed = 0;
+        overflowReported = false;
+        count = 0;
+        sorted = false;
+    }
+
+    DrawPacket* record(RenderPass pass, GLuint program, GLuint vao, float depth = 0.0f) {
+        sorted = false;
+        return serialList().record(pass, program, vao, depth);
+    }
+
+    template <typename T>
+    void setUniform(DrawPacket* packet, Uniform u, const T& value) { serialList().setUniform(packet, u, value); }
+
+    // 当前在录制的单线程列表，可以直接传给按 CommandList 写的录制函数
+    CommandList& commands() {
+        sorted = false;
+        return serialList();
+    }
+
+    // 合并一个在别处填好的列表（只记指针，不复制）；列表在 submit 之前不能 reset
+    void merge(const CommandList& list) {
+        if (listCount == MAX_LISTS) {
+            std::cerr << "ERROR::RENDER_QUEUE::TOO_MANY_LISTS: " << MAX_LISTS << std::endl;
+            return;
+        }
+        lists[listCount++] = &list;
+        current = nullptr;
+        sorted = false;
+    }
+
+    // 把 [0, itemCount) 平均分成每个线程一段，每段往自己的 CommandList 录制（调用线程也录一段），
+    // record(list, begin, end) 里不能调用 GL；返回时各段已按顺序合并进队列
+    // 同一帧里可以调用多次：每次从本帧还没用过的列表往后取，已经合并的列表在 begin() 之前不会被 reset
+    // 列表第一次用到时创建，容量按段数均分队列容量并留一倍余量，之后每帧复用
+    template <typename RecordFn>
+    void recordParallel(JobSystem& jobs, size_t itemCount, RecordFn&& record) {
+        size_t chunks = std::min(std::min(jobs.size(), MAX_LISTS - listCount), itemCount);
+        if (chunks <= 1) {
+            record(serialList(), (size_t)0, itemCount);
+            sorted = false;
+            return;
+        }
+        size_t first = workerListsUsed;
+        workerListsUsed += chunks;
+        while (workerLists.size() < workerListsUsed)
+            workerLists.emplace_back(new CommandList(2 * capacity / chunks + 1, 2 * frameBytes / chunks));
+        jobs.parallelFor(0, chunks, [&](size_t firstChunk, size_t lastChunk) {
+            for (size_t c = firstChunk; c < lastChunk; ++c) {
+                CommandList* list = workerLists[first + c].get();
+                list->reset();
+                record(*list, itemCount * c / chunks, itemCount * (c + 1) / chunks);
+            }
+        }, 1);
+        for (size_t c = 0; c < chunks; ++c)
+            merge(*workerLists[first + c]);
+    }
+
+    // 生成排序键并排序；submit() 会在需要时自动调用
+    void sort() {
+        auto start = std::chrono::steady_clock::now();
+        gather();
+        for (size_t i = 0; i < count; ++i)
+            items[i] = SortItem{ makeKey(*recorded[i]), (uint32_t)i };
+        radixSort(items.get(), scratch.get(), count);
+        for (size_t i = 0; i < count; ++i)
+            ordered[i] = recorded[items[i].index];
+        sorted = true;
+        sortTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 按排序后的顺序执行：只有状态和上一个包不同时才切换，结束时恢复不透明通道的默认状态
+    void submit() {
+        if (!sorted)
+            sort();
+        last = Stats{};
+        last.packets = (unsigned)count;
+        last.sortUs = sortTime;
+
+        const DrawPacket* previous = nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            const DrawPacket& packet = *ordered[i];
+            unsigned changes = diff(previous, packet);
+            tally(last, changes);
+
+            if (changes & CHANGE_PASS)
+                applyPass(packet.pass);
+            if (changes & CHANGE_PROGRAM)
+                glState().useProgram(packet.program);
+            if (changes & CHANGE_VAO)
+                glState().bindVertexArray(packet.vao);
+            for (unsigned unit = 0; unit < DrawPacket::MAX_TEXTURES; ++unit)
+                if (changes & (CHANGE_TEXTURE << unit))
+                    glState().bindTextureUnit(unit, packet.textureTargets[unit], packet.textures[unit]);
+            for (const UniformWrite* u = packet.uniforms; u; u = u->next) {
+                applyUniform(*u);
+                ++last.uniformWrites;
+            }
+            if (blockChanged(previous, packet)) {
+                glState().bindBufferRange(GL_UNIFORM_BUFFER, OBJECT_BLOCK_BINDING, packet.blockBuffer,
+                                          packet.blockOffset, packet.blockSize);
+                ++last.blockBinds;
+            }
+
+            if (packet.indexType == 0)
+                glDrawArraysInstanced(packet.mode, (GLint)packet.first, packet.count, packet.instances);
+            else
+                glDrawElementsInstanced(packet.mode, packet.count, packet.indexType,
+                                        (const void*)packet.first, packet.instances);
+            previous = &packet;
+        }
+        if (previous && previous->pass != RenderPass::Opaque)
+            applyPass(RenderPass::Opaque);
+    }
+
+    // 所有列表里的绘制包总数（超出队列容量的部分排序时会被丢弃）
+    size_t size() const {
+        if (sorted)
+            return count;
+        size_t total = 0;
+        for (size_t l = 0; l < listCount; ++l)
+            total += lists[l]->size();
+        return std::min(total, capacity);
+    }
+    const Stats& stats() const { return last; }  // 上一次 submit 的统计
+    const FrameAllocator& memory() const { return local.memory(); }
+
+    // 录制顺序（合并后）和排序后的顺序，sort() 之后有效；供基准程序在没有 GL 上下文时比较状态切换次数
+    const DrawPacket* const* recordedPackets() const { return recorded.get(); }
+    const DrawPacket* const* sortedPackets() const { return ordered.get(); }
+
+    // 按给定顺序执行会产生多少次状态切换（和 submit 用同一套比较规则，不调用 GL）
+    static Stats countStateChanges(const DrawPacket* const* packets, size_t n) {
+        Stats stats;
+        stats.packets = (unsigned)n;
+        const DrawPacket* previous = nullptr;
+        for (size_t i = 0; i < n; ++i) {
+            tally(stats, diff(previous, *packets[i]));
+            for (const UniformWrite* u = packets[i]->uniforms; u; u = u->next)
+                ++stats.uniformWrites;
+            if (blockChanged(previous, *packets[i]))
+                ++stats.blockBinds;
+            previous = packets[i];
+        }
+        return stats;
+    }
+
+    static uint64_t makeKey(const DrawPacket& packet) {
+        uint64_t pass = (uint64_t)packet.pass & 0xF;
+        uint64_t program = packet.program & 0xFFF;
+        uint64_t material = textureHash(packet) & 0xFFF;
+        uint64_t vao = packet.vao & 0xFF;
+        uint64_t depth = depthBits(packet.depth);
+        if (packet.pass == RenderPass::Transparent)
+            return pass << 60 | (0xFFFFFFull - depth) << 36 | program << 24 | material << 12 | vao << 4;
+        return pass << 60 | program << 48 | material << 36 | vao << 28 | depth << 4;
+    }
+
+private:
+    struct SortItem {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    enum : unsigned {
+        CHANGE_PASS = 1u << 0,
+        CHANGE_PROGRAM = 1u << 1,
+        CHANGE_VAO = 1u << 2,
+        CHANGE_TEXTURE = 1u << 3  // 之后每个纹理单元占一位
+    };
+
+    CommandList local;
+    const CommandList* lists[MAX_LISTS] = {};
+    size_t listCount = 0;
+    std::vector<std::unique_ptr<CommandList>> workerLists;
+    size_t workerListsUsed = 0;  // 本帧 recordParallel 已经取走的列表数
+    // record() 写的列表：本帧开头是 local；merge 之后置空，下一次 record() 再从 serialLists 取一个接在后面
+    CommandList* current = &local;
+    std::vector<std::unique_ptr<CommandList>> serialLists;
+    size_t serialListsUsed = 0;
+
+    size_t capacity;
+    size_t frameBytes;
+    size_t count = 0;
+    bool sorted = false;
+    bool overflowReported = false;  // 本帧已经报过 PACKET_LIMIT，begin() 时清掉
+    double sortTime = 0.0;
+    Stats last;
+
+    std::unique_ptr<const DrawPacket*[]> recorded;
+    std::unique_ptr<const DrawPacket*[]> ordered;
+    std::unique_ptr<SortItem[]> items;
+    std::unique_ptr<SortItem[]> scratch;
+
+    // 合并过别的列表之后，单线程录制换一个新列表并立刻合并，保证它排在已合并的列表后面
+    // 这些列表和 local 一样按整个队列的容量创建；列表数用完时（merge 已经报过错）退回写 local，顺序不再保证
+    CommandList& serialList() {
+        if (current)
+            return *current;
+        if (listCount == MAX_LISTS) {
+            current = &local;
+            return local;
+        }
+        if (serialListsUsed == serialLists.size())
+            serialLists.emplace_back(new CommandList(capacity, frameBytes));
+        CommandList* list = serialLists[serialListsUsed++].get();
+        list->reset();
+        merge(*list);
+        current = list;
+        return *list;
+    }
+
+    // 按合并顺序把各列表的绘制包指针收集到一起
+    void gather() {
+        count = 0;
+        for (size_t l = 0; l < listCount; ++l) {
+            const CommandList& list = *lists[l];
+            size_t n = std::min(list.size(), capacity - count);
+            if (n < list.size() && !overflowReported) {
+                std::cerr << "ERROR::RENDER_QUEUE::PACKET_LIMIT: dropping " << list.size() - n
+                          << " packets over " << capacity << std::endl;
+                overflowReported = true;
+            }
+            std::memcpy(recorded.get() + count, list.packets(), n * sizeof(const DrawPacket*));
+            count += n;
+        }
+    }
+
+    // 正浮点数的位模式和数值同序，取高 24 位即可；负数和 NaN 当作 0
+    static uint64_t depthBits(float depth) {
+        if (!(depth > 0.0f))
+            return 0;
+        uint32_t bits;
+        std::memcpy(&bits, &depth, sizeof(bits));
+        return bits >> 7;
+    }
+
+    static uint32_t textureHash(const DrawPacket& packet) {
+        uint32_t h = 2166136261u;
+        for (unsigned unit = 0; unit < DrawPacket::MAX_TEXTURES; ++unit)
+            h = (h ^ packet.textures[unit]) * 16777619u;
+        return h ^ (h >> 12) ^ (h >> 24);
+    }
+
+    static unsigned diff(const DrawPacket* previous, const DrawPacket& packet) {
+        if (!previous) {
+            unsigned changes = CHANGE_PASS | CHANGE_PROGRAM | CHANGE_VAO;
+            for (unsigned unit = 0; unit < DrawPacket::MAX_TEXTURES; ++unit)
+                if (packet.textures[unit] != 0)
+                    changes |= CHANGE_TEXTURE << unit;
+            return changes;
+        }
+        unsigned changes = 0;
+        if (previous->pass != packet.pass) changes |= CHANGE_PASS;
+        if (previous->program != packet.program) changes |= CHANGE_PROGRAM;
+        if (previous->vao != packet.vao) changes |= CHANGE_VAO;
+        // 不用的单元保持原来的绑定，不算切换
+        for (unsigned unit = 0; unit < DrawPacket::MAX_TEXTURES; ++unit)
+            if (packet.textures[unit] != 0 && (previous->textures[unit] != packet.textures[unit]
+                                               || previous->textureTargets[unit] != packet.textureTargets[unit]))
+                changes |= CHANGE_TEXTURE << unit;
+        return changes;
+    }
+
+    static bool blockChanged(const DrawPacket* previous, const DrawPacket& packet) {
+        return packet.blockBuffer != 0 && (!previous || previous->blockBuffer != packet.blockBuffer
+                                           || previous->blockOffset != packet.blockOffset
+                                           || previous->blockSize != packet.blockSize);
+    }
+
+    static void tally(Stats& stats, unsigned changes) {
+        if (changes & CHANGE_PASS) ++stats.passChanges;
+        if (changes & CHANGE_PROGRAM) ++stats.programChanges;
+        if (changes & CHANGE_VAO) ++stats.vaoChanges;
+        for (unsigned unit = 0; unit < DrawPacket::MAX_TEXTURES; ++unit)
+            if (changes & (CHANGE_TEXTURE << unit))
+                ++stats.textureChanges;
+    }
+
+    static void applyPass(RenderPass pass) {
+        GLStateCache& gl = glState();
+        if (pass == RenderPass::Opaque) {
+            gl.enable(GL_DEPTH_TEST);
+            gl.disable(GL_BLEND);
+            gl.depthMask(GL_TRUE);
+            return;
+        }
+        gl.enable(GL_BLEND);
+        gl.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gl.depthMask(GL_FALSE);
+        if (pass == RenderPass::Overlay)
+            gl.disable(GL_DEPTH_TEST);
+        else
+            gl.enable(GL_DEPTH_TEST);
+    }
+
+    static void applyUniform(const UniformWrite& u) {
+        const float* f = static_cast<const float*>(u.data);
+        switch (u.kind) {
+        case UniformKind::Int:   glUniform1i(u.location, *static_cast<const int*>(u.data)); break;
+        case UniformKind::Float: glUniform1f(u.location, *f); break;
+        case UniformKind::Vec3:  glUniform3fv(u.location, 1, f); break;
+        case UniformKind::Vec4:  glUniform4fv(u.location, 1, f); break;
+        case UniformKind::Mat4:  glUniformMatrix4fv(u.location, 1, GL_FALSE, f); break;
+        }
+    }
+
+    // LSD 基数排序，每趟 8 位：一次扫描建好全部 8 个直方图，所有元素该字节都相同的趟直接跳过
+    // （保留的低 4 位和没用到的通道位会被跳过）；稳定排序，键相同的包保持录制顺序
+    static void radixSort(SortItem* data, SortItem* temp, size_t n) {
+        if (n < 2)
+            return;
+        uint32_t histogram[8][256] = {};
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t key = data[i].key;
+            for (int b = 0; b < 8; ++b)
+                ++histogram[b][(key >> (b * 8)) & 0xFF];
+        }
+
+        SortItem* src = data;
+        SortItem* dst = temp;
+        for (int b = 0; b < 8; ++b) {
+            uint32_t* counts = histogram[b];
+            if (counts[(src[0].key >> (b * 8)) & 0xFF] == n)
+                continue;
+            uint32_t offset = 0;
+            for (int d = 0; d < 256; ++d) {
+                uint32_t c = counts[d];
+                counts[d] = offset;
+                offset += c;
+            }
+            for (size_t i = 0; i < n; ++i)
+                dst[counts[(src[i].key >> (b * 8)) & 0xFF]++] = src[i];
+            std::swap(src, dst);
+        }
+        if (src != data)
+            std::memcpy(data, src, n * sizeof(SortItem));
+    }
+};
+
+#endif
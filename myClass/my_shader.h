@@ -9,6 +9,49 @@
 #include <sstream>
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <chrono>
+
+#include <filesystem>
+
+#include "my_shaderCache.h"
+#include "my_uniformBlocks.h"
+#include "my_glState.h"
+
+// 编译期可计算的 uniform 名称哈希（FNV-1a 32位）
+constexpr uint32_t uniformHash(const char* str, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<uint8_t>(str[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+constexpr uint32_t uniformHash(const char* str) {
+    size_t len = 0;
+    while (str[len] != '\0') ++len;
+    return uniformHash(str, len);
+}
+// 用法："model"_uniform 在编译期得到哈希值，同时带着名字，查表时按字符串确认不是哈希碰撞
+struct UniformName {
+    const char* str;
+    size_t len;
+    uint32_t hash;
+};
+constexpr UniformName operator""_uniform(const char* str, size_t len) {
+    return UniformName{ str, len, uniformHash(str, len) };
+}
+
+// uniform 句柄：链接后解析一次，渲染循环里直接用 location 设置，不再查字符串
+struct Uniform {
+    GLint  location = -1;
+    GLenum type = 0;
+    GLint  size = 0;
+    bool valid() const { return location >= 0; }
+};
 
 class Shader {
 public:
@@ -16,10 +59,37 @@ public:
 
     // 构造函数：顶点着色器必须，片段着色器可选
     Shader(const char* vertexPath, const char* fragmentPath = nullptr) {
+        // 1. 读取顶点/片段着色器源码
         std::string vertexCode;
         std::string fragmentCode;
+        loadSources(vertexPath, fragmentPath, vertexCode, fragmentCode);
+
+        // 2. 先查程序二进制缓存，命中则跳过 GLSL 编译
+        ShaderBinaryCache& cache = shaderCache();
+        uint64_t cacheKey = cache.key(vertexCode, fragmentCode);
+        ID = glCreateProgram();
+        if (!cache.load(ID, cacheKey)) {
+            auto start = std::chrono::steady_clock::now();
+            compileAndLink(vertexCode, fragmentCode);
+            double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            cache.store(ID, cacheKey, elapsedMs);
+        }
+
+        // 3. 链接后一次性反射所有 active uniform，建立查找表，并绑定共享 uniform block
+        reflectUniforms();
+        bindUniformBlocks();
+    }
 
-        // 1. 读取顶点着色器
+    // 接管一个已经链接完成的程序（ShaderBatch 异步编译后使用）
+    explicit Shader(GLuint program) : ID(program) {
+        reflectUniforms();
+        bindUniformBlocks();
+    }
+
+    // 读取一对着色器源码：只做文件 IO 不调用 GL，可以在工作线程里执行
+    static void loadSources(const char* vertexPath, const char* fragmentPath,
+                            std::string& vertexCode, std::string& fragmentCode) {
+        // 读取顶点着色器
         std::ifstream vShaderFile;
         vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
         try {
@@ -31,8 +101,9 @@ public:
         } catch (std::ifstream::failure& e) {
             std::cerr << "ERROR::SHADER::VERTEX_FILE_NOT_READ\n";
         }
+        vertexCode = resolveIncludes(vertexCode, std::filesystem::path(vertexPath).parent_path());
 
-        // 2. 读取片段着色器，如果没有提供就用默认简单红色
+        // 读取片段着色器，如果没有提供就用默认简单红色
         if (fragmentPath) {
             std::ifstream fShaderFile;
             fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
@@ -42,6 +113,7 @@ public:
                 fShaderStream << fShaderFile.rdbuf();
                 fragmentCode = fShaderStream.str();
                 fShaderFile.close();
+                fragmentCode = resolveIncludes(fragmentCode, std::filesystem::path(fragmentPath).parent_path());
             } catch (std::ifstream::failure& e) {
                 std::cerr << "ERROR::SHADER::FRAGMENT_FILE_NOT_READ\n";
                 fragmentCode = defaultFragmentShader();
@@ -49,100 +121,122 @@ public:
         } else {
             fragmentCode = defaultFragmentShader();
         }
+    }
 
-        const char* vShaderCode = vertexCode.c_str();
-        const char* fShaderCode = fragmentCode.c_str();
-
-        // 3. 编译顶点着色器
-        GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, nullptr);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
-
-        // 4. 编译片段着色器
-        GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, nullptr);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
+    // 展开 #include "file"（相对当前文件目录），GLSL 本身不支持 include
+    static std::string resolveIncludes(const std::string& code, const std::filesystem::path& directory, int depth = 0) {
+        if (depth > 8) {
+            std::cerr << "ERROR::SHADER::INCLUDE_TOO_DEEP\n";
+            return code;
+        }
+        std::stringstream input(code);
+        std::string result, line;
+        while (std::getline(input, line)) {
+            size_t start = line.find_first_not_of(" \t");
+            if (start != std::string::npos && line.compare(start, 8, "#include") == 0) {
+                size_t open = line.find('"', start + 8);
+                size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+                if (close != std::string::npos) {
+                    std::filesystem::path includePath = directory / line.substr(open + 1, close - open - 1);
+                    std::ifstream includeFile(includePath);
+                    if (!includeFile) {
+                        std::cerr << "ERROR::SHADER::INCLUDE_NOT_READ: " << includePath.string() << "\n";
+                        continue;
+                    }
+                    std::stringstream includeStream;
+                    includeStream << includeFile.rdbuf();
+                    result += resolveIncludes(includeStream.str(), includePath.parent_path(), depth + 1);
+                    result += '\n';
+                    continue;
+                }
+            }
+            result += line;
+            result += '\n';
+        }
+        return result;
+    }
 
-        // 5. 链接程序
-        ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
-        glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
+    void use() const { glState().useProgram(ID); }
 
-        // 6. 删除着色器对象
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+    // 查找 uniform 句柄：只查本地表（按哈希二分，再比较名字），不会调用 glGetUniformLocation
+    Uniform uniform(const UniformName& name) const {
+        return findUniform(name.hash, name.str, name.len);
+    }
+    Uniform uniform(const std::string& name) const {
+        return findUniform(uniformHash(name.data(), name.size()), name.data(), name.size());
+    }
+    Uniform uniform(const char* name) const {
+        size_t len = std::strlen(name);
+        return findUniform(uniformHash(name, len), name, len);
     }
 
-    void use() const { glUseProgram(ID); }
+    // 句柄版本的设置方法
+    void setBool(Uniform u, bool value) const { glUniform1i(u.location, (int)value); }
+    void setInt(Uniform u, int value) const { glUniform1i(u.location, value); }
+    void setFloat(Uniform u, float value) const { glUniform1f(u.location, value); }
+    void setVec2(Uniform u, const glm::vec2& value) const { glUniform2fv(u.location, 1, glm::value_ptr(value)); }
+    void setVec3(Uniform u, float x, float y, float z) const { glUniform3f(u.location, x, y, z); }
+    void setVec3(Uniform u, const glm::vec3& value) const { glUniform3fv(u.location, 1, glm::value_ptr(value)); }
+    void setVec4(Uniform u, const glm::vec4& value) const { glUniform4fv(u.location, 1, glm::value_ptr(value)); }
+    void setMat3(Uniform u, const glm::mat3& mat) const { glUniformMatrix3fv(u.location, 1, GL_FALSE, glm::value_ptr(mat)); }
+    void setMat4(Uniform u, const glm::mat4& mat) const { glUniformMatrix4fv(u.location, 1, GL_FALSE, glm::value_ptr(mat)); }
 
+    // 下面的字符串版本保持原有接口，内部走上面的查找表
     // 标量的构造方法
     void setBool(const std::string& name, bool value) const {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        glUniform1i(uniform(name).location, (int)value);
     }
     void setInt(const std::string& name, int value) const {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        glUniform1i(uniform(name).location, value);
     }
     void setFloat(const std::string& name, float value) const {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        glUniform1f(uniform(name).location, value);
     }
 
     // 向量的构造方法
     void setVec2(const std::string& name, float x, float y) const {
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y);
+        glUniform2f(uniform(name).location, x, y);
     }
     void setVec2(const std::string& name, const glm::vec2& value) const {
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+        glUniform2fv(uniform(name).location, 1, glm::value_ptr(value));
     }
     void setVec3(const std::string& name, float x, float y, float z) const {
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z);
+        glUniform3f(uniform(name).location, x, y, z);
     }
     void setVec3(const std::string& name, const glm::vec3& value) const {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+        glUniform3fv(uniform(name).location, 1, glm::value_ptr(value));
     }
     void setVec4(const std::string& name, float x, float y, float z, float w) const {
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w);
+        glUniform4f(uniform(name).location, x, y, z, w);
     }
     void setVec4(const std::string& name, const glm::vec4& value) const {
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+        glUniform4fv(uniform(name).location, 1, glm::value_ptr(value));
     }
     
     // 矩阵的构造方法
     void setMat2(const std::string& name, const glm::mat2& mat) const {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+        glUniformMatrix2fv(uniform(name).location, 1, GL_FALSE, glm::value_ptr(mat));
     }   
     void setMat3(const std::string& name, const glm::mat3& mat) const {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+        glUniformMatrix3fv(uniform(name).location, 1, GL_FALSE, glm::value_ptr(mat));
     }
     void setMat4(const std::string& name, const glm::mat4& mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+        glUniformMatrix4fv(uniform(name).location, 1, GL_FALSE, glm::value_ptr(mat));
     }
     
     // 数组的构造方法
     void setIntArray(const std::string& name, const std::vector<int>& values) const {
-        glUniform1iv(glGetUniformLocation(ID, name.c_str()), values.size(), values.data());
+        glUniform1iv(uniform(name).location, values.size(), values.data());
     }
     void setFloatArray(const std::string& name, const std::vector<float>& values) const {
-        glUniform1fv(glGetUniformLocation(ID, name.c_str()), values.size(), values.data());
+        glUniform1fv(uniform(name).location, values.size(), values.data());
     }
     void setVec3Array(const std::string& name, const std::vector<glm::vec3>& values) const {
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), values.size(), glm::value_ptr(values[0]));
-    }
-
-private:
-    // 默认 fragment shader：输出红色
-    std::string defaultFragmentShader() {
-        return R"(#version 330 core
-                out vec4 FragColor;
-                void main() {
-                FragColor = vec4(1.0, 0.0, 0.0, 1.0);
-        })";
+        glUniform3fv(uniform(name).location, values.size(), glm::value_ptr(values[0]));
     }
 
-    void checkCompileErrors(GLuint shader, std::string type) {
+    // 检查编译/链接结果并打印日志，返回是否成功
+    static bool checkCompileErrors(GLuint shader, const std::string& type) {
         GLint success;
         GLchar infoLog[1024];
         if (type != "PROGRAM") {
@@ -162,6 +256,127 @@ private:
                           << "\n -- --------------------------------------------------- -- " << std::endl;
             }
         }
+        return success != 0;
+    }
+
+private:
+    // 按哈希排序的扁平表：哈希、名字和句柄分开存放，二分查找只扫哈希数组；
+    // 哈希相同的条目相邻，命中后再比较名字，碰撞时不会拿到别的 uniform 的 location
+    std::vector<uint32_t>    uniformHashes;
+    std::vector<std::string> uniformNames;
+    std::vector<Uniform>     uniformSlots;
+
+    Uniform findUniform(uint32_t hash, const char* name, size_t len) const {
+        auto range = std::equal_range(uniformHashes.begin(), uniformHashes.end(), hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            const std::string& candidate = uniformNames[it - uniformHashes.begin()];
+            if (candidate.size() == len && candidate.compare(0, len, name, len) == 0)
+                return uniformSlots[it - uniformHashes.begin()];
+        }
+        if (range.first != range.second)
+            std::cerr << "ERROR::SHADER::UNIFORM_HASH_COLLISION: " << std::string(name, len) << " vs "
+                      << uniformNames[range.first - uniformHashes.begin()] << std::endl;
+        return Uniform{};
+    }
+
+    void addUniform(const std::string& name, const Uniform& u) {
+        uint32_t hash = uniformHash(name.data(), name.size());
+        auto range = std::equal_range(uniformHashes.begin(), uniformHashes.end(), hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            const std::string& existing = uniformNames[it - uniformHashes.begin()];
+            if (existing == name)
+                return;
+            // 两个不同的名字哈希相同：都保留，查找时按名字区分
+            std::cerr << "ERROR::SHADER::UNIFORM_HASH_COLLISION: " << name << " vs " << existing << std::endl;
+        }
+        size_t index = range.second - uniformHashes.begin();
+        uniformHashes.insert(range.second, hash);
+        uniformNames.insert(uniformNames.begin() + index, name);
+        uniformSlots.insert(uniformSlots.begin() + index, u);
+    }
+
+    // 编译两个阶段并链接到 ID（ID 已由调用者创建）
+    void compileAndLink(const std::string& vertexCode, const std::string& fragmentCode) {
+        const char* vShaderCode = vertexCode.c_str();
+        const char* fShaderCode = fragmentCode.c_str();
+
+        // 编译顶点着色器
+        GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(vertex, 1, &vShaderCode, nullptr);
+        glCompileShader(vertex);
+        checkCompileErrors(vertex, "VERTEX");
+
+        // 编译片段着色器
+        GLuint fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(fragment, 1, &fShaderCode, nullptr);
+        glCompileShader(fragment);
+        checkCompileErrors(fragment, "FRAGMENT");
+
+        // 链接程序
+        shaderCache().prepare(ID);
+        glAttachShader(ID, vertex);
+        glAttachShader(ID, fragment);
+        glLinkProgram(ID);
+        checkCompileErrors(ID, "PROGRAM");
+
+        // 删除着色器对象
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+    }
+
+    // 程序里声明了共享 uniform block 就绑定到固定绑定点（3.3 不支持 layout(binding)）
+    void bindUniformBlocks() {
+        GLuint cameraBlock = glGetUniformBlockIndex(ID, CAMERA_BLOCK_NAME);
+        if (cameraBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, cameraBlock, CAMERA_BLOCK_BINDING);
+        GLuint objectBlock = glGetUniformBlockIndex(ID, OBJECT_BLOCK_NAME);
+        if (objectBlock != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, objectBlock, OBJECT_BLOCK_BINDING);
+    }
+
+    void reflectUniforms() {
+        uniformHashes.clear();
+        uniformNames.clear();
+        uniformSlots.clear();
+
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<GLchar> buffer(maxLength > 0 ? maxLength : 1);
+
+        for (GLint i = 0; i < count; ++i) {
+            GLsizei length = 0;
+            Uniform u;
+            glGetActiveUniform(ID, (GLuint)i, (GLsizei)buffer.size(), &length, &u.size, &u.type, buffer.data());
+            std::string name(buffer.data(), length);
+            u.location = glGetUniformLocation(ID, name.c_str());
+            // uniform block 里的成员没有 location，跳过
+            if (u.location < 0)
+                continue;
+
+            addUniform(name, u);
+            // 数组 "arr[0]" 同时注册 "arr" 和每个元素 "arr[i]"
+            size_t bracket = name.size() > 3 ? name.rfind("[0]") : std::string::npos;
+            if (bracket != std::string::npos && bracket == name.size() - 3) {
+                std::string base = name.substr(0, bracket);
+                addUniform(base, u);
+                for (GLint e = 1; e < u.size; ++e) {
+                    std::string element = base + "[" + std::to_string(e) + "]";
+                    Uniform eu{ glGetUniformLocation(ID, element.c_str()), u.type, 1 };
+                    if (eu.location >= 0)
+                        addUniform(element, eu);
+                }
+            }
+        }
+    }
+
+    // 默认 fragment shader：输出红色
+    static std::string defaultFragmentShader() {
+        return R"(#version 330 core
+                out vec4 FragColor;
+                void main() {
+                FragColor = vec4(1.0, 0.0, 0.0, 1.0);
+        })";
     }
 };
 
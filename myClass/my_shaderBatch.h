@@ -0,0 +1,181 @@
+#ifndef SHADER_BATCH_H
+#define SHADER_BATCH_H
+
+#include <glad/glad.h>
+#include <string>
+#include <deque>
+#include <memory>
+#include <future>
+#include <chrono>
+
+#include "my_glExtensions.h"
+#include "my_shaderCache.h"
+#include "my_shader.h"
+
+class ShaderBatch;
+
+// 异步程序句柄：ready() 非阻塞轮询，get() 第一次调用时才检查编译结果
+class ShaderHandle {
+public:
+    ShaderHandle() = default;
+    ShaderHandle(ShaderBatch* batch, size_t index) : batch(batch), index(index) {}
+
+    bool ready() const;
+    Shader& get() const;
+
+private:
+    ShaderBatch* batch = nullptr;
+    size_t index = 0;
+};
+
+// 批量提交着色器程序：文件读取在工作线程进行，GL 编译链接一次全部发出，
+// 驱动支持 GL_KHR/ARB_parallel_shader_compile 时编译在驱动线程里并行完成
+class ShaderBatch {
+public:
+    ShaderHandle add(const char* vertexPath, const char* fragmentPath = nullptr) {
+        Entry& entry = entries.emplace_back();
+        entry.vertexPath = vertexPath;
+        if (fragmentPath)
+            entry.fragmentPath = fragmentPath;
+        entry.hasFragment = fragmentPath != nullptr;
+        return ShaderHandle(this, entries.size() - 1);
+    }
+
+    // 发出所有未提交的程序，必须在 GL 线程调用
+    void submit() {
+        if (glExt().parallelShaderCompile && !threadsConfigured) {
+            glExt().MaxShaderCompilerThreads(0xFFFFFFFF);
+            threadsConfigured = true;
+        }
+
+        // 1. 文件读取丢到工作线程并行进行
+        for (Entry& entry : entries) {
+            if (entry.state != State::Added)
+                continue;
+            Entry* e = &entry;
+            e->sources = std::async(std::launch::async, [e]() {
+                Sources src;
+                Shader::loadSources(e->vertexPath.c_str(), e->hasFragment ? e->fragmentPath.c_str() : nullptr,
+                                    src.vertexCode, src.fragmentCode);
+                return src;
+            });
+            e->state = State::Reading;
+        }
+
+        // 2. 源码就绪后依次发出编译和链接，不查询状态
+        ShaderBinaryCache& cache = shaderCache();
+        for (Entry& entry : entries) {
+            if (entry.state != State::Reading)
+                continue;
+            Sources src = entry.sources.get();
+            entry.start = std::chrono::steady_clock::now();
+            entry.cacheKey = cache.key(src.vertexCode, src.fragmentCode);
+            entry.program = glCreateProgram();
+            if (cache.load(entry.program, entry.cacheKey)) {
+                entry.state = State::Linked;
+                entry.fromCache = true;
+                continue;
+            }
+
+            const char* vShaderCode = src.vertexCode.c_str();
+            const char* fShaderCode = src.fragmentCode.c_str();
+            entry.vertex = glCreateShader(GL_VERTEX_SHADER);
+            glShaderSource(entry.vertex, 1, &vShaderCode, nullptr);
+            glCompileShader(entry.vertex);
+            entry.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+            glShaderSource(entry.fragment, 1, &fShaderCode, nullptr);
+            glCompileShader(entry.fragment);
+
+            cache.prepare(entry.program);
+            glAttachShader(entry.program, entry.vertex);
+            glAttachShader(entry.program, entry.fragment);
+            glLinkProgram(entry.program);
+            entry.state = State::Linking;
+        }
+    }
+
+    // 没有并行编译扩展时无法非阻塞查询，视为已就绪，get() 时等待
+    bool ready(size_t index) const {
+        const Entry& entry = entries[index];
+        if (entry.state == State::Linked || entry.state == State::Done)
+            return true;
+        if (entry.state != State::Linking)
+            return false;
+        if (!glExt().parallelShaderCompile)
+            return true;
+        GLint done = GL_FALSE;
+        glGetProgramiv(entry.program, GL_COMPLETION_STATUS_KHR, &done);
+        return done == GL_TRUE;
+    }
+
+    bool allReady() const {
+        for (size_t i = 0; i < entries.size(); ++i)
+            if (!ready(i))
+                return false;
+        return true;
+    }
+
+    // 第一次使用时才检查编译/链接状态并反射 uniform
+    Shader& get(size_t index) {
+        Entry& entry = entries[index];
+        if (entry.state == State::Added || entry.state == State::Reading)
+            submit();
+        if (entry.state != State::Done)
+            finish(entry);
+        return *entry.shader;
+    }
+
+private:
+    enum class State { Added, Reading, Linking, Linked, Done };
+
+    struct Sources {
+        std::string vertexCode;
+        std::string fragmentCode;
+    };
+
+    struct Entry {
+        std::string vertexPath;
+        std::string fragmentPath;
+        bool hasFragment = false;
+        State state = State::Added;
+        std::future<Sources> sources;
+        GLuint vertex = 0;
+        GLuint fragment = 0;
+        GLuint program = 0;
+        uint64_t cacheKey = 0;
+        bool fromCache = false;
+        std::chrono::steady_clock::time_point start;
+        std::unique_ptr<Shader> shader;
+    };
+
+    // deque 保证 add 之后元素地址不变，工作线程可以安全持有指针
+    std::deque<Entry> entries;
+    bool threadsConfigured = false;
+
+    void finish(Entry& entry) {
+        if (!entry.fromCache) {
+            Shader::checkCompileErrors(entry.vertex, "VERTEX");
+            Shader::checkCompileErrors(entry.fragment, "FRAGMENT");
+            bool linked = Shader::checkCompileErrors(entry.program, "PROGRAM");
+            glDeleteShader(entry.vertex);
+            glDeleteShader(entry.fragment);
+            entry.vertex = entry.fragment = 0;
+            // 并行编译时这里是从提交到完成的墙钟时间
+            double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - entry.start).count();
+            if (linked)
+                shaderCache().store(entry.program, entry.cacheKey, elapsedMs);
+        }
+        entry.shader = std::make_unique<Shader>(entry.program);
+        entry.state = State::Done;
+    }
+};
+
+inline bool ShaderHandle::ready() const {
+    return batch && batch->ready(index);
+}
+
+inline Shader& ShaderHandle::get() const {
+    return batch->get(index);
+}
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include "my_glExtensions.h"
+
+// 程序二进制磁盘缓存
+// key = hash(顶点源码 + 片段源码 + 驱动 vendor/renderer/version)，换驱动或改源码自动失效
+class ShaderBinaryCache {
+public:
+    std::string directory = "shader_cache";
+    bool enabled = true;
+
+    // 统计
+    unsigned hits = 0;
+    unsigned misses = 0;
+    unsigned rejected = 0;   // 驱动拒绝了缓存的二进制（驱动升级等），回退完整编译
+    double compileMs = 0.0;  // 未命中时实际编译链接花费的时间
+    double savedMs = 0.0;    // 命中时：原编译耗时 - 读取缓存耗时
+
+    bool available() const {
+        return enabled && glExt().programBinary;
+    }
+
+    uint64_t key(const std::string& vertexCode, const std::string& fragmentCode) {
+        if (driverId.empty()) {
+            driverId += reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+            driverId += '\n';
+            driverId += reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+            driverId += '\n';
+            driverId += reinterpret_cast<const char*>(glGetString(GL_VERSION));
+        }
+        return computeKey(vertexCode, fragmentCode, driverId);
+    }
+
+    // 不碰 GL 的部分单独拿出来，tools/shader_cache_check 直接测
+    // 源码连同结尾的 '\0' 一起哈希，"ab" + "c" 和 "a" + "bc" 不会得到同一个 key
+    static uint64_t computeKey(const std::string& vertexCode, const std::string& fragmentCode, const std::string& driver) {
+        uint64_t hash = 14695981039346656037ull;
+        hash = fnv1a(hash, vertexCode.data(), vertexCode.size() + 1);
+        hash = fnv1a(hash, fragmentCode.data(), fragmentCode.size() + 1);
+        hash = fnv1a(hash, driver.data(), driver.size());
+        return hash;
+    }
+
+    // 链接前调用，允许驱动之后导出二进制
+    void prepare(GLuint program) const {
+        if (available())
+            glExt().ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    // 尝试从缓存恢复程序，成功则 program 已处于链接完成状态
+    bool load(GLuint program, uint64_t hash) {
+        if (!available())
+            return false;
+
+        auto start = std::chrono::steady_clock::now();
+        Entry entry;
+        if (!readEntry(hash, entry)) {
+            ++misses;
+            return false;
+        }
+
+        glExt().ProgramBinary(program, entry.format, entry.blob.data(), (GLsizei)entry.blob.size());
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            ++misses;
+            ++rejected;
+            evict(hash);
+            return false;
+        }
+
+        ++hits;
+        double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (entry.compileMs > loadMs)
+            savedMs += entry.compileMs - loadMs;
+        return true;
+    }
+
+    // 编译链接成功后把二进制写入缓存
+    void store(GLuint program, uint64_t hash, double elapsedMs) {
+        compileMs += elapsedMs;
+        if (!available())
+            return;
+
+        GLint success = 0, length = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (!success || length <= 0)
+            return;
+
+        Entry entry;
+        entry.compileMs = elapsedMs;
+        entry.blob.resize(length);
+        GLsizei written = 0;
+        glExt().GetProgramBinary(program, length, &written, &entry.format, entry.blob.data());
+        entry.blob.resize(written);
+        writeEntry(hash, entry);
+    }
+
+    // 缓存文件里的一条：驱动给的二进制格式和内容，外加当初编译花的时间
+    struct Entry {
+        GLenum format = 0;
+        double compileMs = 0.0;
+        std::vector<char> blob;
+    };
+
+    // 读出 hash 对应的缓存文件；不存在、文件头不对（旧版本、别的 key）或者内容被截断都返回 false
+    bool readEntry(uint64_t hash, Entry& entry) const {
+        std::string path = pathFor(hash);
+        std::ifstream file(path, std::ios::binary);
+        Header header;
+        if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header))
+            || header.magic != MAGIC || header.version != VERSION || header.key != hash)
+            return false;
+        // 长度字段坏了也不要按它去分配
+        std::error_code ec;
+        uintmax_t size = std::filesystem::file_size(path, ec);
+        if (ec || size < sizeof(header) + header.length)
+            return false;
+        entry.format = header.format;
+        entry.compileMs = header.compileMs;
+        entry.blob.resize(header.length);
+        return (bool)file.read(entry.blob.data(), entry.blob.size());
+    }
+
+    bool writeEntry(uint64_t hash, const Entry& entry) const {
+        Header header;
+        header.key = hash;
+        header.format = entry.format;
+        header.length = (uint32_t)entry.blob.size();
+        header.compileMs = entry.compileMs;
+
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        // 先写临时文件再改名，避免中途退出留下半个文件
+        std::string path = pathFor(hash);
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                std::cerr << "ERROR::SHADER_CACHE::WRITE_FAILED: " << tmp << std::endl;
+                return false;
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(entry.blob.data(), entry.blob.size());
+        }
+        std::filesystem::rename(tmp, path, ec);
+        return !ec;
+    }
+
+    void evict(uint64_t hash) const {
+        std::error_code ec;
+        std::filesystem::remove(pathFor(hash), ec);
+    }
+
+    std::string pathFor(uint64_t hash) const {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+        return (std::filesystem::path(directory) / name).string();
+    }
+
+    void printStats() const {
+        std::cout << "Shader binary cache: " << hits << " hit, " << misses << " miss";
+        if (rejected)
+            std::cout << " (" << rejected << " rejected by driver)";
+        std::cout << ", compiled in " << compileMs << " ms, saved " << savedMs << " ms" << std::endl;
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x42474C4F; // "OLGB"
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        GLenum   format = 0;
+        uint32_t length = 0;
+        uint64_t key = 0;
+        double   compileMs = 0.0;
+    };
+
+    std::string driverId;
+
+    static uint64_t fnv1a(uint64_t hash, const char* data, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+};
+
+inline ShaderBinaryCache& shaderCache() {
+    static ShaderBinaryCache cache;
+    return cache;
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef MY_SIMD_H
+#define MY_SIMD_H
+
+// 编译期 SIMD 能力检测：按编译选项（-mavx2 / /arch:AVX2）选择实现，其余情况退回标量
+// MSVC 在 x64 上默认就有 SSE2，但不会定义 __SSSE3__，只有 /arch:AVX2 才会定义 __AVX2__
+// SSSE3 不在编译期假定：工程不开 -mssse3，需要它的函数用 MY_SIMD_TARGET_SSSE3 单独编译，
+// 调用前用 simdHasSSSE3() 在运行时检查（和 my_matrixKernels.h 的 CPUID 分发同一个思路）
+#if defined(__AVX2__)
+#define MY_SIMD_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MY_SIMD_SSE2 1
+#endif
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MY_SIMD_X86 1
+#endif
+
+#if defined(MY_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(MY_SIMD_X86)
+#include <tmmintrin.h>
+#elif defined(MY_SIMD_SSE2)
+#include <emmintrin.h>
+#endif
+
+#if defined(MY_SIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define MY_SIMD_TARGET_SSSE3
+#else
+#include <cpuid.h>
+#define MY_SIMD_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
+
+// CPU 是否支持 SSSE3（CPUID.1:ECX 第 9 位），结果只查一次
+inline bool simdHasSSSE3() {
+#if defined(MY_SIMD_X86)
+    static const bool supported = []() {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int regs[4];
+        __cpuid(regs, 1);
+        return ((regs[2] >> 9) & 1) != 0;
+#else
+        unsigned a, b, c, d;
+        return __get_cpuid(1, &a, &b, &c, &d) && ((c >> 9) & 1) != 0;
+#endif
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef STATIC_MESH_H
+#define STATIC_MESH_H
+
+#include <glad/glad.h>
+#include <vector>
+#include <cstddef>
+
+#include "my_glState.h"
+#include "my_meshImport.h"
+
+// 顶点属性位置，和 MeshVertex 的成员对应
+const GLuint MESH_POSITION_LOCATION = 0;
+const GLuint MESH_NORMAL_LOCATION = 1;
+const GLuint MESH_UV_LOCATION = 2;
+
+// 导入网格的 GL 资源：一个 VAO + 一个缓冲，顶点在前、索引紧跟在后，同时绑成顶点缓冲和索引缓冲
+// 从缓存映射来的网格两部分本来就连续，一次 glBufferData 直接从映射上传；自己持有的网格分两次 glBufferSubData
+// 子网格的索引是绝对下标，画某个子网格就是 glDrawElements(indexCount, indexByteOffset(i))
+class StaticMesh {
+public:
+    GLuint vao = 0;
+    GLuint buffer = 0;
+    std::vector<SubMesh> submeshes;
+    GLsizei indexCount = 0;
+
+    explicit StaticMesh(const MeshData& mesh) : submeshes(mesh.submeshes), indexCount((GLsizei)mesh.indexCount) {
+        if (!mesh)
+            return;
+        indexOffset = mesh.vertexBytes();
+        GLsizeiptr bytes = (GLsizeiptr)(mesh.vertexBytes() + mesh.indexBytes());
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &buffer);
+        glState().bindVertexArray(vao);
+        glState().bindBuffer(GL_ARRAY_BUFFER, buffer);
+        if (const uint8_t* geometry = mesh.contiguousGeometry()) {
+            glBufferData(GL_ARRAY_BUFFER, bytes, geometry, GL_STATIC_DRAW);
+        } else {
+            glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STATIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)mesh.vertexBytes(), mesh.vertices());
+            glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)indexOffset, (GLsizeiptr)mesh.indexBytes(), mesh.indices());
+        }
+        // 同一个缓冲也是这个 VAO 的索引缓冲
+        glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+
+        const GLsizei stride = sizeof(MeshVertex);
+        glVertexAttribPointer(MESH_POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MeshVertex, position));
+        glEnableVertexAttribArray(MESH_POSITION_LOCATION);
+        glVertexAttribPointer(MESH_NORMAL_LOCATION, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MeshVertex, normal));
+        glEnableVertexAttribArray(MESH_NORMAL_LOCATION);
+        glVertexAttribPointer(MESH_UV_LOCATION, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(MeshVertex, uv));
+        glEnableVertexAttribArray(MESH_UV_LOCATION);
+    }
+
+    StaticMesh(const StaticMesh&) = delete;
+    StaticMesh& operator=(const StaticMesh&) = delete;
+
+    bool valid() const { return vao != 0; }
+
+    // 第 i 个子网格的索引在缓冲里的字节偏移，给 glDrawElements / DrawPacket::setElements 用
+    GLintptr indexByteOffset(size_t i) const {
+        return (GLintptr)(indexOffset + (size_t)submeshes[i].firstIndex * sizeof(uint32_t));
+    }
+
+    // 调用前需要先 use() 对应的 shader
+    void draw() const {
+        if (!valid())
+            return;
+        glState().bindVertexArray(vao);
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (void*)indexOffset);
+    }
+
+    void drawSubMesh(size_t i) const {
+        if (!valid())
+            return;
+        glState().bindVertexArray(vao);
+        glDrawElements(GL_TRIANGLES, (GLsizei)submeshes[i].indexCount, GL_UNSIGNED_INT, (void*)indexByteOffset(i));
+    }
+
+    // 和 main 里的 VAO/VBO 一样在上下文销毁前显式释放
+    void release() {
+        if (vao != 0) {
+            glState().forgetVertexArray(vao);
+            glDeleteVertexArrays(1, &vao);
+            vao = 0;
+        }
+        if (buffer != 0) {
+            glState().forgetBuffer(buffer);
+            glDeleteBuffers(1, &buffer);
+            buffer = 0;
+        }
+    }
+
+private:
+    size_t indexOffset = 0;
+};
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <glad/glad.h>
+#include <iostream>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "my_glExtensions.h"
+#include "my_glState.h"
+
+// 从流式缓冲里分配出的一段：data 供 CPU 写入，offset 是在 buffer 里的字节偏移，用于 glBindBufferRange / 顶点属性指针
+struct StreamAllocation {
+    void* data = nullptr;
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+// 每帧动态数据（每次 draw 的 uniform block、实例数据、动态顶点）用的环形缓冲
+// 持久映射路径（GL 4.4 / ARB_buffer_storage）：一个缓冲分成 regions 段，每帧写一段，
+//   写完插 fence，轮回到这一段时先等 fence，CPU 直接写进映射内存，没有 map/unmap 和 glBufferSubData
+// 回退路径：只用一段，CPU 写到暂存内存，flush() 时第一次先 glBufferData(nullptr) 孤立旧存储再 glBufferSubData
+// allocate() 可以在工作线程里调用（无锁），其余函数只能在 GL 线程
+class StreamBuffer {
+public:
+    struct Stats {
+        unsigned stalls = 0;        // 开始新的一帧时 fence 还没到，CPU 不得不等
+        double stallUs = 0.0;       // 等待的总时间
+        unsigned overflows = 0;     // 空间不够、出现过分配失败的帧数
+        size_t frameBytes = 0;      // 上一帧用掉的字节数
+        size_t peakFrameBytes = 0;
+    };
+
+    explicit StreamBuffer(size_t regionBytes = 4 << 20, unsigned regionCount = 3)
+        : regionSize(regionBytes), regions(std::max(1u, std::min(regionCount, MAX_REGIONS))) {
+        GLint align = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
+        uniformAlignment = align > 0 ? (size_t)align : 256;
+        // 每段的起点也要满足 uniform block 的对齐
+        regionSize = (regionSize + uniformAlignment - 1) / uniformAlignment * uniformAlignment;
+
+        glGenBuffers(1, &id);
+        glState().bindBuffer(GL_COPY_WRITE_BUFFER, id);
+        if (glExt().bufferStorage) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            GLsizeiptr total = (GLsizeiptr)(regionSize * regions);
+            glExt().BufferStorage(GL_COPY_WRITE_BUFFER, total, nullptr, flags);
+            mapped = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, total, flags));
+            if (!mapped)
+                std::cerr << "ERROR::STREAM_BUFFER::PERSISTENT_MAP_FAILED: falling back to orphaning" << std::endl;
+        }
+        if (!mapped) {
+            // 不可变存储不能再 glBufferData，映射失败时换一个新缓冲
+            if (glExt().bufferStorage) {
+                glState().forgetBuffer(id);
+                glDeleteBuffers(1, &id);
+                glGenBuffers(1, &id);
+                glState().bindBuffer(GL_COPY_WRITE_BUFFER, id);
+            }
+            regions = 1;
+            staging.reset(new uint8_t[regionSize]);
+            glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)regionSize, nullptr, GL_STREAM_DRAW);
+        }
+    }
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // 和 main 里的其它 GL 对象一样在上下文销毁前显式释放
+    void release() {
+        for (GLsync& fence : fences) {
+            if (fence)
+                glDeleteSync(fence);
+            fence = nullptr;
+        }
+        if (id != 0) {
+            if (mapped) {
+                glState().bindBuffer(GL_COPY_WRITE_BUFFER, id);
+                glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+                mapped = nullptr;
+            }
+            glState().forgetBuffer(id);
+            glDeleteBuffers(1, &id);
+            id = 0;
+        }
+    }
+
+    // 每帧录制前调用：给上一帧用过的段插 fence，换到下一段，必要时等 GPU 读完这一段
+    void beginFrame() {
+        size_t used = std::min(head.load(std::memory_order_relaxed), regionSize);
+        current.frameBytes = used;
+        current.peakFrameBytes = std::max(current.peakFrameBytes, used);
+        if (started && mapped) {
+            fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            region = (region + 1) % regions;
+            waitForRegion(region);
+        }
+        started = true;
+        head.store(0, std::memory_order_relaxed);
+        flushed = 0;
+        overflowReported.store(false, std::memory_order_relaxed);
+    }
+
+    // 线程安全的子分配；空间不够时返回空的 StreamAllocation
+    StreamAllocation allocate(size_t bytes, size_t alignment = 16) {
+        size_t start;
+        size_t old = head.load(std::memory_order_relaxed);
+        do {
+            start = (old + alignment - 1) / alignment * alignment;
+            if (start + bytes > regionSize) {
+                reportOverflow(bytes);
+                return StreamAllocation{};
+            }
+        } while (!head.compare_exchange_weak(old, start + bytes, std::memory_order_relaxed));
+
+        StreamAllocation allocation;
+        allocation.data = (mapped ? mapped + region * regionSize : staging.get()) + start;
+        allocation.offset = (GLintptr)(region * regionSize + start);
+        allocation.size = (GLsizeiptr)bytes;
+        return allocation;
+    }
+
+    // 按 GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 对齐，可以直接绑成 uniform block
+    StreamAllocation allocateUniform(size_t bytes) { return allocate(bytes, uniformAlignment); }
+
+    template <typename T>
+    StreamAllocation write(const T& value, size_t alignment = 16) {
+        StreamAllocation allocation = allocate(sizeof(T), alignment);
+        if (allocation)
+            std::memcpy(allocation.data, &value, sizeof(T));
+        return allocation;
+    }
+
+    // 绘制用到本帧写入的数据之前调用：持久映射是 coherent 的，什么都不用做；
+    // 回退路径把暂存内存里新写的部分上传（本帧第一次先孤立旧存储）
+    void flush() {
+        if (mapped)
+            return;
+        size_t used = std::min(head.load(std::memory_order_relaxed), regionSize);
+        if (used <= flushed)
+            return;
+        glState().bindBuffer(GL_COPY_WRITE_BUFFER, id);
+        if (flushed == 0)
+            glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)regionSize, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)flushed, (GLsizeiptr)(used - flushed), staging.get() + flushed);
+        flushed = used;
+    }
+
+    void bindRange(GLenum target, GLuint index, const StreamAllocation& allocation) {
+        glState().bindBufferRange(target, index, id, allocation.offset, allocation.size);
+    }
+
+    GLuint buffer() const { return id; }
+    bool persistent() const { return mapped != nullptr; }
+    size_t capacity() const { return regionSize; }
+    size_t uniformOffsetAlignment() const { return uniformAlignment; }
+    const Stats& stats() const { return current; }
+
+private:
+    static constexpr unsigned MAX_REGIONS = 4;
+
+    GLuint id = 0;
+    size_t regionSize;
+    unsigned regions;
+    unsigned region = 0;
+    size_t uniformAlignment = 256;
+    uint8_t* mapped = nullptr;
+    std::unique_ptr<uint8_t[]> staging;
+    GLsync fences[MAX_REGIONS] = {};
+    std::atomic<size_t> head{ 0 };
+    std::atomic<bool> overflowReported{ false };
+    size_t flushed = 0;
+    bool started = false;
+    Stats current;
+
+    void waitForRegion(unsigned index) {
+        GLsync fence = fences[index];
+        if (!fence)
+            return;
+        fences[index] = nullptr;
+        // 先不等待地查一次，已经完成就不算停顿
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            ++current.stalls;
+            auto start = std::chrono::steady_clock::now();
+            do {
+                result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            } while (result == GL_TIMEOUT_EXPIRED);
+            current.stallUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+        if (result == GL_WAIT_FAILED)
+            std::cerr << "ERROR::STREAM_BUFFER::FENCE_WAIT_FAILED" << std::endl;
+        glDeleteSync(fence);
+    }
+
+    void reportOverflow(size_t bytes) {
+        if (overflowReported.exchange(true, std::memory_order_relaxed))
+            return;
+        // 每帧都溢出时只打印第一次，之后只计数
+        if (++current.overflows == 1)
+            std::cerr << "ERROR::STREAM_BUFFER::OUT_OF_SPACE: " << bytes << " bytes requested, region is "
+                      << regionSize << " bytes" << std::endl;
+    }
+};
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef TEXTURE_ARRAY_H
+#define TEXTURE_ARRAY_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "my_TextureLoader.h"
+#include "my_texturePacker.h"
+
+// 把多张贴图合进一个纹理对象，换材质时只改一个 uniform（层号 / UV 矩形），不用重新绑纹理
+// TextureArray：尺寸相同的图放进 GL_TEXTURE_2D_ARRAY 的各层，着色器用 sampler2DArray + 层号采样
+// TextureAtlas：尺寸不一的图用 skyline 打包进一张大图，着色器用 UV 矩形把 [0,1] 映射到子图
+
+class TextureArray {
+public:
+    GLuint ID = 0;
+    int width = 0, height = 0;
+    std::vector<std::string> paths; // 第 i 层对应的图片
+
+    // 所有图片统一成 RGBA；尺寸和第一张不同的图跳过（layer() 返回 -1）
+    TextureArray(const std::vector<std::string>& files, const TextureParams& params = TextureParams{}) {
+        std::vector<MipChain> chains;
+        for (const std::string& path : files) {
+            MipChain chain = mipCache().loadOrBuild(path, params.flip, params.srgb, 4);
+            if (!chain) {
+                std::cerr << "Failed to load texture:" << path << std::endl;
+                continue;
+            }
+            if (!chains.empty() && (chain.width != width || chain.height != height)) {
+                std::cerr << "ERROR::TEXTURE_ARRAY::SIZE_MISMATCH " << path << " is " << chain.width << "x" << chain.height
+                          << ", expected " << width << "x" << height << std::endl;
+                continue;
+            }
+            width = chain.width;
+            height = chain.height;
+            paths.push_back(path);
+            chains.push_back(std::move(chain));
+        }
+        if (chains.empty())
+            return;
+
+        GLsizei levels = Texture::usesMipmaps(params.minFilter) ? (GLsizei)chains[0].levels.size() : 1;
+        GLint internalFormat = Texture::internalFormat(4, params.srgb);
+
+        glGenTextures(1, &ID);
+        glState().bindTexture(GL_TEXTURE_2D_ARRAY, ID);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (GLsizei level = 0; level < levels; ++level) {
+            const MipLevelInfo& l = chains[0].levels[level];
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat, l.width, l.height, (GLsizei)chains.size(), 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            for (size_t layer = 0; layer < chains.size(); ++layer)
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, (GLint)layer, l.width, l.height, 1,
+                                GL_RGBA, GL_UNSIGNED_BYTE, chains[layer].level(level));
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, params.wrapS);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, params.wrapT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, params.minFilter);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, params.magFilter);
+    }
+
+    int layers() const { return (int)paths.size(); }
+
+    // 图片所在的层，没有加载成功返回 -1
+    int layer(const std::string& path) const {
+        for (size_t i = 0; i < paths.size(); ++i)
+            if (paths[i] == path)
+                return (int)i;
+        return -1;
+    }
+
+    void use(GLuint textureUnit = 0) const {
+        glState().bindTextureUnit(textureUnit, GL_TEXTURE_2D_ARRAY, ID);
+    }
+
+    ~TextureArray() {
+        if (ID != 0) {
+            glState().forgetTexture(ID);
+            glDeleteTextures(1, &ID);
+        }
+    }
+
+    TextureArray(const TextureArray&) = delete;
+    TextureArray& operator=(const TextureArray&) = delete;
+};
+
+class TextureAtlas {
+public:
+    GLuint ID = 0;
+    AtlasLayout layout;
+    std::vector<std::string> paths; // 第 i 个子图对应的图片，和 layout.rects 一一对应
+
+    // padding 取 2 的幂：子图之间留 padding 像素的边缘复制，mip 只生成到 log2(padding) 级，
+    // 再往下相邻子图会混在同一个像素里。wrap 固定为 CLAMP_TO_EDGE，重复平铺在着色器里用 fract 做
+    TextureAtlas(const std::vector<std::string>& files, const TextureParams& params = TextureParams{}, int padding = 8) {
+        if (padding < 1 || (padding & (padding - 1)) != 0) {
+            std::cerr << "ERROR::TEXTURE_ATLAS::PADDING_NOT_POWER_OF_TWO " << padding << std::endl;
+            return;
+        }
+
+        std::vector<Image> images;
+        std::vector<PackRect> sizes;
+        for (const std::string& path : files) {
+            Image image = decodeImage(path, 4);
+            if (!image) {
+                std::cerr << "Failed to load texture:" << path << std::endl;
+                continue;
+            }
+            if (params.flip)
+                flipRowsInPlace(image.pixels, image.width, image.height, image.channels);
+            sizes.push_back({ 0, 0, image.width, image.height });
+            paths.push_back(path);
+            images.push_back(std::move(image));
+        }
+        if (images.empty())
+            return;
+
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        layout = packAtlas(sizes, padding, maxSize > 0 ? maxSize : 8192);
+        if (!layout) {
+            std::cerr << "ERROR::TEXTURE_ATLAS::DOES_NOT_FIT " << images.size() << " images" << std::endl;
+            paths.clear();
+            return;
+        }
+
+        std::vector<uint8_t> pixels((size_t)layout.width * layout.height * 4, 0);
+        for (size_t i = 0; i < images.size(); ++i)
+            blitWithExtrude(pixels.data(), layout.width, 4, layout.rects[i], images[i].pixels, padding);
+        images.clear();
+
+        MipChain chain = buildMipChain(pixels.data(), layout.width, layout.height, 4, params.srgb);
+        int levels = 1;
+        if (Texture::usesMipmaps(params.minFilter))
+            for (int p = padding; p > 1 && levels < (int)chain.levels.size(); p >>= 1)
+                ++levels;
+
+        glGenTextures(1, &ID);
+        glState().bindTexture(GL_TEXTURE_2D, ID);
+        for (int level = 0; level < levels; ++level) {
+            const MipLevelInfo& l = chain.levels[level];
+            glTexImage2D(GL_TEXTURE_2D, level, Texture::internalFormat(4, params.srgb), l.width, l.height, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, chain.level(level));
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.magFilter);
+
+        layout.printReport();
+    }
+
+    int count() const { return (int)paths.size(); }
+
+    int index(const std::string& path) const {
+        for (size_t i = 0; i < paths.size(); ++i)
+            if (paths[i] == path)
+                return (int)i;
+        return -1;
+    }
+
+    // 第 i 个子图的 UV 矩形：xy 为左下角偏移，zw 为缩放，着色器里 uv * rect.zw + rect.xy
+    glm::vec4 uvRect(int i) const {
+        const PackRect& r = layout.rects[i];
+        return glm::vec4((float)r.x / layout.width, (float)r.y / layout.height,
+                         (float)r.width / layout.width, (float)r.height / layout.height);
+    }
+
+    void use(GLuint textureUnit = 0) const {
+        glState().bindTextureUnit(textureUnit, GL_TEXTURE_2D, ID);
+    }
+
+    ~TextureAtlas() {
+        if (ID != 0) {
+            glState().forgetTexture(ID);
+            glDeleteTextures(1, &ID);
+        }
+    }
+
+    TextureAtlas(const TextureAtlas&) = delete;
+    TextureAtlas& operator=(const TextureAtlas&) = delete;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include <glad/glad.h>
+#include <string>
+#include <memory>
+#include <list>
+#include <unordered_map>
+#include <filesystem>
+#include <iostream>
+
+#include "my_TextureLoader.h"
+
+// 共享纹理句柄：复制只是增加引用计数
+using TextureHandle = std::shared_ptr<const Texture>;
+
+// 按 (规范化路径 + 加载参数) 去重的纹理缓存
+// 超出显存预算时按 LRU 淘汰没有句柄引用的纹理；还被引用的纹理不会被淘汰
+class TextureCache {
+public:
+    size_t budgetBytes;
+
+    struct Stats {
+        size_t residentBytes = 0;
+        size_t residentCount = 0;
+        unsigned hits = 0;
+        unsigned misses = 0;
+        unsigned evictions = 0;
+        double hitRate() const {
+            unsigned total = hits + misses;
+            return total ? (double)hits / total : 0.0;
+        }
+    };
+
+    explicit TextureCache(size_t budgetBytes = 256u * 1024 * 1024) : budgetBytes(budgetBytes) {}
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    TextureHandle get(const std::string& path, const TextureParams& params = TextureParams{}) {
+        std::string key = makeKey(path, params);
+        auto found = lookup.find(key);
+        if (found != lookup.end()) {
+            ++stats.hits;
+            // 移到 LRU 表头
+            entries.splice(entries.begin(), entries, found->second);
+            return found->second->texture;
+        }
+
+        ++stats.misses;
+        auto texture = std::make_shared<Texture>(path, params);
+        if (texture->ID == 0)
+            return texture; // 加载失败不缓存，文件修好后可以重新加载
+
+        Entry entry;
+        entry.key = key;
+        entry.texture = texture;
+        entry.bytes = estimateBytes(*texture, params);
+        entries.push_front(std::move(entry));
+        lookup[key] = entries.begin();
+        stats.residentBytes += entries.front().bytes;
+        ++stats.residentCount;
+
+        trim();
+        return texture;
+    }
+
+    // 淘汰最久未使用且没有外部引用的纹理，直到回到预算以内
+    void trim() {
+        auto it = entries.end();
+        while (stats.residentBytes > budgetBytes && it != entries.begin()) {
+            --it;
+            if (it->texture.use_count() > 1)
+                continue;
+            stats.residentBytes -= it->bytes;
+            --stats.residentCount;
+            ++stats.evictions;
+            lookup.erase(it->key);
+            it = entries.erase(it);
+        }
+    }
+
+    // 释放缓存持有的全部引用（在上下文销毁前调用）
+    void clear() {
+        entries.clear();
+        lookup.clear();
+        stats.residentBytes = 0;
+        stats.residentCount = 0;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+    void printStats() const {
+        std::cout << "Texture cache: " << stats.residentCount << " textures, "
+                  << stats.residentBytes / 1024 << " KB resident, hit rate "
+                  << stats.hitRate() * 100.0 << "%, " << stats.evictions << " evicted" << std::endl;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const Texture> texture;
+        size_t bytes = 0;
+    };
+
+    std::list<Entry> entries; // 表头是最近使用的
+    std::unordered_map<std::string, std::list<Entry>::iterator> lookup;
+    Stats stats;
+
+    static std::string makeKey(const std::string& path, const TextureParams& params) {
+        std::error_code ec;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+        std::string key = ec ? std::filesystem::path(path).lexically_normal().generic_string()
+                             : canonical.generic_string();
+        key += '|' + std::to_string(params.flip) + '|' + std::to_string(params.channels) + '|' + std::to_string(params.srgb)
+             + '|' + std::to_string(params.wrapS) + '|' + std::to_string(params.wrapT)
+             + '|' + std::to_string(params.minFilter) + '|' + std::to_string(params.magFilter);
+        return key;
+    }
+
+    // 驱动一般把 RGB 按 RGBA 存储；带 mipmap 时多出约 1/3；压缩纹理直接用文件里的大小
+    static size_t estimateBytes(const Texture& texture, const TextureParams& params) {
+        if (texture.compressedBytes)
+            return texture.compressedBytes;
+        int channels = texture.nrChannels == 3 ? 4 : texture.nrChannels;
+        size_t bytes = (size_t)texture.width * texture.height * channels;
+        return Texture::usesMipmaps(params.minFilter) ? bytes * 4 / 3 : bytes;
+    }
+};
+
+#endif
@@ -0,0 +1,701 @@
+#ifndef TEXTURE_COMPRESSOR_H
+#define TEXTURE_COMPRESSOR_H
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#include "my_jobSystem.h"
+#include "my_mipmap.h"
+
+// 离线纹理压缩：BC1 / BC3 / BC7(mode 6) / ETC2 RGB / ETC2 RGBA(EAC)
+// 纯 CPU 实现，不依赖 GL，输入都是 RGBA8，每个 4x4 块独立编码，可以按块行并行
+// 编码器追求的是“离线够用”的质量和速度，不是穷举搜索
+enum class BlockFormat {
+    BC1,        // RGB 4bpp，无 alpha
+    BC3,        // RGBA 8bpp：BC4 alpha + BC1 颜色
+    BC7,        // RGBA 8bpp，只用 mode 6（单分区，RGBA 7777+p，4 位索引）
+    ETC2_RGB,   // RGB 4bpp，只产生 ETC1 兼容的 individual/differential 模式
+    ETC2_RGBA   // RGBA 8bpp：EAC alpha + ETC2 颜色
+};
+
+inline size_t blockBytes(BlockFormat format) {
+    return (format == BlockFormat::BC1 || format == BlockFormat::ETC2_RGB) ? 8 : 16;
+}
+
+inline size_t compressedSize(int width, int height, BlockFormat format) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * blockBytes(format);
+}
+
+namespace texcomp {
+
+inline int clamp255(int v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+inline int colorError(const uint8_t* a, const uint8_t* b, int channels = 3) {
+    int e = 0;
+    for (int c = 0; c < channels; ++c) {
+        int d = (int)a[c] - (int)b[c];
+        e += d * d;
+    }
+    return e;
+}
+
+// 取出一个 4x4 块（RGBA8），超出图片边缘的像素复制最后一行/列
+inline void fetchBlock(const uint8_t* rgba, int width, int height, int bx, int by, uint8_t block[64]) {
+    for (int y = 0; y < 4; ++y) {
+        int sy = std::min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; ++x) {
+            int sx = std::min(bx * 4 + x, width - 1);
+            std::memcpy(block + (y * 4 + x) * 4, rgba + ((size_t)sy * width + sx) * 4, 4);
+        }
+    }
+}
+
+// ---------------------------------------------------------------- BC1 ----
+
+inline uint16_t packRGB565(const float c[3]) {
+    int r = clamp255((int)std::lround(c[0]));
+    int g = clamp255((int)std::lround(c[1]));
+    int b = clamp255((int)std::lround(c[2]));
+    return (uint16_t)(((r * 31 + 127) / 255) << 11 | ((g * 63 + 127) / 255) << 5 | ((b * 31 + 127) / 255));
+}
+
+inline void unpackRGB565(uint16_t v, uint8_t out[3]) {
+    int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    out[0] = (uint8_t)((r << 3) | (r >> 2));
+    out[1] = (uint8_t)((g << 2) | (g >> 4));
+    out[2] = (uint8_t)((b << 3) | (b >> 2));
+}
+
+// 用颜色协方差的主轴求两个端点（幂迭代），比包围盒对角线更贴合实际分布
+inline void principalEndpoints(const uint8_t block[64], int channels, float lo[4], float hi[4]) {
+    float mean[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < channels; ++c)
+            mean[c] += block[i * 4 + c];
+    for (int c = 0; c < channels; ++c)
+        mean[c] /= 16.0f;
+
+    float cov[4][4] = {};
+    for (int i = 0; i < 16; ++i) {
+        float d[4];
+        for (int c = 0; c < channels; ++c)
+            d[c] = block[i * 4 + c] - mean[c];
+        for (int a = 0; a < channels; ++a)
+            for (int b = 0; b < channels; ++b)
+                cov[a][b] += d[a] * d[b];
+    }
+
+    float axis[4] = { 1, 1, 1, 1 };
+    for (int iter = 0; iter < 8; ++iter) {
+        float next[4] = { 0, 0, 0, 0 };
+        for (int a = 0; a < channels; ++a)
+            for (int b = 0; b < channels; ++b)
+                next[a] += cov[a][b] * axis[b];
+        float len = 0.0f;
+        for (int c = 0; c < channels; ++c)
+            len += next[c] * next[c];
+        len = std::sqrt(len);
+        if (len < 1e-6f)
+            break;
+        for (int c = 0; c < channels; ++c)
+            axis[c] = next[c] / len;
+    }
+
+    float minT = 1e30f, maxT = -1e30f;
+    for (int i = 0; i < 16; ++i) {
+        float t = 0.0f;
+        for (int c = 0; c < channels; ++c)
+            t += (block[i * 4 + c] - mean[c]) * axis[c];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (int c = 0; c < channels; ++c) {
+        lo[c] = mean[c] + axis[c] * minT;
+        hi[c] = mean[c] + axis[c] * maxT;
+    }
+}
+
+inline void encodeBC1Block(const uint8_t block[64], uint8_t out[8]) {
+    float lo[4], hi[4];
+    principalEndpoints(block, 3, lo, hi);
+    uint16_t c0 = packRGB565(hi);
+    uint16_t c1 = packRGB565(lo);
+    // c0 > c1 才是 4 色模式
+    if (c0 < c1)
+        std::swap(c0, c1);
+
+    uint32_t indices = 0;
+    if (c0 != c1) {
+        uint8_t palette[4][3];
+        unpackRGB565(c0, palette[0]);
+        unpackRGB565(c1, palette[1]);
+        for (int c = 0; c < 3; ++c) {
+            palette[2][c] = (uint8_t)((2 * palette[0][c] + palette[1][c] + 1) / 3);
+            palette[3][c] = (uint8_t)((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+        }
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestError = 1 << 30;
+            for (int p = 0; p < 4; ++p) {
+                int e = colorError(block + i * 4, palette[p]);
+                if (e < bestError) { bestError = e; best = p; }
+            }
+            indices |= (uint32_t)best << (2 * i);
+        }
+    }
+    out[0] = (uint8_t)(c0 & 0xFF); out[1] = (uint8_t)(c0 >> 8);
+    out[2] = (uint8_t)(c1 & 0xFF); out[3] = (uint8_t)(c1 >> 8);
+    for (int i = 0; i < 4; ++i)
+        out[4 + i] = (uint8_t)(indices >> (8 * i));
+}
+
+inline void decodeBC1Block(const uint8_t in[8], uint8_t block[64]) {
+    uint16_t c0 = (uint16_t)(in[0] | in[1] << 8);
+    uint16_t c1 = (uint16_t)(in[2] | in[3] << 8);
+    uint8_t palette[4][4];
+    unpackRGB565(c0, palette[0]);
+    unpackRGB565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = palette[2][3] = 255;
+    palette[3][3] = 255;
+    for (int c = 0; c < 3; ++c) {
+        if (c0 > c1) {
+            palette[2][c] = (uint8_t)((2 * palette[0][c] + palette[1][c] + 1) / 3);
+            palette[3][c] = (uint8_t)((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+        } else {
+            palette[2][c] = (uint8_t)((palette[0][c] + palette[1][c]) / 2);
+            palette[3][c] = 0;
+        }
+    }
+    if (c0 <= c1)
+        palette[3][3] = 0;
+    uint32_t indices = in[4] | in[5] << 8 | in[6] << 16 | (uint32_t)in[7] << 24;
+    for (int i = 0; i < 16; ++i)
+        std::memcpy(block + i * 4, palette[(indices >> (2 * i)) & 3], 4);
+}
+
+// ---------------------------------------------------------------- BC4 / BC3 ----
+
+inline void encodeBC4Block(const uint8_t block[64], int channel, uint8_t out[8]) {
+    int minA = 255, maxA = 0;
+    for (int i = 0; i < 16; ++i) {
+        minA = std::min<int>(minA, block[i * 4 + channel]);
+        maxA = std::max<int>(maxA, block[i * 4 + channel]);
+    }
+    out[0] = (uint8_t)maxA;
+    out[1] = (uint8_t)minA;
+    uint64_t indices = 0;
+    if (maxA > minA) {
+        // a0 > a1：8 级插值，索引 0 = a0，1 = a1，2..7 从 a0 向 a1 过渡
+        for (int i = 0; i < 16; ++i) {
+            int a = block[i * 4 + channel];
+            int step = ((maxA - a) * 14 + (maxA - minA)) / (2 * (maxA - minA)); // round((max-a)/(max-min)*7)
+            int index = step == 0 ? 0 : (step == 7 ? 1 : step + 1);
+            indices |= (uint64_t)index << (3 * i);
+        }
+    }
+    for (int i = 0; i < 6; ++i)
+        out[2 + i] = (uint8_t)(indices >> (8 * i));
+}
+
+inline void decodeBC4Block(const uint8_t in[8], int channel, uint8_t block[64]) {
+    int a0 = in[0], a1 = in[1];
+    int palette[8] = { a0, a1 };
+    if (a0 > a1) {
+        for (int i = 2; i < 8; ++i)
+            palette[i] = ((8 - i) * a0 + (i - 1) * a1 + 3) / 7;
+    } else {
+        for (int i = 2; i < 6; ++i)
+            palette[i] = ((6 - i) * a0 + (i - 1) * a1 + 2) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices |= (uint64_t)in[2 + i] << (8 * i);
+    for (int i = 0; i < 16; ++i)
+        block[i * 4 + channel] = (uint8_t)palette[(indices >> (3 * i)) & 7];
+}
+
+inline void encodeBC3Block(const uint8_t block[64], uint8_t out[16]) {
+    encodeBC4Block(block, 3, out);
+    encodeBC1Block(block, out + 8);
+}
+
+inline void decodeBC3Block(const uint8_t in[16], uint8_t block[64]) {
+    decodeBC1Block(in + 8, block);
+    decodeBC4Block(in, 3, block);
+}
+
+// ---------------------------------------------------------------- BC7 mode 6 ----
+
+const int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// 小端位流写入器
+struct BitWriter {
+    uint8_t* data;
+    int pos = 0;
+    void write(uint32_t value, int bits) {
+        for (int i = 0; i < bits; ++i, ++pos)
+            if (value >> i & 1)
+                data[pos >> 3] |= (uint8_t)(1 << (pos & 7));
+    }
+};
+
+struct BitReader {
+    const uint8_t* data;
+    int pos = 0;
+    uint32_t read(int bits) {
+        uint32_t v = 0;
+        for (int i = 0; i < bits; ++i, ++pos)
+            v |= (uint32_t)(data[pos >> 3] >> (pos & 7) & 1) << i;
+        return v;
+    }
+};
+
+// 把一个浮点端点量化成 7 位 + 共享 p 位，选误差最小的 p
+inline void quantizeBC7Endpoint(const float e[4], uint8_t q[4], int& pbit) {
+    int bestError = 1 << 30;
+    for (int p = 0; p < 2; ++p) {
+        int error = 0;
+        uint8_t candidate[4];
+        for (int c = 0; c < 4; ++c) {
+            int v = (int)std::lround((e[c] - p) / 2.0f);
+            v = v < 0 ? 0 : (v > 127 ? 127 : v);
+            candidate[c] = (uint8_t)v;
+            int d = ((v << 1) | p) - (int)std::lround(e[c]);
+            error += d * d;
+        }
+        if (error < bestError) {
+            bestError = error;
+            pbit = p;
+            std::memcpy(q, candidate, 4);
+        }
+    }
+}
+
+// 给定量化后的端点，为每个像素选最佳 4 位索引，返回总误差
+inline int fitBC7Indices(const uint8_t block[64], const uint8_t q[2][4], const int p[2], int indices[16]) {
+    int endpoint[2][4];
+    for (int e = 0; e < 2; ++e)
+        for (int c = 0; c < 4; ++c)
+            endpoint[e][c] = (q[e][c] << 1) | p[e];
+
+    int total = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = 0, bestError = 1 << 30;
+        for (int w = 0; w < 16; ++w) {
+            int error = 0;
+            for (int c = 0; c < 4; ++c) {
+                int v = ((64 - BC7_WEIGHTS4[w]) * endpoint[0][c] + BC7_WEIGHTS4[w] * endpoint[1][c] + 32) >> 6;
+                int d = v - block[i * 4 + c];
+                error += d * d;
+            }
+            if (error < bestError) { bestError = error; best = w; }
+        }
+        indices[i] = best;
+        total += bestError;
+    }
+    return total;
+}
+
+inline void encodeBC7Block(const uint8_t block[64], uint8_t out[16]) {
+    float lo[4], hi[4];
+    principalEndpoints(block, 4, lo, hi);
+    uint8_t q[2][4];
+    int p[2] = { 0, 0 };
+    quantizeBC7Endpoint(lo, q[0], p[0]);
+    quantizeBC7Endpoint(hi, q[1], p[1]);
+    int indices[16];
+    int error = fitBC7Indices(block, q, p, indices);
+
+    // 按已选索引用最小二乘重新求一次端点，误差更小才采用
+    float sumAA = 0, sumAB = 0, sumBB = 0, sumAX[4] = {}, sumBX[4] = {};
+    for (int i = 0; i < 16; ++i) {
+        float b = BC7_WEIGHTS4[indices[i]] / 64.0f, a = 1.0f - b;
+        sumAA += a * a; sumAB += a * b; sumBB += b * b;
+        for (int c = 0; c < 4; ++c) {
+            sumAX[c] += a * block[i * 4 + c];
+            sumBX[c] += b * block[i * 4 + c];
+        }
+    }
+    float det = sumAA * sumBB - sumAB * sumAB;
+    if (error > 0 && std::fabs(det) > 1e-6f) {
+        float e0[4], e1[4];
+        for (int c = 0; c < 4; ++c) {
+            e0[c] = std::min(255.0f, std::max(0.0f, (sumBB * sumAX[c] - sumAB * sumBX[c]) / det));
+            e1[c] = std::min(255.0f, std::max(0.0f, (sumAA * sumBX[c] - sumAB * sumAX[c]) / det));
+        }
+        uint8_t refinedQ[2][4];
+        int refinedP[2] = { 0, 0 }, refinedIndices[16];
+        quantizeBC7Endpoint(e0, refinedQ[0], refinedP[0]);
+        quantizeBC7Endpoint(e1, refinedQ[1], refinedP[1]);
+        if (fitBC7Indices(block, refinedQ, refinedP, refinedIndices) < error) {
+            std::memcpy(q, refinedQ, sizeof(q));
+            std::memcpy(p, refinedP, sizeof(p));
+            std::memcpy(indices, refinedIndices, sizeof(indices));
+        }
+    }
+
+    // 第一个像素的索引最高位是隐含的 0，否则交换端点并翻转索引
+    if (indices[0] & 8) {
+        std::swap(q[0], q[1]);
+        std::swap(p[0], p[1]);
+        for (int& index : indices)
+            index = 15 - index;
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{ out };
+    writer.write(1 << 6, 7); // mode 6
+    for (int c = 0; c < 4; ++c) {
+        writer.write(q[0][c], 7);
+        writer.write(q[1][c], 7);
+    }
+    writer.write(p[0], 1);
+    writer.write(p[1], 1);
+    writer.write(indices[0], 3);
+    for (int i = 1; i < 16; ++i)
+        writer.write(indices[i], 4);
+}
+
+// 只解码 mode 6（本编码器只产生这一种），其他模式返回 false
+inline bool decodeBC7Block(const uint8_t in[16], uint8_t block[64]) {
+    BitReader reader{ in };
+    if (reader.read(7) != (1 << 6))
+        return false;
+    int q[2][4];
+    for (int c = 0; c < 4; ++c) {
+        q[0][c] = reader.read(7);
+        q[1][c] = reader.read(7);
+    }
+    int p0 = reader.read(1), p1 = reader.read(1);
+    int endpoint[2][4];
+    for (int c = 0; c < 4; ++c) {
+        endpoint[0][c] = (q[0][c] << 1) | p0;
+        endpoint[1][c] = (q[1][c] << 1) | p1;
+    }
+    for (int i = 0; i < 16; ++i) {
+        int w = BC7_WEIGHTS4[reader.read(i == 0 ? 3 : 4)];
+        for (int c = 0; c < 4; ++c)
+            block[i * 4 + c] = (uint8_t)(((64 - w) * endpoint[0][c] + w * endpoint[1][c] + 32) >> 6);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------- ETC2 ----
+
+const int ETC_MODIFIERS[8][4] = {
+    { 2, 8, -2, -8 }, { 5, 17, -5, -17 }, { 9, 29, -9, -29 }, { 13, 42, -13, -42 },
+    { 18, 60, -18, -60 }, { 24, 80, -24, -80 }, { 33, 106, -33, -106 }, { 47, 183, -47, -183 }
+};
+
+// 子块的像素（flip=0 左右两半，flip=1 上下两半）
+inline void etcSubblockPixels(int flip, int sub, int pixels[8]) {
+    int n = 0;
+    for (int y = 0; y < 4; ++y)
+        for (int x = 0; x < 4; ++x) {
+            int inSub = flip ? (y >= 2) : (x >= 2);
+            if (inSub == sub)
+                pixels[n++] = y * 4 + x;
+        }
+}
+
+// 在给定基色下给子块选最佳码表，返回误差，并写出每个像素的 2 位索引
+inline int etcFitSubblock(const uint8_t block[64], const int pixels[8], const int base[3], int& table, int indices[16]) {
+    int bestTotal = 1 << 30;
+    for (int t = 0; t < 8; ++t) {
+        int total = 0;
+        int chosen[8];
+        for (int i = 0; i < 8; ++i) {
+            const uint8_t* px = block + pixels[i] * 4;
+            int bestError = 1 << 30;
+            for (int m = 0; m < 4; ++m) {
+                int error = 0;
+                for (int c = 0; c < 3; ++c) {
+                    int d = clamp255(base[c] + ETC_MODIFIERS[t][m]) - px[c];
+                    error += d * d;
+                }
+                if (error < bestError) { bestError = error; chosen[i] = m; }
+            }
+            total += bestError;
+        }
+        if (total < bestTotal) {
+            bestTotal = total;
+            table = t;
+            for (int i = 0; i < 8; ++i)
+                indices[pixels[i]] = chosen[i];
+        }
+    }
+    return bestTotal;
+}
+
+inline void encodeETC2RGBBlock(const uint8_t block[64], uint8_t out[8]) {
+    uint64_t bestBits = 0;
+    int bestError = 1 << 30;
+
+    for (int flip = 0; flip < 2; ++flip) {
+        int pixels[2][8];
+        float average[2][3] = {};
+        for (int s = 0; s < 2; ++s) {
+            etcSubblockPixels(flip, s, pixels[s]);
+            for (int i = 0; i < 8; ++i)
+                for (int c = 0; c < 3; ++c)
+                    average[s][c] += block[pixels[s][i] * 4 + c] / 8.0f;
+        }
+
+        for (int diff = 0; diff < 2; ++diff) {
+            int q[2][3], base[2][3];
+            bool valid = true;
+            for (int s = 0; s < 2; ++s)
+                for (int c = 0; c < 3; ++c) {
+                    if (diff) {
+                        q[s][c] = std::min(31, (int)std::lround(average[s][c] * 31.0f / 255.0f));
+                        base[s][c] = (q[s][c] << 3) | (q[s][c] >> 2);
+                    } else {
+                        q[s][c] = std::min(15, (int)std::lround(average[s][c] * 15.0f / 255.0f));
+                        base[s][c] = (q[s][c] << 4) | q[s][c];
+                    }
+                }
+            // differential 模式下差值必须在 [-4, 3]，否则 ETC2 会把它当成 T/H/planar 模式
+            if (diff)
+                for (int c = 0; c < 3; ++c)
+                    valid = valid && q[1][c] - q[0][c] >= -4 && q[1][c] - q[0][c] <= 3;
+            if (!valid)
+                continue;
+
+            int table[2] = { 0, 0 }, indices[16];
+            int error = etcFitSubblock(block, pixels[0], base[0], table[0], indices)
+                      + etcFitSubblock(block, pixels[1], base[1], table[1], indices);
+            if (error >= bestError)
+                continue;
+            bestError = error;
+
+            uint64_t bits = 0;
+            if (diff) {
+                bits |= (uint64_t)q[0][0] << 59 | (uint64_t)((q[1][0] - q[0][0]) & 7) << 56;
+                bits |= (uint64_t)q[0][1] << 51 | (uint64_t)((q[1][1] - q[0][1]) & 7) << 48;
+                bits |= (uint64_t)q[0][2] << 43 | (uint64_t)((q[1][2] - q[0][2]) & 7) << 40;
+            } else {
+                bits |= (uint64_t)q[0][0] << 60 | (uint64_t)q[1][0] << 56;
+                bits |= (uint64_t)q[0][1] << 52 | (uint64_t)q[1][1] << 48;
+                bits |= (uint64_t)q[0][2] << 44 | (uint64_t)q[1][2] << 40;
+            }
+            bits |= (uint64_t)table[0] << 37 | (uint64_t)table[1] << 34;
+            bits |= (uint64_t)diff << 33 | (uint64_t)flip << 32;
+            // 像素按列优先编号：(x, y) -> x * 4 + y；低 16 位是索引的低位，高 16 位是高位
+            for (int y = 0; y < 4; ++y)
+                for (int x = 0; x < 4; ++x) {
+                    int m = indices[y * 4 + x];
+                    int bit = x * 4 + y;
+                    bits |= (uint64_t)(m & 1) << bit;
+                    bits |= (uint64_t)(m >> 1) << (16 + bit);
+                }
+            bestBits = bits;
+        }
+    }
+    for (int i = 0; i < 8; ++i)
+        out[i] = (uint8_t)(bestBits >> (56 - 8 * i));
+}
+
+// 只解码 individual / differential 模式（本编码器只产生这两种）
+inline void decodeETC2RGBBlock(const uint8_t in[8], uint8_t block[64]) {
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i)
+        bits = bits << 8 | in[i];
+    int diff = bits >> 33 & 1, flip = bits >> 32 & 1;
+    int base[2][3];
+    for (int c = 0; c < 3; ++c) {
+        if (diff) {
+            int b = bits >> (59 - 8 * c) & 31;
+            int d = bits >> (56 - 8 * c) & 7;
+            d = d >= 4 ? d - 8 : d;
+            base[0][c] = (b << 3) | (b >> 2);
+            base[1][c] = ((b + d) << 3) | ((b + d) >> 2);
+        } else {
+            int b0 = bits >> (60 - 8 * c) & 15, b1 = bits >> (56 - 8 * c) & 15;
+            base[0][c] = (b0 << 4) | b0;
+            base[1][c] = (b1 << 4) | b1;
+        }
+    }
+    int table[2] = { (int)(bits >> 37 & 7), (int)(bits >> 34 & 7) };
+    for (int y = 0; y < 4; ++y)
+        for (int x = 0; x < 4; ++x) {
+            int bit = x * 4 + y;
+            int m = (int)((bits >> bit & 1) | (bits >> (16 + bit) & 1) << 1);
+            int s = flip ? (y >= 2) : (x >= 2);
+            for (int c = 0; c < 3; ++c)
+                block[(y * 4 + x) * 4 + c] = (uint8_t)clamp255(base[s][c] + ETC_MODIFIERS[table[s]][m]);
+            block[(y * 4 + x) * 4 + 3] = 255;
+        }
+}
+
+const int EAC_MODIFIERS[16][8] = {
+    { -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 },  { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 },  { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 },  { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 },   { -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+inline void encodeEACAlphaBlock(const uint8_t block[64], uint8_t out[8]) {
+    int minA = 255, maxA = 0;
+    for (int i = 0; i < 16; ++i) {
+        minA = std::min<int>(minA, block[i * 4 + 3]);
+        maxA = std::max<int>(maxA, block[i * 4 + 3]);
+    }
+    int base = (minA + maxA + 1) / 2;
+    int bestError = 1 << 30, bestTable = 13, bestMul = 1;
+    uint64_t bestIndices = 0;
+    for (int t = 0; t < 16 && bestError > 0; ++t) {
+        // 乘数让码表大致覆盖 [min, max]
+        int span = EAC_MODIFIERS[t][7] - EAC_MODIFIERS[t][3];
+        int center = std::max(1, std::min(15, (maxA - minA + span / 2) / span));
+        for (int mul = std::max(1, center - 1); mul <= std::min(15, center + 1); ++mul) {
+            int error = 0;
+            uint64_t indices = 0;
+            for (int x = 0; x < 4; ++x)
+                for (int y = 0; y < 4; ++y) {
+                    int a = block[(y * 4 + x) * 4 + 3];
+                    int best = 0, bestE = 1 << 30;
+                    for (int m = 0; m < 8; ++m) {
+                        int d = clamp255(base + EAC_MODIFIERS[t][m] * mul) - a;
+                        if (d * d < bestE) { bestE = d * d; best = m; }
+                    }
+                    error += bestE;
+                    indices |= (uint64_t)best << (45 - 3 * (x * 4 + y));
+                }
+            if (error < bestError) {
+                bestError = error;
+                bestTable = t;
+                bestMul = mul;
+                bestIndices = indices;
+            }
+        }
+    }
+    out[0] = (uint8_t)base;
+    out[1] = (uint8_t)(bestMul << 4 | bestTable);
+    for (int i = 0; i < 6; ++i)
+        out[2 + i] = (uint8_t)(bestIndices >> (40 - 8 * i));
+}
+
+inline void decodeEACAlphaBlock(const uint8_t in[8], uint8_t block[64]) {
+    int base = in[0], mul = in[1] >> 4, table = in[1] & 15;
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices = indices << 8 | in[2 + i];
+    for (int x = 0; x < 4; ++x)
+        for (int y = 0; y < 4; ++y) {
+            int m = (int)(indices >> (45 - 3 * (x * 4 + y)) & 7);
+            block[(y * 4 + x) * 4 + 3] = (uint8_t)clamp255(base + EAC_MODIFIERS[table][m] * mul);
+        }
+}
+
+inline void encodeETC2RGBABlock(const uint8_t block[64], uint8_t out[16]) {
+    encodeEACAlphaBlock(block, out);
+    encodeETC2RGBBlock(block, out + 8);
+}
+
+inline void decodeETC2RGBABlock(const uint8_t in[16], uint8_t block[64]) {
+    decodeETC2RGBBlock(in + 8, block);
+    decodeEACAlphaBlock(in, block);
+}
+
+inline void encodeBlock(BlockFormat format, const uint8_t block[64], uint8_t* out) {
+    switch (format) {
+    case BlockFormat::BC1:       encodeBC1Block(block, out); break;
+    case BlockFormat::BC3:       encodeBC3Block(block, out); break;
+    case BlockFormat::BC7:       encodeBC7Block(block, out); break;
+    case BlockFormat::ETC2_RGB:  encodeETC2RGBBlock(block, out); break;
+    case BlockFormat::ETC2_RGBA: encodeETC2RGBABlock(block, out); break;
+    }
+}
+
+inline void decodeBlock(BlockFormat format, const uint8_t* in, uint8_t block[64]) {
+    switch (format) {
+    case BlockFormat::BC1:       decodeBC1Block(in, block); break;
+    case BlockFormat::BC3:       decodeBC3Block(in, block); break;
+    case BlockFormat::BC7:       decodeBC7Block(in, block); break;
+    case BlockFormat::ETC2_RGB:  decodeETC2RGBBlock(in, block); break;
+    case BlockFormat::ETC2_RGBA: decodeETC2RGBABlock(in, block); break;
+    }
+}
+
+} // namespace texcomp
+
+// 压缩一张 RGBA8 图；传入任务系统时按块行并行
+inline std::vector<uint8_t> compressImage(const uint8_t* rgba, int width, int height, BlockFormat format,
+                                          JobSystem* jobs = nullptr) {
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    size_t bytes = blockBytes(format);
+    std::vector<uint8_t> out((size_t)blocksX * blocksY * bytes);
+
+    auto encodeRows = [=, &out](int firstRow, int lastRow) {
+        uint8_t block[64];
+        for (int by = firstRow; by < lastRow; ++by)
+            for (int bx = 0; bx < blocksX; ++bx) {
+                texcomp::fetchBlock(rgba, width, height, bx, by, block);
+                texcomp::encodeBlock(format, block, out.data() + ((size_t)by * blocksX + bx) * bytes);
+            }
+    };
+
+    if (!jobs || blocksY < 2) {
+        encodeRows(0, blocksY);
+        return out;
+    }
+    // 一行块（BC7 下一行就是几百个块的模式搜索）已经够重，最小粒度 1 行
+    jobs->parallelFor(0, (size_t)blocksY, [&](size_t first, size_t last) { encodeRows((int)first, (int)last); }, 1);
+    return out;
+}
+
+// 解码回 RGBA8（用于计算压缩误差）
+inline std::vector<uint8_t> decompressImage(const uint8_t* data, int width, int height, BlockFormat format) {
+    int blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    size_t bytes = blockBytes(format);
+    std::vector<uint8_t> rgba((size_t)width * height * 4);
+    uint8_t block[64];
+    for (int by = 0; by < blocksY; ++by)
+        for (int bx = 0; bx < blocksX; ++bx) {
+            texcomp::decodeBlock(format, data + ((size_t)by * blocksX + bx) * bytes, block);
+            for (int y = 0; y < 4 && by * 4 + y < height; ++y)
+                for (int x = 0; x < 4 && bx * 4 + x < width; ++x)
+                    std::memcpy(&rgba[((size_t)(by * 4 + y) * width + bx * 4 + x) * 4], block + (y * 4 + x) * 4, 4);
+        }
+    return rgba;
+}
+
+// 峰值信噪比（dB），channels = 3 时忽略 alpha
+inline double computePSNR(const uint8_t* a, const uint8_t* b, size_t pixelCount, int channels) {
+    double sum = 0.0;
+    for (size_t i = 0; i < pixelCount; ++i)
+        for (int c = 0; c < channels; ++c) {
+            double d = (double)a[i * 4 + c] - b[i * 4 + c];
+            sum += d * d;
+        }
+    double mse = sum / (pixelCount * channels);
+    return mse <= 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+struct CompressedLevel {
+    int width = 0, height = 0;
+    std::vector<uint8_t> data;
+};
+
+// 生成完整 mip 链（一直到 1x1，sRGB 纹理在线性空间缩小）并逐级压缩
+inline std::vector<CompressedLevel> compressMipChain(const uint8_t* rgba, int width, int height, BlockFormat format,
+                                                     bool srgb = false, JobSystem* jobs = nullptr) {
+    MipChain chain = buildMipChain(rgba, width, height, 4, srgb, jobs);
+    std::vector<CompressedLevel> levels(chain.levels.size());
+    for (size_t i = 0; i < chain.levels.size(); ++i) {
+        levels[i].width = chain.levels[i].width;
+        levels[i].height = chain.levels[i].height;
+        levels[i].data = compressImage(chain.level(i), levels[i].width, levels[i].height, format, jobs);
+    }
+    return levels;
+}
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef TEXTURE_PACKER_H
+#define TEXTURE_PACKER_H
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <iostream>
+#include <cmath>
+
+// 纹理图集打包（纯 CPU，不依赖 GL）
+// skyline bottom-left：维护一条“天际线”，每次把矩形放在能让顶边最低的位置
+struct PackRect {
+    int x = 0, y = 0, width = 0, height = 0;
+};
+
+class SkylinePacker {
+public:
+    SkylinePacker(int width, int height) : width(width), height(height) {
+        nodes.push_back({ 0, 0, width });
+    }
+
+    // 放入一个 w x h 的矩形，放不下返回 false
+    bool insert(int w, int h, PackRect& out) {
+        int bestIndex = -1, bestTop = height + 1, bestWidth = width + 1, bestY = 0;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            int y = fit(i, w, h);
+            if (y < 0)
+                continue;
+            // 顶边最低优先，相同时选更窄的一段，减少留下的空洞
+            if (y + h < bestTop || (y + h == bestTop && nodes[i].width < bestWidth)) {
+                bestIndex = (int)i;
+                bestTop = y + h;
+                bestWidth = nodes[i].width;
+                bestY = y;
+            }
+        }
+        if (bestIndex < 0)
+            return false;
+
+        out = { nodes[bestIndex].x, bestY, w, h };
+        nodes.insert(nodes.begin() + bestIndex, Node{ out.x, bestY + h, w });
+
+        // 新段覆盖掉的部分从后面的段里切掉
+        for (size_t i = bestIndex + 1; i < nodes.size(); ++i) {
+            int prevEnd = nodes[i - 1].x + nodes[i - 1].width;
+            if (nodes[i].x >= prevEnd)
+                break;
+            int shrink = prevEnd - nodes[i].x;
+            nodes[i].x += shrink;
+            nodes[i].width -= shrink;
+            if (nodes[i].width > 0)
+                break;
+            nodes.erase(nodes.begin() + i);
+            --i;
+        }
+        // 合并相邻的同高段
+        for (size_t i = 0; i + 1 < nodes.size();) {
+            if (nodes[i].y == nodes[i + 1].y) {
+                nodes[i].width += nodes[i + 1].width;
+                nodes.erase(nodes.begin() + i + 1);
+            } else {
+                ++i;
+            }
+        }
+        usedArea += (size_t)w * h;
+        top = std::max(top, bestTop);
+        return true;
+    }
+
+    size_t used() const { return usedArea; }
+    int usedHeight() const { return top; }
+    double occupancy() const { return (double)usedArea / ((double)width * height); }
+
+private:
+    struct Node {
+        int x, y, width;
+    };
+
+    int width, height;
+    std::vector<Node> nodes;
+    size_t usedArea = 0;
+    int top = 0;
+
+    // 以第 i 段的左端为起点放置时矩形底边的高度，放不下返回 -1
+    int fit(size_t i, int w, int h) const {
+        int x = nodes[i].x;
+        if (x + w > width)
+            return -1;
+        int y = nodes[i].y, remaining = w;
+        for (size_t j = i; remaining > 0; ++j) {
+            y = std::max(y, nodes[j].y);
+            if (y + h > height)
+                return -1;
+            remaining -= nodes[j].width;
+        }
+        return y;
+    }
+};
+
+// 图集布局：rects[i] 是第 i 张图（不含边距）在图集里的位置
+struct AtlasLayout {
+    int width = 0, height = 0;
+    int padding = 0;
+    std::vector<PackRect> rects;
+    size_t imageArea = 0;   // 所有图片本身的面积
+    size_t paddedArea = 0;  // 含边距和对齐后的面积
+
+    explicit operator bool() const { return width > 0; }
+
+    // 打包效率：图片面积 / 图集面积
+    double efficiency() const { return width ? (double)imageArea / ((double)width * height) : 0.0; }
+
+    void printReport(std::ostream& out = std::cout) const {
+        out << "Atlas " << width << "x" << height << ": " << rects.size() << " images, efficiency "
+            << efficiency() * 100.0 << "% (" << (width ? (double)paddedArea / ((double)width * height) * 100.0 : 0.0)
+            << "% including " << padding << "px padding)" << std::endl;
+    }
+};
+
+inline int roundUp(int value, int multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// 把一组尺寸打包进面积尽量小的图集（宽高不要求 2 的幂），放不进 maxSize x maxSize 返回空布局
+// padding 同时也是对齐粒度（取 2 的幂）：每张图四周留 padding 像素，起点和图集尺寸都按 padding 对齐，
+// 这样前 log2(padding) 级 mip 里相邻图片的像素不会混到一起
+inline AtlasLayout packAtlas(const std::vector<PackRect>& sizes, int padding = 8, int maxSize = 8192) {
+    AtlasLayout layout;
+    layout.padding = padding;
+    if (sizes.empty())
+        return layout;
+
+    std::vector<int> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    // 先放高的，skyline 对高度降序的输入最友好
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return sizes[a].height != sizes[b].height ? sizes[a].height > sizes[b].height : sizes[a].width > sizes[b].width;
+    });
+
+    int align = std::max(1, padding);
+    auto slotWidth = [&](int i) { return roundUp(sizes[i].width + 2 * padding, align); };
+    auto slotHeight = [&](int i) { return roundUp(sizes[i].height + 2 * padding, align); };
+    size_t padded = 0;
+    int minWidth = 1;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        padded += (size_t)slotWidth((int)i) * slotHeight((int)i);
+        minWidth = std::max(minWidth, slotWidth((int)i));
+        layout.imageArea += (size_t)sizes[i].width * sizes[i].height;
+    }
+
+    // 在一段宽度里逐个尝试（步长为对齐粒度的倍数），高度取天际线实际用到的高度，选面积最小的
+    int step = roundUp(32, align);
+    int widest = std::min(maxSize, minWidth + 4 * (int)std::sqrt((double)padded));
+    size_t bestArea = (size_t)-1;
+    for (int w = minWidth; w <= widest; w = roundUp(w + 1, step)) {
+        SkylinePacker packer(w, maxSize);
+        std::vector<PackRect> rects(sizes.size());
+        bool fits = true;
+        for (int i : order) {
+            PackRect slot;
+            if (!packer.insert(slotWidth(i), slotHeight(i), slot)) {
+                fits = false;
+                break;
+            }
+            rects[i] = { slot.x + padding, slot.y + padding, sizes[i].width, sizes[i].height };
+        }
+        int h = roundUp(packer.usedHeight(), align);
+        if (!fits || (size_t)w * h >= bestArea)
+            continue;
+        bestArea = (size_t)w * h;
+        layout.width = w;
+        layout.height = h;
+        layout.rects = std::move(rects);
+        layout.paddedArea = packer.used();
+    }
+    return layout;
+}
+
+// 把一张图拷进图集，并把边缘像素向外复制 padding 圈（避免双线性过滤和 mip 从邻居取到颜色）
+inline void blitWithExtrude(uint8_t* atlas, int atlasWidth, int channels, const PackRect& rect,
+                            const uint8_t* image, int padding) {
+    for (int y = -padding; y < rect.height + padding; ++y) {
+        int sy = std::min(std::max(y, 0), rect.height - 1);
+        uint8_t* dst = atlas + ((size_t)(rect.y + y) * atlasWidth + rect.x - padding) * channels;
+        for (int x = -padding; x < rect.width + padding; ++x, dst += channels) {
+            int sx = std::min(std::max(x, 0), rect.width - 1);
+            const uint8_t* src = image + ((size_t)sy * rect.width + sx) * channels;
+            for (int c = 0; c < channels; ++c)
+                dst[c] = src[c];
+        }
+    }
+}
+
+#endif
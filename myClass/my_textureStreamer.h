@@ -0,0 +1,265 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <iostream>
+
+#include "my_TextureLoader.h"
+#include "my_glState.h"
+#include "my_threadPool.h"
+#include "my_lockFreeQueue.h"
+#include "my_imageUtils.h"
+#include "my_mipCache.h"
+
+class TextureStreamer;
+
+// 流式纹理句柄：加载完成前 use() 绑定的是占位纹理
+class StreamedTexture {
+public:
+    const std::string path;
+
+    StreamedTexture(std::string path, GLuint placeholder) : path(std::move(path)), placeholder(placeholder) {}
+
+    bool ready() const { return texture != nullptr; }
+    bool failed() const { return loadFailed; }
+    GLuint id() const { return texture ? texture->ID : placeholder; }
+    const Texture* get() const { return texture.get(); }
+
+    void use(GLuint textureUnit = 0) const {
+        glState().bindTextureUnit(textureUnit, GL_TEXTURE_2D, id());
+    }
+
+private:
+    friend class TextureStreamer;
+    std::unique_ptr<Texture> texture;
+    GLuint placeholder;
+    bool loadFailed = false;
+};
+
+// 异步纹理加载：
+//   1. 线程池里解码图片并生成 mip 链（mip 缓存命中时直接读出整条链）
+//   2. 解码结果经无锁队列交回渲染线程
+//   3. 每帧在字节预算内通过 PBO 上传，用 fence 判断上传完成后才替换掉占位纹理
+// load() 和 update() 都必须在 GL 线程调用
+class TextureStreamer {
+public:
+    size_t frameBudgetBytes;
+
+    // 统计
+    size_t bytesUploadedLastFrame = 0;
+    unsigned completed = 0;
+    unsigned failures = 0;
+
+    explicit TextureStreamer(size_t frameBudgetBytes = 4 * 1024 * 1024, unsigned workerCount = ThreadPool::defaultThreadCount(),
+                             unsigned uploadSlots = 4)
+        : frameBudgetBytes(frameBudgetBytes), decoded(1024), workers(workerCount), slots(uploadSlots) {}
+
+    ~TextureStreamer() {
+        // 先让工作线程停下再等它们结束：队满时它们在等渲染线程消费，这里已经不会再有人 pop 了
+        // 还没上传的像素随后释放（GL 对象需要显式 release()）
+        stopping = true;
+        workers.wait();
+        DecodedImage image;
+        while (decoded.pop(image))
+            waiting.push_back(std::move(image));
+        waiting.clear();
+    }
+
+    std::shared_ptr<StreamedTexture> load(const std::string& path, bool flip = true) {
+        auto handle = std::make_shared<StreamedTexture>(path, placeholderTexture());
+        ++inFlight;
+        workers.submit([this, handle, flip]() {
+            if (stopping)
+                return;
+            DecodedImage image;
+            image.target = handle;
+            image.chain = mipCache().loadOrBuild(handle->path, flip, false);
+            // 命中缓存时链指向文件映射，在工作线程里把页读进来，渲染线程拷进 PBO 时不再卡在磁盘上
+            if (image.chain.mapping)
+                image.chain.mapping->prefault();
+            // 队满说明渲染线程跟不上，让出时间片等它消费；析构时放弃这张图
+            while (!decoded.push(std::move(image))) {
+                if (stopping)
+                    return;
+                std::this_thread::yield();
+            }
+        });
+        return handle;
+    }
+
+    // 还在解码或上传中的数量
+    unsigned pending() const { return inFlight.load(); }
+
+    // 每帧调用一次
+    void update() {
+        // 1. 上传已完成（fence 已触发）的纹理替换掉占位
+        for (UploadSlot& slot : slots) {
+            if (!slot.fence)
+                continue;
+            GLenum status = glClientWaitSync(slot.fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                continue;
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+            slot.target->texture = std::make_unique<Texture>(slot.texture, slot.width, slot.height, slot.channels);
+            slot.target.reset();
+            --inFlight;
+            ++completed;
+        }
+
+        // 2. 取出工作线程解码好的图片
+        DecodedImage image;
+        while (decoded.pop(image))
+            waiting.push_back(std::move(image));
+
+        // 3. 在本帧预算内上传；单张超过预算的图片独占一帧
+        size_t uploaded = 0;
+        while (!waiting.empty()) {
+            DecodedImage& next = waiting.front();
+            if (!next.chain) {
+                std::cerr << "Failed to load texture:" << next.target->path << std::endl;
+                next.target->loadFailed = true;
+                waiting.pop_front();
+                --inFlight;
+                ++failures;
+                continue;
+            }
+            size_t bytes = next.chain.bytes();
+            if (uploaded > 0 && uploaded + bytes > frameBudgetBytes)
+                break;
+            UploadSlot* slot = freeSlot();
+            if (!slot)
+                break;
+            upload(*slot, next);
+            waiting.pop_front();
+            uploaded += bytes;
+        }
+        bytesUploadedLastFrame = uploaded;
+    }
+
+    // 在上下文销毁前调用；还在等 fence 的纹理没有交给句柄，在这里一起删掉
+    void release() {
+        for (UploadSlot& slot : slots) {
+            if (slot.fence) {
+                glDeleteSync(slot.fence);
+                glState().forgetTexture(slot.texture);
+                glDeleteTextures(1, &slot.texture);
+                --inFlight;
+            }
+            if (slot.pbo) {
+                glState().forgetBuffer(slot.pbo);
+                glDeleteBuffers(1, &slot.pbo);
+            }
+            slot = UploadSlot{};
+        }
+        if (placeholder) {
+            glState().forgetTexture(placeholder);
+            glDeleteTextures(1, &placeholder);
+            placeholder = 0;
+        }
+    }
+
+private:
+    struct DecodedImage {
+        std::shared_ptr<StreamedTexture> target;
+        MipChain chain;
+    };
+
+    struct UploadSlot {
+        GLuint pbo = 0;
+        size_t capacity = 0;
+        GLsync fence = nullptr;
+        std::shared_ptr<StreamedTexture> target;
+        GLuint texture = 0;
+        int width = 0, height = 0, channels = 0;
+    };
+
+    LockFreeQueue<DecodedImage> decoded;
+    std::deque<DecodedImage> waiting;   // 只在渲染线程访问
+    ThreadPool workers;
+    std::vector<UploadSlot> slots;
+    std::atomic<unsigned> inFlight{ 0 };
+    std::atomic<bool> stopping{ false };
+    GLuint placeholder = 0;
+
+    // 2x2 的洋红/黑棋盘格，一眼能看出还没加载完
+    GLuint placeholderTexture() {
+        if (placeholder == 0) {
+            const unsigned char pixels[16] = { 255, 0, 255, 255,  0, 0, 0, 255,
+                                               0, 0, 0, 255,      255, 0, 255, 255 };
+            glGenTextures(1, &placeholder);
+            glState().bindTexture(GL_TEXTURE_2D, placeholder);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+        return placeholder;
+    }
+
+    UploadSlot* freeSlot() {
+        for (UploadSlot& slot : slots)
+            if (!slot.fence)
+                return &slot;
+        return nullptr;
+    }
+
+    void upload(UploadSlot& slot, const DecodedImage& decodedImage) {
+        const MipChain& chain = decodedImage.chain;
+        size_t bytes = chain.bytes();
+        if (slot.pbo == 0)
+            glGenBuffers(1, &slot.pbo);
+        glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.pbo);
+        if (slot.capacity < bytes) {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+            slot.capacity = bytes;
+        }
+        // 槽位的 fence 已经触发，GPU 不再读取，可以不同步直接写
+        // 整条 mip 链已经在工作线程里翻转、扩展好，这里只做一次拷贝
+        void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        // 映射失败或者 unmap 时数据损坏（GL_FALSE）都退回 glBufferSubData，PBO 里不能留着未初始化的内容
+        bool copied = false;
+        if (dst) {
+            std::memcpy(dst, chain.data(), bytes);
+            copied = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+        }
+        if (!copied) {
+            std::cerr << "ERROR::TEXTURE_STREAMER::PBO_MAP_FAILED: " << decodedImage.target->path
+                      << ", uploading with glBufferSubData" << std::endl;
+            glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, bytes, chain.data());
+        }
+
+        // 和 Texture 的同步加载用同一套通道数 -> 格式的对应（灰度 + 透明是 GL_RG8）
+        GLenum format = Texture::pixelFormat(chain.channels);
+        GLint internalFormat = Texture::internalFormat(chain.channels, chain.srgb);
+        glGenTextures(1, &slot.texture);
+        glState().bindTexture(GL_TEXTURE_2D, slot.texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (size_t level = 0; level < chain.levels.size(); ++level) {
+            const MipLevelInfo& l = chain.levels[level];
+            glTexImage2D(GL_TEXTURE_2D, (GLint)level, internalFormat, l.width, l.height, 0, format, GL_UNSIGNED_BYTE,
+                         (void*)l.offset);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)chain.levels.size() - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // 一定要解绑，否则之后从内存上传的 glTexImage2D 会被当成 PBO 偏移
+        glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.target = decodedImage.target;
+        slot.width = chain.width;
+        slot.height = chain.height;
+        slot.channels = chain.channels;
+    }
+};
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <atomic>
+
+// 简单的工作线程池：任务里不能调用 GL（上下文只在主线程）
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount = defaultThreadCount()) {
+        if (threadCount == 0)
+            threadCount = 1;
+        for (unsigned i = 0; i < threadCount; ++i)
+            workers.emplace_back([this]() { workerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : workers)
+            t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+            ++unfinished;
+        }
+        wake.notify_one();
+    }
+
+    // 阻塞直到已提交的任务全部完成
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this]() { return unfinished == 0; });
+    }
+
+    size_t size() const { return workers.size(); }
+
+    // 留一个核给渲染线程
+    static unsigned defaultThreadCount() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n > 1 ? n - 1 : 1;
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    size_t unfinished = 0;
+    bool stopping = false;
+
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this]() { return stopping || !jobs.empty(); });
+                if (stopping && jobs.empty())
+                    return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--unfinished == 0)
+                    idle.notify_all();
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,385 @@
+#ifndef TRANSFORM_GRAPH_H
+#define TRANSFORM_GRAPH_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+
+#include "my_jobSystem.h"
+#include "my_matrixKernels.h"
+
+// 父子变换层级，节点按广度优先顺序存在扁平的 SoA 数组里（不调用 GL）
+//   - 槽位顺序是一层一层排的：父节点的槽位总是小于子节点，同一个父节点的子节点连续，
+//     所以全量更新就是一次从前往后的线性扫描，world[i] = world[parent[i]] * local[i]
+//   - 改了局部 TRS 的节点记进脏列表；update() 只从这些节点往下走它们的子树，其余节点一个都不碰，
+//     静止的场景每帧几乎零开销，开销跟变化量走而不是跟场景大小走；
+//     脏节点很多时子树遍历的跳跃访问反而更慢，改成一次按槽位顺序的带标记扫描
+//   - 矩阵用 my_matrixKernels.h 的批量内核算：一段槽位先合成局部矩阵，再按父节点分段左乘父矩阵
+//   - changed() 是这一帧世界矩阵变了的槽位（升序），直接用来做实例缓冲的部分上传
+//   - 增删节点、换父节点只记一个标记，下一次 update() 统一重排一次（O(n)，全部算作变化）
+// NodeId 是稳定的句柄，槽位在重排后会变；删除的 NodeId 之后会被复用
+class TransformGraph {
+public:
+    typedef uint32_t NodeId;
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    struct Stats {
+        size_t dirtyRoots = 0; // 这一帧被直接修改的节点
+        size_t updated = 0;    // 实际重算世界矩阵的节点（脏节点 + 它们的子树）
+        bool relayout = false; // 这一帧重排过，所有槽位都算变化
+        double updateUs = 0.0;
+    };
+
+    // parent 为 NONE 时是根节点；新节点的世界矩阵在下一次 update() 之后才有效
+    NodeId add(NodeId parent, const glm::vec3& position, const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+               const glm::vec3& scale = glm::vec3(1.0f)) {
+        if (parent != NONE && !valid(parent))
+            return NONE;
+        NodeId id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+        } else {
+            id = (NodeId)slotById.size();
+            slotById.push_back(NONE);
+        }
+        // 先追加在末尾（父节点槽位一定更小），等 update() 重排
+        uint32_t slot = (uint32_t)idBySlot.size();
+        slotById[id] = slot;
+        idBySlot.push_back(id);
+        parentSlot.push_back(parent == NONE ? NONE : slotById[parent]);
+        firstChild.push_back(0);
+        childCount.push_back(0);
+        px.push_back(position.x); py.push_back(position.y); pz.push_back(position.z);
+        rx.push_back(rotation.x); ry.push_back(rotation.y); rz.push_back(rotation.z); rw.push_back(rotation.w);
+        sx.push_back(scale.x); sy.push_back(scale.y); sz.push_back(scale.z);
+        localDirty.push_back(0);
+        stamp.push_back(0);
+        world.push_back(glm::mat4(1.0f));
+        ++alive;
+        layoutDirty = true;
+        return id;
+    }
+
+    // 连同整个子树一起删除
+    void remove(NodeId id) {
+        if (!valid(id))
+            return;
+        if (layoutDirty)
+            relayout();
+        std::vector<uint32_t>& pending = stack;
+        pending.assign(1, slotById[id]);
+        while (!pending.empty()) {
+            uint32_t slot = pending.back();
+            pending.pop_back();
+            for (uint32_t c = 0; c < childCount[slot]; ++c)
+                pending.push_back(firstChild[slot] + c);
+            freeIds.push_back(idBySlot[slot]);
+            slotById[idBySlot[slot]] = NONE;
+            idBySlot[slot] = NONE; // 重排时跳过
+            --alive;
+        }
+        layoutDirty = true;
+    }
+
+    // 挂到新的父节点下（NONE 变成根）；不能挂到自己的子树里
+    bool setParent(NodeId id, NodeId parent) {
+        if (!valid(id) || (parent != NONE && !valid(parent)))
+            return false;
+        for (NodeId up = parent; up != NONE; up = parentOf(up))
+            if (up == id)
+                return false;
+        parentSlot[slotById[id]] = parent == NONE ? NONE : slotById[parent];
+        layoutDirty = true;
+        return true;
+    }
+
+    bool valid(NodeId id) const { return id < slotById.size() && slotById[id] != NONE; }
+    size_t size() const { return alive; }
+    // 槽位数；重排之前可能包含已删除的空槽位
+    size_t slots() const { return idBySlot.size(); }
+
+    NodeId parentOf(NodeId id) const {
+        uint32_t parent = parentSlot[slotById[id]];
+        return parent == NONE ? NONE : idBySlot[parent];
+    }
+    uint32_t slotOf(NodeId id) const { return slotById[id]; }
+    NodeId idOf(uint32_t slot) const { return idBySlot[slot]; }
+
+    // ---- 局部变换 ----
+
+    void setPosition(NodeId id, const glm::vec3& p) {
+        uint32_t s = slotById[id];
+        px[s] = p.x; py[s] = p.y; pz[s] = p.z;
+        markDirty(s);
+    }
+    void setRotation(NodeId id, const glm::quat& q) {
+        uint32_t s = slotById[id];
+        rx[s] = q.x; ry[s] = q.y; rz[s] = q.z; rw[s] = q.w;
+        markDirty(s);
+    }
+    void setScale(NodeId id, const glm::vec3& v) {
+        uint32_t s = slotById[id];
+        sx[s] = v.x; sy[s] = v.y; sz[s] = v.z;
+        markDirty(s);
+    }
+
+    glm::vec3 position(NodeId id) const { uint32_t s = slotById[id]; return glm::vec3(px[s], py[s], pz[s]); }
+    glm::quat rotation(NodeId id) const { uint32_t s = slotById[id]; return glm::quat(rw[s], rx[s], ry[s], rz[s]); }
+    glm::vec3 scale(NodeId id) const { uint32_t s = slotById[id]; return glm::vec3(sx[s], sy[s], sz[s]); }
+
+    // 局部 TRS 合成的矩阵：T * R * S
+    glm::mat4 localMatrix(uint32_t slot) const {
+        glm::mat4 m;
+        matrixKernels().composeTransforms(columnsFrom(slot), 0, 1, &m);
+        return m;
+    }
+
+    // ---- 世界矩阵 ----
+
+    const glm::mat4& worldMatrix(NodeId id) const { return world[slotById[id]]; }
+    // 按槽位排列，和实例缓冲一一对应
+    const std::vector<glm::mat4>& worldMatrices() const { return world; }
+
+    // 只重算脏节点的子树；有结构变化时先重排再全量更新
+    void update(JobSystem* jobs = nullptr) {
+        auto start = std::chrono::steady_clock::now();
+        frameStats = Stats();
+        if (layoutDirty) {
+            relayout();
+            updateAll(jobs);
+            frameStats.relayout = true;
+            changedSlots.resize(idBySlot.size());
+            for (uint32_t s = 0; s < (uint32_t)changedSlots.size(); ++s)
+                changedSlots[s] = s;
+            frameStats.updated = changedSlots.size();
+        } else {
+            changedSlots.clear();
+            frameStats.dirtyRoots = dirtyRoots.size();
+            if (++frame == 0) {
+                // 计数绕回时清掉旧标记，避免把很久以前的标记当成这一帧的
+                std::fill(stamp.begin(), stamp.end(), 0);
+                frame = 1;
+            }
+            if (dirtyRoots.size() * LINEAR_PASS_RATIO > idBySlot.size())
+                propagateLinear();
+            else
+                propagateSubtrees();
+            dirtyRoots.clear();
+            frameStats.updated = changedSlots.size();
+        }
+        frameStats.updateUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // 不管脏标记，按层从前往后全部重算；同一层的节点互不依赖，传入 jobs 时一层内并行
+    void updateAll(JobSystem* jobs = nullptr) {
+        if (layoutDirty)
+            relayout();
+        for (size_t level = 0; level + 1 < levelStart.size(); ++level) {
+            size_t first = levelStart[level], last = levelStart[level + 1];
+            if (jobs) {
+                jobs->parallelFor(first, last, [this](size_t a, size_t b) {
+                    composeRange(a, b);
+                }, MIN_NODES_PER_TASK);
+            } else {
+                composeRange(first, last);
+            }
+        }
+        std::fill(localDirty.begin(), localDirty.end(), 0);
+        dirtyRoots.clear();
+    }
+
+    // 上一次 update() 重算过的槽位（升序）
+    const std::vector<uint32_t>& changed() const { return changedSlots; }
+    // 上一次 update() 重排过：槽位全变了，实例缓冲要整块重传
+    bool layoutChanged() const { return frameStats.relayout; }
+    const Stats& stats() const { return frameStats; }
+
+private:
+    static constexpr size_t MIN_NODES_PER_TASK = 1024;
+    // 脏节点超过槽位数的 1/LINEAR_PASS_RATIO 时改用线性扫描
+    static constexpr size_t LINEAR_PASS_RATIO = 256;
+
+    // 按 NodeId
+    std::vector<uint32_t> slotById;
+    std::vector<NodeId> freeIds;
+    // 按槽位（广度优先）
+    std::vector<NodeId> idBySlot;
+    std::vector<uint32_t> parentSlot;
+    std::vector<uint32_t> firstChild, childCount;
+    std::vector<float> px, py, pz;
+    std::vector<float> rx, ry, rz, rw;
+    std::vector<float> sx, sy, sz;
+    std::vector<uint8_t> localDirty;
+    std::vector<uint32_t> stamp;
+    std::vector<glm::mat4> world;
+    std::vector<size_t> levelStart; // 第 k 层是槽位 [levelStart[k], levelStart[k + 1])
+
+    std::vector<uint32_t> dirtyRoots;
+    std::vector<uint32_t> changedSlots;
+    std::vector<uint32_t> stack;
+    uint32_t frame = 0;
+    size_t alive = 0;
+    bool layoutDirty = false;
+    Stats frameStats;
+
+    void markDirty(uint32_t slot) {
+        if (!localDirty[slot]) {
+            localDirty[slot] = 1;
+            dirtyRoots.push_back(slot);
+        }
+    }
+
+    // 脏节点少：从每个脏节点沿子节点区间往下走，只碰这些子树
+    // 按槽位升序处理：祖先一定先于后代，祖先也脏时后代在它的子树里已经算过，直接跳过
+    void propagateSubtrees() {
+        std::sort(dirtyRoots.begin(), dirtyRoots.end());
+        for (uint32_t root : dirtyRoots) {
+            if (stamp[root] == frame)
+                continue;
+            composeWorld(root);
+            stack.assign(1, root);
+            while (!stack.empty()) {
+                uint32_t s = stack.back();
+                stack.pop_back();
+                stamp[s] = frame;
+                localDirty[s] = 0;
+                changedSlots.push_back(s);
+                // 子节点的槽位连续，一次批量算完再入栈
+                composeRange(firstChild[s], firstChild[s] + childCount[s]);
+                for (uint32_t c = 0; c < childCount[s]; ++c)
+                    stack.push_back(firstChild[s] + c);
+            }
+        }
+        std::sort(changedSlots.begin(), changedSlots.end());
+    }
+
+    // 脏节点多：子树遍历的跳跃访问和排序比重算本身还贵，改成按槽位顺序一层一层扫一遍，
+    // 自己脏或者父节点这一帧重算过就重算；没变的节点只读两个字节，结果天然升序
+    // 父节点都在上一层，同一层里连续要重算的槽位可以一次交给批量内核
+    void propagateLinear() {
+        for (size_t level = 0; level + 1 < levelStart.size(); ++level) {
+            uint32_t last = (uint32_t)levelStart[level + 1];
+            for (uint32_t s = (uint32_t)levelStart[level]; s < last;) {
+                uint32_t end = s;
+                while (end < last && needsUpdate(end)) {
+                    stamp[end] = frame;
+                    localDirty[end] = 0;
+                    changedSlots.push_back(end);
+                    ++end;
+                }
+                if (end == s) {
+                    ++s;
+                    continue;
+                }
+                composeRange(s, end);
+                s = end;
+            }
+        }
+    }
+
+    bool needsUpdate(uint32_t slot) const {
+        uint32_t parent = parentSlot[slot];
+        return localDirty[slot] || (parent != NONE && stamp[parent] == frame);
+    }
+
+    // 从第 first 个槽位开始的 TRS 列
+    TRSColumns columnsFrom(size_t first) const {
+        return TRSColumns{ px.data() + first, py.data() + first, pz.data() + first, rx.data() + first, ry.data() + first,
+                           rz.data() + first, rw.data() + first, sx.data() + first, sy.data() + first, sz.data() + first };
+    }
+
+    // 槽位 [first, last) 的父节点都已经算好：先批量合成局部矩阵写进 world，
+    // 再按父节点分段（同一个父节点的子节点连续）原地左乘父节点的世界矩阵，根节点的局部矩阵就是世界矩阵
+    void composeRange(size_t first, size_t last) {
+        const MatrixKernels& kernels = matrixKernels();
+        kernels.composeTransforms(columnsFrom(0), first, last, world.data());
+        for (size_t s = first; s < last;) {
+            uint32_t parent = parentSlot[s];
+            size_t end = s + 1;
+            while (end < last && parentSlot[end] == parent)
+                ++end;
+            if (parent != NONE)
+                kernels.multiply(world[parent], &world[s], &world[s], end - s);
+            s = end;
+        }
+    }
+
+    void composeWorld(uint32_t slot) { composeRange(slot, slot + 1); }
+
+    template <typename T>
+    static void permute(std::vector<T>& column, const std::vector<uint32_t>& order) {
+        std::vector<T> sorted(order.size());
+        for (size_t k = 0; k < order.size(); ++k)
+            sorted[k] = column[order[k]];
+        column.swap(sorted);
+    }
+
+    // 按广度优先重新排槽位，去掉已删除的空槽位，重建子节点区间和层边界
+    void relayout() {
+        size_t n = idBySlot.size();
+        // 按旧槽位建 CSR 形式的子节点表，子节点保持原来的相对顺序
+        std::vector<uint32_t> childStart(n + 1, 0);
+        for (size_t s = 0; s < n; ++s)
+            if (idBySlot[s] != NONE && parentSlot[s] != NONE)
+                ++childStart[parentSlot[s] + 1];
+        for (size_t s = 0; s < n; ++s)
+            childStart[s + 1] += childStart[s];
+        std::vector<uint32_t> children(childStart[n]);
+        std::vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+        for (size_t s = 0; s < n; ++s)
+            if (idBySlot[s] != NONE && parentSlot[s] != NONE)
+                children[fill[parentSlot[s]]++] = (uint32_t)s;
+
+        // 根节点是第 0 层，之后每处理完一层，下一层正好是队列里接着的那一段
+        std::vector<uint32_t> order;
+        order.reserve(alive);
+        std::vector<uint32_t> newFirst, newCount;
+        newFirst.reserve(alive);
+        newCount.reserve(alive);
+        levelStart.assign(1, 0);
+        for (size_t s = 0; s < n; ++s)
+            if (idBySlot[s] != NONE && parentSlot[s] == NONE)
+                order.push_back((uint32_t)s);
+        size_t levelEnd = order.size();
+        for (size_t head = 0; head < order.size(); ++head) {
+            if (head == levelEnd) {
+                levelStart.push_back(head);
+                levelEnd = order.size();
+            }
+            uint32_t s = order[head];
+            newFirst.push_back((uint32_t)order.size());
+            newCount.push_back(childStart[s + 1] - childStart[s]);
+            for (uint32_t k = childStart[s]; k < childStart[s + 1]; ++k)
+                order.push_back(children[k]);
+        }
+        levelStart.push_back(order.size());
+
+        std::vector<uint32_t> newSlot(n, NONE);
+        for (size_t k = 0; k < order.size(); ++k)
+            newSlot[order[k]] = (uint32_t)k;
+        std::vector<uint32_t> newParent(order.size());
+        for (size_t k = 0; k < order.size(); ++k) {
+            uint32_t parent = parentSlot[order[k]];
+            newParent[k] = parent == NONE ? NONE : newSlot[parent];
+        }
+        parentSlot.swap(newParent);
+        firstChild.swap(newFirst);
+        childCount.swap(newCount);
+        permute(idBySlot, order);
+        for (std::vector<float>* column : { &px, &py, &pz, &rx, &ry, &rz, &rw, &sx, &sy, &sz })
+            permute(*column, order);
+        permute(world, order);
+        for (size_t k = 0; k < order.size(); ++k)
+            slotById[idBySlot[k]] = (uint32_t)k;
+        localDirty.assign(order.size(), 0);
+        stamp.assign(order.size(), 0);
+        dirtyRoots.clear();
+        layoutDirty = false;
+    }
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef UNIFORM_BLOCKS_H
+#define UNIFORM_BLOCKS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// 所有程序共享的 uniform block 绑定点，Shader 链接后按名字自动绑定
+const GLuint CAMERA_BLOCK_BINDING = 0;
+const char* const CAMERA_BLOCK_NAME = "CameraBlock";
+const GLuint OBJECT_BLOCK_BINDING = 1;
+const char* const OBJECT_BLOCK_NAME = "ObjectBlock";
+
+// 与 shader/camera.glsl 中的 std140 布局一一对应（全部是 16 字节对齐的成员）
+struct CameraBlockData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProj;
+    glm::vec4 cameraPos; // xyz = 相机位置
+    glm::vec4 time;      // x = 当前时间 y = 帧间隔
+};
+static_assert(sizeof(CameraBlockData) == 224, "CameraBlockData must match std140 layout");
+
+// 与 shader/object.glsl 对应：每次 draw 一份，从流式环形缓冲里分配后用 glBindBufferRange 绑定
+struct ObjectBlockData {
+    glm::mat4 model;
+    glm::vec4 color;
+};
+static_assert(sizeof(ObjectBlockData) == 80, "ObjectBlockData must match std140 layout");
+
+#endif
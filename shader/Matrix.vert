@@ -4,12 +4,12 @@ layout (location = 1) in vec2 aTexCoord;
 
 out vec2 TexCoord;
 
+#include "camera.glsl"
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main(){
     //乘法从右向左读
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = viewProj * model * vec4(aPos, 1.0);
     TexCoord = vec2(aTexCoord.x, aTexCoord.y);
 }
\ No newline at end of file
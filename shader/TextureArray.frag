@@ -0,0 +1,13 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+// 两张贴图放在同一个纹理数组里，换材质只改层号
+uniform sampler2DArray textures;
+uniform int layer_1;
+uniform int layer_2;
+
+void main(){
+    FragColor = mix(texture(textures, vec3(TexCoord, layer_2)), texture(textures, vec3(TexCoord, layer_1)), 0.2);
+}
@@ -0,0 +1,19 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+// 两张贴图打包在同一张图集里，rect.xy 为子图偏移，rect.zw 为缩放（TextureAtlas::uvRect）
+uniform sampler2D atlas;
+uniform vec4 rect_1;
+uniform vec4 rect_2;
+
+// fract 模拟 GL_REPEAT；导数取自展开前的坐标，否则 fract 跳变处会选到最低一级 mip 出现接缝
+vec4 sampleAtlas(vec4 rect){
+    vec2 uv = fract(TexCoord) * rect.zw + rect.xy;
+    return textureGrad(atlas, uv, dFdx(TexCoord) * rect.zw, dFdy(TexCoord) * rect.zw);
+}
+
+void main(){
+    FragColor = mix(sampleAtlas(rect_2), sampleAtlas(rect_1), 0.2);
+}
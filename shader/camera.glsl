@@ -0,0 +1,8 @@
+// 相机 uniform block，由 FpsCamera 每帧填充一次，所有程序共享
+layout(std140) uniform CameraBlock {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec4 cameraPos; // xyz = 相机位置
+    vec4 time;      // x = 当前时间 y = 帧间隔
+};
@@ -1,10 +1,14 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
+// 每实例属性：模型矩阵占 1~4，颜色在 5
+layout(location = 1) in mat4 aModel;
+layout(location = 5) in vec4 aColor;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "camera.glsl"
+
+out vec3 objectColor;
 
 void main(){
-    gl_Position = projection * view * model * vec4(aPos, 1.0f);
-}
\ No newline at end of file
+    gl_Position = viewProj * aModel * vec4(aPos, 1.0f);
+    objectColor = aColor.rgb;
+}
@@ -0,0 +1,14 @@
+#version 430 core
+layout(location = 0) in vec3 aPos;
+// 每实例属性，内容是 0..N-1：间接命令的 baseInstance 让它正好等于物体下标
+layout(location = 1) in uint aObjectIndex;
+
+#include "camera.glsl"
+#include "gpuObjects.glsl"
+
+out vec3 objectColor;
+
+void main(){
+    gl_Position = viewProj * objects[aObjectIndex].model * vec4(aPos, 1.0f);
+    objectColor = objects[aObjectIndex].color.rgb;
+}
@@ -0,0 +1,12 @@
+// GPU 驱动渲染的物体表，与 my_gpuDriven.h 里的 GpuObject 一一对应（std430）
+struct GpuObject {
+    mat4 model;
+    vec4 color;
+    vec4 center;  // xyz = 世界空间 AABB 中心
+    vec4 extent;  // xyz = 世界空间 AABB 半长
+    uvec4 info;   // x = 网格下标
+};
+
+layout(std430, binding = 0) readonly buffer ObjectBuffer {
+    GpuObject objects[];
+};
@@ -1,10 +1,10 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
 
+#include "camera.glsl"
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main(){
-    gl_Position = projection * view * model * vec4(aPos, 1.0f);
+    gl_Position = viewProj * model * vec4(aPos, 1.0f);
 }
\ No newline at end of file
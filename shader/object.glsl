@@ -0,0 +1,5 @@
+// 每次 draw 的 uniform block，从流式环形缓冲里分配，用 glBindBufferRange 绑定
+layout(std140) uniform ObjectBlock {
+    mat4 model;
+    vec4 color;
+};
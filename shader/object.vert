@@ -0,0 +1,12 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+
+#include "camera.glsl"
+#include "object.glsl"
+
+out vec4 objectColor;
+
+void main(){
+    gl_Position = viewProj * model * vec4(aPos, 1.0f);
+    objectColor = color;
+}
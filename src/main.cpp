@@ -2,20 +2,46 @@
 #include <GLAD/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 // 引入自定义类
+#include "my_glExtensions.h"
 #include "my_shader.h"
+#include "my_shaderBatch.h"
 #include "my_TextureLoader.h"
+#include "my_textureStreamer.h"
+#include "my_textureCache.h"
+#include "my_textureArray.h"
 #include "my_fpsCamera.h"
+#include "my_glState.h"
+#include "my_instancing.h"
+#include "my_geometry.h"
+#include "my_occlusion.h"
+#include "my_renderQueue.h"
+#include "my_streamBuffer.h"
+#include "my_gpuDriven.h"
+#include "my_meshOptimizer.h"
+#include "my_meshImport.h"
+#include "my_staticMesh.h"
+#include "my_jobSystem.h"
+#include "my_ecs.h"
+#include "my_transformGraph.h"
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void processInput(GLFWwindow* window);
+void updateWindowTitle(GLFWwindow* window, float currentFrame);
+void runInstancingBenchmark(GLFWwindow* window, Shader& perDrawShader, Uniform perDrawModel, GLuint perDrawVAO,
+                            GLsizei perDrawIndexCount, Shader& blockShader,
+                            Shader& instancedShader, InstancedMesh& instancedMesh, size_t count, JobSystem& jobs);
 
 // 窗口大小
 const unsigned int SCR_WIDTH = 800;
@@ -31,21 +57,37 @@ bool firstMouse = true;
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
-// 灯光
-glm::vec3 lightPos(1.2f, 1.0f, 2.0f);
-
-int main()
+// 箱子的材质：两张贴图混合（texture_1 占 20%），几种材质之间共用图片文件
+struct CrateMaterial {
+    const char* texture1;
+    const char* texture2;
+};
+const CrateMaterial CRATE_MATERIALS[] = {
+    { "Resource\\Image\\container.jpg",   "Resource\\Image\\awesomeface.png" },
+    { "Resource\\Image\\awesomeface.png", "Resource\\Image\\container.jpg" },
+    { "Resource\\Image\\container.jpg",   "Resource\\Image\\container.jpg" },
+    { "Resource\\Image\\awesomeface.png", "Resource\\Image\\awesomeface.png" },
+};
+const int CRATE_MATERIAL_COUNT = sizeof(CRATE_MATERIALS) / sizeof(CRATE_MATERIALS[0]);
+
+int main(int argc, char** argv)
 {
 
 	// GLFW 初始化和配置
     glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
 
-	// 构建GLFW窗口
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
+	// 构建GLFW窗口：先要高版本上下文（GPU 驱动渲染需要 4.3），创建失败再逐级退回 3.3
+    const int contextVersions[][2] = { { 4, 6 }, { 4, 5 }, { 4, 3 }, { 3, 3 } };
+    GLFWwindow* window = NULL;
+    for (const auto& version : contextVersions) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+        window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "LearnOpenGL", NULL, NULL);
+        if (window != NULL)
+            break;
+    }
     if (window == NULL)
     {
         std::cout << "Failed to create GLFW window" << std::endl;
@@ -65,75 +107,54 @@ int main()
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    // glad 只包含 3.3 core，高版本/扩展函数在这里按需加载
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+
+    // 批量矩阵内核按 CPU 选的指令集
+    std::cout << "matrix kernels: " << mathPathName(matrixKernels().path()) << std::endl;
+
     // 线框模式
     // glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
     //开启ZBuff
-    glEnable(GL_DEPTH_TEST);
+    glState().enable(GL_DEPTH_TEST);
 
     // 这里实现我们的shader项目
 
-    Shader cubeShader("shader\\cube.vert","shader\\cube.frag");
-    Shader lightShader("shader\\light.vert","shader\\light.frag");
-
-    // 顶点数组
-    //加入纹理的顶点
-    float vertices[] = {
-        -0.5f, -0.5f, -0.5f, 
-         0.5f, -0.5f, -0.5f,  
-         0.5f,  0.5f, -0.5f,  
-         0.5f,  0.5f, -0.5f,  
-        -0.5f,  0.5f, -0.5f, 
-        -0.5f, -0.5f, -0.5f, 
-
-        -0.5f, -0.5f,  0.5f, 
-         0.5f, -0.5f,  0.5f,  
-         0.5f,  0.5f,  0.5f,  
-         0.5f,  0.5f,  0.5f,  
-        -0.5f,  0.5f,  0.5f, 
-        -0.5f, -0.5f,  0.5f, 
-
-        -0.5f,  0.5f,  0.5f, 
-        -0.5f,  0.5f, -0.5f, 
-        -0.5f, -0.5f, -0.5f, 
-        -0.5f, -0.5f, -0.5f, 
-        -0.5f, -0.5f,  0.5f, 
-        -0.5f,  0.5f,  0.5f, 
-
-         0.5f,  0.5f,  0.5f,  
-         0.5f,  0.5f, -0.5f,  
-         0.5f, -0.5f, -0.5f,  
-         0.5f, -0.5f, -0.5f,  
-         0.5f, -0.5f,  0.5f,  
-         0.5f,  0.5f,  0.5f,  
-
-        -0.5f, -0.5f, -0.5f, 
-         0.5f, -0.5f, -0.5f,  
-         0.5f, -0.5f,  0.5f,  
-         0.5f, -0.5f,  0.5f,  
-        -0.5f, -0.5f,  0.5f, 
-        -0.5f, -0.5f, -0.5f, 
-
-        -0.5f,  0.5f, -0.5f, 
-         0.5f,  0.5f, -0.5f,  
-         0.5f,  0.5f,  0.5f,  
-         0.5f,  0.5f,  0.5f,  
-        -0.5f,  0.5f,  0.5f, 
-        -0.5f,  0.5f, -0.5f,
-    };
-
+    // 所有着色器一次性提交，编译和下面的顶点数据准备并行进行
+    ShaderBatch shaderBatch;
+    ShaderHandle cubeShaderHandle  = shaderBatch.add("shader\\cube.vert","shader\\cube.frag");
+    ShaderHandle lightShaderHandle = shaderBatch.add("shader\\light.vert","shader\\light.frag");
+    ShaderHandle objectShaderHandle = shaderBatch.add("shader\\object.vert","shader\\object.frag");
+    ShaderHandle crateShaderHandle = shaderBatch.add("shader\\Matrix.vert","shader\\Matrix.frag");
+    ShaderHandle arrayShaderHandle = shaderBatch.add("shader\\Matrix.vert","shader\\TextureArray.frag");
+    ShaderHandle atlasShaderHandle = shaderBatch.add("shader\\Matrix.vert","shader\\TextureAtlas.frag");
+    shaderBatch.submit();
 
     // 初始化代码（只运行一次 (除非你的物体频繁改变)）
-    // 定义立方体的VAO、VBO对象
-    unsigned int VBO,cubeVAO;
+    // 立方体的 36 个顶点去重成索引网格（每个角只变换一次），再按顶点缓存和读取顺序重排
+    IndexedMesh cubeGeometry = buildIndexedMesh(CUBE_VERTICES, CUBE_VERTEX_COUNT, 3);
+    VertexCacheStats cubeBefore = analyzeVertexCache(cubeGeometry);
+    optimizeMesh(cubeGeometry);
+    VertexCacheStats cubeAfter = analyzeVertexCache(cubeGeometry);
+    const GLsizei cubeIndexCount = (GLsizei)cubeGeometry.indices.size();
+    std::cout << "cube mesh: " << CUBE_VERTEX_COUNT << " -> " << cubeGeometry.vertexCount() << " vertices, ACMR "
+              << cubeBefore.acmr << " -> " << cubeAfter.acmr << ", ATVR " << cubeBefore.atvr << " -> "
+              << cubeAfter.atvr << std::endl;
+
+    // 定义立方体的VAO、VBO、EBO对象
+    unsigned int VBO,EBO,cubeVAO;
     glGenVertexArrays(1, &cubeVAO);
     glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
 
-    // 绑定VAO、VBO
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glBindVertexArray(cubeVAO);
+    // 绑定VAO、VBO、EBO（索引缓冲的绑定记在 VAO 里）
+    glState().bindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, cubeGeometry.vertices.size() * sizeof(float), cubeGeometry.vertices.data(), GL_STATIC_DRAW);
+    glState().bindVertexArray(cubeVAO);
+    glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, cubeGeometry.indices.size() * sizeof(uint32_t), cubeGeometry.indices.data(), GL_STATIC_DRAW);
 
     // 设置顶点属性指针
     // 启用顶点属性 记得关闭哦！！！
@@ -144,13 +165,259 @@ int main()
     unsigned int lightVAO;
     glGenVertexArrays(1, &lightVAO);
 
-    // 这里共用了VBO 顶点缓冲对象 所以不需要再去填充VBO数据 
-    glBindVertexArray(lightVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    // 这里共用了VBO、EBO 所以不需要再去填充数据 
+    glState().bindVertexArray(lightVAO);
+    glState().bindBuffer(GL_ARRAY_BUFFER, VBO);
+    glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
 
     glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,3*sizeof(float),(void*)0);
     glEnableVertexAttribArray(0);
 
+    // 带贴图的箱子：位置 + uv，同样去重成索引网格
+    IndexedMesh crateGeometry = buildIndexedMesh(TEXTURED_CUBE_VERTICES, TEXTURED_CUBE_VERTEX_COUNT, 5);
+    optimizeMesh(crateGeometry);
+    const GLsizei crateIndexCount = (GLsizei)crateGeometry.indices.size();
+    unsigned int crateVBO, crateEBO, crateVAO;
+    glGenVertexArrays(1, &crateVAO);
+    glGenBuffers(1, &crateVBO);
+    glGenBuffers(1, &crateEBO);
+    glState().bindBuffer(GL_ARRAY_BUFFER, crateVBO);
+    glBufferData(GL_ARRAY_BUFFER, crateGeometry.vertices.size() * sizeof(float), crateGeometry.vertices.data(), GL_STATIC_DRAW);
+    glState().bindVertexArray(crateVAO);
+    glState().bindBuffer(GL_ELEMENT_ARRAY_BUFFER, crateEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, crateGeometry.indices.size() * sizeof(uint32_t), crateGeometry.indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0,3,GL_FLOAT,GL_FALSE,5*sizeof(float),(void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1,2,GL_FLOAT,GL_FALSE,5*sizeof(float),(void*)(3*sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    // 箱子的两张贴图在后台线程解码，之后每帧按预算经 PBO 上传；加载完成前画的是占位的棋盘格
+    TextureStreamer textureStreamer;
+    std::shared_ptr<StreamedTexture> crateTextures[2] = {
+        textureStreamer.load("Resource\\Image\\container.jpg"),
+        textureStreamer.load("Resource\\Image\\awesomeface.png"),
+    };
+    bool crateTexturesReported = false;
+
+    // 第一次使用时才检查编译结果
+    Shader& cubeShader  = cubeShaderHandle.get();
+    Shader& lightShader = lightShaderHandle.get();
+    Shader& objectShader = objectShaderHandle.get();
+    Shader& crateShader = crateShaderHandle.get();
+    Shader& arrayShader = arrayShaderHandle.get();
+    Shader& atlasShader = atlasShaderHandle.get();
+    shaderCache().printStats();
+
+    // 渲染循环外一次性解析 uniform 句柄，循环里不再按字符串查找
+    const Uniform cubeLightColor  = cubeShader.uniform("lightColor"_uniform);
+    const Uniform lightModel      = lightShader.uniform("model"_uniform);
+    const Uniform crateModel      = crateShader.uniform("model"_uniform);
+    // 采样器固定用 0、1 号纹理单元，只需设置一次
+    crateShader.use();
+    crateShader.setInt(crateShader.uniform("texture_1"_uniform), 0);
+    crateShader.setInt(crateShader.uniform("texture_2"_uniform), 1);
+    const glm::mat4 crateTransform = glm::translate(glm::mat4(1.0f), glm::vec3(2.0f, 0.0f, 0.0f));
+    // 纹理数组 / 图集的采样器都在 0 号单元（默认值），每次 draw 只改层号或 UV 矩形
+    const Uniform arrayModel  = arrayShader.uniform("model"_uniform);
+    const Uniform arrayLayer1 = arrayShader.uniform("layer_1"_uniform);
+    const Uniform arrayLayer2 = arrayShader.uniform("layer_2"_uniform);
+    const Uniform atlasModel  = atlasShader.uniform("model"_uniform);
+    const Uniform atlasRect1  = atlasShader.uniform("rect_1"_uniform);
+    const Uniform atlasRect2  = atlasShader.uniform("rect_2"_uniform);
+
+    camera.SetAspectRatio((float)SCR_WIDTH, (float)SCR_HEIGHT);
+
+    // 立方体走实例化路径：模型矩阵和颜色放在每实例缓冲里
+    InstancedMesh cubeMesh(cubeVAO, cubeIndexCount, 16384, GL_TRIANGLES, GL_UNSIGNED_INT);
+    // 实例的模型矩阵来自变换层级，颜色按 NodeId 存；层级没有变化的帧不重新上传实例缓冲
+    TransformGraph cubeGraph;
+    std::vector<glm::vec4> cubeColors;
+    cubeGraph.add(TransformGraph::NONE, glm::vec3(0.0f));
+    cubeColors.push_back(glm::vec4(1.0f, 0.5f, 0.31f, 1.0f));
+    ResidentInstanceBuffer cubeInstances;
+
+    // 每帧的绘制都经过渲染队列：按程序 / 材质 / 深度排序，减少状态切换
+    RenderQueue renderQueue;
+    // 每帧的动态数据（实例数据、每次 draw 的 uniform block）从三缓冲的环形缓冲里分配
+    StreamBuffer streamBuffer;
+    std::cout << "stream buffer: " << (streamBuffer.persistent() ? "persistent mapped" : "orphaning fallback")
+              << ", " << streamBuffer.capacity() / 1024 << " KiB per frame" << std::endl;
+    // 共用的工作窃取任务系统：模型导入、并行录制、CPU 遮挡光栅化都跑在上面，主线程等待时也帮着执行
+    JobSystem jobs;
+
+    // 场景里用 uniform block 画的物体都是实体：变换、包围盒、绘制句柄按 SoA 存在 Registry 里
+    Registry scene;
+    Entity light = scene.create();
+    scene.addTransform(light, glm::vec3(1.2f, 1.0f, 2.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(0.2f));
+    scene.setBounds(light, glm::vec3(-0.5f), glm::vec3(0.5f));
+    scene.addRenderable(light, RenderHandle{ objectShader.ID, lightVAO, cubeIndexCount, 0 }, glm::vec4(1.0f));
+
+    // 命令行 --bench-instancing [数量]：对比每物体 uniform 和实例化两种画法后退出
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--bench-instancing") {
+            size_t count = (i + 1 < argc) ? std::stoul(argv[i + 1]) : 100000;
+            runInstancingBenchmark(window, lightShader, lightModel, lightVAO, cubeIndexCount, objectShader,
+                                   cubeShader, cubeMesh, count, jobs);
+            textureStreamer.release();
+            cubeMesh.release();
+            streamBuffer.release();
+            glfwTerminate();
+            return 0;
+        }
+    }
+
+    // 命令行 --mesh <文件>：导入 OBJ / glTF 画在立方体左边
+    // 第一次解析后在旁边写 .mesh 缓存，之后直接映射缓存，一次 glBufferData 上传
+    // 每个子网格一个实体，共用同一个 VAO，按索引偏移区分
+    std::unique_ptr<StaticMesh> importedMesh;
+    MeshData importedMeshData; // GPU 驱动路径还要把它的位置和索引拼进共享缓冲
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) != "--mesh")
+            continue;
+        double loadStart = glfwGetTime();
+        MeshData meshData = meshCache().loadOrImport(argv[i + 1], &jobs);
+        double uploadStart = glfwGetTime();
+        if (meshData) {
+            importedMesh = std::make_unique<StaticMesh>(meshData);
+            // 按包围盒缩放到边长 1，中心放在 (-2, 0, 0)
+            glm::vec3 extent = meshData.boundsMax - meshData.boundsMin;
+            float size = std::max(extent.x, std::max(extent.y, extent.z));
+            float fit = size > 0.0f ? 1.0f / size : 1.0f;
+            glm::vec3 position = glm::vec3(-2.0f, 0.0f, 0.0f) - (meshData.boundsMin + meshData.boundsMax) * 0.5f * fit;
+            for (size_t m = 0; m < importedMesh->submeshes.size(); ++m) {
+                const SubMesh& submesh = importedMesh->submeshes[m];
+                // 按材质给一个固定的颜色，区分子网格
+                uint32_t material = submesh.material;
+                glm::vec4 color(0.4f + 0.6f * ((material * 37u) % 11u) / 10.0f,
+                                0.4f + 0.6f * ((material * 53u + 3u) % 7u) / 6.0f,
+                                0.4f + 0.6f * ((material * 71u + 5u) % 5u) / 4.0f, 1.0f);
+                Entity part = scene.create();
+                scene.addTransform(part, position, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(fit));
+                scene.setBounds(part, submesh.boundsMin, submesh.boundsMax);
+                scene.addRenderable(part, RenderHandle{ objectShader.ID, importedMesh->vao, (GLsizei)submesh.indexCount,
+                                                        importedMesh->indexByteOffset(m) }, color);
+            }
+            std::cout << "mesh " << argv[i + 1] << ": " << meshData.triangleCount() << " triangles, "
+                      << meshData.vertexCount << " vertices, " << meshData.submeshes.size() << " submeshes, load "
+                      << (uploadStart - loadStart) * 1000.0 << " ms (" << (meshData.mapping ? "cache" : "parsed")
+                      << "), upload " << (glfwGetTime() - uploadStart) * 1000.0 << " ms" << std::endl;
+            importedMeshData = std::move(meshData);
+        }
+        meshCache().printStats();
+        break;
+    }
+
+    // 立方体下方一排箱子，每个一种材质；贴图经过 TextureCache，按路径和加载参数去重，
+    // 四种材质引用的八张贴图实际只加载两张
+    TextureCache textureCache;
+    std::vector<TextureHandle> materialTextures;
+    std::vector<glm::mat4> materialCrates;
+    for (int m = 0; m < CRATE_MATERIAL_COUNT; ++m) {
+        materialTextures.push_back(textureCache.get(CRATE_MATERIALS[m].texture1));
+        materialTextures.push_back(textureCache.get(CRATE_MATERIALS[m].texture2));
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(-2.25f + 1.5f * m, -1.2f, -1.0f));
+        materialCrates.push_back(glm::scale(model, glm::vec3(0.6f)));
+    }
+    textureCache.printStats();
+
+    // 同样的四种材质再画两排：一排的贴图放进纹理数组，一排打包进图集
+    // 每排只有一个纹理对象，换材质只改 uniform，渲染队列按纹理分组后整排不用重新绑纹理
+    std::vector<std::string> materialFiles;
+    for (const CrateMaterial& material : CRATE_MATERIALS)
+        for (const char* file : { material.texture1, material.texture2 })
+            if (std::find(materialFiles.begin(), materialFiles.end(), file) == materialFiles.end())
+                materialFiles.push_back(file);
+    std::unique_ptr<TextureArray> materialArray = std::make_unique<TextureArray>(materialFiles);
+    std::unique_ptr<TextureAtlas> materialAtlas = std::make_unique<TextureAtlas>(materialFiles);
+    struct MaterialSlots {
+        int layer1, layer2;
+        glm::vec4 rect1, rect2;
+    };
+    std::vector<MaterialSlots> materialSlots;
+    bool materialSlotsValid = materialArray->ID != 0 && materialAtlas->ID != 0;
+    for (const CrateMaterial& material : CRATE_MATERIALS) {
+        MaterialSlots slots{ materialArray->layer(material.texture1), materialArray->layer(material.texture2),
+                             glm::vec4(0.0f), glm::vec4(0.0f) };
+        int rect1 = materialAtlas->index(material.texture1), rect2 = materialAtlas->index(material.texture2);
+        materialSlotsValid = materialSlotsValid && slots.layer1 >= 0 && slots.layer2 >= 0 && rect1 >= 0 && rect2 >= 0;
+        if (materialSlotsValid) {
+            slots.rect1 = materialAtlas->uvRect(rect1);
+            slots.rect2 = materialAtlas->uvRect(rect2);
+        }
+        materialSlots.push_back(slots);
+    }
+
+    // GL 4.3 的上下文里实体走 GPU 驱动路径：立方体和导入模型的位置 / 索引拼进一对共享缓冲，
+    // 每个实体一个 GpuObject，场景搭好后一次性上传（实体在循环里不移动）；
+    // 每帧 CPU 只把视锥 + 遮挡剔除的结果作为位图交给 cull.comp，一次多重间接绘制画完所有实体
+    // 不支持时实体仍然逐个录进渲染队列
+    std::unique_ptr<GpuDrivenRenderer> gpuScene;
+    std::unique_ptr<Shader> gpuSceneShader;
+    GLuint gpuSceneBuffers[2] = {};
+    std::vector<uint32_t> gpuSceneVisibility;
+    if (GpuDrivenRenderer::supported()) {
+        std::vector<float> positions = cubeGeometry.vertices;
+        std::vector<uint32_t> indices = cubeGeometry.indices;
+        std::vector<GpuMesh> meshes = { GpuMesh{ (GLuint)cubeIndexCount, 0, 0, 0 } };
+        // 每个网格在渲染队列路径里的 VAO + 索引偏移，用来把实体对到网格表上
+        std::vector<std::pair<GLuint, GLintptr>> meshKeys = { { lightVAO, 0 } };
+        if (importedMesh) {
+            GLint baseVertex = (GLint)cubeGeometry.vertexCount();
+            for (size_t v = 0; v < importedMeshData.vertexCount; ++v) {
+                const glm::vec3& position = importedMeshData.vertices()[v].position;
+                positions.insert(positions.end(), { position.x, position.y, position.z });
+            }
+            indices.insert(indices.end(), importedMeshData.indices(), importedMeshData.indices() + importedMeshData.indexCount);
+            for (size_t m = 0; m < importedMesh->submeshes.size(); ++m) {
+                const SubMesh& submesh = importedMesh->submeshes[m];
+                meshes.push_back(GpuMesh{ submesh.indexCount, (GLuint)cubeIndexCount + submesh.firstIndex, baseVertex, 0 });
+                meshKeys.push_back({ importedMesh->vao, importedMesh->indexByteOffset(m) });
+            }
+        }
+
+        scene.updateTransforms(&jobs);
+        const TransformPool& transforms = scene.transforms;
+        const RenderPool& renderables = scene.renderables;
+        std::vector<GpuObject> objects(renderables.size());
+        bool mapped = true;
+        for (uint32_t slot = 0; slot < (uint32_t)objects.size(); ++slot) {
+            auto key = std::find(meshKeys.begin(), meshKeys.end(),
+                                 std::make_pair(renderables.vao[slot], renderables.indexByteOffset[slot]));
+            mapped = mapped && key != meshKeys.end();
+            if (!mapped)
+                break;
+            const AABBSoA& bounds = transforms.worldBounds;
+            objects[slot].model = transforms.world[slot];
+            objects[slot].color = renderables.color[slot];
+            objects[slot].center = glm::vec4(bounds.cx[slot], bounds.cy[slot], bounds.cz[slot], 0.0f);
+            objects[slot].extent = glm::vec4(bounds.ex[slot], bounds.ey[slot], bounds.ez[slot], 0.0f);
+            objects[slot].mesh = (uint32_t)(key - meshKeys.begin());
+        }
+
+        if (mapped) {
+            glGenBuffers(2, gpuSceneBuffers);
+            glState().bindBuffer(GL_ARRAY_BUFFER, gpuSceneBuffers[0]);
+            glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float), positions.data(), GL_STATIC_DRAW);
+            glState().bindBuffer(GL_COPY_WRITE_BUFFER, gpuSceneBuffers[1]);
+            glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+            gpuScene = std::make_unique<GpuDrivenRenderer>(gpuSceneBuffers[0], gpuSceneBuffers[1], meshes);
+            gpuSceneShader = std::make_unique<Shader>("shader\\gpuDriven.vert", "shader\\cube.frag");
+            gpuSceneShader->use();
+            gpuSceneShader->setVec3(gpuSceneShader->uniform("lightColor"_uniform), glm::vec3(1.0f));
+            gpuScene->setObjects(objects);
+        } else {
+            std::cerr << "ERROR::MAIN::GPU_SCENE_MESH_NOT_FOUND: an entity uses geometry outside the shared buffers" << std::endl;
+        }
+    }
+    std::cout << "scene entities: "
+              << (gpuScene && gpuScene->valid() ? "GPU-driven (compute cull + multi-draw indirect)" : "render queue")
+              << ", context " << glExt().major << "." << glExt().minor << std::endl;
+    importedMeshData = MeshData();
+
+    std::vector<uint32_t> visibleEntities;
+    // 场景里的立方体和箱子当遮挡体，每帧在 CPU 上光栅化出 Hi-Z，视锥剔除后再去掉被挡住的实体
+    OcclusionBuffer occlusion;
+
     // 渲染循环体
     while (!glfwWindowShouldClose(window))
     {
@@ -158,6 +425,8 @@ int main()
         float currentFrame = static_cast<float>(glfwGetTime());
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
+        glState().beginFrame();
+        updateWindowTitle(window, currentFrame);
 
         // 输入
         processInput(window);
@@ -166,32 +435,132 @@ int main()
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        cubeShader.use();
-        cubeShader.setVec3("objectColor", 1.0f, 0.5f, 0.31f);
-        cubeShader.setVec3("lightColor",  1.0f, 1.0f, 1.0f);
-
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH/(float)SCR_HEIGHT, 0.1f, 100.0f);
-        glm::mat4 view = camera.GetViewMatrix();
-        cubeShader.setMat4("projection", projection);
-        cubeShader.setMat4("view", view);
-
-        glm::mat4 model = glm::mat4(1.0f);
-        cubeShader.setMat4("model", model);
-
-        glBindVertexArray(cubeVAO);
-        glDrawArrays(GL_TRIANGLES,0,36);
-
-        lightShader.use();
-        lightShader.setMat4("projection", projection);
-        lightShader.setMat4("view", view);
-
-        model = glm::mat4(1.0f);
-        model = glm::translate(model, lightPos);
-        model = glm::scale(model, glm::vec3(0.2f));
-        lightShader.setMat4("model", model);
-
-        glBindVertexArray(lightVAO);
-        glDrawArrays(GL_TRIANGLES,0,36);
+        // 相机矩阵每帧只上传一次到共享 uniform block
+        camera.UpdateUniformBuffer(currentFrame, deltaTime);
+
+        // 后台解码好的纹理在本帧预算内上传，上传完成的替换掉占位
+        textureStreamer.update();
+        if (!crateTexturesReported && textureStreamer.pending() == 0) {
+            std::cout << "texture streamer: " << textureStreamer.completed << " textures streamed, "
+                      << textureStreamer.failures << " failed" << std::endl;
+            crateTexturesReported = true;
+        }
+
+        // 先录制绘制包，排序后统一提交
+        streamBuffer.beginFrame();
+        renderQueue.begin();
+
+        cubeGraph.update();
+        cubeInstances.update(cubeGraph.slots(), cubeGraph.changed(), cubeGraph.layoutChanged(), [&](uint32_t slot) {
+            return InstanceData{ cubeGraph.worldMatrices()[slot], cubeColors[cubeGraph.idOf(slot)] };
+        });
+        GLsizei cubeCount = cubeMesh.useInstances(cubeInstances);
+        if (DrawPacket* cube = renderQueue.record(RenderPass::Opaque, cubeShader.ID, cubeMesh.vertexArray(),
+                                                  glm::length(camera.Position))) {
+            cube->setElements(cubeMesh.primitive(), cubeMesh.vertices(), cubeMesh.elementType(), 0, cubeCount);
+            renderQueue.setUniform(cube, cubeLightColor, glm::vec3(1.0f, 1.0f, 1.0f));
+        }
+        if (DrawPacket* crate = renderQueue.record(RenderPass::Opaque, crateShader.ID, crateVAO,
+                                                   glm::length(camera.Position - glm::vec3(crateTransform[3])))) {
+            crate->setTexture(0, GL_TEXTURE_2D, crateTextures[0]->id());
+            crate->setTexture(1, GL_TEXTURE_2D, crateTextures[1]->id());
+            crate->setElements(GL_TRIANGLES, crateIndexCount, GL_UNSIGNED_INT);
+            renderQueue.setUniform(crate, crateModel, crateTransform);
+        }
+        for (int m = 0; m < CRATE_MATERIAL_COUNT; ++m) {
+            const glm::mat4& model = materialCrates[m];
+            if (DrawPacket* crate = renderQueue.record(RenderPass::Opaque, crateShader.ID, crateVAO,
+                                                       glm::length(camera.Position - glm::vec3(model[3])))) {
+                crate->setTexture(0, GL_TEXTURE_2D, materialTextures[2 * m]->ID);
+                crate->setTexture(1, GL_TEXTURE_2D, materialTextures[2 * m + 1]->ID);
+                crate->setElements(GL_TRIANGLES, crateIndexCount, GL_UNSIGNED_INT);
+                renderQueue.setUniform(crate, crateModel, model);
+            }
+            if (!materialSlotsValid)
+                continue;
+            const MaterialSlots& slots = materialSlots[m];
+            glm::mat4 arrayCrate = glm::translate(model, glm::vec3(0.0f, -1.5f, 0.0f));
+            if (DrawPacket* crate = renderQueue.record(RenderPass::Opaque, arrayShader.ID, crateVAO,
+                                                       glm::length(camera.Position - glm::vec3(arrayCrate[3])))) {
+                crate->setTexture(0, GL_TEXTURE_2D_ARRAY, materialArray->ID);
+                crate->setElements(GL_TRIANGLES, crateIndexCount, GL_UNSIGNED_INT);
+                renderQueue.setUniform(crate, arrayModel, arrayCrate);
+                renderQueue.setUniform(crate, arrayLayer1, slots.layer1);
+                renderQueue.setUniform(crate, arrayLayer2, slots.layer2);
+            }
+            glm::mat4 atlasCrate = glm::translate(model, glm::vec3(0.0f, -3.0f, 0.0f));
+            if (DrawPacket* crate = renderQueue.record(RenderPass::Opaque, atlasShader.ID, crateVAO,
+                                                       glm::length(camera.Position - glm::vec3(atlasCrate[3])))) {
+                crate->setTexture(0, GL_TEXTURE_2D, materialAtlas->ID);
+                crate->setElements(GL_TRIANGLES, crateIndexCount, GL_UNSIGNED_INT);
+                renderQueue.setUniform(crate, atlasModel, atlasCrate);
+                renderQueue.setUniform(crate, atlasRect1, slots.rect1);
+                renderQueue.setUniform(crate, atlasRect2, slots.rect2);
+            }
+        }
+
+        // 实体：变换和包围盒在任务系统上更新，视锥 + 遮挡剔除后交给 GPU 驱动路径，
+        // 或者每个可见实体一个 ObjectBlock + 一个绘制包；槽位同时对应 transforms 和 renderables 的列
+        scene.updateTransforms(&jobs);
+        const TransformPool& transforms = scene.transforms;
+        const RenderPool& renderables = scene.renderables;
+
+        // 遮挡体：实例化的立方体、各排箱子（和立方体同样是边长 1 的盒子），以及用立方体网格画的实体
+        occlusion.begin(camera.GetViewProjectionMatrix());
+        for (size_t slot = 0; slot < cubeGraph.slots(); ++slot)
+            occlusion.addOccluder(CUBE_VERTICES, CUBE_VERTEX_COUNT, cubeGraph.worldMatrices()[slot]);
+        occlusion.addOccluder(CUBE_VERTICES, CUBE_VERTEX_COUNT, crateTransform);
+        for (const glm::mat4& model : materialCrates) {
+            occlusion.addOccluder(CUBE_VERTICES, CUBE_VERTEX_COUNT, model);
+            if (!materialSlotsValid)
+                continue;
+            occlusion.addOccluder(CUBE_VERTICES, CUBE_VERTEX_COUNT, glm::translate(model, glm::vec3(0.0f, -1.5f, 0.0f)));
+            occlusion.addOccluder(CUBE_VERTICES, CUBE_VERTEX_COUNT, glm::translate(model, glm::vec3(0.0f, -3.0f, 0.0f)));
+        }
+        for (uint32_t slot = 0; slot < (uint32_t)renderables.size(); ++slot)
+            if (renderables.vao[slot] == lightVAO)
+                occlusion.addOccluder(CUBE_VERTICES, CUBE_VERTEX_COUNT, transforms.world[slot]);
+        occlusion.rasterize(&jobs);
+
+        scene.cullRenderables(camera.GetFrustum(), visibleEntities);
+        occlusion.cullAABBs(transforms.worldBounds, visibleEntities);
+        if (gpuScene && gpuScene->valid()) {
+            // GPU 驱动路径：剔除结果作为位图交给 cull.comp，绘制放在渲染队列提交之后
+            GpuDrivenRenderer::buildVisibilityMask(visibleEntities, renderables.size(), gpuSceneVisibility);
+            gpuScene->setVisibility(gpuSceneVisibility);
+        } else {
+            // 可见实体分段并行录制，每段往自己的 CommandList 写；每段一次分配好本段所有的 ObjectBlock，
+            // 工作线程之间只在分配时碰一次流缓冲的原子头指针
+            const size_t objectStride = (sizeof(ObjectBlockData) + streamBuffer.uniformOffsetAlignment() - 1)
+                                        / streamBuffer.uniformOffsetAlignment() * streamBuffer.uniformOffsetAlignment();
+            renderQueue.recordParallel(jobs, visibleEntities.size(), [&](CommandList& list, size_t first, size_t last) {
+                if (first == last)
+                    return;
+                StreamAllocation objectBlocks = streamBuffer.allocateUniform(objectStride * (last - first));
+                if (!objectBlocks)
+                    return;
+                for (size_t i = first; i < last; ++i) {
+                    uint32_t slot = visibleEntities[i];
+                    glm::vec3 center(transforms.worldBounds.cx[slot], transforms.worldBounds.cy[slot], transforms.worldBounds.cz[slot]);
+                    DrawPacket* packet = list.record(RenderPass::Opaque, renderables.program[slot], renderables.vao[slot],
+                                                     glm::length(camera.Position - center));
+                    if (!packet)
+                        break;
+                    size_t offset = objectStride * (i - first);
+                    ObjectBlockData* block = reinterpret_cast<ObjectBlockData*>(static_cast<char*>(objectBlocks.data) + offset);
+                    block->model = transforms.world[slot];
+                    block->color = renderables.color[slot];
+                    packet->setUniformBlock(streamBuffer.buffer(), objectBlocks.offset + (GLintptr)offset, sizeof(ObjectBlockData));
+                    packet->setElements(GL_TRIANGLES, renderables.indexCount[slot], GL_UNSIGNED_INT,
+                                        renderables.indexByteOffset[slot]);
+                }
+            });
+        }
+
+        streamBuffer.flush();
+        renderQueue.submit();
+        if (gpuScene && gpuScene->valid())
+            gpuScene->draw(camera.GetFrustum(), *gpuSceneShader);
 
 		// 交换缓冲区和轮询IO事件(键盘鼠标等)
         glfwSwapBuffers(window);
@@ -199,9 +568,41 @@ int main()
     }
 
     // 回收缓冲对象
+    if (gpuScene) {
+        gpuScene->release();
+        glState().forgetProgram(gpuSceneShader->ID);
+        glDeleteProgram(gpuSceneShader->ID);
+        for (GLuint buffer : gpuSceneBuffers)
+            glState().forgetBuffer(buffer);
+        glDeleteBuffers(2, gpuSceneBuffers);
+    }
+    if (importedMesh)
+        importedMesh->release();
+    // 句柄持有的纹理要在上下文销毁前删掉，还在上传中的由 release() 回收
+    for (std::shared_ptr<StreamedTexture>& texture : crateTextures)
+        texture.reset();
+    textureStreamer.release();
+    materialTextures.clear();
+    textureCache.clear();
+    materialArray.reset();
+    materialAtlas.reset();
+    cubeInstances.release();
+    cubeMesh.release();
+    streamBuffer.release();
+    glState().forgetVertexArray(cubeVAO);
+    glState().forgetVertexArray(lightVAO);
+    glState().forgetVertexArray(crateVAO);
+    glState().forgetBuffer(VBO);
+    glState().forgetBuffer(EBO);
+    glState().forgetBuffer(crateVBO);
+    glState().forgetBuffer(crateEBO);
     glDeleteVertexArrays(1,&cubeVAO);
     glDeleteVertexArrays(1,&lightVAO);
+    glDeleteVertexArrays(1,&crateVAO);
     glDeleteBuffers(1,&VBO);
+    glDeleteBuffers(1,&EBO);
+    glDeleteBuffers(1,&crateVBO);
+    glDeleteBuffers(1,&crateEBO);
 
     // 清理所有的资源并正确地退出应用程序
     glfwTerminate();
@@ -223,11 +624,276 @@ void processInput(GLFWwindow* window)
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) camera.ProcessKeyboard(RIGHT,deltaTime);
 }
 
+// 每秒在标题栏显示一次帧率和上一帧 GL 状态缓存的统计
+void updateWindowTitle(GLFWwindow* window, float currentFrame)
+{
+    static float lastUpdate = 0.0f;
+    static int frames = 0;
+    ++frames;
+    if (currentFrame - lastUpdate < 1.0f)
+        return;
+
+    const GLStateCache::Stats& stats = glState().lastFrameStats();
+    std::string title = "LearnOpenGL | " + std::to_string(frames) + " FPS | GL calls issued "
+        + std::to_string(stats.issued) + ", skipped " + std::to_string(stats.skipped);
+    glfwSetWindowTitle(window, title.c_str());
+    lastUpdate = currentFrame;
+    frames = 0;
+}
+
+// 把 count 个立方体排成网格，分别用每物体 uniform 和实例化各画若干帧，比较耗时
+void runInstancingBenchmark(GLFWwindow* window, Shader& perDrawShader, Uniform perDrawModel, GLuint perDrawVAO,
+                            GLsizei perDrawIndexCount, Shader& blockShader,
+                            Shader& instancedShader, InstancedMesh& instancedMesh, size_t count, JobSystem& jobs)
+{
+    const int frames = 60;
+    int side = 1;
+    while ((size_t)side * side * side < count) ++side;
+
+    std::vector<InstanceData> instances;
+    instances.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 position(float(i % side), float((i / side) % side), float(i / ((size_t)side * side)));
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), (position - glm::vec3(side * 0.5f)) * 1.5f);
+        model = glm::scale(model, glm::vec3(0.5f));
+        instances.push_back({ model, glm::vec4(position / float(side), 1.0f) });
+    }
+
+    camera.Position = glm::vec3(0.0f, 0.0f, side * 1.5f);
+    camera.SetAspectRatio((float)SCR_WIDTH, (float)SCR_HEIGHT);
+
+    auto measure = [&](const char* name, auto&& drawScene) {
+        double start = glfwGetTime();
+        double submit = 0.0;
+        for (int f = 0; f < frames; ++f) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            camera.UpdateUniformBuffer((float)glfwGetTime(), 0.0f);
+            double submitStart = glfwGetTime();
+            drawScene();
+            submit += glfwGetTime() - submitStart;
+            glfwSwapBuffers(window);
+            glFinish();
+        }
+        double total = glfwGetTime() - start;
+        std::cout << name << ": " << count << " cubes, " << total * 1000.0 / frames << " ms/frame ("
+                  << submit * 1000.0 / frames << " ms CPU submit)" << std::endl;
+    };
+
+    measure("per-draw uniforms", [&]() {
+        perDrawShader.use();
+        glState().bindVertexArray(perDrawVAO);
+        for (const InstanceData& instance : instances) {
+            perDrawShader.setMat4(perDrawModel, instance.model);
+            glDrawElements(GL_TRIANGLES, perDrawIndexCount, GL_UNSIGNED_INT, nullptr);
+        }
+    });
+
+    // 同样是每物体一次 draw，但视锥测试、绘制包和 uniform 打包在任务系统上并行录制，
+    // 主线程录制其中一段，然后合并、排序和提交
+    RenderQueue queue(instances.size(), instances.size() * 256);
+    measure("per-draw uniforms, render queue with parallel recording", [&]() {
+        const Frustum& frustum = camera.GetFrustum();
+        glm::vec3 eye = camera.Position;
+        queue.begin();
+        queue.recordParallel(jobs, instances.size(), [&](CommandList& list, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                glm::vec3 center(instances[i].model[3]);
+                if (!frustum.intersectsAABB(center, glm::vec3(0.25f)))
+                    continue;
+                if (DrawPacket* packet = list.record(RenderPass::Opaque, perDrawShader.ID, perDrawVAO,
+                                                     glm::length(center - eye))) {
+                    packet->setElements(GL_TRIANGLES, perDrawIndexCount, GL_UNSIGNED_INT);
+                    list.setUniform(packet, perDrawModel, instances[i].model);
+                }
+            }
+        });
+        queue.submit();
+    });
+    std::cout << "  " << queue.stats().packets << " packets recorded on " << jobs.size() << " threads, "
+              << queue.stats().stateChanges() << " state changes, sort " << queue.stats().sortUs << " us" << std::endl;
+
+    // 同上，但每次 draw 的数据在工作线程里直接写进流式缓冲的 ObjectBlock，提交时只剩 glBindBufferRange
+    // 每个 ObjectBlock 按 uniform 偏移对齐（最大 256 字节）分配
+    StreamBuffer stream(instances.size() * 256);
+    measure("per-draw uniform blocks from the stream buffer", [&]() {
+        const Frustum& frustum = camera.GetFrustum();
+        glm::vec3 eye = camera.Position;
+        stream.beginFrame();
+        queue.begin();
+        queue.recordParallel(jobs, instances.size(), [&](CommandList& list, size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                glm::vec3 center(instances[i].model[3]);
+                if (!frustum.intersectsAABB(center, glm::vec3(0.25f)))
+                    continue;
+                StreamAllocation allocation = stream.allocateUniform(sizeof(ObjectBlockData));
+                if (!allocation)
+                    return;
+                ObjectBlockData* block = static_cast<ObjectBlockData*>(allocation.data);
+                block->model = instances[i].model;
+                block->color = instances[i].color;
+                if (DrawPacket* packet = list.record(RenderPass::Opaque, blockShader.ID, perDrawVAO,
+                                                     glm::length(center - eye))) {
+                    packet->setUniformBlock(stream.buffer(), allocation.offset, allocation.size);
+                    packet->setElements(GL_TRIANGLES, perDrawIndexCount, GL_UNSIGNED_INT);
+                }
+            }
+        });
+        stream.flush();
+        queue.submit();
+    });
+    std::cout << "  " << (stream.persistent() ? "persistent mapped" : "orphaning fallback") << ", "
+              << stream.stats().peakFrameBytes / 1024 << " KiB peak per frame, "
+              << stream.stats().stalls << " fence stalls (" << stream.stats().stallUs / 1000.0 << " ms), "
+              << stream.stats().overflows << " overflowing frames" << std::endl;
+    stream.release();
+
+    measure("instanced", [&]() {
+        instancedShader.use();
+        instancedMesh.draw(instances);
+    });
+
+    // 同样的立方体挂在变换层级下：每一层 z 一个父节点，立方体是它的子节点，实例缓冲常驻显存
+    // 静止时每帧不上传；每帧转动一个父节点时只重算、只上传那一层
+    TransformGraph graph;
+    std::vector<glm::vec4> graphColors;
+    std::vector<TransformGraph::NodeId> layers;
+    for (int z = 0; z < side; ++z) {
+        layers.push_back(graph.add(TransformGraph::NONE, glm::vec3(0.0f)));
+        graphColors.push_back(glm::vec4(1.0f));
+    }
+    for (size_t i = 0; i < instances.size(); ++i) {
+        graph.add(layers[i / ((size_t)side * side)], glm::vec3(instances[i].model[3]), glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                  glm::vec3(0.5f));
+        graphColors.push_back(instances[i].color);
+    }
+    ResidentInstanceBuffer residentInstances;
+    size_t uploadedBytes = 0;
+    int frame = 0;
+    auto drawGraph = [&](bool animate) {
+        if (animate) {
+            TransformGraph::NodeId layer = layers[frame % side];
+            graph.setRotation(layer, glm::angleAxis(0.01f * frame, glm::vec3(0.0f, 0.0f, 1.0f)));
+        }
+        ++frame;
+        graph.update();
+        residentInstances.update(graph.slots(), graph.changed(), graph.layoutChanged(), [&](uint32_t slot) {
+            return InstanceData{ graph.worldMatrices()[slot], graphColors[graph.idOf(slot)] };
+        });
+        uploadedBytes += residentInstances.stats().bytes;
+        instancedShader.use();
+        GLsizei n = instancedMesh.useInstances(residentInstances);
+        glDrawElementsInstanced(instancedMesh.primitive(), instancedMesh.vertices(), instancedMesh.elementType(), nullptr, n);
+    };
+    drawGraph(false); // 第一帧是整块上传，不计入
+    uploadedBytes = 0;
+    measure("instanced from a transform graph, static", [&]() { drawGraph(false); });
+    std::cout << "  " << uploadedBytes / frames / 1024 << " KiB uploaded per frame" << std::endl;
+    uploadedBytes = 0;
+    measure("instanced from a transform graph, one layer rotating", [&]() { drawGraph(true); });
+    std::cout << "  " << graph.stats().updated << " nodes updated, " << residentInstances.stats().ranges
+              << " upload ranges, " << uploadedBytes / frames / 1024 << " KiB uploaded per frame" << std::endl;
+    residentInstances.release();
+
+    // 立方体顶点在 [-0.5, 0.5]，缩放 0.5 后半长 0.25；每帧先做视锥剔除，只提交可见的实例
+    AABBSoA bounds;
+    bounds.reserve(instances.size());
+    for (const InstanceData& instance : instances)
+        bounds.push(glm::vec3(instance.model[3]), glm::vec3(0.25f));
+    std::vector<uint32_t> visible;
+    std::vector<InstanceData> visibleInstances;
+    visibleInstances.reserve(instances.size());
+    measure("instanced + frustum culled", [&]() {
+        camera.CullAABBs(bounds, visible);
+        visibleInstances.clear();
+        for (uint32_t index : visible)
+            visibleInstances.push_back(instances[index]);
+        instancedShader.use();
+        instancedMesh.draw(visibleInstances);
+    });
+    std::cout << "  " << visible.size() << " of " << instances.size() << " cubes inside the frustum" << std::endl;
+
+    // 离相机最近的一层立方体当遮挡体：先在 CPU 上光栅化出 Hi-Z，再把被挡住的实例去掉，最后才提交绘制
+    std::vector<glm::mat4> occluders;
+    for (size_t i = (size_t)(side - 1) * side * side; i < instances.size(); ++i)
+        occluders.push_back(instances[i].model);
+    OcclusionBuffer occlusion;
+    double rasterMs = 0.0;
+    measure("instanced + frustum + occlusion culled", [&]() {
+        occlusion.begin(camera.GetViewProjectionMatrix());
+        for (const glm::mat4& model : occluders)
+            occlusion.addOccluder(CUBE_VERTICES, CUBE_VERTEX_COUNT, model);
+        occlusion.rasterize(&jobs);
+        rasterMs += (occlusion.stats().rasterUs + occlusion.stats().hizUs) / 1000.0;
+
+        camera.CullAABBs(bounds, visible);
+        occlusion.cullAABBs(bounds, visible);
+        visibleInstances.clear();
+        for (uint32_t index : visible)
+            visibleInstances.push_back(instances[index]);
+        instancedShader.use();
+        instancedMesh.draw(visibleInstances);
+    });
+    std::cout << "  " << visible.size() << " cubes left after occlusion, CPU raster + Hi-Z "
+              << rasterMs / frames << " ms/frame" << std::endl;
+
+    // 剔除和命令生成都搬到 GPU：物体一次性上传到 SSBO，每帧 CPU 只发一次 dispatch 和一次多重间接绘制
+    if (!GpuDrivenRenderer::supported()) {
+        std::cout << "GPU-driven (compute cull + multi-draw indirect): skipped, needs GL 4.3 (context is "
+                  << glExt().major << "." << glExt().minor << ")" << std::endl;
+        return;
+    }
+    GLuint gpuBuffers[2];
+    glGenBuffers(2, gpuBuffers);
+    glState().bindBuffer(GL_ARRAY_BUFFER, gpuBuffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(CUBE_POSITIONS), CUBE_POSITIONS, GL_STATIC_DRAW);
+    glState().bindBuffer(GL_COPY_WRITE_BUFFER, gpuBuffers[1]);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(CUBE_INDICES), CUBE_INDICES, GL_STATIC_DRAW);
+    std::vector<GpuMesh> meshes = { GpuMesh{ (GLuint)CUBE_INDEX_COUNT, 0, 0, 0 } };
+    GpuDrivenRenderer gpuDriven(gpuBuffers[0], gpuBuffers[1], meshes);
+    Shader gpuDrivenShader("shader\\gpuDriven.vert", "shader\\cube.frag");
+    gpuDrivenShader.use();
+    gpuDrivenShader.setVec3(gpuDrivenShader.uniform("lightColor"_uniform), glm::vec3(1.0f));
+
+    std::vector<GpuObject> objects(instances.size());
+    for (size_t i = 0; i < instances.size(); ++i) {
+        objects[i].model = instances[i].model;
+        objects[i].color = instances[i].color;
+        objects[i].center = instances[i].model[3];
+        objects[i].extent = glm::vec4(0.25f, 0.25f, 0.25f, 0.0f);
+    }
+    gpuDriven.setObjects(objects);
+    double gpuDrivenUs = 0.0;
+    measure("GPU-driven (compute cull + multi-draw indirect)", [&]() {
+        gpuDriven.draw(camera.GetFrustum(), gpuDrivenShader);
+        gpuDrivenUs += gpuDriven.stats().cullUs;
+    });
+    std::cout << "  " << gpuDriven.readVisibleCount() << " cubes drawn, "
+              << (gpuDriven.stats().compacted ? "compacted with indirect count" : "fixed command count, culled ones have 0 instances")
+              << ", CPU " << gpuDrivenUs / frames << " us/frame" << std::endl;
+    // 和 CPU 参考实现核对最后一帧的命令；正好压在视锥平面上的物体 GPU 和 CPU 的浮点结果可能不同
+    std::vector<DrawElementsIndirectCommand> gpuCommands, cpuCommands(objects.size());
+    gpuDriven.readCommands(gpuCommands);
+    GLuint cpuVisible = GpuDrivenRenderer::buildCommands(camera.GetFrustum(), objects.data(), objects.size(), meshes.data(),
+                                                         gpuDriven.stats().compacted, cpuCommands.data());
+    bool sameAsCpu = cpuVisible == gpuDriven.readVisibleCount() &&
+                     GpuDrivenRenderer::sameCommands(gpuCommands, cpuCommands, objects.size(), cpuVisible, gpuDriven.stats().compacted);
+    std::cout << "  commands " << (sameAsCpu ? "match" : "DIFFER FROM") << " the CPU reference (" << cpuVisible
+              << " visible)" << std::endl;
+
+    gpuDriven.release();
+    glState().forgetProgram(gpuDrivenShader.ID);
+    glDeleteProgram(gpuDrivenShader.ID);
+    for (GLuint buffer : gpuBuffers)
+        glState().forgetBuffer(buffer);
+    glDeleteBuffers(2, gpuBuffers);
+}
+
 // 创建回调函数
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
 	// OpenGL渲染窗口的尺寸大小，即视口(Viewport)
     glViewport(0, 0, width, height);
+    camera.SetAspectRatio((float)width, (float)height);
 }
 
 void mouse_callback(GLFWwindow* window, double xposIn, double yposIn){
@@ -0,0 +1,171 @@
+// 图集打包检查：随机生成多组图片尺寸交给 packAtlas，逐个校验布局并打印打包效率报告（纯 CPU）
+// 用法：atlas_pack_check [每种分布的随机布局数=20]
+// 校验：
+//   每张图在图集里的尺寸和输入一致，含边距的格子不越界、两两不重叠
+//   格子起点和图集宽高都按 padding 对齐
+//   blitWithExtrude 只写自己的格子：图片像素原样拷贝，边距是边缘像素的复制
+//   放不下时返回空布局
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "my_texturePacker.h"
+#include "check_common.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+Checker checker("ATLAS_PACK_CHECK");
+
+// 几种常见的输入：差不多大的贴图、图标 + 大图混合、又高又窄 / 又宽又扁、大量小图标
+struct Distribution {
+    const char* name;
+    int count;
+    void (*make)(CheckRandom&, int&, int&);
+};
+
+const Distribution DISTRIBUTIONS[] = {
+    { "similar", 16, [](CheckRandom& r, int& w, int& h) { w = r(200, 260); h = r(200, 260); } },
+    { "mixed", 40, [](CheckRandom& r, int& w, int& h) {
+          bool big = r(0, 4) == 0;
+          w = big ? r(256, 512) : r(16, 96);
+          h = big ? r(256, 512) : r(16, 96);
+      } },
+    { "strips", 30, [](CheckRandom& r, int& w, int& h) {
+          bool tall = r(0, 1) == 0;
+          w = tall ? r(8, 32) : r(128, 400);
+          h = tall ? r(128, 400) : r(8, 32);
+      } },
+    { "icons", 400, [](CheckRandom& r, int& w, int& h) { w = r(8, 40); h = r(8, 40); } },
+};
+
+// 逐个校验一个布局；owner 记录每个像素属于哪个格子，用来查重叠
+void checkLayout(const AtlasLayout& layout, const std::vector<PackRect>& sizes, int padding, const std::string& tag) {
+    if (!layout) {
+        checker.expect(false, "EMPTY_LAYOUT " + tag);
+        return;
+    }
+    checker.expect(layout.rects.size() == sizes.size(), "RECT_COUNT " + tag);
+    checker.expect(layout.width % padding == 0 && layout.height % padding == 0, "ATLAS_SIZE_NOT_ALIGNED " + tag);
+    checker.expect(layout.efficiency() > 0.0 && layout.efficiency() <= 1.0, "EFFICIENCY_OUT_OF_RANGE " + tag);
+
+    std::vector<int> owner((size_t)layout.width * layout.height, -1);
+    for (size_t i = 0; i < layout.rects.size() && i < sizes.size(); ++i) {
+        const PackRect& r = layout.rects[i];
+        std::string at = tag + " rect " + std::to_string(i);
+        checker.expect(r.width == sizes[i].width && r.height == sizes[i].height, "RECT_SIZE " + at);
+        int x0 = r.x - padding, y0 = r.y - padding, x1 = r.x + r.width + padding, y1 = r.y + r.height + padding;
+        if (x0 < 0 || y0 < 0 || x1 > layout.width || y1 > layout.height) {
+            checker.expect(false, "OUT_OF_BOUNDS " + at);
+            continue;
+        }
+        checker.expect(x0 % padding == 0 && y0 % padding == 0, "SLOT_NOT_ALIGNED " + at);
+        bool overlap = false;
+        for (int y = y0; y < y1 && !overlap; ++y)
+            for (int x = x0; x < x1; ++x) {
+                int& cell = owner[(size_t)y * layout.width + x];
+                if (cell >= 0) {
+                    checker.expect(false, "OVERLAP " + at + " with rect " + std::to_string(cell));
+                    overlap = true;
+                    break;
+                }
+                cell = (int)i;
+            }
+    }
+}
+
+// 每张图填上自己的编号（按像素位置变化），拷进图集后逐像素核对，边距应等于最近的边缘像素
+void checkBlit(const AtlasLayout& layout, int padding, const std::string& tag) {
+    const int channels = 4;
+    const uint8_t CLEAR = 0xEE;
+    std::vector<uint8_t> atlas((size_t)layout.width * layout.height * channels, CLEAR);
+    auto pixel = [](size_t image, int x, int y, int c) { return (uint8_t)(image * 31 + x * 7 + y * 13 + c); };
+    for (size_t i = 0; i < layout.rects.size(); ++i) {
+        const PackRect& r = layout.rects[i];
+        std::vector<uint8_t> image((size_t)r.width * r.height * channels);
+        for (int y = 0; y < r.height; ++y)
+            for (int x = 0; x < r.width; ++x)
+                for (int c = 0; c < channels; ++c)
+                    image[((size_t)y * r.width + x) * channels + c] = pixel(i, x, y, c);
+        blitWithExtrude(atlas.data(), layout.width, channels, r, image.data(), padding);
+    }
+
+    std::vector<bool> covered((size_t)layout.width * layout.height, false);
+    for (size_t i = 0; i < layout.rects.size(); ++i) {
+        const PackRect& r = layout.rects[i];
+        bool same = true;
+        for (int y = -padding; y < r.height + padding && same; ++y)
+            for (int x = -padding; x < r.width + padding && same; ++x) {
+                size_t at = (size_t)(r.y + y) * layout.width + r.x + x;
+                covered[at] = true;
+                int sx = std::min(std::max(x, 0), r.width - 1), sy = std::min(std::max(y, 0), r.height - 1);
+                for (int c = 0; c < channels; ++c)
+                    same = same && atlas[at * channels + c] == pixel(i, sx, sy, c);
+            }
+        checker.expect(same, "BLIT_MISMATCH " + tag + " rect " + std::to_string(i));
+    }
+    // 格子以外的像素没有被写过
+    bool untouched = true;
+    for (size_t at = 0; at < covered.size() && untouched; ++at)
+        if (!covered[at])
+            for (int c = 0; c < channels; ++c)
+                untouched = untouched && atlas[at * channels + c] == CLEAR;
+    checker.expect(untouched, "BLIT_OUTSIDE_SLOT " + tag);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int layoutsPerDistribution = argc > 1 ? std::stoi(argv[1]) : 20;
+    const int PADDINGS[] = { 1, 2, 4, 8, 16 };
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const Distribution& distribution : DISTRIBUTIONS) {
+        double efficiencySum = 0.0, worst = 1.0, packMs = 0.0;
+        int layouts = 0;
+        for (int n = 0; n < layoutsPerDistribution; ++n) {
+            CheckRandom random{ 1000u + (uint32_t)n * 7919u };
+            std::vector<PackRect> sizes(random(1, distribution.count));
+            for (PackRect& size : sizes)
+                distribution.make(random, size.width, size.height);
+            int padding = PADDINGS[n % 5];
+            std::string tag = std::string(distribution.name) + " #" + std::to_string(n) + " padding " + std::to_string(padding);
+
+            auto start = Clock::now();
+            AtlasLayout layout = packAtlas(sizes, padding);
+            packMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            checkLayout(layout, sizes, padding, tag);
+            if (!layout)
+                continue;
+            // 像素级的核对只对前几个布局做，大量图标时逐像素检查很慢
+            if (n < 5)
+                checkBlit(layout, padding, tag);
+            efficiencySum += layout.efficiency();
+            worst = std::min(worst, layout.efficiency());
+            ++layouts;
+            if (n == 0) {
+                std::cout << "  " << std::setw(8) << std::left << distribution.name << std::right << " ";
+                layout.printReport();
+            }
+        }
+        std::cout << "  " << std::setw(8) << std::left << distribution.name << std::right << " " << layouts
+                  << " layouts: mean efficiency " << (layouts ? efficiencySum / layouts * 100.0 : 0.0) << "%, worst "
+                  << worst * 100.0 << "%, " << (layouts ? packMs / layouts : 0.0) << " ms per pack" << std::endl;
+    }
+
+    // 放不下时返回空布局，而不是越界的布局
+    std::vector<PackRect> tooBig = { { 0, 0, 300, 300 }, { 0, 0, 300, 300 } };
+    checker.expect(!packAtlas(tooBig, 8, 256), "OVERSIZED_IMAGE_PACKED");
+    checker.expect(!packAtlas(std::vector<PackRect>(), 8), "EMPTY_INPUT_PACKED");
+    // 刚好放得下：四张 120x120 + 4px 边距正好是 256x256
+    std::vector<PackRect> exact(4, PackRect{ 0, 0, 120, 120 });
+    AtlasLayout tight = packAtlas(exact, 4, 256);
+    checkLayout(tight, exact, 4, "exact fit");
+
+    return checker.finish();
+}
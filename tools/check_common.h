@@ -0,0 +1,51 @@
+#ifndef CHECK_COMMON_H
+#define CHECK_COMMON_H
+
+// tools/*_check 共用的小工具（纯 CPU）：
+//   Checker      失败时打印 ERROR::<前缀>::<原因> 并记下，main 最后 return checker.finish()
+//   CheckRandom  固定种子的线性同余随机数，每次运行生成同样的随机场景，失败可以复现
+#include <iostream>
+#include <string>
+#include <cstdint>
+
+class Checker {
+public:
+    // prefix 是工具名的大写形式，例如 "OCCLUSION_CHECK"
+    explicit Checker(const char* prefix) : prefix(prefix) {}
+
+    void expect(bool condition, const std::string& what) {
+        if (!condition) {
+            std::cerr << "ERROR::" << prefix << "::" << what << std::endl;
+            failed = true;
+        }
+    }
+
+    bool ok() const { return !failed; }
+
+    // 打印汇总，返回进程退出码（ctest 按它判断成败）
+    int finish() const {
+        std::cout << (failed ? "CHECKS FAILED" : "all checks passed") << std::endl;
+        return failed ? 1 : 0;
+    }
+
+private:
+    const char* prefix;
+    bool failed = false;
+};
+
+struct CheckRandom {
+    uint32_t seed;
+
+    uint32_t next() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    }
+
+    // [lo, hi) 内的浮点数
+    float operator()(float lo, float hi) { return lo + (hi - lo) * (float)next() / 16777216.0f; }
+
+    // [lo, hi] 内的整数
+    int operator()(int lo, int hi) { return lo + (int)(next() % (uint32_t)(hi - lo + 1)); }
+};
+
+#endif
@@ -0,0 +1,83 @@
+// 视锥剔除微基准：逐个测试的参考实现 vs SIMD，AABB 和包围球各测一次
+// 用法：cull_bench [包围体数量=100000] [重复次数=100]
+// 场景里的物体散布在相机四周很大的范围内，大部分在视锥外；同时校验两种实现的可见列表完全一致
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "my_frustum.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename F>
+double averageUs(int runs, F&& fn) {
+    auto start = Clock::now();
+    for (int r = 0; r < runs; ++r)
+        fn();
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / runs;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 100000;
+    int runs = argc > 2 ? std::stoi(argv[2]) : 100;
+
+    // 和 FpsCamera 默认参数一致：45 度视角，0.1 ~ 100 的深度范围
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum = Frustum::fromMatrix(projection * view);
+
+    AABBSoA boxes;
+    SphereSoA spheres;
+    boxes.reserve(count);
+    spheres.reserve(count);
+    uint32_t seed = 12345;
+    auto random = [&](float lo, float hi) {
+        seed = seed * 1664525u + 1013904223u;
+        return lo + (hi - lo) * (float)(seed >> 8) / 16777216.0f;
+    };
+    for (size_t i = 0; i < count; ++i) {
+        glm::vec3 center(random(-200.0f, 200.0f), random(-200.0f, 200.0f), random(-200.0f, 200.0f));
+        glm::vec3 extent(random(0.1f, 2.0f), random(0.1f, 2.0f), random(0.1f, 2.0f));
+        boxes.push(center, extent);
+        spheres.push(center, glm::length(extent));
+    }
+
+    std::cout << "frustum culling " << count << " objects, " << runs << " runs, "
+#if defined(MY_SIMD_AVX2)
+              << "AVX2"
+#elif defined(MY_SIMD_SSE2)
+              << "SSE2"
+#else
+              << "no SIMD"
+#endif
+              << std::endl;
+
+    bool allMatch = true;
+    std::vector<uint32_t> scalar, simd;
+    auto report = [&](const char* name, double scalarUs, double simdUs) {
+        bool match = scalar == simd;
+        allMatch = allMatch && match;
+        std::cout << "  " << name << ": " << simd.size() << " visible (" << 100.0 * simd.size() / (count ? count : 1)
+                  << "%), scalar " << scalarUs << " us, SIMD " << simdUs << " us (" << scalarUs / simdUs << "x)"
+                  << (match ? "" : "  MISMATCH") << std::endl;
+    };
+
+    double scalarUs = averageUs(runs, [&]() { cullAABBs(frustum, boxes, scalar, CullPath::Scalar); });
+    double simdUs = averageUs(runs, [&]() { cullAABBs(frustum, boxes, simd, CullPath::SIMD); });
+    report("AABB  ", scalarUs, simdUs);
+
+    scalarUs = averageUs(runs, [&]() { cullSpheres(frustum, spheres, scalar, CullPath::Scalar); });
+    simdUs = averageUs(runs, [&]() { cullSpheres(frustum, spheres, simd, CullPath::SIMD); });
+    report("sphere", scalarUs, simdUs);
+
+    return allMatch ? 0 : 1;
+}
@@ -0,0 +1,291 @@
+// 实体存储基准：每帧旋转所有实体、重算世界矩阵和包围盒、视锥剔除、收集可见实例数据
+// 用法：ecs_bench [实体数量=200000] [帧数=60] [工作线程数=核数-1]
+// 对照组是常见的面向对象写法：每个物体单独 new 出来（按创建顺序打乱后存指针），TRS、矩阵、包围盒、句柄都放在对象里
+// ECS 组在 Registry 的 SoA 列上做同样的事，分别单线程和在任务系统上跑
+// 不需要 GL 上下文：校验世界矩阵和 glm 的 translate * mat4_cast * scale 一致、两边的可见数量一致，
+// 并在随机增删实体之后校验 owning group 的槽位对应关系
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "my_ecs.h"
+#include "my_instancing.h"
+#include "my_jobSystem.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct Random {
+    uint32_t seed = 12345;
+    float operator()(float lo, float hi) {
+        seed = seed * 1664525u + 1013904223u;
+        return lo + (hi - lo) * (float)(seed >> 8) / 16777216.0f;
+    }
+};
+
+// 对照组：一个物体一个堆对象
+struct SceneObject {
+    glm::vec3 position;
+    glm::quat rotation;
+    glm::vec3 scale;
+    glm::quat spin;
+    glm::mat4 model;
+    glm::vec3 boundsMin, boundsMax;
+    RenderHandle handle;
+    glm::vec4 color;
+};
+
+struct FrameTimes {
+    double update = 0.0, transform = 0.0, cull = 0.0, gather = 0.0;
+    double total() const { return update + transform + cull + gather; }
+};
+
+void printTimes(const char* name, const FrameTimes& t, int frames, size_t visible) {
+    std::cout << "  " << name << ": " << t.total() / frames << " ms/frame (spin " << t.update / frames
+              << ", transform " << t.transform / frames << ", cull " << t.cull / frames << ", gather "
+              << t.gather / frames << "), " << visible << " visible" << std::endl;
+}
+
+// 四元数乘法按 SoA 展开：q = spin * q
+void spinRotations(TransformPool& t, const std::vector<float>& sx, const std::vector<float>& sy,
+                   const std::vector<float>& sz, const std::vector<float>& sw, size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+        float ax = sx[i], ay = sy[i], az = sz[i], aw = sw[i];
+        float bx = t.rx[i], by = t.ry[i], bz = t.rz[i], bw = t.rw[i];
+        t.rw[i] = aw * bw - ax * bx - ay * by - az * bz;
+        t.rx[i] = aw * bx + ax * bw + ay * bz - az * by;
+        t.ry[i] = aw * by + ay * bw + az * bx - ax * bz;
+        t.rz[i] = aw * bz + az * bw + ax * by - ay * bx;
+    }
+}
+
+bool nearlyEqual(const glm::mat4& a, const glm::mat4& b) {
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            if (std::fabs(a[c][r] - b[c][r]) > 1e-4f * (1.0f + std::fabs(b[c][r])))
+                return false;
+    return true;
+}
+
+// 组内槽位两个池指向同一个实体，组外的实体不会同时有两个组件
+bool checkGroup(const Registry& scene) {
+    const std::vector<uint32_t>& t = scene.transforms.entities();
+    const std::vector<uint32_t>& r = scene.renderables.entities();
+    for (size_t i = 0; i < scene.renderableCount(); ++i)
+        if (t[i] != r[i])
+            return false;
+    for (size_t i = scene.renderableCount(); i < t.size(); ++i)
+        if (scene.renderables.contains(t[i]))
+            return false;
+    for (size_t i = scene.renderableCount(); i < r.size(); ++i)
+        if (scene.transforms.contains(r[i]))
+            return false;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 200000;
+    int frames = argc > 2 ? std::stoi(argv[2]) : 60;
+    JobSystem jobs(argc > 3 ? (unsigned)std::stoul(argv[3]) : JobSystem::defaultWorkerCount());
+
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 200.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 60.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum = Frustum::fromMatrix(projection * view);
+
+    // 同一组随机数生成两边的场景
+    Random random;
+    std::vector<SceneObject> source(count);
+    for (size_t i = 0; i < count; ++i) {
+        SceneObject& o = source[i];
+        o.position = glm::vec3(random(-100.0f, 100.0f), random(-60.0f, 60.0f), random(-100.0f, 40.0f));
+        glm::vec3 axis = glm::normalize(glm::vec3(random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(0.1f, 1.0f)));
+        o.rotation = glm::angleAxis(random(0.0f, 6.28f), axis);
+        o.scale = glm::vec3(random(0.2f, 1.0f), random(0.2f, 1.0f), random(0.2f, 1.0f));
+        o.spin = glm::angleAxis(random(0.005f, 0.05f), axis);
+        o.model = glm::mat4(1.0f);
+        o.boundsMin = glm::vec3(-0.5f);
+        o.boundsMax = glm::vec3(0.5f);
+        o.handle = RenderHandle{ 1u + (GLuint)(i % 8), 1u + (GLuint)(i % 32), 36, 0 };
+        o.color = glm::vec4(random(0.0f, 1.0f), random(0.0f, 1.0f), random(0.0f, 1.0f), 1.0f);
+    }
+
+    // 对照组：单独分配，再打乱指针顺序，模拟创建 / 删除交错之后对象在堆上的分布
+    std::vector<std::unique_ptr<SceneObject>> objects;
+    objects.reserve(count);
+    for (const SceneObject& o : source)
+        objects.emplace_back(new SceneObject(o));
+    for (size_t i = count; i > 1; --i)
+        std::swap(objects[i - 1], objects[(size_t)random(0.0f, (float)i) % i]);
+
+    Registry scene;
+    scene.reserve(count);
+    std::vector<Entity> entities(count);
+    std::vector<float> spinX(count), spinY(count), spinZ(count), spinW(count);
+    for (size_t i = 0; i < count; ++i) {
+        const SceneObject& o = source[i];
+        Entity e = scene.create();
+        scene.addTransform(e, o.position, o.rotation, o.scale);
+        scene.setBounds(e, o.boundsMin, o.boundsMax);
+        scene.addRenderable(e, o.handle, o.color);
+        entities[i] = e;
+        // 每个实体的角速度是自己的数据，和槽位顺序一致地放在一列里
+        uint32_t slot = scene.transforms.slotOf(e.index);
+        spinX[slot] = o.spin.x; spinY[slot] = o.spin.y; spinZ[slot] = o.spin.z; spinW[slot] = o.spin.w;
+    }
+    std::cout << "ecs bench: " << count << " entities, " << frames << " frames, " << jobs.size() << " threads, "
+              << sizeof(SceneObject) << " bytes per object vs "
+              << (sizeof(float) * 10 + sizeof(float) * 12 + sizeof(glm::mat4) + sizeof(RenderHandle) + sizeof(glm::vec4))
+              << " bytes per entity in columns" << std::endl;
+
+    std::vector<InstanceData> instances;
+    instances.reserve(count);
+
+    FrameTimes objectTimes;
+    for (int f = 0; f < frames; ++f) {
+        auto start = Clock::now();
+        for (auto& o : objects)
+            o->rotation = o->spin * o->rotation;
+        objectTimes.update += msSince(start);
+
+        start = Clock::now();
+        for (auto& o : objects) {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), o->position) * glm::mat4_cast(o->rotation);
+            o->model = glm::scale(model, o->scale);
+        }
+        objectTimes.transform += msSince(start);
+
+        // 剔除和收集合在一个循环里，这是对象写法最自然的样子；时间算在 cull 里
+        start = Clock::now();
+        instances.clear();
+        for (auto& o : objects) {
+            glm::vec3 center(o->model * glm::vec4((o->boundsMin + o->boundsMax) * 0.5f, 1.0f));
+            glm::vec3 e = (o->boundsMax - o->boundsMin) * 0.5f;
+            glm::vec3 extent(std::fabs(o->model[0][0]) * e.x + std::fabs(o->model[1][0]) * e.y + std::fabs(o->model[2][0]) * e.z,
+                             std::fabs(o->model[0][1]) * e.x + std::fabs(o->model[1][1]) * e.y + std::fabs(o->model[2][1]) * e.z,
+                             std::fabs(o->model[0][2]) * e.x + std::fabs(o->model[1][2]) * e.y + std::fabs(o->model[2][2]) * e.z);
+            if (frustum.intersectsAABB(center, extent))
+                instances.push_back({ o->model, o->color });
+        }
+        objectTimes.cull += msSince(start);
+    }
+    size_t objectVisible = instances.size();
+
+    std::vector<uint32_t> visible;
+    auto runRegistry = [&](JobSystem* pool, FrameTimes& times) {
+        for (int f = 0; f < frames; ++f) {
+            auto start = Clock::now();
+            size_t n = scene.transforms.size();
+            if (pool)
+                pool->parallelFor(0, n, [&](size_t first, size_t last) {
+                    spinRotations(scene.transforms, spinX, spinY, spinZ, spinW, first, last);
+                }, 4096);
+            else
+                spinRotations(scene.transforms, spinX, spinY, spinZ, spinW, 0, n);
+            times.update += msSince(start);
+
+            start = Clock::now();
+            scene.updateTransforms(pool);
+            times.transform += msSince(start);
+
+            start = Clock::now();
+            scene.cullRenderables(frustum, visible);
+            times.cull += msSince(start);
+
+            start = Clock::now();
+            instances.resize(visible.size());
+            const std::vector<glm::mat4>& world = scene.transforms.world;
+            const std::vector<glm::vec4>& color = scene.renderables.color;
+            for (size_t k = 0; k < visible.size(); ++k)
+                instances[k] = InstanceData{ world[visible[k]], color[visible[k]] };
+            times.gather += msSince(start);
+        }
+    };
+
+    // 两组都从同样的初始旋转开始跑同样的帧数，最后比较
+    FrameTimes serialTimes, jobTimes;
+    runRegistry(nullptr, serialTimes);
+    size_t serialVisible = visible.size();
+    for (size_t i = 0; i < count; ++i)
+        scene.setRotation(entities[i], source[i].rotation);
+    runRegistry(&jobs, jobTimes);
+
+    printTimes("heap objects (pointer per object)", objectTimes, frames, objectVisible);
+    printTimes("registry SoA, 1 thread", serialTimes, frames, serialVisible);
+    printTimes("registry SoA, job system", jobTimes, frames, visible.size());
+    std::cout << "  speedup: " << objectTimes.total() / serialTimes.total() << "x single-threaded, "
+              << objectTimes.total() / jobTimes.total() << "x on " << jobs.size() << " threads" << std::endl;
+
+    bool ok = true;
+    // 旋转累乘的舍入两边不完全一样，允许一点误差；可见数量只在视锥边缘可能差几个
+    for (size_t i = 0; i < count; i += std::max<size_t>(1, count / 1000)) {
+        glm::quat q = scene.transforms.rotation(scene.transforms.slotOf(entities[i].index));
+        glm::mat4 reference = glm::scale(glm::translate(glm::mat4(1.0f), source[i].position) * glm::mat4_cast(q), source[i].scale);
+        if (!nearlyEqual(scene.worldMatrix(entities[i]), reference)) {
+            std::cerr << "ERROR::ECS_BENCH::WORLD_MATRIX_MISMATCH entity " << i << std::endl;
+            ok = false;
+            break;
+        }
+    }
+    size_t diff = objectVisible > serialVisible ? objectVisible - serialVisible : serialVisible - objectVisible;
+    if (serialVisible != visible.size() || diff > count / 1000 + 8) {
+        std::cerr << "ERROR::ECS_BENCH::VISIBLE_COUNT_MISMATCH " << objectVisible << " / " << serialVisible << " / "
+                  << visible.size() << std::endl;
+        ok = false;
+    }
+
+    // 随机删实体、拿掉 / 加回渲染组件、新建实体，之后组的对应关系和句柄有效性都要保持
+    auto start = Clock::now();
+    size_t churn = std::min<size_t>(count / 2, 50000);
+    for (size_t k = 0; k < churn; ++k) {
+        size_t i = (size_t)random(0.0f, (float)count) % count;
+        switch (k % 4) {
+        case 0: {
+            Entity old = entities[i];
+            scene.destroy(old);
+            entities[i] = scene.create();
+            if (scene.valid(old) || entities[i].index != old.index || scene.hasTransform(entities[i]))
+                ok = false;
+            scene.addRenderable(entities[i], source[i].handle, source[i].color);
+            scene.addTransform(entities[i], source[i].position);
+            break;
+        }
+        case 1: scene.removeRenderable(entities[i]); break;
+        case 2: scene.addRenderable(entities[i], source[i].handle, source[i].color); break;
+        default: scene.removeTransform(entities[i]); scene.addTransform(entities[i], source[i].position); break;
+        }
+    }
+    double churnMs = msSince(start);
+    if (!checkGroup(scene) || scene.size() != count) {
+        std::cerr << "ERROR::ECS_BENCH::GROUP_BROKEN after churn" << std::endl;
+        ok = false;
+    }
+    scene.updateTransforms(&jobs);
+    for (size_t i = 0; i < count; i += std::max<size_t>(1, count / 1000)) {
+        if (!scene.hasTransform(entities[i]) || scene.position(entities[i]) != source[i].position) {
+            std::cerr << "ERROR::ECS_BENCH::LOST_COMPONENT entity " << i << std::endl;
+            ok = false;
+            break;
+        }
+    }
+    std::cout << "  churn: " << churn << " structural changes in " << churnMs << " ms, " << scene.renderableCount()
+              << " of " << scene.transforms.size() << " transforms renderable" << std::endl;
+
+    std::cout << (ok ? "all checks passed" : "CHECKS FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
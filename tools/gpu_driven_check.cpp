@@ -0,0 +1,183 @@
+// GPU 驱动渲染的 CPU 侧检查：不创建 GL 上下文，测结构体布局和 cull.comp 的 CPU 参考实现
+// 用法：gpu_driven_check [随机场景数=20]
+// 检查：
+//   layout     GpuObject / GpuMesh / DrawElementsIndirectCommand 的大小和字段偏移符合 std430 和 GL 的约定
+//   commands   buildCommands 的可见性和 Frustum::intersectsAABB、SoA 的 cullAABBs 一致；
+//              不压缩时每个物体一条命令，baseInstance = 物体下标，网格字段取自它的网格；
+//              压缩时可见命令按下标排在前面，后面的不动，返回值就是 drawCount
+//   compare    sameCommands 不在乎压缩命令的先后顺序，但任何一个字段不同都能发现
+//   visibility 带位图时只有视锥内且置位的物体可见，和先剔除再按位图过滤的结果一致；
+//              buildVisibilityMask 忽略越界下标
+//   validate   网格下标越界的物体被拒绝
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "my_frustum.h"
+#include "my_gpuDriven.h"
+#include "check_common.h"
+
+namespace {
+
+Checker checker("GPU_DRIVEN_CHECK");
+
+const DrawElementsIndirectCommand UNTOUCHED = { 0xDEADu, 0xDEADu, 0xDEADu, -1, 0xDEADu };
+
+bool sameCommand(const DrawElementsIndirectCommand& a, const DrawElementsIndirectCommand& b) {
+    return a.count == b.count && a.instanceCount == b.instanceCount && a.firstIndex == b.firstIndex &&
+           a.baseVertex == b.baseVertex && a.baseInstance == b.baseInstance;
+}
+
+// 和 shader/gpuObjects.glsl、cull.comp 里的 std430 布局逐个字段对上
+void checkLayout() {
+    checker.expect(sizeof(GpuObject) == 128, "GPU_OBJECT_SIZE");
+    checker.expect(offsetof(GpuObject, model) == 0 && offsetof(GpuObject, color) == 64 && offsetof(GpuObject, center) == 80 &&
+                   offsetof(GpuObject, extent) == 96 && offsetof(GpuObject, mesh) == 112, "GPU_OBJECT_OFFSETS");
+    checker.expect(sizeof(GpuMesh) == 16 && offsetof(GpuMesh, indexCount) == 0 && offsetof(GpuMesh, firstIndex) == 4 &&
+                   offsetof(GpuMesh, baseVertex) == 8, "GPU_MESH_LAYOUT");
+    // glMultiDrawElementsIndirect 规定的 5 个 32 位字段，stride 传 0 时按紧密排列读
+    checker.expect(sizeof(DrawElementsIndirectCommand) == 20 && offsetof(DrawElementsIndirectCommand, count) == 0 &&
+                   offsetof(DrawElementsIndirectCommand, instanceCount) == 4 && offsetof(DrawElementsIndirectCommand, firstIndex) == 8 &&
+                   offsetof(DrawElementsIndirectCommand, baseVertex) == 12 && offsetof(DrawElementsIndirectCommand, baseInstance) == 16,
+                   "INDIRECT_COMMAND_LAYOUT");
+}
+
+void checkCommands(int scenes) {
+    const std::vector<GpuMesh> meshes = { { 36, 0, 0, 0 }, { 36, 36, 8, 0 }, { 960, 72, 16, 0 } };
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    size_t objects = 0, visibleTotal = 0;
+    for (int s = 0; s < scenes; ++s) {
+        CheckRandom random{ 99u + (uint32_t)s * 7919u };
+        std::string tag = "scene " + std::to_string(s);
+        glm::vec3 eye(random(-20.0f, 20.0f), random(-5.0f, 15.0f), random(20.0f, 60.0f));
+        glm::mat4 viewProj = projection * glm::lookAt(eye, glm::vec3(random(-5.0f, 5.0f), 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        Frustum frustum = Frustum::fromMatrix(viewProj);
+
+        size_t count = 1 + (size_t)random(0.0f, 3000.0f);
+        std::vector<GpuObject> scene(count);
+        AABBSoA bounds;
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 center(random(-80.0f, 80.0f), random(-20.0f, 20.0f), random(-80.0f, 80.0f));
+            glm::vec3 extent(random(0.1f, 3.0f), random(0.1f, 3.0f), random(0.1f, 3.0f));
+            scene[i].model = glm::translate(glm::mat4(1.0f), center);
+            scene[i].center = glm::vec4(center, 0.0f);
+            scene[i].extent = glm::vec4(extent, 0.0f);
+            scene[i].mesh = (uint32_t)(i % meshes.size());
+            bounds.push(center, extent);
+        }
+        checker.expect(GpuDrivenRenderer::validateObjects(scene.data(), count, meshes.size()), "VALID_OBJECTS_REJECTED " + tag);
+
+        std::vector<uint32_t> reference;
+        cullAABBs(frustum, bounds, reference);
+        std::vector<bool> visible(count, false);
+        for (uint32_t i : reference)
+            visible[i] = true;
+
+        // 不压缩：每个物体固定一条
+        std::vector<DrawElementsIndirectCommand> full(count, UNTOUCHED);
+        GLuint drawCount = GpuDrivenRenderer::buildCommands(frustum, scene.data(), count, meshes.data(), false, full.data());
+        checker.expect(drawCount == reference.size(), "DRAW_COUNT_DISAGREES_WITH_CULL_AABBS " + tag);
+        bool fullOk = true;
+        for (size_t i = 0; i < count; ++i) {
+            const GpuMesh& mesh = meshes[scene[i].mesh];
+            bool expected = frustum.intersectsAABB(glm::vec3(scene[i].center), glm::vec3(scene[i].extent));
+            fullOk = fullOk && expected == visible[i] &&
+                     sameCommand(full[i], { mesh.indexCount, expected ? 1u : 0u, mesh.firstIndex, mesh.baseVertex, (GLuint)i });
+        }
+        checker.expect(fullOk, "FULL_COMMANDS " + tag);
+
+        // 压缩：可见的按下标排在前面，后面的不写
+        std::vector<DrawElementsIndirectCommand> compact(count, UNTOUCHED);
+        GLuint compactCount = GpuDrivenRenderer::buildCommands(frustum, scene.data(), count, meshes.data(), true, compact.data());
+        checker.expect(compactCount == drawCount, "COMPACT_DRAW_COUNT " + tag);
+        bool compactOk = compactCount <= count;
+        for (size_t k = 0; k < compactCount && k < reference.size(); ++k)
+            compactOk = compactOk && sameCommand(compact[k], full[reference[k]]);
+        for (size_t k = compactCount; k < count; ++k)
+            compactOk = compactOk && sameCommand(compact[k], UNTOUCHED);
+        checker.expect(compactOk, "COMPACT_COMMANDS " + tag);
+
+        // GPU 上原子加的顺序不固定：打乱之后仍然相同，改掉一个字段就不同
+        std::vector<DrawElementsIndirectCommand> shuffled = compact;
+        std::reverse(shuffled.begin(), shuffled.begin() + compactCount);
+        checker.expect(GpuDrivenRenderer::sameCommands(shuffled, compact, count, compactCount, true), "SHUFFLED_COMPACT_DIFFERS " + tag);
+        checker.expect(GpuDrivenRenderer::sameCommands(full, full, count, drawCount, false), "FULL_DIFFERS_FROM_ITSELF " + tag);
+        if (compactCount > 0) {
+            shuffled[compactCount / 2].firstIndex += 3;
+            checker.expect(!GpuDrivenRenderer::sameCommands(shuffled, compact, count, compactCount, true), "CHANGED_FIELD_NOT_DETECTED " + tag);
+        }
+        std::vector<DrawElementsIndirectCommand> changed = full;
+        changed[count - 1].instanceCount ^= 1u;
+        checker.expect(!GpuDrivenRenderer::sameCommands(changed, full, count, drawCount, false), "CHANGED_INSTANCE_NOT_DETECTED " + tag);
+        checker.expect(!GpuDrivenRenderer::sameCommands(std::vector<DrawElementsIndirectCommand>(), full, count, drawCount, false),
+                       "SHORT_BUFFER_ACCEPTED " + tag);
+
+        // 位图：随机去掉一部分，结果必须是视锥剔除结果里仍然置位的那些
+        std::vector<uint32_t> kept;
+        for (size_t i = 0; i < count; ++i)
+            if (random(0.0f, 1.0f) < 0.5f)
+                kept.push_back((uint32_t)i);
+        std::vector<uint32_t> mask;
+        GpuDrivenRenderer::buildVisibilityMask(kept, count, mask);
+        std::vector<bool> inMask(count, false);
+        for (uint32_t i : kept)
+            inMask[i] = true;
+        std::vector<DrawElementsIndirectCommand> masked(count, UNTOUCHED);
+        GLuint maskedCount = GpuDrivenRenderer::buildCommands(frustum, scene.data(), count, meshes.data(), false, masked.data(),
+                                                              mask.data());
+        size_t expectedMasked = 0;
+        bool maskedOk = mask.size() == (count + 31) / 32;
+        for (size_t i = 0; i < count; ++i) {
+            bool expected = visible[i] && inMask[i];
+            expectedMasked += expected ? 1 : 0;
+            DrawElementsIndirectCommand command = full[i];
+            command.instanceCount = expected ? 1u : 0u;
+            maskedOk = maskedOk && sameCommand(masked[i], command);
+        }
+        checker.expect(maskedOk && maskedCount == expectedMasked, "MASKED_COMMANDS " + tag);
+
+        objects += count;
+        visibleTotal += drawCount;
+    }
+    std::cout << "  " << scenes << " random scenes: " << objects << " objects, " << visibleTotal << " visible" << std::endl;
+    checker.expect(visibleTotal > 0 && visibleTotal < objects, "RANDOM_SCENES_DEGENERATE");
+
+    // 没有物体时什么都不写
+    DrawElementsIndirectCommand none = UNTOUCHED;
+    Frustum frustum = Frustum::fromMatrix(projection);
+    checker.expect(GpuDrivenRenderer::buildCommands(frustum, nullptr, 0, meshes.data(), true, &none) == 0 && sameCommand(none, UNTOUCHED),
+                   "EMPTY_SCENE");
+}
+
+void checkVisibilityMask() {
+    std::vector<uint32_t> mask;
+    GpuDrivenRenderer::buildVisibilityMask({ 0u, 31u, 32u, 64u, 65u, 1000u }, 65, mask);
+    checker.expect(mask.size() == 3 && mask[0] == 0x80000001u && mask[1] == 1u && mask[2] == 1u, "MASK_BITS");
+    GpuDrivenRenderer::buildVisibilityMask({}, 0, mask);
+    checker.expect(mask.empty(), "EMPTY_MASK");
+}
+
+void checkValidate() {
+    std::vector<GpuObject> objects(4);
+    objects[2].mesh = 3;
+    std::cerr << "(the next MESH_OUT_OF_RANGE error is expected)" << std::endl;
+    checker.expect(!GpuDrivenRenderer::validateObjects(objects.data(), objects.size(), 3), "OUT_OF_RANGE_MESH_ACCEPTED");
+    checker.expect(GpuDrivenRenderer::validateObjects(objects.data(), objects.size(), 4), "IN_RANGE_MESH_REJECTED");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int scenes = argc > 1 ? std::stoi(argv[1]) : 20;
+    checkLayout();
+    checkCommands(scenes);
+    checkVisibilityMask();
+    checkValidate();
+    return checker.finish();
+}
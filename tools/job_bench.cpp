@@ -0,0 +1,211 @@
+// 任务系统的扩展性基准：同一批负载分别在 1..N 个线程上跑，报告耗时、加速比和并行效率
+// 用法：job_bench [最多线程数=核数] [重复次数=5]
+// 负载：
+//   uniform    parallelFor 对 1M 个点做均匀的计算（每个元素代价相同）
+//   skewed     parallelFor 每个元素的代价随下标线性增长，考验自适应分块和窃取
+//   fib        递归 fork-join（每层 run 一个子任务再 wait），大量细粒度任务
+//   graph      16 级依赖链，每级 64 个任务 runAfter 上一级的计数器
+//   pool       uniform 同样的负载按固定块数交给 ThreadPool，submit + wait 对照
+// 每种负载都校验结果和单线程一致
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <thread>
+#include <functional>
+#include <utility>
+
+#include "my_jobSystem.h"
+#include "my_threadPool.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const size_t POINT_COUNT = 1u << 20;
+const size_t SKEWED_COUNT = 1u << 14;
+const int FIB_N = 32;
+const int FIB_CUTOFF = 12; // 比这小的直接递归，任务大约是微秒级
+const int GRAPH_LEVELS = 16;
+const int GRAPH_WIDTH = 64;
+
+// 每个元素若干次 sin + 乘加，以计算为主，内存带宽不是瓶颈
+inline float kernel(float x, int iterations) {
+    float y = x;
+    for (int i = 0; i < iterations; ++i)
+        y = y * 0.999f + std::sin(y) * 0.001f;
+    return y;
+}
+
+double sumOf(const std::vector<float>& values) {
+    double sum = 0.0;
+    for (float v : values)
+        sum += v;
+    return sum;
+}
+
+double runUniform(JobSystem& jobs, std::vector<float>& values) {
+    jobs.parallelFor(0, values.size(), [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            values[i] = kernel((float)i * 1e-6f, 8);
+    });
+    return sumOf(values);
+}
+
+double runSkewed(JobSystem& jobs, std::vector<float>& values) {
+    jobs.parallelFor(0, values.size(), [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            values[i] = kernel((float)i * 1e-4f, 1 + (int)(i / 16));
+    });
+    return sumOf(values);
+}
+
+uint64_t fibSerial(int n) {
+    return n < 2 ? (uint64_t)n : fibSerial(n - 1) + fibSerial(n - 2);
+}
+
+uint64_t fib(JobSystem& jobs, int n) {
+    if (n < FIB_CUTOFF)
+        return fibSerial(n);
+    uint64_t a = 0;
+    JobCounter counter;
+    jobs.run([&]() { a = fib(jobs, n - 1); }, &counter);
+    uint64_t b = fib(jobs, n - 2);
+    jobs.wait(counter);
+    return a + b;
+}
+
+// 每级的任务读上一级的结果写自己这一级，依赖全靠 runAfter 保证
+double runGraph(JobSystem& jobs, std::vector<float>& cells) {
+    std::vector<JobCounter> levels(GRAPH_LEVELS);
+    for (int level = 0; level < GRAPH_LEVELS; ++level) {
+        for (int slot = 0; slot < GRAPH_WIDTH; ++slot) {
+            auto work = [&cells, level, slot]() {
+                float previous = level > 0 ? cells[(size_t)(level - 1) * GRAPH_WIDTH + (slot + 1) % GRAPH_WIDTH] : 1.0f;
+                cells[(size_t)level * GRAPH_WIDTH + slot] = kernel(previous + (float)slot * 0.01f, 20000);
+            };
+            if (level == 0)
+                jobs.run(work, &levels[level]);
+            else
+                jobs.runAfter(levels[level - 1], work, &levels[level]);
+        }
+    }
+    jobs.wait(levels.back());
+    return sumOf(cells);
+}
+
+// ThreadPool 没有所有者线程参与，threads 个线程就开 threads 个工作线程，主线程只等
+double runPool(ThreadPool& pool, std::vector<float>& values, size_t threads) {
+    size_t chunks = threads * 4;
+    size_t chunkSize = (values.size() + chunks - 1) / chunks;
+    for (size_t first = 0; first < values.size(); first += chunkSize) {
+        size_t last = std::min(values.size(), first + chunkSize);
+        pool.submit([&values, first, last]() {
+            for (size_t i = first; i < last; ++i)
+                values[i] = kernel((float)i * 1e-6f, 8);
+        });
+    }
+    pool.wait();
+    return sumOf(values);
+}
+
+template <typename F>
+double bestMs(int repeats, F&& f) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = Clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+struct Row {
+    double uniform, skewed, fib, graph, pool;
+    uint64_t executed, stolen;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    unsigned maxThreads = argc > 1 ? (unsigned)std::stoul(argv[1]) : hardware;
+    int repeats = argc > 2 ? std::stoi(argv[2]) : 5;
+    maxThreads = std::max(1u, maxThreads);
+
+    std::cout << "job system scaling, 1.." << maxThreads << " threads (" << hardware << " hardware), best of "
+              << repeats << std::endl;
+    if (maxThreads > hardware)
+        std::cout << "note: more threads than hardware threads, speedup is bounded by " << hardware << "x" << std::endl;
+
+    std::vector<float> points(POINT_COUNT), skewed(SKEWED_COUNT), cells((size_t)GRAPH_LEVELS * GRAPH_WIDTH);
+    double uniformRef = 0.0, skewedRef = 0.0, graphRef = 0.0;
+    uint64_t fibRef = fibSerial(FIB_N);
+    bool ok = true;
+
+    std::vector<Row> rows;
+    for (unsigned threads = 1; threads <= maxThreads; ++threads) {
+        Row row{};
+        double uniformSum = 0.0, skewedSum = 0.0, graphSum = 0.0, poolSum = 0.0;
+        uint64_t fibResult = 0;
+        {
+            // 所有者线程（这里是主线程）也算一个
+            JobSystem jobs(threads - 1);
+            row.uniform = bestMs(repeats, [&]() { uniformSum = runUniform(jobs, points); });
+            row.skewed = bestMs(repeats, [&]() { skewedSum = runSkewed(jobs, skewed); });
+            row.fib = bestMs(repeats, [&]() { fibResult = fib(jobs, FIB_N); });
+            row.graph = bestMs(repeats, [&]() { graphSum = runGraph(jobs, cells); });
+            JobSystem::Stats stats = jobs.stats();
+            row.executed = stats.executed;
+            row.stolen = stats.stolen;
+        }
+        {
+            ThreadPool pool(threads);
+            row.pool = bestMs(repeats, [&]() { poolSum = runPool(pool, points, threads); });
+        }
+
+        if (threads == 1) {
+            uniformRef = uniformSum;
+            skewedRef = skewedSum;
+            graphRef = graphSum;
+        }
+        // 每个元素的计算和分块无关，结果应该逐位一致
+        if (uniformSum != uniformRef || poolSum != uniformRef || skewedSum != skewedRef || graphSum != graphRef ||
+            fibResult != fibRef) {
+            std::cerr << "ERROR::JOB_BENCH::MISMATCH at " << threads << " threads" << std::endl;
+            ok = false;
+        }
+        rows.push_back(row);
+    }
+
+    const Row& base = rows.front();
+    auto column = [](double ms, double baseMs, unsigned threads) {
+        double speedup = baseMs / ms;
+        std::cout << std::setw(8) << ms << " ms " << std::setw(5) << speedup << "x " << std::setw(4)
+                  << (int)std::lround(speedup / threads * 100.0) << "% ";
+    };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "threads";
+    for (const char* name : { "uniform", "skewed", "fib", "graph", "ThreadPool" })
+        std::cout << " | " << std::setw(25) << std::left << name << std::right;
+    std::cout << " | stolen/executed" << std::endl;
+    for (unsigned i = 0; i < rows.size(); ++i) {
+        unsigned threads = i + 1;
+        const Row& row = rows[i];
+        std::cout << std::setw(7) << threads;
+        for (auto pair : { std::make_pair(row.uniform, base.uniform), std::make_pair(row.skewed, base.skewed),
+                           std::make_pair(row.fib, base.fib), std::make_pair(row.graph, base.graph),
+                           std::make_pair(row.pool, base.pool) }) {
+            std::cout << " | ";
+            column(pair.first, pair.second, threads);
+        }
+        std::cout << "| " << row.stolen << "/" << row.executed << std::endl;
+    }
+    std::cout << "speedup relative to 1 thread of the same column, efficiency = speedup / threads" << std::endl;
+    std::cout << (ok ? "results match single-threaded" : "RESULTS DIFFER") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+// 批量矩阵内核基准：每条指令集路径分别和逐个调用 glm 比较耗时，并校验结果
+// 用法：matrix_bench [实例数=100000] [重复次数=20]
+// 四项负载（都是 n 个实例一次做完）：
+//   compose    SoA 的 TRS 合成模型矩阵；glm 对照是 translate * mat4_cast 再 scale
+//   +bounds    合成的同时把局部包围盒变换到世界空间（ECS 每帧做的就是这个）
+//   mvp        viewProj * model；glm 对照是逐个 operator*
+//   aabbs      已有的模型矩阵变换包围盒
+// 校验：每条 SIMD 路径和标量路径逐位一致（mvp 和 glm 的 operator* 是否逐位一致只报告，-march=native 时 glm 会用 FMA），
+// 合成的矩阵和包围盒和 glm 在误差内一致；不同的起止下标和原地乘法也要一致
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "my_matrixKernels.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Random {
+    uint32_t seed = 12345;
+    uint32_t next() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    }
+    float operator()(float lo, float hi) { return lo + (hi - lo) * (float)next() / 16777216.0f; }
+};
+
+template <typename F>
+double bestUs(int repeats, F&& f) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = Clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+// 和参考值的最大相对误差（分母至少是 1，接近 0 的元素按绝对误差算）
+double maxError(const float* a, const float* b, size_t count) {
+    double worst = 0.0;
+    for (size_t k = 0; k < count; ++k)
+        worst = std::max(worst, (double)std::fabs(a[k] - b[k]) / std::max(1.0, (double)std::fabs(b[k])));
+    return worst;
+}
+
+double maxError(const AABBSoA& a, const AABBSoA& b) {
+    double worst = 0.0;
+    for (const auto& pair : { std::make_pair(&a.cx, &b.cx), std::make_pair(&a.cy, &b.cy), std::make_pair(&a.cz, &b.cz),
+                              std::make_pair(&a.ex, &b.ex), std::make_pair(&a.ey, &b.ey), std::make_pair(&a.ez, &b.ez) })
+        worst = std::max(worst, maxError(pair.first->data(), pair.second->data(), pair.first->size()));
+    return worst;
+}
+
+bool sameBits(const AABBSoA& a, const AABBSoA& b) {
+    return a.cx == b.cx && a.cy == b.cy && a.cz == b.cz && a.ex == b.ex && a.ey == b.ey && a.ez == b.ez;
+}
+
+bool sameBits(const std::vector<glm::mat4>& a, const std::vector<glm::mat4>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(glm::mat4)) == 0;
+}
+
+struct Row {
+    const char* name;
+    double compose, bounds, mvp, aabbs;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 100000;
+    int repeats = argc > 2 ? std::stoi(argv[2]) : 20;
+    const double TOLERANCE = 1e-5;
+
+    // 随机的 TRS 和局部包围盒
+    Random random;
+    std::vector<float> px(count), py(count), pz(count), rx(count), ry(count), rz(count), rw(count), sx(count), sy(count), sz(count);
+    AABBSoA local;
+    local.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        px[i] = random(-100.0f, 100.0f); py[i] = random(-100.0f, 100.0f); pz[i] = random(-100.0f, 100.0f);
+        glm::quat q = glm::angleAxis(random(0.0f, 6.28f), glm::normalize(glm::vec3(random(-1.0f, 1.0f), random(-1.0f, 1.0f), 1.0f)));
+        rx[i] = q.x; ry[i] = q.y; rz[i] = q.z; rw[i] = q.w;
+        sx[i] = random(0.5f, 2.0f); sy[i] = random(0.5f, 2.0f); sz[i] = random(0.5f, 2.0f);
+        local.push(glm::vec3(random(-1.0f, 1.0f), random(-1.0f, 1.0f), random(-1.0f, 1.0f)),
+                   glm::vec3(random(0.1f, 1.0f), random(0.1f, 1.0f), random(0.1f, 1.0f)));
+    }
+    TRSColumns trs{ px.data(), py.data(), pz.data(), rx.data(), ry.data(), rz.data(), rw.data(), sx.data(), sy.data(), sz.data() };
+    ConstAABBColumns localColumns = readColumns(local);
+    glm::mat4 viewProj = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 1000.0f) *
+                         glm::lookAt(glm::vec3(0.0f, 50.0f, 200.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+    MatrixKernels& kernels = matrixKernels();
+    MathPath supported = kernels.supportedPath();
+    std::cout << "matrix kernels: " << count << " instances, best of " << repeats << ", this CPU supports "
+              << mathPathName(supported) << std::endl;
+
+    // glm 对照：每个实例各调一次
+    std::vector<glm::mat4> glmModels(count), glmMvps(count);
+    AABBSoA glmBounds = local;
+    auto glmCompose = [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            glm::mat4 m = glm::translate(glm::mat4(1.0f), glm::vec3(px[i], py[i], pz[i])) * glm::mat4_cast(glm::quat(rw[i], rx[i], ry[i], rz[i]));
+            glmModels[i] = glm::scale(m, glm::vec3(sx[i], sy[i], sz[i]));
+        }
+    };
+    auto glmAABBs = [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            const glm::mat4& m = glmModels[i];
+            glm::vec3 c(local.cx[i], local.cy[i], local.cz[i]), e(local.ex[i], local.ey[i], local.ez[i]);
+            glm::vec3 center = glm::vec3(m * glm::vec4(c, 1.0f));
+            glm::vec3 extent = glm::abs(glm::vec3(m[0])) * e.x + glm::abs(glm::vec3(m[1])) * e.y + glm::abs(glm::vec3(m[2])) * e.z;
+            glmBounds.cx[i] = center.x; glmBounds.cy[i] = center.y; glmBounds.cz[i] = center.z;
+            glmBounds.ex[i] = extent.x; glmBounds.ey[i] = extent.y; glmBounds.ez[i] = extent.z;
+        }
+    };
+    std::vector<Row> rows;
+    Row glmRow{ "glm", 0.0, 0.0, 0.0, 0.0 };
+    glmRow.compose = bestUs(repeats, glmCompose);
+    glmRow.bounds = bestUs(repeats, [&]() { glmCompose(); glmAABBs(); });
+    glmRow.mvp = bestUs(repeats, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            glmMvps[i] = viewProj * glmModels[i];
+    });
+    glmRow.aabbs = bestUs(repeats, glmAABBs);
+    rows.push_back(glmRow);
+
+    bool ok = true;
+    std::vector<glm::mat4> models(count), mvps(count), inPlace(count), scalarModels, scalarMvps;
+    AABBSoA bounds = local, aabbs = local, scalarBounds;
+    AABBColumns boundsColumns = writeColumns(bounds), aabbColumns = writeColumns(aabbs);
+    bool mvpMatchesGlm = true;
+    for (MathPath path : { MathPath::Scalar, MathPath::SSE2, MathPath::AVX2, MathPath::AVX512 }) {
+        if ((int)path > (int)supported)
+            break;
+        kernels.setPath(path);
+        Row row{ mathPathName(path), 0.0, 0.0, 0.0, 0.0 };
+        row.compose = bestUs(repeats, [&]() { kernels.composeTransforms(trs, 0, count, models.data()); });
+        row.bounds = bestUs(repeats, [&]() {
+            kernels.composeTransforms(trs, 0, count, models.data(), &localColumns, &boundsColumns);
+        });
+        row.mvp = bestUs(repeats, [&]() { kernels.multiply(viewProj, models.data(), mvps.data(), count); });
+        row.aabbs = bestUs(repeats, [&]() {
+            kernels.transformAABBs(models.data(), localColumns, aabbColumns, 0, count);
+        });
+        rows.push_back(row);
+
+        // 其余路径都要和标量路径逐位一致
+        if (path == MathPath::Scalar) {
+            scalarModels = models;
+            scalarMvps = mvps;
+            scalarBounds = bounds;
+            glmCompose();
+            glmAABBs();
+            for (size_t i = 0; i < count; ++i)
+                glmMvps[i] = viewProj * models[i];
+            mvpMatchesGlm = sameBits(mvps, glmMvps);
+            double modelError = maxError(matrix_detail::floats(models.data()), matrix_detail::floats(glmModels.data()), count * 16);
+            double boundsError = maxError(bounds, glmBounds);
+            std::cout << "  vs glm: model max error " << std::scientific << std::setprecision(2) << modelError
+                      << ", bounds max error " << boundsError << ", mvp "
+                      << (mvpMatchesGlm ? "bit-identical" : "differs") << std::defaultfloat << std::endl;
+            if (modelError > TOLERANCE || boundsError > TOLERANCE) {
+                std::cerr << "ERROR::MATRIX_BENCH::GLM_MISMATCH" << std::endl;
+                ok = false;
+            }
+        } else if (!sameBits(models, scalarModels) || !sameBits(mvps, scalarMvps) || !sameBits(bounds, scalarBounds) ||
+                   !sameBits(aabbs, scalarBounds)) {
+            std::cerr << "ERROR::MATRIX_BENCH::PATH_MISMATCH " << mathPathName(path) << std::endl;
+            ok = false;
+        }
+
+        // 起止下标不是宽度的整数倍，只写 [first, last)；原地乘法
+        size_t first = std::min<size_t>(3, count), last = count > 8 ? count - 5 : count;
+        std::vector<glm::mat4> partial(count, glm::mat4(0.0f));
+        kernels.composeTransforms(trs, first, last, partial.data());
+        bool partialOk = std::memcmp(partial.data() + first, scalarModels.data() + first, (last - first) * sizeof(glm::mat4)) == 0;
+        for (size_t i = 0; i < count && partialOk; ++i)
+            partialOk = (i >= first && i < last) || partial[i] == glm::mat4(0.0f);
+        inPlace = scalarModels;
+        kernels.multiply(viewProj, inPlace.data(), inPlace.data(), count);
+        if (!partialOk || !sameBits(inPlace, scalarMvps)) {
+            std::cerr << "ERROR::MATRIX_BENCH::PARTIAL_OR_IN_PLACE_MISMATCH " << mathPathName(path) << std::endl;
+            ok = false;
+        }
+    }
+    kernels.setPath(supported);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  path     " << std::setw(17) << "compose" << std::setw(19) << "+bounds" << std::setw(19) << "mvp"
+              << std::setw(19) << "aabbs" << std::endl;
+    for (const Row& row : rows) {
+        std::cout << "  " << std::setw(8) << std::left << row.name << std::right;
+        for (auto pair : { std::make_pair(row.compose, glmRow.compose), std::make_pair(row.bounds, glmRow.bounds),
+                           std::make_pair(row.mvp, glmRow.mvp), std::make_pair(row.aabbs, glmRow.aabbs) })
+            std::cout << std::setw(10) << pair.first << " us " << std::setw(4) << pair.second / pair.first << "x";
+        std::cout << std::endl;
+    }
+    std::cout << "  speedup relative to one glm call per instance; " << count << " instances = "
+              << count * sizeof(glm::mat4) / 1024 << " KiB of matrices" << std::endl;
+    std::cout << (ok ? "all checks passed" : "CHECKS FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
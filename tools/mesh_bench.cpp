@@ -0,0 +1,115 @@
+// 网格优化基准：三角形汤 -> 去重索引 -> 顶点缓存重排 -> 顶点读取重排，每一步报告 ACMR / ATVR / overfetch
+// 用法：mesh_bench [球面细分=256] [缓存大小=16]
+// 测试网格是经纬度球（位置 + 法线 + uv），三角形顺序打乱，模拟导出工具给出的无序网格
+// 同时校验优化前后三角形集合（含绕序）完全一致
+#include <iostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+
+#include "my_meshOptimizer.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const size_t FLOATS = 8; // 位置 3 + 法线 3 + uv 2
+
+// 经纬度球的三角形列表（不带索引，每个三角形 3 个完整顶点）
+std::vector<float> makeSphereSoup(int segments) {
+    const float PI = 3.14159265358979f;
+    int rings = segments / 2;
+    auto vertex = [&](std::vector<float>& out, int ring, int segment) {
+        float theta = PI * ring / rings;
+        float phi = 2.0f * PI * segment / segments;
+        float x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = std::sin(theta) * std::sin(phi);
+        float v[FLOATS] = { x, y, z, x, y, z, (float)segment / segments, (float)ring / rings };
+        out.insert(out.end(), v, v + FLOATS);
+    };
+    std::vector<float> soup;
+    for (int r = 0; r < rings; ++r)
+        for (int s = 0; s < segments; ++s) {
+            // 两极的退化三角形跳过
+            if (r != 0) {
+                vertex(soup, r, s); vertex(soup, r + 1, s); vertex(soup, r, s + 1);
+            }
+            if (r != rings - 1) {
+                vertex(soup, r, s + 1); vertex(soup, r + 1, s); vertex(soup, r + 1, s + 1);
+            }
+        }
+    return soup;
+}
+
+// 每个三角形转成“顶点内容”的三元组，旋转到字典序最小（保留绕序），排序后可以直接比较
+using Triangle = std::array<std::array<float, FLOATS>, 3>;
+std::vector<Triangle> canonicalTriangles(const IndexedMesh& mesh) {
+    std::vector<Triangle> triangles(mesh.triangleCount());
+    for (size_t t = 0; t < triangles.size(); ++t) {
+        Triangle tri;
+        for (int k = 0; k < 3; ++k)
+            std::copy_n(&mesh.vertices[mesh.indices[t * 3 + k] * FLOATS], FLOATS, tri[k].begin());
+        Triangle best = tri;
+        for (int r = 1; r < 3; ++r) {
+            Triangle rotated = { tri[r], tri[(r + 1) % 3], tri[(r + 2) % 3] };
+            best = std::min(best, rotated);
+        }
+        triangles[t] = best;
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+void print(const char* name, const IndexedMesh& mesh, unsigned cacheSize) {
+    VertexCacheStats cache = analyzeVertexCache(mesh, cacheSize);
+    VertexFetchStats fetch = analyzeVertexFetch(mesh);
+    std::cout << "  " << name << ": ACMR " << cache.acmr << ", ATVR " << cache.atvr << ", overfetch "
+              << fetch.overfetch << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int segments = argc > 1 ? std::stoi(argv[1]) : 256;
+    unsigned cacheSize = argc > 2 ? (unsigned)std::stoul(argv[2]) : 16;
+
+    std::vector<float> soup = makeSphereSoup(segments);
+    size_t soupVertices = soup.size() / FLOATS;
+
+    // 打乱三角形顺序
+    uint32_t seed = 12345;
+    size_t triangles = soupVertices / 3;
+    for (size_t t = triangles - 1; t > 0; --t) {
+        seed = seed * 1664525u + 1013904223u;
+        size_t other = (seed >> 8) % (t + 1);
+        std::swap_ranges(soup.begin() + t * 3 * FLOATS, soup.begin() + (t + 1) * 3 * FLOATS,
+                         soup.begin() + other * 3 * FLOATS);
+    }
+
+    auto start = Clock::now();
+    IndexedMesh mesh = buildIndexedMesh(soup, FLOATS);
+    auto indexed = Clock::now();
+    std::cout << "mesh: " << triangles << " triangles, " << soupVertices << " -> " << mesh.vertexCount()
+              << " vertices after dedupe (" << std::chrono::duration<double, std::milli>(indexed - start).count()
+              << " ms), FIFO cache of " << cacheSize << std::endl;
+    std::vector<Triangle> reference = canonicalTriangles(mesh);
+    print("indexed, shuffled     ", mesh, cacheSize);
+
+    start = Clock::now();
+    optimizeVertexCache(mesh.indices, mesh.vertexCount());
+    auto cacheDone = Clock::now();
+    print("vertex cache optimized", mesh, cacheSize);
+
+    optimizeVertexFetch(mesh);
+    auto fetchDone = Clock::now();
+    print("vertex fetch optimized", mesh, cacheSize);
+
+    bool same = canonicalTriangles(mesh) == reference;
+    std::cout << "  vertex cache " << std::chrono::duration<double, std::milli>(cacheDone - start).count()
+              << " ms, vertex fetch " << std::chrono::duration<double, std::milli>(fetchDone - cacheDone).count()
+              << " ms" << (same ? "" : "  TRIANGLES CHANGED") << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+// 网格导入基准：OBJ / glTF 文本解析（单线程 vs 任务系统）和二进制缓存加载的吞吐量，单位 MB/s
+// 用法：mesh_import_bench [源文件.obj/.gltf/.glb | 生成网格细分=1024]
+// 不给文件时生成一个圆环面 OBJ（细分² × 2 个三角形，v/vt/vn + 4 个材质）和内容相同的 .gltf + .bin，
+// 两种格式都导入一遍；同时校验缓存加载的结果和直接解析的逐字节一致
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+
+#include "my_meshImport.h"
+#include "my_jobSystem.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double mbPerSecond(uint64_t bytes, double ms) {
+    return ms > 0.0 ? bytes / (ms * 1000.0) : 0.0;
+}
+
+// 圆环面：顶点按网格排列，面按材质分成 4 段
+struct Torus {
+    std::vector<float> positions, normals, uvs;
+    std::vector<uint32_t> indices; // 每个面 3 个角，v / vt / vn 共用同一个下标
+    int segments = 0;
+};
+
+Torus makeTorus(int segments) {
+    const float PI = 3.14159265358979f;
+    Torus torus;
+    torus.segments = segments;
+    int rings = segments / 2;
+    for (int r = 0; r <= rings; ++r)
+        for (int s = 0; s <= segments; ++s) {
+            float u = 2.0f * PI * s / segments, v = 2.0f * PI * r / rings;
+            float nx = std::cos(v) * std::cos(u), ny = std::sin(v), nz = std::cos(v) * std::sin(u);
+            torus.positions.insert(torus.positions.end(), { std::cos(u) + 0.25f * nx, 0.25f * ny, std::sin(u) + 0.25f * nz });
+            torus.normals.insert(torus.normals.end(), { nx, ny, nz });
+            torus.uvs.insert(torus.uvs.end(), { (float)s / segments, (float)r / rings });
+        }
+    for (int r = 0; r < rings; ++r)
+        for (int s = 0; s < segments; ++s) {
+            uint32_t a = (uint32_t)(r * (segments + 1) + s), b = a + 1;
+            uint32_t c = a + (uint32_t)(segments + 1), d = c + 1;
+            torus.indices.insert(torus.indices.end(), { a, c, b, b, c, d });
+        }
+    return torus;
+}
+
+bool writeOBJ(const Torus& torus, const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    size_t vertexCount = torus.positions.size() / 3;
+    for (size_t i = 0; i < vertexCount; ++i)
+        std::fprintf(file, "v %.6f %.6f %.6f\n", torus.positions[i * 3], torus.positions[i * 3 + 1], torus.positions[i * 3 + 2]);
+    for (size_t i = 0; i < vertexCount; ++i)
+        std::fprintf(file, "vt %.6f %.6f\n", torus.uvs[i * 2], torus.uvs[i * 2 + 1]);
+    for (size_t i = 0; i < vertexCount; ++i)
+        std::fprintf(file, "vn %.6f %.6f %.6f\n", torus.normals[i * 3], torus.normals[i * 3 + 1], torus.normals[i * 3 + 2]);
+    size_t triangles = torus.indices.size() / 3;
+    for (size_t t = 0; t < triangles; ++t) {
+        if (t % ((triangles + 3) / 4) == 0)
+            std::fprintf(file, "usemtl material_%zu\n", t / ((triangles + 3) / 4));
+        uint32_t a = torus.indices[t * 3] + 1, b = torus.indices[t * 3 + 1] + 1, c = torus.indices[t * 3 + 2] + 1;
+        std::fprintf(file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, c, c, c);
+    }
+    return std::fclose(file) == 0;
+}
+
+// 同一个圆环面的 glTF：一个 mesh 4 个图元（每个材质一个），共用顶点属性，放在一个 .bin 里
+bool writeGLTF(const Torus& torus, const std::string& path, const std::string& binName) {
+    std::string binPath = (std::filesystem::path(path).parent_path() / binName).string();
+    std::ofstream bin(binPath, std::ios::binary | std::ios::trunc);
+    size_t vertexCount = torus.positions.size() / 3;
+    size_t positionBytes = torus.positions.size() * 4, normalBytes = torus.normals.size() * 4, uvBytes = torus.uvs.size() * 4;
+    bin.write(reinterpret_cast<const char*>(torus.positions.data()), (std::streamsize)positionBytes);
+    bin.write(reinterpret_cast<const char*>(torus.normals.data()), (std::streamsize)normalBytes);
+    bin.write(reinterpret_cast<const char*>(torus.uvs.data()), (std::streamsize)uvBytes);
+    bin.write(reinterpret_cast<const char*>(torus.indices.data()), (std::streamsize)(torus.indices.size() * 4));
+    if (!bin)
+        return false;
+    size_t indexStart = positionBytes + normalBytes + uvBytes;
+    size_t totalBytes = indexStart + torus.indices.size() * 4;
+
+    glm::vec3 lo(INFINITY), hi(-INFINITY);
+    for (size_t i = 0; i < vertexCount; ++i) {
+        glm::vec3 p(torus.positions[i * 3], torus.positions[i * 3 + 1], torus.positions[i * 3 + 2]);
+        lo = glm::min(lo, p);
+        hi = glm::max(hi, p);
+    }
+    size_t triangles = torus.indices.size() / 3;
+    size_t perMaterial = (triangles + 3) / 4;
+
+    std::ofstream json(path, std::ios::trunc);
+    json << "{\"asset\":{\"version\":\"2.0\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],"
+         << "\"nodes\":[{\"mesh\":0}],\"buffers\":[{\"uri\":\"" << binName << "\",\"byteLength\":" << totalBytes << "}],"
+         << "\"bufferViews\":["
+         << "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" << positionBytes << "},"
+         << "{\"buffer\":0,\"byteOffset\":" << positionBytes << ",\"byteLength\":" << normalBytes << "},"
+         << "{\"buffer\":0,\"byteOffset\":" << positionBytes + normalBytes << ",\"byteLength\":" << uvBytes << "},"
+         << "{\"buffer\":0,\"byteOffset\":" << indexStart << ",\"byteLength\":" << torus.indices.size() * 4 << "}],"
+         << "\"accessors\":["
+         << "{\"bufferView\":0,\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC3\",\"min\":["
+         << lo.x << "," << lo.y << "," << lo.z << "],\"max\":[" << hi.x << "," << hi.y << "," << hi.z << "]},"
+         << "{\"bufferView\":1,\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC3\"},"
+         << "{\"bufferView\":2,\"componentType\":5126,\"count\":" << vertexCount << ",\"type\":\"VEC2\"}";
+    for (size_t m = 0; m < 4; ++m) {
+        size_t first = std::min(triangles, m * perMaterial), last = std::min(triangles, (m + 1) * perMaterial);
+        json << ",{\"bufferView\":3,\"byteOffset\":" << first * 12 << ",\"componentType\":5125,\"count\":"
+             << (last - first) * 3 << ",\"type\":\"SCALAR\"}";
+    }
+    json << "],\"materials\":[";
+    for (size_t m = 0; m < 4; ++m)
+        json << (m ? "," : "") << "{\"name\":\"material_" << m << "\"}";
+    json << "],\"meshes\":[{\"primitives\":[";
+    for (size_t m = 0; m < 4; ++m)
+        json << (m ? "," : "") << "{\"attributes\":{\"POSITION\":0,\"NORMAL\":1,\"TEXCOORD_0\":2},\"indices\":" << 3 + m
+             << ",\"material\":" << m << "}";
+    json << "]}]}";
+    return (bool)json;
+}
+
+bool sameMesh(const MeshData& a, const MeshData& b) {
+    return a.vertexCount == b.vertexCount && a.indexCount == b.indexCount && a.materials == b.materials
+        && a.submeshes.size() == b.submeshes.size()
+        && std::memcmp(a.vertices(), b.vertices(), a.vertexBytes()) == 0
+        && std::memcmp(a.indices(), b.indices(), a.indexBytes()) == 0
+        && std::memcmp(a.submeshes.data(), b.submeshes.data(), a.submeshes.size() * sizeof(SubMesh)) == 0;
+}
+
+// 解析（单线程 / 任务系统）、写缓存、读缓存各一次，返回是否一致
+bool benchmark(const std::string& path, JobSystem& jobs) {
+    std::vector<std::string> dependencies;
+    auto start = Clock::now();
+    MeshData single = importMesh(path, nullptr, true, &dependencies);
+    double singleMs = msSince(start);
+    if (!single)
+        return false;
+    // .gltf 的数据主要在外部 .bin 里，一起算进吞吐量
+    std::error_code ec;
+    uint64_t bytes = std::filesystem::file_size(path, ec);
+    for (const std::string& dependency : dependencies)
+        bytes += std::filesystem::file_size(dependency, ec);
+    std::cout << path << " (" << bytes / (1024.0 * 1024.0) << " MiB with " << dependencies.size() << " buffers)" << std::endl;
+    start = Clock::now();
+    MeshData threaded = importMesh(path, &jobs);
+    double threadedMs = msSince(start);
+    start = Clock::now();
+    MeshData parsed = importMesh(path, &jobs, false);
+    double parseMs = msSince(start);
+    std::cout << "  " << single.triangleCount() << " triangles, " << single.vertexCount << " vertices, "
+              << single.submeshes.size() << " submeshes" << std::endl;
+    std::cout << "  parse + optimize, 1 thread:   " << singleMs << " ms, " << mbPerSecond(bytes, singleMs) << " MB/s" << std::endl;
+    std::cout << "  parse only, " << jobs.size() << " threads:        " << parseMs << " ms, "
+              << mbPerSecond(bytes, parseMs) << " MB/s" << std::endl;
+    std::cout << "  parse + optimize, " << jobs.size() << " threads:  " << threadedMs << " ms, "
+              << mbPerSecond(bytes, threadedMs) << " MB/s" << std::endl;
+
+    // 先删掉旧缓存，第一次必然未命中
+    MeshCache cache;
+    std::filesystem::remove(MeshCache::pathFor(path), ec);
+    start = Clock::now();
+    MeshData built = cache.loadOrImport(path, &jobs);
+    double missMs = msSince(start);
+    start = Clock::now();
+    MeshData cached = cache.loadOrImport(path, &jobs);
+    double hitMs = msSince(start);
+    // 没有 GL 上下文，用一次整块拷贝代替 glBufferData 从映射读数据的开销
+    std::vector<uint8_t> upload(cached.vertexBytes() + cached.indexBytes());
+    start = Clock::now();
+    if (cached.contiguousGeometry())
+        std::memcpy(upload.data(), cached.contiguousGeometry(), upload.size());
+    double copyMs = msSince(start);
+    uint64_t cacheBytes = std::filesystem::file_size(MeshCache::pathFor(path), ec);
+    std::cout << "  cache miss (parse + write):   " << missMs << " ms" << std::endl;
+    std::cout << "  cache hit (map + prefault):   " << hitMs << " ms, " << cacheBytes / (1024.0 * 1024.0) << " MiB, "
+              << (cached.mapping ? "mapped" : "NOT MAPPED") << std::endl;
+    std::cout << "  cache hit + one-copy upload:  " << hitMs + copyMs << " ms, "
+              << mbPerSecond(cacheBytes, hitMs + copyMs) << " MB/s, "
+              << threadedMs / std::max(hitMs + copyMs, 1e-6) << "x faster than parsing" << std::endl;
+
+    bool same = sameMesh(single, threaded) && sameMesh(single, built) && sameMesh(single, cached) && cached.mapping;
+    if (!same)
+        std::cout << "  MISMATCH between single-threaded, threaded and cached results" << std::endl;
+
+    // 把第一个子网格的顶点范围改到数组外面：缓存必须被拒绝并从源文件重建，而不是映射出越界的子网格
+    size_t submeshOffset = (128 + cached.vertexBytes() + cached.indexBytes() + 15) / 16 * 16;
+    cached = MeshData();
+    bool rejected = false;
+    {
+        std::fstream corrupt(MeshCache::pathFor(path), std::ios::binary | std::ios::in | std::ios::out);
+        uint32_t vertexCount = 0xFFFFFFFFu;
+        corrupt.seekp((std::streamoff)(submeshOffset + offsetof(SubMesh, vertexCount)));
+        corrupt.write(reinterpret_cast<const char*>(&vertexCount), sizeof(vertexCount));
+        rejected = (bool)corrupt;
+    }
+    unsigned missesBefore = cache.misses;
+    MeshData rebuilt = cache.loadOrImport(path, &jobs);
+    rejected = rejected && cache.misses == missesBefore + 1 && sameMesh(single, rebuilt);
+    std::cout << "  corrupted submesh range:      " << (rejected ? "rejected, rebuilt from source" : "NOT REJECTED") << std::endl;
+    return same && rejected;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    JobSystem jobs;
+    std::string arg = argc > 1 ? argv[1] : "1024";
+    bool generated = !arg.empty() && arg.find_first_not_of("0123456789") == std::string::npos;
+    if (!generated)
+        return benchmark(arg, jobs) ? 0 : 1;
+
+    int segments = std::max(8, std::stoi(arg));
+    Torus torus = makeTorus(segments);
+    std::string obj = "mesh_import_bench.obj", gltf = "mesh_import_bench.gltf";
+    auto start = Clock::now();
+    if (!writeOBJ(torus, obj) || !writeGLTF(torus, gltf, "mesh_import_bench.bin")) {
+        std::cerr << "ERROR::MESH_IMPORT_BENCH::WRITE_FAILED" << std::endl;
+        return 1;
+    }
+    std::cout << "generated torus, " << torus.indices.size() / 3 << " triangles (" << msSince(start) << " ms)" << std::endl;
+
+    bool ok = benchmark(obj, jobs);
+    ok = benchmark(gltf, jobs) && ok;
+
+    // 两种格式描述的是同一个网格：三角形数、子网格数和包围盒应当一致
+    MeshData fromOBJ = importMesh(obj, &jobs), fromGLTF = importMesh(gltf, &jobs);
+    bool agree = fromOBJ.triangleCount() == fromGLTF.triangleCount() && fromOBJ.submeshes.size() == fromGLTF.submeshes.size()
+        && glm::length(fromOBJ.boundsMin - fromGLTF.boundsMin) < 1e-4f && glm::length(fromOBJ.boundsMax - fromGLTF.boundsMax) < 1e-4f;
+    std::cout << "OBJ and glTF imports " << (agree ? "agree" : "DISAGREE") << std::endl;
+
+    for (const char* file : { "mesh_import_bench.obj", "mesh_import_bench.obj.mesh", "mesh_import_bench.gltf",
+                              "mesh_import_bench.gltf.mesh", "mesh_import_bench.bin" })
+        std::remove(file);
+    return ok && agree ? 0 : 1;
+}
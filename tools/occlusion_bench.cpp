@@ -0,0 +1,127 @@
+// CPU 遮挡剔除基准：几面由立方体拉伸成的墙做遮挡体，后面散布大量小立方体
+// 用法：occlusion_bench [物体数量=20000] [帧数=100]
+// 报告每帧光栅化 / Hi-Z / 测试的耗时和剔除率，并校验标量、SIMD、多线程三种光栅化的深度缓冲逐字节一致
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "my_geometry.h"
+#include "my_frustum.h"
+#include "my_occlusion.h"
+#include "my_jobSystem.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<glm::mat4> makeOccluders() {
+    std::vector<glm::mat4> walls;
+    auto wall = [&](glm::vec3 position, glm::vec3 size) {
+        walls.push_back(glm::scale(glm::translate(glm::mat4(1.0f), position), size));
+    };
+    wall(glm::vec3(0.0f, 0.0f, -12.0f), glm::vec3(14.0f, 8.0f, 1.0f));    // 正前方的大墙
+    wall(glm::vec3(-14.0f, 0.0f, -25.0f), glm::vec3(10.0f, 12.0f, 1.0f)); // 左后方
+    wall(glm::vec3(14.0f, 0.0f, -25.0f), glm::vec3(10.0f, 12.0f, 1.0f));  // 右后方
+    wall(glm::vec3(0.0f, -4.5f, -40.0f), glm::vec3(60.0f, 1.0f, 60.0f));  // 地面
+    return walls;
+}
+
+void renderOccluders(OcclusionBuffer& buffer, const glm::mat4& viewProj, const std::vector<glm::mat4>& walls,
+                     JobSystem* jobs, CullPath path) {
+    buffer.begin(viewProj);
+    for (const glm::mat4& model : walls)
+        buffer.addOccluder(CUBE_VERTICES, CUBE_VERTEX_COUNT, model);
+    buffer.rasterize(jobs, path);
+}
+
+bool sameDepth(const OcclusionBuffer& a, const OcclusionBuffer& b) {
+    for (int level = 0; level < a.levels(); ++level) {
+        size_t bytes = (size_t)a.levelWidth(level) * a.levelHeight(level) * sizeof(float);
+        if (std::memcmp(a.depth(level), b.depth(level), bytes) != 0)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 20000;
+    int frames = argc > 2 ? std::stoi(argv[2]) : 100;
+
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+    std::vector<glm::mat4> walls = makeOccluders();
+
+    AABBSoA bounds;
+    bounds.reserve(count);
+    uint32_t seed = 12345;
+    auto random = [&](float lo, float hi) {
+        seed = seed * 1664525u + 1013904223u;
+        return lo + (hi - lo) * (float)(seed >> 8) / 16777216.0f;
+    };
+    for (size_t i = 0; i < count; ++i)
+        bounds.push(glm::vec3(random(-40.0f, 40.0f), random(-4.0f, 6.0f), random(-90.0f, -5.0f)), glm::vec3(0.25f));
+
+    JobSystem jobs;
+    OcclusionBuffer scalar, simd, threaded;
+    std::cout << "occlusion culling " << count << " objects, " << walls.size() * CUBE_VERTEX_COUNT / 3
+              << " occluder triangles, " << simd.bufferWidth() << "x" << simd.bufferHeight() << " depth, "
+#if defined(MY_SIMD_AVX2)
+              << "AVX2"
+#elif defined(MY_SIMD_SSE2)
+              << "SSE2"
+#else
+              << "no SIMD"
+#endif
+              << ", " << jobs.size() << " threads" << std::endl;
+
+    // 相机沿 x 来回平移，每帧重新光栅化；三种光栅化方式每帧都比对一次
+    bool allMatch = true;
+    double scalarUs = 0.0, simdUs = 0.0, threadedUs = 0.0, hizUs = 0.0, frustumUs = 0.0, testUs = 0.0;
+    size_t frustumVisible = 0, finalVisible = 0;
+    std::vector<uint32_t> visible;
+    for (int f = 0; f < frames; ++f) {
+        float x = 6.0f * std::sin(f * 0.05f);
+        glm::mat4 viewProj = projection * glm::lookAt(glm::vec3(x, 1.0f, 0.0f), glm::vec3(x, 1.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+        renderOccluders(scalar, viewProj, walls, nullptr, CullPath::Scalar);
+        renderOccluders(simd, viewProj, walls, nullptr, CullPath::SIMD);
+        renderOccluders(threaded, viewProj, walls, &jobs, CullPath::SIMD);
+        scalarUs += scalar.stats().rasterUs;
+        simdUs += simd.stats().rasterUs;
+        threadedUs += threaded.stats().rasterUs;
+        hizUs += simd.stats().hizUs;
+        allMatch = allMatch && sameDepth(scalar, simd) && sameDepth(simd, threaded);
+
+        auto start = Clock::now();
+        cullAABBs(Frustum::fromMatrix(viewProj), bounds, visible);
+        auto culled = Clock::now();
+        frustumVisible += visible.size();
+        simd.cullAABBs(bounds, visible);
+        frustumUs += std::chrono::duration<double, std::micro>(culled - start).count();
+        testUs += std::chrono::duration<double, std::micro>(Clock::now() - culled).count();
+        finalVisible += visible.size();
+    }
+
+    // 墙正后方的物体必须被剔除，墙前面的必须保留
+    OcclusionBuffer check;
+    glm::mat4 viewProj = projection * glm::lookAt(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    renderOccluders(check, viewProj, walls, nullptr, CullPath::SIMD);
+    bool sane = !check.isVisible(glm::vec3(0.0f, 1.0f, -30.0f), glm::vec3(0.5f))
+             && check.isVisible(glm::vec3(0.0f, 1.0f, -8.0f), glm::vec3(0.5f));
+
+    std::cout << "  raster per frame: scalar " << scalarUs / frames << " us, SIMD " << simdUs / frames << " us ("
+              << scalarUs / simdUs << "x), SIMD + jobs " << threadedUs / frames << " us; Hi-Z build "
+              << hizUs / frames << " us" << (allMatch ? "" : "  MISMATCH") << "\n"
+              << "  test per frame: frustum " << frustumUs / frames << " us, occlusion " << testUs / frames << " us\n"
+              << "  per frame: " << frustumVisible / frames << " in frustum, " << finalVisible / frames
+              << " after occlusion (" << (frustumVisible ? 100.0 * (frustumVisible - finalVisible) / frustumVisible : 0.0)
+              << "% of frustum-visible objects occluded)" << (sane ? "" : "  SANITY CHECK FAILED") << std::endl;
+    return allMatch && sane ? 0 : 1;
+}
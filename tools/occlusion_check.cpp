@@ -0,0 +1,247 @@
+// CPU 遮挡剔除的正确性检查（纯 CPU，不需要 GL 上下文）
+// 用法：occlusion_check [随机场景数=20]
+// 检查：
+//   raster     标量、SIMD、SIMD + 任务系统三种光栅化的深度缓冲和每级 Hi-Z 逐字节一致
+//   hiz        每级的每个纹素等于上一级对应 2x2（缩到 1 的那一维重复）里最远的深度
+//   wall       墙正后方的物体被剔除；墙前面、露出墙边、跨过近平面、在相机后面的物体都保留
+//   conservative 随机场景里逐像素暴力判断“能看见”的包围盒，isVisible 一定也判成可见
+//   cullAABBs  和逐个调用 isVisible 的结果一致，统计数对得上
+//   empty      没有遮挡体，或者遮挡体全是退化三角形 / 在相机后面时，什么都不剔除
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "my_geometry.h"
+#include "my_frustum.h"
+#include "my_occlusion.h"
+#include "my_jobSystem.h"
+#include "check_common.h"
+
+namespace {
+
+Checker checker("OCCLUSION_CHECK");
+
+const glm::mat4 PROJECTION = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+
+glm::mat4 viewProjFrom(const glm::vec3& eye, const glm::vec3& target) {
+    return PROJECTION * glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+glm::mat4 box(const glm::vec3& position, const glm::vec3& size) {
+    return glm::scale(glm::translate(glm::mat4(1.0f), position), size);
+}
+
+void render(OcclusionBuffer& buffer, const glm::mat4& viewProj, const std::vector<glm::mat4>& occluders, JobSystem* jobs,
+            CullPath path) {
+    buffer.begin(viewProj);
+    for (const glm::mat4& model : occluders)
+        buffer.addOccluder(CUBE_VERTICES, CUBE_VERTEX_COUNT, model);
+    buffer.rasterize(jobs, path);
+}
+
+bool sameDepth(const OcclusionBuffer& a, const OcclusionBuffer& b) {
+    for (int level = 0; level < a.levels(); ++level) {
+        size_t bytes = (size_t)a.levelWidth(level) * a.levelHeight(level) * sizeof(float);
+        if (std::memcmp(a.depth(level), b.depth(level), bytes) != 0)
+            return false;
+    }
+    return true;
+}
+
+void checkHiZ(const OcclusionBuffer& buffer, const std::string& tag) {
+    for (int level = 1; level < buffer.levels(); ++level) {
+        int sw = buffer.levelWidth(level - 1), sh = buffer.levelHeight(level - 1);
+        int dw = buffer.levelWidth(level), dh = buffer.levelHeight(level);
+        checker.expect(dw == std::max(1, sw / 2) && dh == std::max(1, sh / 2), "HIZ_LEVEL_SIZE " + tag + " level " + std::to_string(level));
+        const float* src = buffer.depth(level - 1);
+        const float* dst = buffer.depth(level);
+        bool same = true;
+        for (int y = 0; y < dh && same; ++y)
+            for (int x = 0; x < dw && same; ++x) {
+                float farthest = 0.0f;
+                for (int sy = y * 2; sy <= std::min(y * 2 + 1, sh - 1); ++sy)
+                    for (int sx = x * 2; sx <= std::min(x * 2 + 1, sw - 1); ++sx)
+                        farthest = std::max(farthest, src[(size_t)sy * sw + sx]);
+                same = dst[(size_t)y * dw + x] == farthest;
+            }
+        checker.expect(same, "HIZ_NOT_MAX_OF_CHILDREN " + tag + " level " + std::to_string(level));
+    }
+    checker.expect(buffer.levelWidth(buffer.levels() - 1) == 1 && buffer.levelHeight(buffer.levels() - 1) == 1,
+                   "HIZ_TOP_NOT_1x1 " + tag);
+}
+
+// 暴力参考：8 个角逐个投影，在全分辨率深度缓冲里看矩形内部有没有比包围盒最近深度还远的像素
+// 矩形往里收一个像素、深度留一点余量，只在“肯定看得见”时返回 true，避免和被测代码在舍入上较劲
+bool surelyVisible(const OcclusionBuffer& buffer, const glm::mat4& viewProj, const glm::vec3& center, const glm::vec3& extent) {
+    const int w = buffer.bufferWidth(), h = buffer.bufferHeight();
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f, minZ = 1e30f;
+    for (int k = 0; k < 8; ++k) {
+        glm::vec3 corner = center + glm::vec3((k & 1) ? extent.x : -extent.x, (k & 2) ? extent.y : -extent.y,
+                                              (k & 4) ? extent.z : -extent.z);
+        glm::vec4 clip = viewProj * glm::vec4(corner, 1.0f);
+        if (clip.w <= 0.01f)
+            return false;
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        minX = std::min(minX, (ndc.x * 0.5f + 0.5f) * w);
+        maxX = std::max(maxX, (ndc.x * 0.5f + 0.5f) * w);
+        minY = std::min(minY, (ndc.y * 0.5f + 0.5f) * h);
+        maxY = std::max(maxY, (ndc.y * 0.5f + 0.5f) * h);
+        minZ = std::min(minZ, ndc.z * 0.5f + 0.5f);
+    }
+    if (minZ <= 0.0f)
+        return false;
+    int x0 = std::max(0, (int)minX + 1), x1 = std::min(w - 1, (int)maxX - 1);
+    int y0 = std::max(0, (int)minY + 1), y1 = std::min(h - 1, (int)maxY - 1);
+    const float* depth = buffer.depth(0);
+    for (int y = y0; y <= y1; ++y)
+        for (int x = x0; x <= x1; ++x)
+            if (depth[(size_t)y * w + x] > minZ + 1e-4f)
+                return true;
+    return false;
+}
+
+void checkWall() {
+    OcclusionBuffer buffer;
+    glm::mat4 viewProj = viewProjFrom(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, -1.0f));
+    // 一面 14x8 的墙挡在 z = -12，相机在原点朝 -z 看
+    render(buffer, viewProj, { box(glm::vec3(0.0f, 1.0f, -12.0f), glm::vec3(14.0f, 8.0f, 1.0f)) }, nullptr, CullPath::SIMD);
+    checker.expect(buffer.stats().trianglesSetup > 0, "WALL_NOT_RASTERIZED");
+    checkHiZ(buffer, "wall");
+
+    checker.expect(!buffer.isVisible(glm::vec3(0.0f, 1.0f, -30.0f), glm::vec3(0.5f)), "BEHIND_WALL_VISIBLE");
+    checker.expect(!buffer.isVisible(glm::vec3(2.0f, 2.0f, -20.0f), glm::vec3(1.0f)), "BEHIND_WALL_OFFSET_VISIBLE");
+    checker.expect(buffer.isVisible(glm::vec3(0.0f, 1.0f, -8.0f), glm::vec3(0.5f)), "IN_FRONT_OF_WALL_CULLED");
+    // 紧贴墙面、和墙有一半深度重叠
+    checker.expect(buffer.isVisible(glm::vec3(0.0f, 1.0f, -11.5f), glm::vec3(0.5f)), "TOUCHING_WALL_CULLED");
+    // 在墙后面但露出墙的上边缘（墙的左右两边已经在屏幕外）
+    checker.expect(buffer.isVisible(glm::vec3(0.0f, 5.5f, -13.5f), glm::vec3(0.5f)), "PAST_WALL_EDGE_CULLED");
+    // 跨过近平面、完全在相机后面、在视锥外面都按可见处理
+    checker.expect(buffer.isVisible(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.5f)), "STRADDLING_NEAR_PLANE_CULLED");
+    checker.expect(buffer.isVisible(glm::vec3(0.0f, 1.0f, 10.0f), glm::vec3(0.5f)), "BEHIND_CAMERA_CULLED");
+    checker.expect(buffer.isVisible(glm::vec3(200.0f, 1.0f, -30.0f), glm::vec3(0.5f)), "OUTSIDE_FRUSTUM_CULLED");
+}
+
+void checkEmpty() {
+    glm::mat4 viewProj = viewProjFrom(glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, -1.0f));
+    AABBSoA bounds;
+    CheckRandom random{ 777u };
+    for (int i = 0; i < 500; ++i)
+        bounds.push(glm::vec3(random(-20.0f, 20.0f), random(-5.0f, 5.0f), random(-90.0f, -1.0f)), glm::vec3(random(0.05f, 2.0f)));
+
+    auto allVisible = [&](OcclusionBuffer& buffer, const std::string& tag) {
+        std::vector<uint32_t> indices(bounds.size());
+        for (size_t i = 0; i < indices.size(); ++i)
+            indices[i] = (uint32_t)i;
+        checker.expect(buffer.cullAABBs(bounds, indices) == bounds.size(), "CULLED_WITHOUT_OCCLUDERS " + tag);
+        const float* depth = buffer.depth(0);
+        bool cleared = true;
+        for (size_t i = 0; i < (size_t)buffer.bufferWidth() * buffer.bufferHeight(); ++i)
+            cleared = cleared && depth[i] == 1.0f;
+        checker.expect(cleared, "DEPTH_NOT_CLEARED " + tag);
+    };
+
+    OcclusionBuffer empty;
+    render(empty, viewProj, {}, nullptr, CullPath::SIMD);
+    allVisible(empty, "empty");
+
+    // 压扁成零面积的立方体、整个在相机后面的立方体：一个三角形都不应该进入光栅化
+    OcclusionBuffer degenerate;
+    render(degenerate, viewProj,
+           { box(glm::vec3(0.0f, 1.0f, -10.0f), glm::vec3(10.0f, 0.0f, 0.0f)),
+             box(glm::vec3(0.0f, 1.0f, 20.0f), glm::vec3(30.0f, 30.0f, 1.0f)) },
+           nullptr, CullPath::SIMD);
+    checker.expect(degenerate.stats().trianglesSubmitted == 2 * CUBE_VERTEX_COUNT / 3, "TRIANGLES_SUBMITTED");
+    checker.expect(degenerate.stats().trianglesSetup == 0, "DEGENERATE_TRIANGLES_SET_UP");
+    allVisible(degenerate, "degenerate");
+
+    // 上一帧的遮挡体不能留到下一帧
+    OcclusionBuffer reused;
+    render(reused, viewProj, { box(glm::vec3(0.0f, 1.0f, -12.0f), glm::vec3(14.0f, 8.0f, 1.0f)) }, nullptr, CullPath::SIMD);
+    render(reused, viewProj, {}, nullptr, CullPath::SIMD);
+    allVisible(reused, "reused");
+}
+
+// 随机相机 + 随机遮挡体：三种光栅化一致、Hi-Z 正确、剔除保守、cullAABBs 和 isVisible 一致
+void checkRandomScenes(int scenes, JobSystem& jobs) {
+    size_t tested = 0, occluded = 0, surelyVisibleCount = 0;
+    for (int s = 0; s < scenes; ++s) {
+        CheckRandom random{ 4242u + (uint32_t)s * 7919u };
+        std::string tag = "scene " + std::to_string(s);
+        glm::vec3 eye(random(-10.0f, 10.0f), random(0.0f, 4.0f), random(-5.0f, 5.0f));
+        glm::vec3 target = eye + glm::vec3(random(-0.5f, 0.5f), random(-0.3f, 0.3f), -1.0f);
+        glm::mat4 viewProj = viewProjFrom(eye, target);
+
+        std::vector<glm::mat4> occluders;
+        int count = 2 + (int)random(0.0f, 10.0f);
+        for (int i = 0; i < count; ++i)
+            occluders.push_back(box(glm::vec3(random(-25.0f, 25.0f), random(-3.0f, 5.0f), random(-60.0f, -8.0f)),
+                                    glm::vec3(random(1.0f, 16.0f), random(1.0f, 10.0f), random(0.5f, 4.0f))));
+
+        OcclusionBuffer scalar, simd, threaded;
+        render(scalar, viewProj, occluders, nullptr, CullPath::Scalar);
+        render(simd, viewProj, occluders, nullptr, CullPath::SIMD);
+        render(threaded, viewProj, occluders, &jobs, CullPath::SIMD);
+        checker.expect(sameDepth(scalar, simd), "SCALAR_SIMD_DEPTH_MISMATCH " + tag);
+        checker.expect(sameDepth(simd, threaded), "THREADED_DEPTH_MISMATCH " + tag);
+        checkHiZ(simd, tag);
+
+        AABBSoA bounds;
+        for (int i = 0; i < 2000; ++i)
+            bounds.push(glm::vec3(random(-40.0f, 40.0f), random(-4.0f, 8.0f), random(-90.0f, -2.0f)),
+                        glm::vec3(random(0.05f, 1.5f), random(0.05f, 1.5f), random(0.05f, 1.5f)));
+        std::vector<uint32_t> indices;
+        cullAABBs(Frustum::fromMatrix(viewProj), bounds, indices);
+        std::vector<uint32_t> inFrustum = indices;
+
+        std::vector<bool> visible(bounds.size(), false);
+        bool conservative = true;
+        for (uint32_t i : inFrustum) {
+            glm::vec3 center(bounds.cx[i], bounds.cy[i], bounds.cz[i]), extent(bounds.ex[i], bounds.ey[i], bounds.ez[i]);
+            visible[i] = simd.isVisible(center, extent);
+            if (surelyVisible(simd, viewProj, center, extent)) {
+                ++surelyVisibleCount;
+                conservative = conservative && visible[i];
+            }
+        }
+        checker.expect(conservative, "VISIBLE_BOX_CULLED " + tag);
+
+        size_t kept = simd.cullAABBs(bounds, indices);
+        bool agree = kept == indices.size();
+        size_t expected = 0;
+        for (uint32_t i : inFrustum)
+            expected += visible[i] ? 1 : 0;
+        for (uint32_t i : indices)
+            agree = agree && visible[i];
+        checker.expect(agree && kept == expected, "CULL_AABBS_DISAGREES_WITH_IS_VISIBLE " + tag);
+        checker.expect(simd.stats().tested == inFrustum.size() && simd.stats().occluded == inFrustum.size() - kept,
+                       "CULL_STATS " + tag);
+        tested += inFrustum.size();
+        occluded += inFrustum.size() - kept;
+    }
+    std::cout << "  " << scenes << " random scenes: " << tested << " boxes in frustum, " << occluded << " occluded, "
+              << surelyVisibleCount << " checked against the per-pixel reference" << std::endl;
+    checker.expect(occluded > 0, "RANDOM_SCENES_CULLED_NOTHING");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int scenes = argc > 1 ? std::stoi(argv[1]) : 20;
+
+    // 宽高向上取到 2 的幂，Hi-Z 一直缩到 1x1
+    OcclusionBuffer odd(200, 100);
+    checker.expect(odd.bufferWidth() == 256 && odd.bufferHeight() == 128, "BUFFER_SIZE_NOT_POWER_OF_TWO");
+
+    JobSystem jobs;
+    checkWall();
+    checkEmpty();
+    checkRandomScenes(scenes, jobs);
+
+    return checker.finish();
+}
@@ -0,0 +1,253 @@
+// 渲染队列基准：材质很多的场景，按录制顺序提交 vs 排序后提交的状态切换次数，以及录制 / 排序耗时
+// 用法：render_queue_bench [物体数量=10000] [帧数=200] [工作线程数=核数-1]
+// 场景由几百种“道具”（程序 + 两张纹理 + 网格）随机摆放而成，10% 的物体是透明的
+// 录制包括每个物体的视锥测试、模型矩阵计算和 uniform 打包，分别在单线程和任务系统上跑一遍
+// 不需要 GL 上下文：只比较状态切换次数，校验排序结果符合键的约定，并校验多线程录制的排序结果和单线程一致
+// （包括同一帧分两次调用 recordParallel、以及 record / recordParallel / record 混用的情况）
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "my_renderQueue.h"
+#include "my_frustum.h"
+#include "my_jobSystem.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Prop {
+    GLuint program;
+    GLuint vao;
+    GLuint diffuse;
+    GLuint specular;
+    bool transparent;
+};
+
+struct Object {
+    uint32_t prop;
+    glm::vec3 position;
+    float spin;
+};
+
+struct Scene {
+    std::vector<Prop> props;
+    std::vector<Object> objects;
+    Uniform model;
+    Uniform tint;
+};
+
+// 录制 [first, last) 范围的物体：视锥外的跳过，其余算模型矩阵并生成绘制包
+void recordObjects(const Scene& scene, const Frustum& frustum, const glm::vec3& eye, float time,
+                   CommandList& list, size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+        const Object& o = scene.objects[i];
+        if (!frustum.containsSphere(o.position, 0.9f))
+            continue;
+        const Prop& p = scene.props[o.prop];
+        DrawPacket* packet = list.record(p.transparent ? RenderPass::Transparent : RenderPass::Opaque,
+                                         p.program, p.vao, glm::length(o.position - eye));
+        if (!packet)
+            return;
+        packet->setTexture(0, GL_TEXTURE_2D, p.diffuse);
+        packet->setTexture(1, GL_TEXTURE_2D, p.specular);
+        packet->setElements(GL_TRIANGLES, 36, GL_UNSIGNED_SHORT);
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), o.position);
+        model = glm::rotate(model, time * o.spin, glm::vec3(0.3f, 1.0f, 0.2f));
+        list.setUniform(packet, scene.model, glm::scale(model, glm::vec3(0.5f)));
+        if (p.transparent)
+            list.setUniform(packet, scene.tint, glm::vec4(1.0f, 1.0f, 1.0f, 0.5f));
+    }
+}
+
+// 两次排序结果逐包比较（绘制包在不同的分配器里，只能比内容）
+bool samePackets(const RenderQueue& a, const RenderQueue& b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        const DrawPacket& x = *a.sortedPackets()[i];
+        const DrawPacket& y = *b.sortedPackets()[i];
+        if (x.program != y.program || x.vao != y.vao || x.depth != y.depth || x.textures[0] != y.textures[0]
+            || std::memcmp(x.uniforms->data, y.uniforms->data, sizeof(glm::mat4)) != 0)
+            return false;
+    }
+    return true;
+}
+
+// 排序结果必须满足：键不减；同一通道内不透明的从前往后、透明的从后往前
+bool checkOrder(const RenderQueue& queue) {
+    const DrawPacket* const* packets = queue.sortedPackets();
+    for (size_t i = 1; i < queue.size(); ++i) {
+        const DrawPacket& a = *packets[i - 1];
+        const DrawPacket& b = *packets[i];
+        if (RenderQueue::makeKey(a) > RenderQueue::makeKey(b))
+            return false;
+        // 键里的深度只有 24 位（约 1.5e-5 的相对精度），比较时留出截断误差
+        if (a.pass == RenderPass::Transparent && b.pass == RenderPass::Transparent && a.depth < b.depth * 0.9999f)
+            return false;
+        if (a.pass == RenderPass::Opaque && a.program == b.program && a.vao == b.vao
+            && a.textures[0] == b.textures[0] && a.textures[1] == b.textures[1] && a.depth * 0.9999f > b.depth)
+            return false;
+    }
+    return true;
+}
+
+// 所有绘制包的键都相同，排序后只能保持录制顺序：record、recordParallel、再 record、再 recordParallel 交替录制，
+// 用 int uniform 记下每个包的序号，排序后必须还是 0, 1, 2, ...
+bool checkMixedOrder(JobSystem& jobs) {
+    const size_t SEGMENT = 1000;
+    RenderQueue queue(8 * SEGMENT, 8 * SEGMENT * 128);
+    Uniform order;
+    order.location = 0;
+    auto recordRange = [&](CommandList& list, size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            list.setUniform(list.record(RenderPass::Opaque, 1, 1, 1.0f), order, (int)i);
+    };
+    bool same = true;
+    for (int frame = 0; frame < 3; ++frame) {
+        queue.begin();
+        size_t next = 0;
+        for (int round = 0; round < 2; ++round) {
+            for (size_t i = next; i < next + SEGMENT; ++i)
+                queue.setUniform(queue.record(RenderPass::Opaque, 1, 1, 1.0f), order, (int)i);
+            next += SEGMENT;
+            queue.recordParallel(jobs, SEGMENT, [&](CommandList& list, size_t first, size_t last) {
+                recordRange(list, next + first, next + last);
+            });
+            next += SEGMENT;
+            // recordParallel 退化成单线程的情况（只有一项）也要排在后面
+            queue.recordParallel(jobs, 1, [&](CommandList& list, size_t first, size_t last) {
+                recordRange(list, next + first, next + last);
+            });
+            next += 1;
+        }
+        recordRange(queue.commands(), next, next + SEGMENT);
+        next += SEGMENT;
+
+        queue.sort();
+        same = same && queue.size() == next;
+        for (size_t i = 0; i < queue.size() && same; ++i) {
+            int value;
+            std::memcpy(&value, queue.sortedPackets()[i]->uniforms->data, sizeof(value));
+            same = value == (int)i;
+        }
+    }
+    return same;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 10000;
+    int frames = argc > 2 ? std::stoi(argv[2]) : 200;
+
+    uint32_t seed = 12345;
+    auto random = [&](uint32_t n) {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) % n;
+    };
+    auto randomFloat = [&](float lo, float hi) { return lo + (hi - lo) * random(1u << 20) / float(1u << 20); };
+
+    // 8 个程序、48 个网格、192 张纹理，组合成 400 种道具
+    const uint32_t PROGRAMS = 8, MESHES = 48, TEXTURES = 192, PROPS = 400;
+    Scene scene;
+    scene.props.resize(PROPS);
+    for (Prop& p : scene.props)
+        p = Prop{ 1 + random(PROGRAMS), 1 + random(MESHES), 1 + random(TEXTURES), 1 + random(TEXTURES), random(10) == 0 };
+
+    scene.objects.resize(count);
+    for (Object& o : scene.objects) {
+        o.prop = random(PROPS);
+        o.position = glm::vec3(randomFloat(-50.0f, 50.0f), randomFloat(-5.0f, 5.0f), randomFloat(-50.0f, 50.0f));
+        o.spin = randomFloat(-1.0f, 1.0f);
+    }
+    scene.model.location = 0;
+    scene.tint.location = 1;
+
+    JobSystem jobs(argc > 3 ? (unsigned)std::stoul(argv[3]) : JobSystem::defaultWorkerCount());
+    RenderQueue serial(count, count * 256);
+    RenderQueue parallel(count, count * 256);
+    RenderQueue split(count, count * 256);
+    std::cout << "render queue: " << count << " objects, " << PROPS << " props, " << PROGRAMS << " programs, "
+              << TEXTURES << " textures, " << MESHES << " meshes, " << jobs.size() << " threads" << std::endl;
+
+    // 相机在场景外绕圈往里看，每帧重新录制并排序
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 800.0f / 600.0f, 0.1f, 200.0f);
+    double recordUs = 0.0, parallelUs = 0.0, sortUs = 0.0, stdSortUs = 0.0;
+    RenderQueue::Stats unsorted, sorted;
+    bool ordered = true, identical = true;
+    std::vector<uint64_t> keys(count);
+    for (int f = 0; f < frames; ++f) {
+        float time = f * 0.03f;
+        glm::vec3 eye(60.0f * std::cos(time), 10.0f, 60.0f * std::sin(time));
+        glm::mat4 viewProj = projection * glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        Frustum frustum = Frustum::fromMatrix(viewProj);
+
+        auto start = Clock::now();
+        serial.begin();
+        recordObjects(scene, frustum, eye, time, serial.commands(), 0, count);
+        auto recorded = Clock::now();
+        serial.sort();
+        auto done = Clock::now();
+        parallel.begin();
+        parallel.recordParallel(jobs, count, [&](CommandList& list, size_t first, size_t last) {
+            recordObjects(scene, frustum, eye, time, list, first, last);
+        });
+        auto parallelDone = Clock::now();
+        parallel.sort();
+        // 前后两半分两次录制：第二次不能覆盖第一次已经合并进来的列表
+        split.begin();
+        size_t half = count / 2;
+        split.recordParallel(jobs, half, [&](CommandList& list, size_t first, size_t last) {
+            recordObjects(scene, frustum, eye, time, list, first, last);
+        });
+        split.recordParallel(jobs, count - half, [&](CommandList& list, size_t first, size_t last) {
+            recordObjects(scene, frustum, eye, time, list, half + first, half + last);
+        });
+        split.sort();
+        recordUs += std::chrono::duration<double, std::micro>(recorded - start).count();
+        sortUs += std::chrono::duration<double, std::micro>(done - recorded).count();
+        parallelUs += std::chrono::duration<double, std::micro>(parallelDone - done).count();
+
+        // 对照：同样的键用 std::sort
+        for (size_t i = 0; i < serial.size(); ++i)
+            keys[i] = RenderQueue::makeKey(*serial.recordedPackets()[i]);
+        auto stdStart = Clock::now();
+        std::sort(keys.begin(), keys.begin() + serial.size());
+        stdSortUs += std::chrono::duration<double, std::micro>(Clock::now() - stdStart).count();
+
+        if (f == 0) {
+            unsorted = RenderQueue::countStateChanges(serial.recordedPackets(), serial.size());
+            sorted = RenderQueue::countStateChanges(serial.sortedPackets(), serial.size());
+        }
+        ordered = ordered && checkOrder(serial);
+        identical = identical && samePackets(serial, parallel) && samePackets(serial, split);
+    }
+
+    auto print = [](const char* name, const RenderQueue::Stats& s) {
+        std::cout << "  " << name << ": " << s.stateChanges() << " state changes (pass " << s.passChanges
+                  << ", program " << s.programChanges << ", VAO " << s.vaoChanges << ", texture "
+                  << s.textureChanges << "), " << s.uniformWrites << " uniform writes" << std::endl;
+    };
+    print("record order", unsorted);
+    print("sorted      ", sorted);
+    std::cout << "  " << (double)unsorted.stateChanges() / std::max(1u, sorted.stateChanges())
+              << "x fewer state changes\n"
+              << "  per frame: record " << recordUs / frames << " us on one thread, " << parallelUs / frames
+              << " us on the job system (" << recordUs / parallelUs << "x)" << (identical ? "" : "  MISMATCH") << "\n"
+              << "  per frame: radix sort " << sortUs / frames << " us (std::sort of keys alone "
+              << stdSortUs / frames << " us), frame memory " << serial.memory().highWater() / 1024 << " KiB"
+              << (ordered ? "" : "  ORDER CHECK FAILED") << std::endl;
+    bool mixed = checkMixedOrder(jobs);
+    if (!mixed)
+        std::cout << "  MIXED RECORD ORDER CHECK FAILED" << std::endl;
+    return ordered && identical && mixed ? 0 : 1;
+}
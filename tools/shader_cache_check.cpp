@@ -0,0 +1,102 @@
+// 程序二进制缓存的 CPU 侧检查：不创建 GL 上下文，只测 key 和缓存文件的读写
+// 用法：shader_cache_check [临时目录=shader_cache_check]
+// 检查：
+//   key        改顶点 / 片段源码或者换驱动都会变；源码边界不同的拼接不会撞在一起
+//   round-trip 写进去的格式、内容、编译耗时原样读回，不留 .tmp 文件
+//   reject     不存在、魔数 / 版本不对、文件名和头里的 key 对不上、内容被截断的文件都读不出来
+//   evict      驱动拒绝后删掉的文件再读就是未命中
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+
+#include "my_shaderCache.h"
+#include "check_common.h"
+
+namespace {
+
+Checker checker("SHADER_CACHE_CHECK");
+
+// 直接改写缓存文件里 offset 处的字节，模拟旧版本或者损坏的文件
+void patchFile(const std::string& path, size_t offset, const void* data, size_t size) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.write(static_cast<const char*>(data), size);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string directory = argc > 1 ? argv[1] : "shader_cache_check";
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+
+    // key
+    const std::string vert = "#version 330 core\nvoid main() { gl_Position = vec4(0.0); }\n";
+    const std::string frag = "#version 330 core\nout vec4 c;\nvoid main() { c = vec4(1.0); }\n";
+    const std::string driver = "Vendor\nRenderer\n4.6.0 1.2.3";
+    uint64_t base = ShaderBinaryCache::computeKey(vert, frag, driver);
+    checker.expect(base == ShaderBinaryCache::computeKey(vert, frag, driver), "KEY_NOT_DETERMINISTIC");
+    checker.expect(base != ShaderBinaryCache::computeKey(vert + " ", frag, driver), "KEY_IGNORES_VERTEX");
+    checker.expect(base != ShaderBinaryCache::computeKey(vert, frag + " ", driver), "KEY_IGNORES_FRAGMENT");
+    checker.expect(base != ShaderBinaryCache::computeKey(vert, frag, "Vendor\nRenderer\n4.6.0 1.2.4"), "KEY_IGNORES_DRIVER");
+    checker.expect(ShaderBinaryCache::computeKey("ab", "c", driver) != ShaderBinaryCache::computeKey("a", "bc", driver),
+                   "KEY_SOURCE_BOUNDARY");
+    checker.expect(ShaderBinaryCache::computeKey(vert, frag, driver) != ShaderBinaryCache::computeKey(frag, vert, driver),
+                   "KEY_STAGE_ORDER");
+
+    // round-trip
+    ShaderBinaryCache cache;
+    cache.directory = directory;
+    ShaderBinaryCache::Entry written;
+    written.format = 0x8E21;
+    written.compileMs = 12.5;
+    for (int i = 0; i < 4096; ++i)
+        written.blob.push_back((char)(i * 31 + 7));
+    checker.expect(cache.writeEntry(base, written), "WRITE_FAILED");
+    ShaderBinaryCache::Entry read;
+    checker.expect(cache.readEntry(base, read), "READ_FAILED");
+    checker.expect(read.format == written.format && read.compileMs == written.compileMs && read.blob == written.blob,
+                   "ROUND_TRIP_MISMATCH");
+    checker.expect(!std::filesystem::exists(cache.pathFor(base) + ".tmp"), "TMP_LEFT_BEHIND");
+
+    // 覆盖写：同一个 key 再写一次，读到的是新内容
+    written.blob.resize(100);
+    written.compileMs = 3.0;
+    checker.expect(cache.writeEntry(base, written) && cache.readEntry(base, read) && read.blob == written.blob &&
+                   read.compileMs == 3.0, "OVERWRITE_MISMATCH");
+
+    // reject
+    checker.expect(!cache.readEntry(base + 1, read), "READ_MISSING_FILE");
+    std::string path = cache.pathFor(base);
+    std::filesystem::copy_file(path, cache.pathFor(base + 1), ec);
+    checker.expect(!ec && !cache.readEntry(base + 1, read), "READ_WRONG_KEY");
+
+    uint32_t badMagic = 0, badVersion = 99;
+    auto rewrite = [&]() { cache.writeEntry(base, written); };
+    patchFile(path, 0, &badMagic, sizeof(badMagic));
+    checker.expect(!cache.readEntry(base, read), "READ_BAD_MAGIC");
+    rewrite();
+    patchFile(path, 4, &badVersion, sizeof(badVersion));
+    checker.expect(!cache.readEntry(base, read), "READ_BAD_VERSION");
+    rewrite();
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    checker.expect(!cache.readEntry(base, read), "READ_TRUNCATED");
+    // 长度字段被改成一个巨大的值：不能按它分配内存
+    rewrite();
+    uint32_t hugeLength = 0xFFFFFFF0u;
+    patchFile(path, 12, &hugeLength, sizeof(hugeLength));
+    checker.expect(!cache.readEntry(base, read), "READ_BAD_LENGTH");
+
+    // evict
+    rewrite();
+    checker.expect(cache.readEntry(base, read), "READ_AFTER_REWRITE");
+    cache.evict(base);
+    checker.expect(!cache.readEntry(base, read) && !std::filesystem::exists(path), "EVICT_FAILED");
+
+    std::filesystem::remove_all(directory, ec);
+    return checker.finish();
+}
@@ -0,0 +1,137 @@
+// 离线纹理烘焙：把 png/jpg 压缩成带完整 mip 链的 KTX2，运行时 Texture 直接上传压缩块
+// 用法：texture_baker [--format bc1|bc3|bc7|etc2|etc2a] [--srgb] [--no-flip] [-o 输出] 图片...
+// 不指定 -o 时输出到同目录、同名的 .ktx2
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <filesystem>
+
+#include "my_imageUtils.h"
+#include "my_textureCompressor.h"
+#include "my_ktx2.h"
+#include "my_jobSystem.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+bool parseFormat(const std::string& name, BlockFormat& format) {
+    if (name == "bc1")        format = BlockFormat::BC1;
+    else if (name == "bc3")   format = BlockFormat::BC3;
+    else if (name == "bc7")   format = BlockFormat::BC7;
+    else if (name == "etc2")  format = BlockFormat::ETC2_RGB;
+    else if (name == "etc2a") format = BlockFormat::ETC2_RGBA;
+    else return false;
+    return true;
+}
+
+bool hasAlpha(BlockFormat format) {
+    return format != BlockFormat::BC1 && format != BlockFormat::ETC2_RGB;
+}
+
+void printUsage() {
+    std::cout << "usage: texture_baker [--format bc1|bc3|bc7|etc2|etc2a] [--srgb] [--no-flip] [-o output.ktx2] image..." << std::endl;
+}
+
+// 加载耗时对比：解码原图（含 RGBA 扩展，相当于 Texture 上传前的 CPU 工作）vs 读入 KTX2
+void compareLoadTime(const std::string& source, const std::string& baked) {
+    const int runs = 5;
+    auto start = Clock::now();
+    for (int i = 0; i < runs; ++i)
+        decodeImage(source, 4);
+    double decodeMs = elapsedMs(start) / runs;
+
+    start = Clock::now();
+    for (int i = 0; i < runs; ++i)
+        ktx2::read(baked).file.prefault(); // 映射是惰性的，把页读进来才和解码公平比较
+    double readMs = elapsedMs(start) / runs;
+
+    std::cout << "  load: decode " << decodeMs << " ms vs ktx2 " << readMs << " ms ("
+              << (readMs > 0.0 ? decodeMs / readMs : 0.0) << "x)" << std::endl;
+}
+
+bool bake(const std::string& input, const std::string& output, BlockFormat format, bool srgb, bool flip, JobSystem& jobs) {
+    Image image = decodeImage(input, 4);
+    if (!image) {
+        std::cerr << "Failed to load texture:" << input << std::endl;
+        return false;
+    }
+    // 和 Texture 默认行为一致：OpenGL 纹理原点在左下角
+    if (flip)
+        flipRowsInPlace(image.pixels, image.width, image.height, image.channels);
+
+    auto start = Clock::now();
+    std::vector<CompressedLevel> levels = compressMipChain(image.pixels, image.width, image.height, format, srgb, &jobs);
+    double encodeMs = elapsedMs(start);
+
+    if (!ktx2::write(output, format, srgb, levels, flip ? "ru" : "rd")) {
+        std::cerr << "ERROR::TEXTURE_BAKER::WRITE_FAILED " << output << std::endl;
+        return false;
+    }
+
+    // 未压缩的参照：RGBA8 加完整 mip 链
+    size_t rawBytes = 0, compressed = 0;
+    for (const CompressedLevel& level : levels) {
+        rawBytes += (size_t)level.width * level.height * 4;
+        compressed += level.data.size();
+    }
+    std::vector<uint8_t> decoded = decompressImage(levels[0].data.data(), image.width, image.height, format);
+    double psnr = computePSNR(image.pixels, decoded.data(), (size_t)image.width * image.height, hasAlpha(format) ? 4 : 3);
+
+    std::cout << input << " -> " << output << "\n"
+              << "  " << image.width << "x" << image.height << ", " << levels.size() << " levels, "
+              << rawBytes / 1024 << " KB -> " << compressed / 1024 << " KB ("
+              << (double)rawBytes / compressed << ":1), PSNR " << psnr << " dB, encode " << encodeMs << " ms" << std::endl;
+    compareLoadTime(input, output);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BlockFormat format = BlockFormat::BC7;
+    bool srgb = false, flip = true;
+    std::string output;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            if (!parseFormat(argv[++i], format)) {
+                printUsage();
+                return 1;
+            }
+        } else if (arg == "--srgb") {
+            srgb = true;
+        } else if (arg == "--no-flip") {
+            flip = false;
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty() || (!output.empty() && inputs.size() > 1)) {
+        printUsage();
+        return 1;
+    }
+
+    JobSystem jobs;
+    int failed = 0;
+    for (const std::string& input : inputs) {
+        std::string target = output.empty()
+            ? std::filesystem::path(input).replace_extension(".ktx2").string()
+            : output;
+        if (!bake(input, target, format, srgb, flip, jobs))
+            ++failed;
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+// 纹理压缩的 CPU 往返检查：不读图片文件，用程序生成的测试图
+// 用法：texture_compress_check [临时目录=texture_compress_check]
+// 检查：
+//   blocks   BC1 / BC3 / BC7 / ETC2 / ETC2A 压缩后再解码，PSNR 不低于各格式的门限；
+//            纯色图几乎无损；宽高不是 4 的倍数时边缘块也正确；任务系统并行压缩和单线程逐字节一致
+//   ktx2     整条 mip 链写成 KTX2 再读回，格式、尺寸、每一级的数据都一致；
+//            vkFormat 和 BlockFormat / sRGB 能互相转换；坏文件读不出来
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <iterator>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include "my_textureCompressor.h"
+#include "my_ktx2.h"
+#include "my_jobSystem.h"
+#include "check_common.h"
+
+namespace {
+
+Checker checker("TEXTURE_COMPRESS_CHECK");
+
+struct Format {
+    BlockFormat format;
+    const char* name;
+    bool alpha;
+    double minPSNR;  // 测试图上的 RGB（有 alpha 时 RGBA）PSNR 门限，dB
+};
+
+// 门限按两张测试图里较差的一张（67x45，几乎全是色块边缘）的实测值留 2 dB 余量，压缩质量明显下降时报错
+const Format FORMATS[] = {
+    { BlockFormat::BC1,       "BC1",   false, 32.0 },
+    { BlockFormat::BC3,       "BC3",   true,  33.0 },
+    { BlockFormat::BC7,       "BC7",   true,  35.0 },
+    { BlockFormat::ETC2_RGB,  "ETC2",  false, 32.0 },
+    { BlockFormat::ETC2_RGBA, "ETC2A", true,  33.0 },
+};
+
+// 平滑渐变 + 几个色块 + 少量噪声，alpha 是另一个方向的渐变；像普通的颜色贴图，不是最坏情况
+std::vector<uint8_t> makeTestImage(int width, int height) {
+    std::vector<uint8_t> rgba((size_t)width * height * 4);
+    uint32_t seed = 12345;
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x) {
+            seed = seed * 1664525u + 1013904223u;
+            int noise = (int)(seed >> 28) - 8;
+            float u = (float)x / width, v = (float)y / height;
+            int r = (int)(255.0f * u), g = (int)(255.0f * v), b = (int)(128.0f + 100.0f * std::sin(6.0f * u + 3.0f * v));
+            if (((x / 16) + (y / 16)) % 5 == 0) {
+                r = 220;
+                g = 40;
+                b = 60;
+            }
+            uint8_t* p = &rgba[((size_t)y * width + x) * 4];
+            p[0] = (uint8_t)texcomp::clamp255(r + noise);
+            p[1] = (uint8_t)texcomp::clamp255(g + noise);
+            p[2] = (uint8_t)texcomp::clamp255(b + noise);
+            p[3] = (uint8_t)texcomp::clamp255((int)(255.0f * (1.0f - 0.7f * u * v)));
+        }
+    return rgba;
+}
+
+std::vector<uint8_t> makeSolidImage(int width, int height, const uint8_t color[4]) {
+    std::vector<uint8_t> rgba((size_t)width * height * 4);
+    for (size_t i = 0; i < rgba.size(); i += 4)
+        std::memcpy(&rgba[i], color, 4);
+    return rgba;
+}
+
+double roundTripPSNR(const std::vector<uint8_t>& rgba, int width, int height, const Format& f) {
+    std::vector<uint8_t> compressed = compressImage(rgba.data(), width, height, f.format);
+    checker.expect(compressed.size() == compressedSize(width, height, f.format),
+                   std::string("COMPRESSED_SIZE ") + f.name + " " + std::to_string(width) + "x" + std::to_string(height));
+    std::vector<uint8_t> decoded = decompressImage(compressed.data(), width, height, f.format);
+    return computePSNR(rgba.data(), decoded.data(), (size_t)width * height, f.alpha ? 4 : 3);
+}
+
+void checkBlocks(JobSystem& jobs) {
+    const int W = 256, H = 256;
+    std::vector<uint8_t> image = makeTestImage(W, H);
+    // 宽高不是 4 的倍数：最右一列 / 最下一行块只有部分像素在图里
+    const int EW = 67, EH = 45;
+    std::vector<uint8_t> edgeImage = makeTestImage(EW, EH);
+    const uint8_t solid[4] = { 37, 142, 201, 180 };
+    std::vector<uint8_t> solidImage = makeSolidImage(32, 32, solid);
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const Format& f : FORMATS) {
+        double psnr = roundTripPSNR(image, W, H, f);
+        double edgePSNR = roundTripPSNR(edgeImage, EW, EH, f);
+        double solidPSNR = roundTripPSNR(solidImage, 32, 32, f);
+        std::cout << "  " << std::setw(6) << std::left << f.name << std::right << "  PSNR " << psnr << " dB (min "
+                  << f.minPSNR << "), " << EW << "x" << EH << " " << edgePSNR << " dB, solid " << solidPSNR << " dB"
+                  << std::endl;
+        checker.expect(psnr >= f.minPSNR, std::string("PSNR_BELOW_THRESHOLD ") + f.name);
+        checker.expect(edgePSNR >= f.minPSNR, std::string("EDGE_PSNR_BELOW_THRESHOLD ") + f.name);
+        // 纯色块只剩端点量化误差（BC1 的 565 每通道最多差 4 级左右）
+        checker.expect(solidPSNR >= 36.0, std::string("SOLID_PSNR_BELOW_THRESHOLD ") + f.name);
+
+        std::vector<uint8_t> serial = compressImage(image.data(), W, H, f.format);
+        std::vector<uint8_t> parallel = compressImage(image.data(), W, H, f.format, &jobs);
+        checker.expect(serial == parallel, std::string("PARALLEL_MISMATCH ") + f.name);
+    }
+}
+
+void checkKtx2(const std::string& directory, JobSystem& jobs) {
+    const int W = 100, H = 60;
+    std::vector<uint8_t> image = makeTestImage(W, H);
+    for (const Format& f : FORMATS) {
+        for (bool srgb : { false, true }) {
+            std::string tag = std::string(f.name) + (srgb ? " srgb" : "");
+            std::vector<CompressedLevel> levels = compressMipChain(image.data(), W, H, f.format, srgb, &jobs);
+            std::string path = (std::filesystem::path(directory) / (std::string(f.name) + (srgb ? "_srgb" : "") + ".ktx2")).string();
+            checker.expect(ktx2::write(path, f.format, srgb, levels, "ru"), "KTX2_WRITE_FAILED " + tag);
+
+            std::string error;
+            ktx2::Texture2D file = ktx2::read(path, &error);
+            checker.expect((bool)file, "KTX2_READ_FAILED " + tag + ": " + error);
+            if (!file)
+                continue;
+            BlockFormat format;
+            bool readSrgb = !srgb;
+            checker.expect(ktx2::blockFormatFor(file.vkFormat, format, readSrgb) && format == f.format && readSrgb == srgb,
+                           "KTX2_FORMAT_MISMATCH " + tag);
+            checker.expect(file.width == W && file.height == H && file.levels.size() == levels.size(), "KTX2_HEADER_MISMATCH " + tag);
+            for (size_t i = 0; i < levels.size() && i < file.levels.size(); ++i) {
+                const ktx2::Level& level = file.levels[i];
+                bool same = level.width == levels[i].width && level.height == levels[i].height &&
+                            level.length == levels[i].data.size() &&
+                            std::memcmp(file.levelData(i), levels[i].data.data(), level.length) == 0 &&
+                            level.offset % blockBytes(f.format) == 0;
+                checker.expect(same, "KTX2_LEVEL_MISMATCH " + tag + " level " + std::to_string(i));
+            }
+        }
+    }
+
+    // 坏文件：标识符不对、截断到 level index 之前、level 数据超出文件
+    std::string good = (std::filesystem::path(directory) / "BC1.ktx2").string();
+    std::vector<char> bytes;
+    {
+        std::ifstream in(good, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    auto writeBytes = [&](const std::string& name, const std::vector<char>& data) {
+        std::string path = (std::filesystem::path(directory) / name).string();
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), (std::streamsize)data.size());
+        return path;
+    };
+    std::vector<char> badIdentifier = bytes;
+    badIdentifier[1] ^= 0x20;
+    checker.expect(!ktx2::read(writeBytes("bad_identifier.ktx2", badIdentifier)), "KTX2_ACCEPTS_BAD_IDENTIFIER");
+    checker.expect(!ktx2::read(writeBytes("truncated_index.ktx2", std::vector<char>(bytes.begin(), bytes.begin() + 90))),
+                   "KTX2_ACCEPTS_TRUNCATED_INDEX");
+    checker.expect(!ktx2::read(writeBytes("truncated_data.ktx2", std::vector<char>(bytes.begin(), bytes.end() - 1))),
+                   "KTX2_ACCEPTS_TRUNCATED_DATA");
+    checker.expect(!ktx2::read((std::filesystem::path(directory) / "missing.ktx2").string()), "KTX2_ACCEPTS_MISSING_FILE");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string directory = argc > 1 ? argv[1] : "texture_compress_check";
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+    std::filesystem::create_directories(directory, ec);
+
+    JobSystem jobs;
+    std::cout << "block compression round trip:" << std::endl;
+    checkBlocks(jobs);
+    checkKtx2(directory, jobs);
+
+    std::filesystem::remove_all(directory, ec);
+    return checker.finish();
+}
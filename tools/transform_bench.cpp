@@ -0,0 +1,198 @@
+// 变换层级基准：每帧改动不同比例的节点，比较增量更新、全量线性更新和逐对象递归重建的耗时
+// 用法：transform_bench [节点数=100000] [帧数=100] [工作线程数=核数-1]
+// 层级是随机树：每个新节点挂在已有的随机节点下（约 1% 是根），深度大约是 log(n)
+// 对照组是常见写法：节点单独 new 出来，父子用指针连接，每帧从根递归 translate * mat4_cast * scale
+// 同时报告把 changed() 合并成上传区间之后每帧要传给实例缓冲的字节数和调用次数
+// 每种比例跑完都校验增量结果和全量更新逐字节一致、和递归重建在误差内一致
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "my_transformGraph.h"
+#include "my_instancing.h"
+#include "my_jobSystem.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double usSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+struct Random {
+    uint32_t seed = 12345;
+    uint32_t next() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    }
+    float operator()(float lo, float hi) { return lo + (hi - lo) * (float)next() / 16777216.0f; }
+    uint32_t below(size_t n) { return (uint32_t)(next() % n); }
+};
+
+// 对照组的节点
+struct PointerNode {
+    glm::vec3 position;
+    glm::quat rotation;
+    glm::vec3 scale;
+    glm::mat4 world;
+    std::vector<PointerNode*> children;
+};
+
+void rebuildRecursive(PointerNode* node, const glm::mat4& parent) {
+    glm::mat4 local = glm::translate(glm::mat4(1.0f), node->position) * glm::mat4_cast(node->rotation);
+    node->world = parent * glm::scale(local, node->scale);
+    for (PointerNode* child : node->children)
+        rebuildRecursive(child, node->world);
+}
+
+bool nearlyEqual(const glm::mat4& a, const glm::mat4& b) {
+    for (int c = 0; c < 4; ++c)
+        for (int r = 0; r < 4; ++r)
+            if (std::fabs(a[c][r] - b[c][r]) > 1e-3f * (1.0f + std::fabs(b[c][r])))
+                return false;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoul(argv[1]) : 100000;
+    int frames = argc > 2 ? std::stoi(argv[2]) : 100;
+    JobSystem jobs(argc > 3 ? (unsigned)std::stoul(argv[3]) : JobSystem::defaultWorkerCount());
+
+    Random random;
+    TransformGraph graph;
+    std::vector<TransformGraph::NodeId> ids;
+    std::vector<std::unique_ptr<PointerNode>> pointerNodes;
+    std::vector<PointerNode*> pointerRoots;
+    ids.reserve(count);
+    pointerNodes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        bool root = i == 0 || random.below(100) == 0;
+        size_t parent = root ? 0 : random.below(i);
+        glm::vec3 position(random(-2.0f, 2.0f), random(-2.0f, 2.0f), random(-2.0f, 2.0f));
+        glm::quat rotation = glm::angleAxis(random(0.0f, 6.28f), glm::normalize(glm::vec3(random(-1.0f, 1.0f), 1.0f, random(-1.0f, 1.0f))));
+        glm::vec3 scale(random(0.9f, 1.1f));
+        ids.push_back(graph.add(root ? TransformGraph::NONE : ids[parent], position, rotation, scale));
+
+        pointerNodes.emplace_back(new PointerNode{ position, rotation, scale, glm::mat4(1.0f), {} });
+        if (root)
+            pointerRoots.push_back(pointerNodes.back().get());
+        else
+            pointerNodes[parent]->children.push_back(pointerNodes.back().get());
+    }
+    graph.update(); // 第一次是重排 + 全量
+
+    std::cout << "transform graph: " << count << " nodes, " << pointerRoots.size() << " roots, " << frames
+              << " frames per row, " << jobs.size() << " threads" << std::endl;
+
+    // 全量更新的基准线，不随改动比例变化
+    auto start = Clock::now();
+    for (int f = 0; f < frames; ++f)
+        graph.updateAll();
+    double fullUs = usSince(start) / frames;
+    start = Clock::now();
+    for (int f = 0; f < frames; ++f)
+        graph.updateAll(&jobs);
+    double fullJobsUs = usSince(start) / frames;
+    start = Clock::now();
+    for (int f = 0; f < frames; ++f)
+        for (PointerNode* root : pointerRoots)
+            rebuildRecursive(root, glm::mat4(1.0f));
+    double pointerUs = usSince(start) / frames;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  full linear pass: " << fullUs << " us, on the job system: " << fullJobsUs
+              << " us, recursive pointer rebuild: " << pointerUs << " us" << std::endl;
+
+    bool ok = true;
+    std::vector<SlotRange> ranges;
+    const double fractions[] = { 0.0, 0.0001, 0.001, 0.01, 0.1, 1.0 };
+    std::cout << "  changed   incremental      nodes updated   upload/frame           vs full   vs pointers" << std::endl;
+    for (double fraction : fractions) {
+        size_t edits = (size_t)std::ceil(fraction * count);
+        double updateUs = 0.0, updated = 0.0, rangeCount = 0.0, bytes = 0.0;
+        for (int f = 0; f < frames; ++f) {
+            for (size_t k = 0; k < edits; ++k) {
+                TransformGraph::NodeId id = ids[random.below(count)];
+                glm::vec3 p = graph.position(id);
+                graph.setPosition(id, p + glm::vec3(0.001f, 0.0f, 0.0f));
+            }
+            start = Clock::now();
+            graph.update();
+            updateUs += usSince(start);
+            updated += (double)graph.changed().size();
+            coalesceSlots(graph.changed(), ResidentInstanceBuffer::MERGE_GAP, ranges);
+            rangeCount += (double)ranges.size();
+            for (const SlotRange& range : ranges)
+                bytes += (double)range.count * sizeof(InstanceData);
+        }
+        double perFrame = updateUs / frames;
+        std::cout << "  " << std::setprecision(2) << std::setw(6) << fraction * 100.0 << "%  " << std::setprecision(1) << std::setw(9) << perFrame << " us  "
+                  << std::setw(15) << (size_t)(updated / frames) << "  " << std::setw(8) << (size_t)(rangeCount / frames)
+                  << " ranges " << std::setw(8) << (size_t)(bytes / frames / 1024) << " KiB  " << std::setw(7)
+                  << fullUs / std::max(perFrame, 0.01) << "x  " << std::setw(8) << pointerUs / std::max(perFrame, 0.01)
+                  << "x" << std::endl;
+
+        // 增量结果必须和全量重算逐字节一致
+        TransformGraph reference = graph;
+        reference.updateAll();
+        if (std::memcmp(graph.worldMatrices().data(), reference.worldMatrices().data(),
+                        graph.slots() * sizeof(glm::mat4)) != 0) {
+            std::cerr << "ERROR::TRANSFORM_BENCH::INCREMENTAL_MISMATCH at " << fraction * 100.0 << "%" << std::endl;
+            ok = false;
+        }
+    }
+
+    // 和逐对象递归的结果比较（位置改过的同步过去）
+    for (size_t i = 0; i < count; ++i)
+        pointerNodes[i]->position = graph.position(ids[i]);
+    for (PointerNode* root : pointerRoots)
+        rebuildRecursive(root, glm::mat4(1.0f));
+    for (size_t i = 0; i < count; i += std::max<size_t>(1, count / 2000)) {
+        if (!nearlyEqual(graph.worldMatrix(ids[i]), pointerNodes[i]->world)) {
+            std::cerr << "ERROR::TRANSFORM_BENCH::WORLD_MATRIX_MISMATCH node " << i << std::endl;
+            ok = false;
+            break;
+        }
+    }
+
+    // 结构变化：删掉一些子树、换几次父节点，下一帧重排，结果仍然要和递归一致
+    for (int k = 0; k < 20; ++k) {
+        TransformGraph::NodeId a = ids[random.below(count)], b = ids[random.below(count)];
+        if (graph.valid(a) && graph.valid(b))
+            graph.setParent(a, b);
+    }
+    TransformGraph::NodeId removed = ids[random.below(count)];
+    graph.remove(removed);
+    start = Clock::now();
+    graph.update();
+    std::cout << "  relayout after structural changes: " << usSince(start) << " us, " << graph.size()
+              << " nodes left" << std::endl;
+    for (size_t i = 0; i < count; i += std::max<size_t>(1, count / 2000)) {
+        TransformGraph::NodeId id = ids[i];
+        if (!graph.valid(id))
+            continue;
+        glm::mat4 expected = graph.localMatrix(graph.slotOf(id));
+        for (TransformGraph::NodeId p = graph.parentOf(id); p != TransformGraph::NONE; p = graph.parentOf(p))
+            expected = graph.localMatrix(graph.slotOf(p)) * expected;
+        if (!nearlyEqual(graph.worldMatrix(id), expected)) {
+            std::cerr << "ERROR::TRANSFORM_BENCH::RELAYOUT_MISMATCH node " << i << std::endl;
+            ok = false;
+            break;
+        }
+    }
+
+    std::cout << (ok ? "all checks passed" : "CHECKS FAILED") << std::endl;
+    return ok ? 0 : 1;
+}